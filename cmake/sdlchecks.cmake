@@ -927,19 +927,44 @@ macro(CheckPTHREAD)
       check_function_exists(pthread_setname_np HAVE_PTHREAD_SETNAME_NP)
       check_function_exists(pthread_set_name_np HAVE_PTHREAD_SET_NAME_NP)
 
+      if(LINUX)
+        check_c_source_compiles("
+            #include <linux/futex.h>
+            #include <sys/syscall.h>
+            #include <unistd.h>
+            int main(int argc, char **argv) {
+                static int futex = 0;
+                syscall(SYS_futex, &futex, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+                return 0;
+            }" HAVE_LINUX_FUTEX)
+      endif()
+
       set(SOURCE_FILES ${SOURCE_FILES}
           ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_systhread.c
-          ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_sysmutex.c   # Can be faked, if necessary
-          ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_syscond.c    # Can be faked, if necessary
           ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_systls.c
           )
-      if(HAVE_PTHREADS_SEM)
+      if(HAVE_LINUX_FUTEX)
+        # Mutexes, condition variables and semaphores straight on futexes
+        set(SDL_THREAD_LINUX_FUTEX 1)
         set(SOURCE_FILES ${SOURCE_FILES}
-            ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_syssem.c)
+            ${SDL2_SOURCE_DIR}/src/thread/linux/SDL_sysmutex.c
+            ${SDL2_SOURCE_DIR}/src/thread/linux/SDL_syscond.c
+            ${SDL2_SOURCE_DIR}/src/thread/linux/SDL_syssem.c)
       else()
         set(SOURCE_FILES ${SOURCE_FILES}
-            ${SDL2_SOURCE_DIR}/src/thread/generic/SDL_syssem.c)
+            ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_sysmutex.c   # Can be faked, if necessary
+            ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_syscond.c    # Can be faked, if necessary
+            )
+        if(HAVE_PTHREADS_SEM)
+          set(SOURCE_FILES ${SOURCE_FILES}
+              ${SDL2_SOURCE_DIR}/src/thread/pthread/SDL_syssem.c)
+        else()
+          set(SOURCE_FILES ${SOURCE_FILES}
+              ${SDL2_SOURCE_DIR}/src/thread/generic/SDL_syssem.c)
+        endif()
       endif()
+      set(SOURCE_FILES ${SOURCE_FILES}
+          ${SDL2_SOURCE_DIR}/src/thread/generic/SDL_sysrwlock.c)
       set(HAVE_SDL_THREADS TRUE)
     endif()
     set(CMAKE_REQUIRED_FLAGS "${ORIG_CMAKE_REQUIRED_FLAGS}")
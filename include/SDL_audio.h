@@ -489,6 +489,88 @@ extern DECLSPEC SDL_AudioSpec *SDLCALL SDL_LoadWAV_RW(SDL_RWops * src,
  */
 extern DECLSPEC void SDLCALL SDL_FreeWAV(Uint8 * audio_buf);
 
+/* SDL_WAVStream decodes a WAVE file while it is being read, instead of
+   loading all of it into memory like SDL_LoadWAV_RW().
+ */
+/* this is opaque to the outside world. */
+struct _SDL_WAVStream;
+typedef struct _SDL_WAVStream SDL_WAVStream;
+
+/**
+ *  \brief Open a WAVE file for decoding on demand
+ *
+ *  The headers of the file are parsed like with SDL_LoadWAV_RW() and \c spec
+ *  is filled the same way, but the audio data stays in the data source. It is
+ *  read and decoded block by block with SDL_WAVStreamRead(), so memory use
+ *  doesn't depend on the length of the file. The same formats and hints as
+ *  with SDL_LoadWAV_RW() are supported.
+ *
+ *  The data source has to support seeking and must stay valid until the
+ *  stream is closed. If \c freesrc is non-zero, it is closed and freed by
+ *  SDL_CloseWAVStream(), or before this function returns if it fails.
+ *
+ *  \param src The data source with the WAVE data
+ *  \param freesrc A integer value that makes the stream close the data source if non-zero
+ *  \param spec A pointer filled with the audio format of the decoded data
+ *  \return The new stream, or NULL on error.
+ *
+ *  \sa SDL_WAVStreamRead
+ *  \sa SDL_WAVStreamSeek
+ *  \sa SDL_CloseWAVStream
+ */
+extern DECLSPEC SDL_WAVStream *SDLCALL SDL_OpenWAVStream_RW(SDL_RWops * src,
+                                                            int freesrc,
+                                                            SDL_AudioSpec * spec);
+
+/**
+ *  Opens a WAV file for streaming.
+ */
+#define SDL_OpenWAVStream(file, spec) \
+    SDL_OpenWAVStream_RW(SDL_RWFromFile(file, "rb"), 1, spec)
+
+/**
+ *  \brief Decode sample frames from a WAVE stream
+ *
+ *  Decodes up to \c frames sample frames from the current position into
+ *  \c buf, in the format reported by SDL_OpenWAVStream_RW(), and advances
+ *  the position.
+ *
+ *  \param stream The stream to read from
+ *  \param buf A buffer with room for \c frames sample frames
+ *  \param frames The number of sample frames to read
+ *  \return The number of sample frames read, 0 at the end of the data, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamRead(SDL_WAVStream * stream,
+                                              void * buf, int frames);
+
+/**
+ *  \brief Move the read position of a WAVE stream
+ *
+ *  \param stream The stream to seek in
+ *  \param frame The sample frame to continue reading from, clamped to the length of the stream
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamSeek(SDL_WAVStream * stream,
+                                              Sint64 frame);
+
+/**
+ *  Get the current read position of a WAVE stream in sample frames, or -1 on error.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVStreamTell(SDL_WAVStream * stream);
+
+/**
+ *  Get the length of a WAVE stream in sample frames, or -1 on error.
+ *
+ *  The length can get shorter while reading if the data turns out to be
+ *  truncated.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVStreamLength(SDL_WAVStream * stream);
+
+/**
+ *  Close a WAVE stream, and its data source if it was opened with \c freesrc.
+ */
+extern DECLSPEC void SDLCALL SDL_CloseWAVStream(SDL_WAVStream * stream);
+
 /**
  *  This function takes a source format and rate and a destination format
  *  and rate, and initializes the \c cvt structure with information needed
@@ -634,6 +716,54 @@ extern DECLSPEC int SDLCALL SDL_AudioStreamFlush(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
 
+/**
+ *  How an audio stream resamples, from cheapest to best sounding.
+ */
+typedef enum
+{
+    SDL_AUDIO_RESAMPLE_ZERO_ORDER_HOLD, /**< Repeat the last input sample. No added latency, but lots of aliasing. */
+    SDL_AUDIO_RESAMPLE_LINEAR,          /**< Interpolate linearly between two input samples. One sample of latency. */
+    SDL_AUDIO_RESAMPLE_SHORT_SINC,      /**< A short windowed sinc filter. Two samples of latency. */
+    SDL_AUDIO_RESAMPLE_HIGH_QUALITY     /**< The default: the full windowed sinc filter, or libsamplerate if it's available. */
+} SDL_AudioResampleQuality;
+
+/**
+ *  Choose how the stream resamples, to trade quality for CPU time and latency.
+ *
+ *  This is best called right after SDL_NewAudioStream(). Changing the quality
+ *  of a stream that already has data put into it drops the few sample frames
+ *  the resampler is holding back, but not what's already been converted.
+ *  Streams that don't change the sample rate accept and ignore this.
+ *
+ *  \param stream The stream to change
+ *  \param quality One of the SDL_AudioResampleQuality values
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_NewAudioStream
+ *  \sa SDL_AudioStreamPut
+ *  \sa SDL_AudioStreamClear
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamSetResampleQuality(SDL_AudioStream *stream, SDL_AudioResampleQuality quality);
+
+/**
+ *  Replace how the stream mixes its input channels into its output channels.
+ *
+ *  By default a stream up- or downmixes between SDL's channel layouts the
+ *  same way SDL_AudioCVT does. This lets you supply your own coefficients,
+ *  to downmix 5.1 with a louder center channel, say, or swap left and right.
+ *
+ *  \param stream The stream to change
+ *  \param matrix dst_channels rows of src_channels weights each: element
+ *                [(o * src_channels) + i] is how much input channel i adds
+ *                to output channel o. It's copied, so it doesn't need to
+ *                outlive the call. NULL goes back to SDL's default mixing.
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_NewAudioStream
+ *  \sa SDL_AudioStreamPut
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamSetChannelMatrix(SDL_AudioStream *stream, const float *matrix);
+
 /**
  * Free an audio stream
  *
@@ -667,6 +797,72 @@ extern DECLSPEC void SDLCALL SDL_MixAudioFormat(Uint8 * dst,
                                                 SDL_AudioFormat format,
                                                 Uint32 len, int volume);
 
+/**
+ *  Add a voice to a playback device, and get the audio stream that feeds it.
+ *
+ *  While a device has voices, SDL mixes them itself in place of the app's
+ *  callback (or queued audio): every voice is converted to float, scaled by
+ *  its gain and pan, summed into one buffer, and only that sum is clipped and
+ *  converted to the device's format. Voices that run out of data are mixed as
+ *  silence until more is put into them.
+ *
+ *  The stream converts from the format given here to what the device plays.
+ *  Put data into it with SDL_AudioStreamPut() while holding
+ *  SDL_LockAudioDevice(), since the device's audio thread reads from it.
+ *  Don't free the stream yourself; use SDL_RemoveAudioDeviceVoice().
+ *
+ *  A new voice has a gain of 1.0 and is centered.
+ *
+ *  Voices are mixed by SDL's own audio thread, so backends that run the
+ *  callback from a thread of their own (Core Audio, Emscripten,
+ *  Haiku and NaCl)
+ *  keep calling the callback instead.
+ *
+ *  \param dev The playback device to add the voice to
+ *  \param src_format The format of the audio data you'll put into the voice
+ *  \param src_channels The number of channels you'll put into the voice
+ *  \param src_rate The sample rate you'll put into the voice
+ *  \return the voice's stream, or NULL on error.
+ *
+ *  \sa SDL_SetAudioDeviceVoiceGain
+ *  \sa SDL_RemoveAudioDeviceVoice
+ *  \sa SDL_AudioStreamPut
+ */
+extern DECLSPEC SDL_AudioStream * SDLCALL SDL_AddAudioDeviceVoice(SDL_AudioDeviceID dev,
+                                                                  const SDL_AudioFormat src_format,
+                                                                  const Uint8 src_channels,
+                                                                  const int src_rate);
+
+/**
+ *  Set the gain and pan of one of a device's voices.
+ *
+ *  The gain scales the voice linearly; 1.0 plays it unchanged. The pan goes
+ *  from -1.0 (left only) through 0.0 (centered) to 1.0 (right only), and
+ *  turns down the opposite side while leaving the near side at full gain.
+ *  Center and LFE channels only get the gain.
+ *
+ *  \param dev The playback device the voice was added to
+ *  \param voice A stream returned by SDL_AddAudioDeviceVoice()
+ *  \param gain How much to scale the voice by, 0.0 or more
+ *  \param pan Where to place the voice, from -1.0 to 1.0
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_AddAudioDeviceVoice
+ */
+extern DECLSPEC int SDLCALL SDL_SetAudioDeviceVoiceGain(SDL_AudioDeviceID dev, SDL_AudioStream *voice, float gain, float pan);
+
+/**
+ *  Remove a voice from a device and free its stream, dropping any audio that
+ *  is still queued in it. Once a device has no voices left, its callback (or
+ *  queued audio) plays again.
+ *
+ *  \param dev The playback device the voice was added to
+ *  \param voice A stream returned by SDL_AddAudioDeviceVoice()
+ *
+ *  \sa SDL_AddAudioDeviceVoice
+ */
+extern DECLSPEC void SDLCALL SDL_RemoveAudioDeviceVoice(SDL_AudioDeviceID dev, SDL_AudioStream *voice);
+
 /**
  *  Queue more audio on non-callback devices.
  *
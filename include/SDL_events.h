@@ -666,6 +666,34 @@ extern DECLSPEC void SDLCALL SDL_FlushEvents(Uint32 minType, Uint32 maxType);
  */
 extern DECLSPEC int SDLCALL SDL_PollEvent(SDL_Event * event);
 
+/**
+ *  \name SDL_PollEvents() flags
+ */
+/* @{ */
+#define SDL_POLLEVENTS_PUMP             0x00000001  /**< Call SDL_PumpEvents() once before retrieving events */
+#define SDL_POLLEVENTS_COALESCE_MOTION  0x00000002  /**< Merge consecutive mouse and finger motion events */
+/* @} */
+
+/**
+ *  \brief Removes up to \c numevents pending events from the queue in one call.
+ *
+ *  This is equivalent to calling SDL_PollEvent() in a loop, but the event
+ *  queue is locked only once and events are pumped at most once.
+ *
+ *  If ::SDL_POLLEVENTS_COALESCE_MOTION is set, consecutive ::SDL_MOUSEMOTION
+ *  events for the same window and mouse, and consecutive ::SDL_FINGERMOTION
+ *  events for the same finger, are merged into one event. The merged event
+ *  has the latest position and state, and the relative motion of all the
+ *  merged events added together.
+ *
+ *  \param events   An array of at least \c numevents events to fill.
+ *  \param numevents The maximum number of events to retrieve.
+ *  \param flags    A combination of SDL_POLLEVENTS_* flags.
+ *
+ *  \return The number of events stored in \c events, or -1 if there was an error.
+ */
+extern DECLSPEC int SDLCALL SDL_PollEvents(SDL_Event * events, int numevents, Uint32 flags);
+
 /**
  *  \brief Waits indefinitely for the next available event.
  *
@@ -701,6 +701,18 @@ extern "C" {
 */
 #define SDL_HINT_THREAD_STACK_SIZE              "SDL_THREAD_STACK_SIZE"
 
+/**
+*  \brief  A string specifying the number of worker threads in the task pool
+*
+*  By default the task pool has one worker thread less than the number of CPUs,
+*  since the thread waiting for tasks runs them as well. "0" runs every task in
+*  the waiting thread.
+*
+*  This hint is read when the task pool starts, the first time it's used after
+*  SDL_Quit() or at startup.
+*/
+#define SDL_HINT_TASK_POOL_THREADS              "SDL_TASK_POOL_THREADS"
+
 /**
  *  \brief If set to 1, then do not allow high-DPI windows. ("Retina" on Mac and iOS)
  */
@@ -1141,6 +1153,51 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_BATCHING  "SDL_RENDER_BATCHING"
 
+/**
+ *  \brief  A variable controlling whether the 2D render API collects per-frame statistics.
+ *
+ *  This variable can be set to the following values:
+ *    "0"     - Don't collect statistics (default)
+ *    "1"     - Collect statistics, readable with SDL_RenderGetStats()
+ *    "2"     - Collect statistics and log them at every SDL_RenderPresent()
+ *
+ *  The hint is checked when a renderer is created.
+ */
+#define SDL_HINT_RENDER_STATS  "SDL_RENDER_STATS"
+
+/**
+ *  \brief  A variable controlling how much work the 2D render API does to simplify a batch before it is drawn.
+ *
+ *  This variable can be set to the following values:
+ *    "0"     - Send the batch to the render backend as it was queued (default)
+ *    "1"     - Drop redundant state changes and merge adjacent copies of the same texture
+ *    "2"     - Also reorder copies by texture between state changes to form bigger batches
+ *
+ *  Setting this to "2" is a contract that overlapping SDL_RenderCopy() and
+ *  SDL_RenderCopiesF() calls with the same draw state may be drawn in any
+ *  order, which is only safe if your sprites don't overlap or if their
+ *  stacking order doesn't matter.
+ *
+ *  The hint is checked when a renderer is created.
+ */
+#define SDL_HINT_RENDER_OPTIMIZE  "SDL_RENDER_OPTIMIZE"
+
+/**
+ *  \brief  A variable controlling how many threads the software renderer uses.
+ *
+ *  This variable can be set to the following values:
+ *    "0"     - Use one thread per CPU core
+ *    "1"     - Render on the calling thread only (default)
+ *    "N"     - Use N threads, the calling thread included
+ *
+ *  With more than one thread, the render target is split into tiles and
+ *  fills, points, unscaled copies and geometry are rendered tile by tile in
+ *  parallel. The output is identical to rendering on a single thread.
+ *
+ *  The hint is checked when a renderer is created.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_THREADS  "SDL_RENDER_SOFTWARE_THREADS"
+
 
 /**
  *  \brief  A variable controlling whether SDL logs all events pushed onto its internal queue.
@@ -1163,6 +1220,43 @@ extern "C" {
  */
 #define SDL_HINT_EVENT_LOGGING   "SDL_EVENT_LOGGING"
 
+/**
+ *  \brief  A variable controlling whether the event queue uses a lock-free ring for pushing events.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - All event queue operations take the event queue mutex (default)
+ *    "1"     - SDL_PushEvent() calls use a preallocated lock-free ring
+ *
+ *  This helps applications that push events from several threads while the
+ *  main thread is polling. Getting, peeking, filtering and flushing events
+ *  still take the event queue mutex, and the total number of queued events
+ *  is limited the same way in both modes.
+ *
+ *  This hint must be set before the events subsystem is initialized.
+ */
+#define SDL_HINT_EVENT_QUEUE_LOCKFREE   "SDL_EVENT_QUEUE_LOCKFREE"
+
+/**
+ *  \brief  A variable controlling whether new mouse and finger motion events are merged into pending ones.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - Every motion event is added to the event queue (default)
+ *    "1"     - A motion event is merged into the event at the end of the queue
+ *              if that is a motion event for the same window and mouse, or for
+ *              the same finger, and hasn't been retrieved yet.
+ *
+ *  Merged events have the latest position and state, and the relative motion
+ *  of all the merged events added together. This keeps high polling rate
+ *  mice and touch screens from flooding the event queue. Event filters and
+ *  watchers still see every motion event.
+ *
+ *  This hint can be toggled on and off at runtime, and takes effect at the
+ *  next call to SDL_PumpEvents().
+ */
+#define SDL_HINT_MOTION_EVENT_COALESCING   "SDL_MOTION_EVENT_COALESCING"
+
 
 
 /**
@@ -240,6 +240,79 @@ extern DECLSPEC int SDLCALL SDL_CondWaitTimeout(SDL_cond * cond,
 /* @} *//* Condition variable functions */
 
 
+/**
+ *  \name Reader-writer lock functions
+ */
+/* @{ */
+
+/* The SDL reader-writer lock structure, defined in SDL_sysrwlock.c */
+struct SDL_rwlock;
+typedef struct SDL_rwlock SDL_rwlock;
+
+/**
+ *  Create a reader-writer lock.
+ *
+ *  Any number of threads can hold the lock for reading at the same time,
+ *  while only one thread at a time can hold it for writing, and only when
+ *  nobody is reading. This lets data that is read often and changed rarely
+ *  be read on several cores at once.
+ *
+ *  A thread may lock it for reading more than once, and a thread that has
+ *  it locked for writing may lock it again for reading or writing. A thread
+ *  that only has it locked for reading must not try to lock it for writing,
+ *  or it will wait forever.
+ */
+extern DECLSPEC SDL_rwlock *SDLCALL SDL_CreateRWLock(void);
+
+/**
+ *  Lock the reader-writer lock for reading, waiting while another thread
+ *  has it locked for writing.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForReading(SDL_rwlock * rwlock);
+
+/**
+ *  Lock the reader-writer lock for writing, waiting while other threads
+ *  have it locked.
+ *
+ *  \return 0, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForWriting(SDL_rwlock * rwlock);
+
+/**
+ *  Try to lock the reader-writer lock for reading without waiting.
+ *
+ *  \return 0, ::SDL_MUTEX_TIMEDOUT, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForReading(SDL_rwlock * rwlock);
+
+/**
+ *  Try to lock the reader-writer lock for writing without waiting.
+ *
+ *  \return 0, ::SDL_MUTEX_TIMEDOUT, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock);
+
+/**
+ *  Unlock the reader-writer lock, whether it was locked for reading or
+ *  for writing.
+ *
+ *  \return 0, or -1 on error.
+ *
+ *  \warning It is an error to unlock a lock that is not locked by the
+ *           calling thread.
+ */
+extern DECLSPEC int SDLCALL SDL_UnlockRWLock(SDL_rwlock * rwlock);
+
+/**
+ *  Destroy a reader-writer lock.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRWLock(SDL_rwlock * rwlock);
+
+/* @} *//* Reader-writer lock functions */
+
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -85,6 +85,39 @@ typedef struct SDL_RendererInfo
     int max_texture_height;     /**< The maximum texture height */
 } SDL_RendererInfo;
 
+/**
+ *  \brief Per-frame render queue counters, see SDL_RenderGetStats()
+ */
+typedef struct SDL_RenderStats
+{
+    Uint32 viewport_commands;   /**< Viewport changes queued */
+    Uint32 cliprect_commands;   /**< Clip rectangle changes queued */
+    Uint32 drawcolor_commands;  /**< Draw color changes queued */
+    Uint32 clear_commands;      /**< Clears queued */
+    Uint32 point_commands;      /**< Point draws queued */
+    Uint32 line_commands;       /**< Line draws queued */
+    Uint32 rect_commands;       /**< Rectangle fills queued */
+    Uint32 copy_commands;       /**< Texture copies queued */
+    Uint32 copyex_commands;     /**< Rotated or flipped texture copies queued */
+    Uint32 geometry_commands;   /**< Geometry draws queued */
+    Uint32 texture_switches;    /**< Textured draws using a different texture than the one before */
+    Uint32 vertex_bytes;        /**< Vertex data sent to the backend */
+    Uint32 vertex_reallocations;/**< Times the vertex buffer had to grow */
+    Uint32 flushes;             /**< Times the command queue was sent to the backend */
+    Uint32 forced_flushes;      /**< Flushes forced by changing a texture the queue still needs */
+    Uint32 backend_us;          /**< Microseconds spent in the backend running the queue */
+} SDL_RenderStats;
+
+/**
+ *  \brief Vertex structure for SDL_RenderGeometry()
+ */
+typedef struct SDL_Vertex
+{
+    SDL_FPoint position;        /**< Vertex position, in SDL_Renderer coordinates  */
+    SDL_Color  color;           /**< Vertex color */
+    SDL_FPoint tex_coord;       /**< Normalized texture coordinates, if needed */
+} SDL_Vertex;
+
 /**
  *  \brief The scaling mode for a texture.
  */
@@ -1014,6 +1047,28 @@ extern DECLSPEC int SDLCALL SDL_RenderCopyF(SDL_Renderer * renderer,
                                             const SDL_Rect * srcrect,
                                             const SDL_FRect * dstrect);
 
+/**
+ *  \brief Copy many portions of the same texture to the current rendering target.
+ *
+ *  This is equivalent to calling SDL_RenderCopyF() once for each pair of
+ *  rectangles, but the whole array is validated once and, on renderers that
+ *  support it, queued as a single render command.
+ *
+ *  \param renderer The renderer which should copy parts of a texture.
+ *  \param texture The source texture.
+ *  \param srcrects An array of source rectangles, or NULL to use the entire
+ *                  texture for every copy.
+ *  \param dstrects An array of destination rectangles.
+ *  \param count The number of copies.
+ *
+ *  \return 0 on success, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RenderCopiesF(SDL_Renderer * renderer,
+                                              SDL_Texture * texture,
+                                              const SDL_Rect * srcrects,
+                                              const SDL_FRect * dstrects,
+                                              int count);
+
 /**
  *  \brief Copy a portion of the source texture to the current rendering target, rotating it by angle around the given center
  *
@@ -1037,6 +1092,31 @@ extern DECLSPEC int SDLCALL SDL_RenderCopyExF(SDL_Renderer * renderer,
                                             const SDL_FPoint *center,
                                             const SDL_RendererFlip flip);
 
+/**
+ *  \brief Render a list of triangles, optionally using a texture and indices into the vertex array
+ *
+ *  The whole list is queued as a single render command, so large batches of
+ *  sprites or particles can be drawn with one call. Vertex colors modulate
+ *  the texture, and the texture color and alpha modulation are applied on
+ *  top of that. The texture blend mode is used when a texture is given,
+ *  otherwise the renderer draw blend mode.
+ *
+ *  \param renderer The renderer which should draw the triangles.
+ *  \param texture  The texture to use, or NULL for solid colored triangles.
+ *  \param vertices The vertices.
+ *  \param num_vertices The number of vertices.
+ *  \param indices  An array of vertex indices, three per triangle, or NULL
+ *                  to draw the vertices in order.
+ *  \param num_indices The number of indices.
+ *
+ *  \return 0 on success, or -1 if the operation is not supported or
+ *          the parameters are invalid.
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGeometry(SDL_Renderer *renderer,
+                                               SDL_Texture *texture,
+                                               const SDL_Vertex *vertices, int num_vertices,
+                                               const int *indices, int num_indices);
+
 /**
  *  \brief Read pixels from the current rendering target.
  *
@@ -1103,6 +1183,22 @@ extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer * renderer);
  */
 extern DECLSPEC int SDLCALL SDL_RenderFlush(SDL_Renderer * renderer);
 
+/**
+ *  \brief Get the render queue counters of the last presented frame.
+ *
+ *  The counters cover everything between two calls to SDL_RenderPresent().
+ *  They are only collected when SDL_HINT_RENDER_STATS was enabled at the
+ *  time the renderer was created.
+ *
+ *  \param renderer The renderer to query.
+ *  \param stats A pointer filled in with the counters.
+ *
+ *  \return 0 on success, or -1 if statistics are disabled for this renderer.
+ *
+ *  \sa SDL_HINT_RENDER_STATS
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * stats);
+
 
 /**
  *  \brief Bind the texture to the current OpenGL/ES/ES2 context for use with
@@ -510,6 +510,22 @@ extern DECLSPEC int SDLCALL SDL_SoftStretch(SDL_Surface * src,
                                             SDL_Surface * dst,
                                             const SDL_Rect * dstrect);
 
+/**
+ *  \brief Perform a bilinear filtered stretch blit between two surfaces of the
+ *         same pixel format.
+ *
+ *  The surfaces must use a 32-bit format with 8-bit channels, such as
+ *  SDL_PIXELFORMAT_ARGB8888 or SDL_PIXELFORMAT_ABGR8888.
+ *
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_SoftStretch
+ */
+extern DECLSPEC int SDLCALL SDL_SoftStretchLinear(SDL_Surface * src,
+                                                  const SDL_Rect * srcrect,
+                                                  SDL_Surface * dst,
+                                                  const SDL_Rect * dstrect);
+
 #define SDL_BlitScaled SDL_UpperBlitScaled
 
 /**
@@ -331,6 +331,99 @@ extern DECLSPEC void * SDLCALL SDL_TLSGet(SDL_TLSID id);
  */
 extern DECLSPEC int SDLCALL SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void*));
 
+/**
+ *  \name Task pool
+ *
+ *  SDL keeps a pool of worker threads, one less than the number of CPUs, to
+ *  run short tasks in parallel. The pool is started the first time it's used
+ *  and stopped by SDL_Quit().
+ *
+ *  Each worker has its own queue of tasks, and idle workers steal tasks from
+ *  the others. A thread waiting for tasks to finish runs queued tasks itself
+ *  in the meantime, so tasks may add more tasks and wait for them.
+ *
+ *  If the pool can't be started, for example when SDL is built without
+ *  thread support, tasks run right away on the thread that adds them.
+ */
+/* @{ */
+
+/**
+ *  A group of tasks that can be waited for together.
+ */
+typedef struct SDL_TaskGroup SDL_TaskGroup;
+
+/**
+ *  The function prototype for tasks added with SDL_RunTask().
+ */
+typedef void (SDLCALL * SDL_TaskFunction) (void *data);
+
+/**
+ *  The function prototype for SDL_ParallelFor(), called for the indices
+ *  from \c start up to but not including \c end.
+ */
+typedef void (SDLCALL * SDL_ParallelForFunction) (void *data, int start, int end);
+
+/**
+ *  \brief Get the number of worker threads in the task pool.
+ *
+ *  This starts the task pool if it isn't running yet. Tasks still run if
+ *  this is 0, in the thread that waits for them.
+ */
+extern DECLSPEC int SDLCALL SDL_GetTaskPoolThreadCount(void);
+
+/**
+ *  \brief Create a group to add tasks to.
+ *
+ *  \return The new task group, or NULL on error.
+ *
+ *  \sa SDL_RunTask()
+ *  \sa SDL_WaitTaskGroup()
+ *  \sa SDL_DestroyTaskGroup()
+ */
+extern DECLSPEC SDL_TaskGroup * SDLCALL SDL_CreateTaskGroup(void);
+
+/**
+ *  \brief Queue a task in the task pool.
+ *
+ *  \param group The group the task belongs to
+ *  \param fn The function to run
+ *  \param data A pointer passed to \c fn
+ *
+ *  \return 0 on success, -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RunTask(SDL_TaskGroup *group, SDL_TaskFunction fn, void *data);
+
+/**
+ *  \brief Wait for all tasks of a group to finish, running queued tasks meanwhile.
+ */
+extern DECLSPEC void SDLCALL SDL_WaitTaskGroup(SDL_TaskGroup *group);
+
+/**
+ *  \brief Wait for all tasks of a group to finish and free the group.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyTaskGroup(SDL_TaskGroup *group);
+
+/**
+ *  \brief Call a function for a range of indices in parallel, and wait for it.
+ *
+ *  The range is split in halves until the pieces are smaller than twice
+ *  \c grain, and the pieces are spread over the task pool. The grain is
+ *  raised if needed to keep the number of pieces to a small multiple of the
+ *  number of threads.
+ *
+ *  \param start The first index
+ *  \param end One past the last index
+ *  \param grain The smallest number of indices worth running as a task, or 0
+ *  \param fn The function called for each chunk
+ *  \param data A pointer passed to \c fn
+ *
+ *  \return 0 on success, -1 on error. Nothing has been called on error.
+ */
+extern DECLSPEC int SDLCALL SDL_ParallelFor(int start, int end, int grain,
+                                            SDL_ParallelForFunction fn, void *data);
+
+/* @} *//* Task pool */
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
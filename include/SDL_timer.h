@@ -55,6 +55,14 @@ extern DECLSPEC Uint32 SDLCALL SDL_GetTicks(void);
  */
 #define SDL_TICKS_PASSED(A, B)  ((Sint32)((B) - (A)) <= 0)
 
+/**
+ * \brief Get the number of nanoseconds since the SDL library initialization.
+ *
+ * \note The resolution depends on the platform, and may be as coarse as
+ *       a microsecond. Unlike SDL_GetTicks(), this value does not wrap.
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetTicksNS(void);
+
 /**
  * \brief Get the current value of the high resolution counter
  */
@@ -70,6 +78,14 @@ extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceFrequency(void);
  */
 extern DECLSPEC void SDLCALL SDL_Delay(Uint32 ms);
 
+/**
+ * \brief Wait a specified number of nanoseconds before returning.
+ *
+ * This sleeps as precisely as the platform allows, and may busy-wait for
+ * the last part of the delay on platforms without precise sleeps.
+ */
+extern DECLSPEC void SDLCALL SDL_DelayNS(Uint64 ns);
+
 /**
  *  Function prototype for the timer callback function.
  *
@@ -80,6 +96,13 @@ extern DECLSPEC void SDLCALL SDL_Delay(Uint32 ms);
  */
 typedef Uint32 (SDLCALL * SDL_TimerCallback) (Uint32 interval, void *param);
 
+/**
+ *  Function prototype for the nanosecond timer callback function.
+ *
+ *  This works like SDL_TimerCallback, with the interval in nanoseconds.
+ */
+typedef Uint64 (SDLCALL * SDL_NSTimerCallback) (Uint64 interval, void *param);
+
 /**
  * Definition of the timer ID type.
  */
@@ -94,6 +117,20 @@ extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimer(Uint32 interval,
                                                  SDL_TimerCallback callback,
                                                  void *param);
 
+/**
+ * \brief Add a new timer with an interval in nanoseconds.
+ *
+ * Periodic timers added this way are kept to their original schedule, so
+ * a late callback doesn't delay the ones after it.
+ *
+ * \return A timer ID, or 0 when an error occurs.
+ *
+ * \sa SDL_RemoveTimer()
+ */
+extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimerNS(Uint64 interval,
+                                                   SDL_NSTimerCallback callback,
+                                                   void *param);
+
 /**
  * \brief Remove a timer knowing its ID.
  *
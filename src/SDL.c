@@ -42,6 +42,7 @@
 #include "haptic/SDL_haptic_c.h"
 #include "joystick/SDL_joystick_c.h"
 #include "sensor/SDL_sensor_c.h"
+#include "thread/SDL_taskpool_c.h"
 
 #if SDL_THREAD_AMIGAOS4
 #include "thread/amigaos4/SDL_systhread_c.h"
@@ -425,6 +426,8 @@ SDL_Quit(void)
 #endif
     SDL_QuitSubSystem(SDL_INIT_EVERYTHING);
 
+    SDL_QuitTaskPool();
+
 #if !SDL_TIMERS_DISABLED
     SDL_TicksQuit();
 #endif
@@ -39,6 +39,18 @@ struct SDL_DataQueue
     SDL_DataQueuePacket *pool; /* these are unused packets. */
     size_t packet_size;   /* size of new packets */
     size_t queued_bytes;  /* number of bytes of data in the queue. */
+
+    /* Lock-free queues put data in a ring buffer first. The indices count
+       bytes ever written and read, and only wrap at 2^32, so the ring holds
+       (ring_tail - ring_head) bytes. Writes that don't fit in the ring go to
+       the packet list above, under (lock), and once anything is there all
+       writes go there until the reader has drained it, to keep the order. */
+    Uint8 *ring;
+    Uint32 ring_size;      /* a power of two. */
+    SDL_atomic_t ring_head;  /* only the reader changes this. */
+    SDL_atomic_t ring_tail;  /* only the writer changes this. */
+    SDL_atomic_t overflowing;  /* nonzero if the packet list has data. */
+    SDL_mutex *lock;
 };
 
 static void
@@ -84,12 +96,44 @@ SDL_NewDataQueue(const size_t _packetlen, const size_t initialslack)
     return queue;
 }
 
+SDL_DataQueue *
+SDL_NewLockFreeDataQueue(const size_t packetlen, const size_t capacity)
+{
+    SDL_DataQueue *queue = SDL_NewDataQueue(packetlen, 0);
+    Uint32 ring_size = 1024;
+
+    if (!queue) {
+        return NULL;
+    }
+
+    while ((ring_size < capacity) && (ring_size < 0x40000000)) {
+        ring_size *= 2;
+    }
+
+    queue->ring = (Uint8 *) SDL_malloc(ring_size);
+    queue->ring_size = ring_size;
+    queue->lock = SDL_CreateMutex();
+    if (!queue->ring || !queue->lock) {
+        if (!queue->ring) {
+            SDL_OutOfMemory();
+        }
+        SDL_FreeDataQueue(queue);
+        return NULL;
+    }
+
+    return queue;
+}
+
 void
 SDL_FreeDataQueue(SDL_DataQueue *queue)
 {
     if (queue) {
         SDL_FreeDataQueueList(queue->head);
         SDL_FreeDataQueueList(queue->pool);
+        SDL_free(queue->ring);
+        if (queue->lock) {
+            SDL_DestroyMutex(queue->lock);
+        }
         SDL_free(queue);
     }
 }
@@ -107,6 +151,12 @@ SDL_ClearDataQueue(SDL_DataQueue *queue, const size_t slack)
         return;
     }
 
+    if (queue->ring) {
+        /* nothing else may touch the queue during this, so no tricks. */
+        SDL_AtomicSet(&queue->ring_head, SDL_AtomicGet(&queue->ring_tail));
+        SDL_AtomicSet(&queue->overflowing, 0);
+    }
+
     packet = queue->head;
 
     /* merge the available pool and the current queue into one list. */
@@ -171,8 +221,8 @@ AllocateDataQueuePacket(SDL_DataQueue *queue)
 }
 
 
-int
-SDL_WriteToDataQueue(SDL_DataQueue *queue, const void *_data, const size_t _len)
+static int
+WriteToDataQueueList(SDL_DataQueue *queue, const void *_data, const size_t _len)
 {
     size_t len = _len;
     const Uint8 *data = (const Uint8 *) _data;
@@ -225,8 +275,8 @@ SDL_WriteToDataQueue(SDL_DataQueue *queue, const void *_data, const size_t _len)
     return 0;
 }
 
-size_t
-SDL_PeekIntoDataQueue(SDL_DataQueue *queue, void *_buf, const size_t _len)
+static size_t
+PeekIntoDataQueueList(SDL_DataQueue *queue, void *_buf, const size_t _len)
 {
     size_t len = _len;
     Uint8 *buf = (Uint8 *) _buf;
@@ -250,8 +300,8 @@ SDL_PeekIntoDataQueue(SDL_DataQueue *queue, void *_buf, const size_t _len)
     return (size_t) (ptr - buf);
 }
 
-size_t
-SDL_ReadFromDataQueue(SDL_DataQueue *queue, void *_buf, const size_t _len)
+static size_t
+ReadFromDataQueueList(SDL_DataQueue *queue, void *_buf, const size_t _len)
 {
     size_t len = _len;
     Uint8 *buf = (Uint8 *) _buf;
@@ -290,10 +340,147 @@ SDL_ReadFromDataQueue(SDL_DataQueue *queue, void *_buf, const size_t _len)
     return (size_t) (ptr - buf);
 }
 
+/* Copy (len) bytes into or out of the ring, starting at byte (pos) of the
+   stream, in up to two pieces if it wraps around the end. */
+static void
+CopyToRing(SDL_DataQueue *queue, const Uint32 pos, const Uint8 *data, const Uint32 len)
+{
+    const Uint32 offset = pos & (queue->ring_size - 1);
+    const Uint32 first = SDL_min(len, queue->ring_size - offset);
+    SDL_memcpy(queue->ring + offset, data, first);
+    SDL_memcpy(queue->ring, data + first, len - first);
+}
+
+static void
+CopyFromRing(SDL_DataQueue *queue, const Uint32 pos, Uint8 *buf, const Uint32 len)
+{
+    const Uint32 offset = pos & (queue->ring_size - 1);
+    const Uint32 first = SDL_min(len, queue->ring_size - offset);
+    SDL_memcpy(buf, queue->ring + offset, first);
+    SDL_memcpy(buf + first, queue->ring, len - first);
+}
+
+int
+SDL_WriteToDataQueue(SDL_DataQueue *queue, const void *_data, const size_t _len)
+{
+    const Uint8 *data = (const Uint8 *) _data;
+    size_t len = _len;
+    int retval = 0;
+
+    if (!queue) {
+        return SDL_InvalidParamError("queue");
+    } else if (!queue->ring) {
+        return WriteToDataQueueList(queue, data, len);
+    }
+
+    if (!SDL_AtomicGet(&queue->overflowing)) {
+        const Uint32 tail = (Uint32) SDL_AtomicGet(&queue->ring_tail);
+        const Uint32 used = tail - (Uint32) SDL_AtomicGet(&queue->ring_head);
+        const Uint32 cpy = (Uint32) SDL_min(len, (size_t) (queue->ring_size - used));
+        CopyToRing(queue, tail, data, cpy);
+        SDL_MemoryBarrierRelease();  /* the data has to land before the reader can see it. */
+        SDL_AtomicSet(&queue->ring_tail, (int) (tail + cpy));
+        data += cpy;
+        len -= cpy;
+    }
+
+    if (len > 0) {  /* the rest waits in the packet list. */
+        SDL_LockMutex(queue->lock);
+        retval = WriteToDataQueueList(queue, data, len);
+        SDL_AtomicSet(&queue->overflowing, queue->head ? 1 : 0);
+        SDL_UnlockMutex(queue->lock);
+    }
+
+    return retval;
+}
+
+/* Copy up to (len) bytes out of the ring, and take them out of it if (consume). */
+static size_t
+ReadFromRing(SDL_DataQueue *queue, Uint8 *buf, const size_t len, const SDL_bool consume)
+{
+    const Uint32 head = (Uint32) SDL_AtomicGet(&queue->ring_head);
+    const Uint32 used = ((Uint32) SDL_AtomicGet(&queue->ring_tail)) - head;
+    const Uint32 cpy = (Uint32) SDL_min(len, (size_t) used);
+
+    SDL_MemoryBarrierAcquire();
+    CopyFromRing(queue, head, buf, cpy);
+    if (consume) {
+        SDL_MemoryBarrierRelease();  /* finish reading before the writer can reuse the space. */
+        SDL_AtomicSet(&queue->ring_head, (int) (head + cpy));
+    }
+    return cpy;
+}
+
+size_t
+SDL_PeekIntoDataQueue(SDL_DataQueue *queue, void *_buf, const size_t _len)
+{
+    Uint8 *buf = (Uint8 *) _buf;
+    const size_t len = _len;
+    size_t retval;
+
+    if (!queue) {
+        return 0;
+    } else if (!queue->ring) {
+        return PeekIntoDataQueueList(queue, buf, len);
+    } else if (!SDL_AtomicGet(&queue->overflowing)) {
+        return ReadFromRing(queue, buf, len, SDL_FALSE);
+    }
+
+    /* the writer leaves the ring alone while the packet list has data. */
+    SDL_LockMutex(queue->lock);
+    retval = ReadFromRing(queue, buf, len, SDL_FALSE);
+    retval += PeekIntoDataQueueList(queue, buf + retval, len - retval);
+    SDL_UnlockMutex(queue->lock);
+    return retval;
+}
+
+size_t
+SDL_ReadFromDataQueue(SDL_DataQueue *queue, void *_buf, const size_t _len)
+{
+    Uint8 *buf = (Uint8 *) _buf;
+    const size_t len = _len;
+    size_t retval;
+
+    if (!queue) {
+        return 0;
+    } else if (!queue->ring) {
+        return ReadFromDataQueueList(queue, buf, len);
+    }
+
+    retval = ReadFromRing(queue, buf, len, SDL_TRUE);
+
+    if ((retval < len) && SDL_AtomicGet(&queue->overflowing)) {
+        /* The writer may have filled the ring again before it started
+           spilling, and that data is older than the packet list's. It
+           leaves the ring alone from then until the list is drained. */
+        SDL_LockMutex(queue->lock);
+        retval += ReadFromRing(queue, buf + retval, len - retval, SDL_TRUE);
+        retval += ReadFromDataQueueList(queue, buf + retval, len - retval);
+        SDL_AtomicSet(&queue->overflowing, queue->head ? 1 : 0);
+        SDL_UnlockMutex(queue->lock);
+    }
+
+    return retval;
+}
+
 size_t
 SDL_CountDataQueue(SDL_DataQueue *queue)
 {
-    return queue ? queue->queued_bytes : 0;
+    size_t retval;
+
+    if (!queue) {
+        return 0;
+    } else if (!queue->ring) {
+        return queue->queued_bytes;
+    }
+
+    retval = (size_t) (((Uint32) SDL_AtomicGet(&queue->ring_tail)) - ((Uint32) SDL_AtomicGet(&queue->ring_head)));
+    if (SDL_AtomicGet(&queue->overflowing)) {
+        SDL_LockMutex(queue->lock);
+        retval += queue->queued_bytes;
+        SDL_UnlockMutex(queue->lock);
+    }
+    return retval;
 }
 
 void *
@@ -310,6 +497,9 @@ SDL_ReserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len)
     } else if (len > queue->packet_size) {
         SDL_SetError("len is larger than packet size");
         return NULL;
+    } else if (queue->ring) {
+        SDL_SetError("Can't reserve space in a lock-free data queue");
+        return NULL;
     }
 
     packet = queue->head;
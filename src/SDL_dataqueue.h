@@ -27,6 +27,15 @@ struct SDL_DataQueue;
 typedef struct SDL_DataQueue SDL_DataQueue;
 
 SDL_DataQueue *SDL_NewDataQueue(const size_t packetlen, const size_t initialslack);
+
+/* A queue that one thread can write to while another reads from it, without
+   locking. Up to (capacity) bytes (rounded up to a power of two) go in a
+   preallocated ring buffer; past that, writes spill into packets of
+   (packetlen) bytes, and only the spilled data is protected by a mutex.
+   Everything besides writing, reading, peeking and counting still expects
+   that you managed thread safety elsewhere, and reserving space isn't
+   supported. */
+SDL_DataQueue *SDL_NewLockFreeDataQueue(const size_t packetlen, const size_t capacity);
 void SDL_FreeDataQueue(SDL_DataQueue *queue);
 void SDL_ClearDataQueue(SDL_DataQueue *queue, const size_t slack);
 int SDL_WriteToDataQueue(SDL_DataQueue *queue, const void *data, const size_t len);
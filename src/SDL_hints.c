@@ -22,15 +22,29 @@
 
 #include "SDL_hints.h"
 #include "SDL_error.h"
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
 #include "SDL_hints_c.h"
 
 
 /* Assuming there aren't many hints set and they aren't being queried in
    critical performance paths, we'll just use linked lists here.
+
+   Hints are looked up from many threads and rarely changed, so the list is
+   protected by a reader-writer lock. Callbacks are called without holding
+   it, since they often look at other hints and take other locks.
+
+   Instead, calling the callbacks is serialized by a separate recursive
+   mutex, so they see the changes in order. A callback being removed while
+   it runs on another thread is only freed once it returns, and the removal
+   waits for that, so it's never called after SDL_DelHintCallback().
  */
 typedef struct SDL_HintWatch {
     SDL_HintCallback callback;
     void *userdata;
+    int delivering;     /* Number of callback calls holding on to this */
+    SDL_bool running;
+    SDL_bool removed;
     struct SDL_HintWatch *next;
 } SDL_HintWatch;
 
@@ -43,6 +57,95 @@ typedef struct SDL_Hint {
 } SDL_Hint;
 
 static SDL_Hint *SDL_hints;
+static SDL_rwlock *SDL_hints_lock;
+static SDL_mutex *SDL_hint_callbacks_lock;
+
+static void
+SDL_CreateHintLocks(void)
+{
+#if !SDL_THREADS_DISABLED
+    /* Hints can be used before SDL_Init(), so create the locks on first use */
+    if (!SDL_hints_lock) {
+        static SDL_SpinLock create_lock;
+        SDL_AtomicLock(&create_lock);
+        if (!SDL_hints_lock) {
+            SDL_mutex *mutex = SDL_CreateMutex();
+            SDL_rwlock *rwlock = SDL_CreateRWLock();
+            SDL_hint_callbacks_lock = mutex;
+            SDL_MemoryBarrierRelease();
+            SDL_hints_lock = rwlock;
+        }
+        SDL_AtomicUnlock(&create_lock);
+    }
+    SDL_MemoryBarrierAcquire();
+#endif /* !SDL_THREADS_DISABLED */
+}
+
+static void
+SDL_LockHintCallbacks(void)
+{
+    SDL_CreateHintLocks();
+    if (SDL_hint_callbacks_lock) {
+        SDL_LockMutex(SDL_hint_callbacks_lock);
+    }
+}
+
+static void
+SDL_UnlockHintCallbacks(void)
+{
+    if (SDL_hint_callbacks_lock) {
+        SDL_UnlockMutex(SDL_hint_callbacks_lock);
+    }
+}
+
+static void
+SDL_LockHints(SDL_bool writing)
+{
+#if !SDL_THREADS_DISABLED
+    SDL_CreateHintLocks();
+
+    if (SDL_hints_lock) {
+        if (writing) {
+            SDL_LockRWLockForWriting(SDL_hints_lock);
+        } else {
+            SDL_LockRWLockForReading(SDL_hints_lock);
+        }
+    }
+#endif /* !SDL_THREADS_DISABLED */
+}
+
+static void
+SDL_UnlockHints(void)
+{
+    if (SDL_hints_lock) {
+        SDL_UnlockRWLock(SDL_hints_lock);
+    }
+}
+
+/* Calls a callback copied from the list, unless it was removed meanwhile.
+   Called with the callbacks lock held and the hints unlocked. */
+static void
+SDL_CallHintCallback(SDL_HintWatch *entry, const char *name,
+                     const char *old_value, const char *value)
+{
+    SDL_bool removed;
+
+    SDL_LockHints(SDL_TRUE);
+    removed = entry->removed;
+    entry->running = !removed;
+    SDL_UnlockHints();
+
+    if (!removed) {
+        entry->callback(entry->userdata, name, old_value, value);
+    }
+
+    SDL_LockHints(SDL_TRUE);
+    entry->running = SDL_FALSE;
+    if (--entry->delivering == 0 && entry->removed) {
+        SDL_free(entry);
+    }
+    SDL_UnlockHints();
+}
 
 SDL_bool
 SDL_SetHintWithPriority(const char *name, const char *value,
@@ -61,22 +164,52 @@ SDL_SetHintWithPriority(const char *name, const char *value,
         return SDL_FALSE;
     }
 
+    SDL_LockHintCallbacks();
+    SDL_LockHints(SDL_TRUE);
     for (hint = SDL_hints; hint; hint = hint->next) {
         if (SDL_strcmp(name, hint->name) == 0) {
             if (priority < hint->priority) {
+                SDL_UnlockHints();
+                SDL_UnlockHintCallbacks();
                 return SDL_FALSE;
             }
+            hint->priority = priority;
             if (!hint->value || !value || SDL_strcmp(hint->value, value) != 0) {
-                for (entry = hint->callbacks; entry; ) {
-                    /* Save the next entry in case this one is deleted */
-                    SDL_HintWatch *next = entry->next;
-                    entry->callback(entry->userdata, name, hint->value, value);
-                    entry = next;
-                }
-                SDL_free(hint->value);
+                char *old_value = hint->value;
+                SDL_HintWatch **callbacks = NULL;
+                int i, count = 0;
+
                 hint->value = value ? SDL_strdup(value) : NULL;
+
+                /* Copy the callbacks, so they can be called after unlocking,
+                   and can delete themselves */
+                for (entry = hint->callbacks; entry; entry = entry->next) {
+                    ++count;
+                }
+                if (count > 0) {
+                    callbacks = SDL_stack_alloc(SDL_HintWatch *, count);
+                    if (!callbacks) {
+                        count = 0;
+                    }
+                }
+                for (i = 0, entry = hint->callbacks; i < count; ++i, entry = entry->next) {
+                    callbacks[i] = entry;
+                    ++entry->delivering;
+                }
+                SDL_UnlockHints();
+
+                for (i = 0; i < count; ++i) {
+                    SDL_CallHintCallback(callbacks[i], name, old_value, value);
+                }
+                if (callbacks) {
+                    SDL_stack_free(callbacks);
+                }
+                SDL_UnlockHintCallbacks();
+                SDL_free(old_value);
+                return SDL_TRUE;
             }
-            hint->priority = priority;
+            SDL_UnlockHints();
+            SDL_UnlockHintCallbacks();
             return SDL_TRUE;
         }
     }
@@ -84,6 +217,8 @@ SDL_SetHintWithPriority(const char *name, const char *value,
     /* Couldn't find the hint, add a new one */
     hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
     if (!hint) {
+        SDL_UnlockHints();
+        SDL_UnlockHintCallbacks();
         return SDL_FALSE;
     }
     hint->name = SDL_strdup(name);
@@ -92,6 +227,8 @@ SDL_SetHintWithPriority(const char *name, const char *value,
     hint->callbacks = NULL;
     hint->next = SDL_hints;
     SDL_hints = hint;
+    SDL_UnlockHints();
+    SDL_UnlockHintCallbacks();
     return SDL_TRUE;
 }
 
@@ -105,18 +242,22 @@ const char *
 SDL_GetHint(const char *name)
 {
     const char *env;
+    const char *value;
     SDL_Hint *hint;
 
     env = SDL_getenv(name);
+    value = env;
+    SDL_LockHints(SDL_FALSE);
     for (hint = SDL_hints; hint; hint = hint->next) {
         if (SDL_strcmp(name, hint->name) == 0) {
             if (!env || hint->priority == SDL_HINT_OVERRIDE) {
-                return hint->value;
+                value = hint->value;
             }
             break;
         }
     }
-    return env;
+    SDL_UnlockHints();
+    return value;
 }
 
 SDL_bool
@@ -163,7 +304,11 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     }
     entry->callback = callback;
     entry->userdata = userdata;
+    entry->delivering = 0;
+    entry->running = SDL_FALSE;
+    entry->removed = SDL_FALSE;
 
+    SDL_LockHints(SDL_TRUE);
     for (hint = SDL_hints; hint; hint = hint->next) {
         if (SDL_strcmp(name, hint->name) == 0) {
             break;
@@ -173,6 +318,7 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
         /* Need to add a hint entry for this watcher */
         hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
         if (!hint) {
+            SDL_UnlockHints();
             SDL_OutOfMemory();
             SDL_free(entry);
             return;
@@ -188,6 +334,7 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     /* Add it to the callbacks for this hint */
     entry->next = hint->callbacks;
     hint->callbacks = entry;
+    SDL_UnlockHints();
 
     /* Now call it with the current value */
     value = SDL_GetHint(name);
@@ -199,7 +346,9 @@ SDL_DelHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
 {
     SDL_Hint *hint;
     SDL_HintWatch *entry, *prev;
+    SDL_bool running = SDL_FALSE;
 
+    SDL_LockHints(SDL_TRUE);
     for (hint = SDL_hints; hint; hint = hint->next) {
         if (SDL_strcmp(name, hint->name) == 0) {
             prev = NULL;
@@ -210,14 +359,28 @@ SDL_DelHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
                     } else {
                         hint->callbacks = entry->next;
                     }
-                    SDL_free(entry);
+                    running = entry->running;
+                    if (entry->delivering > 0) {
+                        /* The thread calling it frees it */
+                        entry->removed = SDL_TRUE;
+                    } else {
+                        SDL_free(entry);
+                    }
                     break;
                 }
                 prev = entry;
             }
-            return;
+            break;
         }
     }
+    SDL_UnlockHints();
+
+    /* If it's running on another thread, wait for it to return. If it's
+       running on this one, the lock is recursive and we don't wait. */
+    if (running) {
+        SDL_LockHintCallbacks();
+        SDL_UnlockHintCallbacks();
+    }
 }
 
 void SDL_ClearHints(void)
@@ -225,6 +388,8 @@ void SDL_ClearHints(void)
     SDL_Hint *hint;
     SDL_HintWatch *entry;
 
+    SDL_LockHintCallbacks();
+    SDL_LockHints(SDL_TRUE);
     while (SDL_hints) {
         hint = SDL_hints;
         SDL_hints = hint->next;
@@ -238,6 +403,8 @@ void SDL_ClearHints(void)
         }
         SDL_free(hint);
     }
+    SDL_UnlockHints();
+    SDL_UnlockHintCallbacks();
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -576,7 +576,6 @@ SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
     len -= (int) dequeued;
 
     if (len > 0) {  /* fill any remaining space in the stream with silence. */
-        SDL_assert(SDL_CountDataQueue(device->buffer_queue) == 0);
         SDL_memset(stream, device->spec.silence, len);
     }
 }
@@ -612,9 +611,8 @@ SDL_QueueAudio(SDL_AudioDeviceID devid, const void *data, Uint32 len)
     }
 
     if (len > 0) {
-        current_audio.impl.LockDevice(device);
+        /* the queue is safe for us to write while the audio thread reads it. */
         rc = SDL_WriteToDataQueue(device->buffer_queue, data, len);
-        current_audio.impl.UnlockDevice(device);
     }
 
     return rc;
@@ -633,9 +631,8 @@ SDL_DequeueAudio(SDL_AudioDeviceID devid, void *data, Uint32 len)
         return 0;  /* just report zero bytes dequeued. */
     }
 
-    current_audio.impl.LockDevice(device);
+    /* the queue is safe for us to read while the audio thread writes it. */
     rc = (Uint32) SDL_ReadFromDataQueue(device->buffer_queue, data, len);
-    current_audio.impl.UnlockDevice(device);
     return rc;
 }
 
@@ -653,9 +650,7 @@ SDL_GetQueuedAudioSize(SDL_AudioDeviceID devid)
     if (device->callbackspec.callback == SDL_BufferQueueDrainCallback ||
         device->callbackspec.callback == SDL_BufferQueueFillCallback)
     {
-        current_audio.impl.LockDevice(device);
         retval = (Uint32) SDL_CountDataQueue(device->buffer_queue);
-        current_audio.impl.UnlockDevice(device);
     }
 
     return retval;
@@ -680,13 +675,57 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
 }
 
 
+/* Have the app's callback (or the voice mixer) fill one callback buffer. */
+static void
+run_audio_callback(SDL_AudioDevice *device, Uint8 *data, const int len)
+{
+    /* !!! FIXME: this should be LockDevice. */
+    SDL_LockMutex(device->mixer_lock);
+    if (SDL_AtomicGet(&device->paused)) {
+        SDL_memset(data, device->spec.silence, len);
+    } else if (device->voices) {
+        SDL_MixAudioVoices(device, data, len);
+    } else {
+        device->callbackspec.callback(device->callbackspec.userdata, data, len);
+    }
+    SDL_UnlockMutex(device->mixer_lock);
+}
+
+/* Fill a device buffer with as many callbacks as it takes, when only the
+   buffer sizes differ. Whole callback buffers are written in place; only a
+   callback that straddles two device buffers goes through work_buffer. */
+static void
+fill_device_buffer(SDL_AudioDevice *device, Uint8 *data)
+{
+    const int chunk = (int) device->callbackspec.size;
+    const int len = (int) device->spec.size;
+    int filled = 0;
+
+    /* start with what's left of the last callback. */
+    if (device->work_buffer_pending) {
+        const int pending = (int) device->work_buffer_pending;
+        filled = SDL_min(pending, len);
+        SDL_memcpy(data, device->work_buffer + (chunk - pending), filled);
+        device->work_buffer_pending -= filled;
+    }
+
+    while ((len - filled) >= chunk) {
+        run_audio_callback(device, data + filled, chunk);
+        filled += chunk;
+    }
+
+    if (filled < len) {
+        run_audio_callback(device, device->work_buffer, chunk);
+        SDL_memcpy(data + filled, device->work_buffer, len - filled);
+        device->work_buffer_pending = chunk - (len - filled);
+    }
+}
+
 /* The general mixing thread function */
 static int SDLCALL
 SDL_RunAudio(void *devicep)
 {
     SDL_AudioDevice *device = (SDL_AudioDevice *) devicep;
-    void *udata = device->callbackspec.userdata;
-    SDL_AudioCallback callback = device->callbackspec.callback;
     int data_len = 0;
     Uint8 *data;
 
@@ -712,8 +751,18 @@ SDL_RunAudio(void *devicep)
         current_audio.impl.BeginLoopIteration(device);
         data_len = device->callbackspec.size;
 
+        if (device->rebuffer && SDL_AtomicGet(&device->enabled)) {
+            data = current_audio.impl.GetDeviceBuf(device);
+            if (data != NULL) {
+                fill_device_buffer(device, data);
+                current_audio.impl.PlayDevice(device);
+                current_audio.impl.WaitDevice(device);
+                continue;
+            }
+        }
+
         /* Fill the current buffer with sound */
-        if (!device->stream && SDL_AtomicGet(&device->enabled)) {
+        if (!device->stream && !device->rebuffer && SDL_AtomicGet(&device->enabled)) {
             SDL_assert(data_len == device->spec.size);
             data = current_audio.impl.GetDeviceBuf(device);
         } else {
@@ -730,14 +779,7 @@ SDL_RunAudio(void *devicep)
             data = device->work_buffer;
         }
 
-        /* !!! FIXME: this should be LockDevice. */
-        SDL_LockMutex(device->mixer_lock);
-        if (SDL_AtomicGet(&device->paused)) {
-            SDL_memset(data, device->spec.silence, data_len);
-        } else {
-            callback(udata, data, data_len);
-        }
-        SDL_UnlockMutex(device->mixer_lock);
+        run_audio_callback(device, data, data_len);
 
         if (device->stream) {
             /* Stream available audio to device, converting/resampling. */
@@ -763,7 +805,7 @@ SDL_RunAudio(void *devicep)
             }
         } else if (data == device->work_buffer) {
             /* nothing to do; pause like we queued a buffer to play. */
-            const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
+            const Uint32 delay = ((device->callbackspec.samples * 1000) / device->callbackspec.freq);
             SDL_Delay(delay);
         } else {  /* writing directly to the device. */
             /* queue this buffer and wait for it to finish playing. */
@@ -1134,6 +1176,15 @@ close_audio_device(SDL_AudioDevice * device)
     SDL_free(device->work_buffer);
     SDL_FreeAudioStream(device->stream);
 
+    while (device->voices) {
+        SDL_AudioVoice *voice = device->voices;
+        device->voices = voice->next;
+        SDL_FreeAudioStream(voice->stream);
+        SDL_free(voice);
+    }
+    SDL_free(device->mix_bus);
+    SDL_free(device->mix_scratch);
+
     if (device->id > 0) {
         SDL_AudioDevice *opendev = open_devices[device->id - 1];
         SDL_assert((opendev == device) || (opendev == NULL));
@@ -1384,8 +1435,12 @@ open_audio_device(const char *devname, int iscapture,
     if (device->spec.samples != obtained->samples) {
         if (allowed_changes & SDL_AUDIO_ALLOW_SAMPLES_CHANGE) {
             obtained->samples = device->spec.samples;
-        } else {
+        } else if (build_stream || iscapture || current_audio.impl.ProvidesOwnCallbackThread) {
             build_stream = SDL_TRUE;
+        } else {
+            /* Only the buffer size differs, so SDL_RunAudio() can have the
+               callback write into the device's buffers without a stream. */
+            device->rebuffer = SDL_TRUE;
         }
     }
 
@@ -1411,8 +1466,12 @@ open_audio_device(const char *devname, int iscapture,
     }
 
     if (device->spec.callback == NULL) {  /* use buffer queueing? */
-        /* pool a few packets to start. Enough for two callbacks. */
-        device->buffer_queue = SDL_NewDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
+        /* The app and the audio thread use the queue at the same time, so it
+           has to be lock-free. Its ring holds a few callbacks' worth; more
+           than that spills into packets, which the audio thread has to lock
+           to read, but only until it catches up. */
+        device->buffer_queue = SDL_NewLockFreeDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN,
+                                   SDL_max(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size) * 4);
         if (!device->buffer_queue) {
             close_audio_device(device);
             SDL_SetError("Couldn't create audio buffer queue");
@@ -1423,7 +1482,7 @@ open_audio_device(const char *devname, int iscapture,
     }
 
     /* Allocate a scratch audio buffer */
-    device->work_buffer_len = build_stream ? device->callbackspec.size : 0;
+    device->work_buffer_len = (build_stream || device->rebuffer) ? device->callbackspec.size : 0;
     if (device->spec.size > device->work_buffer_len) {
         device->work_buffer_len = device->spec.size;
     }
@@ -1577,6 +1636,133 @@ SDL_UnlockAudio(void)
     SDL_UnlockAudioDevice(1);
 }
 
+static int
+prepare_audio_voice_mixer(SDL_AudioDevice *device)
+{
+    const SDL_AudioSpec *spec = &device->callbackspec;
+    const size_t buslen = spec->samples * spec->channels * sizeof (float);
+
+    device->mix_bus = (float *) SDL_malloc(buslen);
+    device->mix_scratch = (float *) SDL_malloc(buslen);
+    if (!device->mix_bus || !device->mix_scratch) {
+        SDL_free(device->mix_bus);
+        SDL_free(device->mix_scratch);
+        device->mix_bus = device->mix_scratch = NULL;
+        return SDL_OutOfMemory();
+    }
+
+    /* float samples are the biggest, so the bus can be converted in place. */
+    if (SDL_BuildAudioCVT(&device->mix_cvt, AUDIO_F32SYS, spec->channels, spec->freq,
+                          spec->format, spec->channels, spec->freq) < 0) {
+        SDL_free(device->mix_bus);
+        SDL_free(device->mix_scratch);
+        device->mix_bus = device->mix_scratch = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+SDL_AudioStream *
+SDL_AddAudioDeviceVoice(SDL_AudioDeviceID devid, const SDL_AudioFormat src_format,
+                        const Uint8 src_channels, const int src_rate)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    SDL_AudioVoice *voice;
+
+    if (!device) {
+        return NULL;
+    } else if (device->iscapture) {
+        SDL_SetError("Voices can only be added to playback devices");
+        return NULL;
+    }
+
+    voice = (SDL_AudioVoice *) SDL_calloc(1, sizeof (SDL_AudioVoice));
+    if (!voice) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    voice->stream = SDL_NewAudioStream(src_format, src_channels, src_rate, AUDIO_F32SYS,
+                                       device->callbackspec.channels, device->callbackspec.freq);
+    if (!voice->stream) {
+        SDL_free(voice);
+        return NULL;
+    }
+    SDL_SetAudioVoiceGains(voice, device->callbackspec.channels, 1.0f, 0.0f);
+
+    current_audio.impl.LockDevice(device);
+    if (!device->mix_bus && (prepare_audio_voice_mixer(device) < 0)) {
+        current_audio.impl.UnlockDevice(device);
+        SDL_FreeAudioStream(voice->stream);
+        SDL_free(voice);
+        return NULL;
+    }
+    voice->next = device->voices;
+    device->voices = voice;
+    current_audio.impl.UnlockDevice(device);
+
+    return voice->stream;
+}
+
+int
+SDL_SetAudioDeviceVoiceGain(SDL_AudioDeviceID devid, SDL_AudioStream *stream, float gain, float pan)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    SDL_AudioVoice *voice;
+
+    if (!device) {
+        return -1;
+    } else if (!stream) {
+        return SDL_InvalidParamError("voice");
+    } else if (!(gain >= 0.0f)) {
+        return SDL_InvalidParamError("gain");
+    } else if (!((pan >= -1.0f) && (pan <= 1.0f))) {
+        return SDL_InvalidParamError("pan");
+    }
+
+    current_audio.impl.LockDevice(device);
+    for (voice = device->voices; voice != NULL; voice = voice->next) {
+        if (voice->stream == stream) {
+            SDL_SetAudioVoiceGains(voice, device->callbackspec.channels, gain, pan);
+            break;
+        }
+    }
+    current_audio.impl.UnlockDevice(device);
+
+    if (!voice) {
+        return SDL_SetError("Not a voice of this audio device");
+    }
+    return 0;
+}
+
+void
+SDL_RemoveAudioDeviceVoice(SDL_AudioDeviceID devid, SDL_AudioStream *stream)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    SDL_AudioVoice **prev;
+    SDL_AudioVoice *voice = NULL;
+
+    if (!device || !stream) {
+        return;
+    }
+
+    current_audio.impl.LockDevice(device);
+    for (prev = &device->voices; *prev != NULL; prev = &(*prev)->next) {
+        if ((*prev)->stream == stream) {
+            voice = *prev;
+            *prev = voice->next;
+            break;
+        }
+    }
+    current_audio.impl.UnlockDevice(device);
+
+    if (voice) {
+        SDL_FreeAudioStream(voice->stream);
+        SDL_free(voice);
+    }
+}
+
 void
 SDL_CloseAudioDevice(SDL_AudioDeviceID devid)
 {
@@ -36,343 +36,495 @@
 
 #define DEBUG_AUDIOSTREAM 0
 
-#ifdef __SSE3__
-#define HAVE_SSE3_INTRINSICS 1
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
 #endif
 
-#if HAVE_SSE3_INTRINSICS
-/* Convert from stereo to mono. Average left and right. */
-static void SDLCALL
-SDL_ConvertStereoToMono_SSE3(SDL_AudioCVT * cvt, SDL_AudioFormat format)
-{
-    float *dst = (float *) cvt->buf;
-    const float *src = dst;
-    int i = cvt->len_cvt / 8;
-
-    LOG_DEBUG_CONVERT("stereo", "mono (using SSE3)");
-    SDL_assert(format == AUDIO_F32SYS);
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
 
-    /* We can only do this if dst is aligned to 16 bytes; since src is the
-       same pointer and it moves by 2, it can't be forcibly aligned. */
-    if ((((size_t) dst) & 15) == 0) {
-        /* Aligned! Do SSE blocks as long as we have 16 bytes available. */
-        const __m128 divby2 = _mm_set1_ps(0.5f);
-        while (i >= 4) {   /* 4 * float32 */
-            _mm_store_ps(dst, _mm_mul_ps(_mm_hadd_ps(_mm_load_ps(src), _mm_load_ps(src+4)), divby2));
-            i -= 4; src += 8; dst += 4;
+/* Channel conversion is a single pass through a mixing matrix: every output
+   channel is a weighted sum of all the input channels. The weights are kept
+   as one column per input channel, padded to eight outputs, so a frame is
+   converted by adding each input sample times its column. */
+#define CHANNEL_MATRIX_SIZE (8 * 8)
+
+/* Convert (frames) frames through (weights), where weights[(i * 8) + o] is how
+   much input channel i adds to output channel o. This works in place: a
+   downmix goes front to back and an upmix back to front, and a frame is read
+   completely before it's written. */
+SDL_FORCE_INLINE void
+ConvertChannels_Scalar(const float *weights, const int src_chans, const int dst_chans, const float *src, float *dst, const int frames)
+{
+    const int step = (dst_chans > src_chans) ? -1 : 1;
+    int frame = (step < 0) ? (frames - 1) : 0;
+    int i, o, n;
+
+    for (n = frames; n; --n, frame += step) {
+        const float *in = src + (frame * src_chans);
+        float *out = dst + (frame * dst_chans);
+        float mixed[8];
+        for (o = 0; o < dst_chans; o++) {
+            mixed[o] = 0.0f;
+        }
+        for (i = 0; i < src_chans; i++) {
+            const float *column = weights + (i * 8);
+            const float sample = in[i];
+            for (o = 0; o < dst_chans; o++) {
+                mixed[o] += sample * column[o];
+            }
+        }
+        for (o = 0; o < dst_chans; o++) {
+            out[o] = mixed[o];
         }
-    }
-
-    /* Finish off any leftovers with scalar operations. */
-    while (i) {
-        *dst = (src[0] + src[1]) * 0.5f;
-        dst++; i--; src += 2;
-    }
-
-    cvt->len_cvt /= 2;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
     }
 }
-#endif
 
-/* Convert from stereo to mono. Average left and right. */
-static void SDLCALL
-SDL_ConvertStereoToMono(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+#if HAVE_SSE_INTRINSICS
+/* The SSE version works on four frames at a time: it transposes them so each
+   register holds one channel of all four frames, runs the matrix on those,
+   and transposes the results back. A block is loaded completely before any
+   of it is stored, so this is as safe in place as the scalar version. */
+SDL_FORCE_INLINE void
+ConvertChannelBlock_SSE(const __m128 *weights, const int src_chans, const int dst_chans, const float *in, float *out)
 {
-    float *dst = (float *) cvt->buf;
-    const float *src = dst;
-    int i;
-
-    LOG_DEBUG_CONVERT("stereo", "mono");
-    SDL_assert(format == AUDIO_F32SYS);
+    __m128 chans[8];
+    __m128 mixed[8];
+    __m128 a, b;
+    int i, o;
+
+    switch (src_chans) {
+        case 1:
+            chans[0] = _mm_loadu_ps(in);
+            break;
+        case 2:
+            a = _mm_loadu_ps(in);
+            b = _mm_loadu_ps(in + 4);
+            chans[0] = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            chans[1] = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            break;
+        default:
+            /* quad, and the first four channels of 5.1 and 7.1. */
+            chans[0] = _mm_loadu_ps(in);
+            chans[1] = _mm_loadu_ps(in + src_chans);
+            chans[2] = _mm_loadu_ps(in + (src_chans * 2));
+            chans[3] = _mm_loadu_ps(in + (src_chans * 3));
+            _MM_TRANSPOSE4_PS(chans[0], chans[1], chans[2], chans[3]);
+            if (src_chans == 6) {
+                a = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) (in + 4)), (const __m64 *) (in + 10));
+                b = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) (in + 16)), (const __m64 *) (in + 22));
+                chans[4] = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                chans[5] = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            } else if (src_chans == 8) {
+                chans[4] = _mm_loadu_ps(in + 4);
+                chans[5] = _mm_loadu_ps(in + 12);
+                chans[6] = _mm_loadu_ps(in + 20);
+                chans[7] = _mm_loadu_ps(in + 28);
+                _MM_TRANSPOSE4_PS(chans[4], chans[5], chans[6], chans[7]);
+            }
+            break;
+    }
 
-    for (i = cvt->len_cvt / 8; i; --i, src += 2) {
-        *(dst++) = (src[0] + src[1]) * 0.5f;
+    for (o = 0; o < dst_chans; o++) {
+        mixed[o] = _mm_mul_ps(chans[0], weights[o]);
+        for (i = 1; i < src_chans; i++) {
+            mixed[o] = _mm_add_ps(mixed[o], _mm_mul_ps(chans[i], weights[(i * 8) + o]));
+        }
     }
 
-    cvt->len_cvt /= 2;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
+    switch (dst_chans) {
+        case 1:
+            _mm_storeu_ps(out, mixed[0]);
+            break;
+        case 2:
+            _mm_storeu_ps(out, _mm_unpacklo_ps(mixed[0], mixed[1]));
+            _mm_storeu_ps(out + 4, _mm_unpackhi_ps(mixed[0], mixed[1]));
+            break;
+        default:
+            _MM_TRANSPOSE4_PS(mixed[0], mixed[1], mixed[2], mixed[3]);
+            if (dst_chans == 4) {
+                _mm_storeu_ps(out, mixed[0]);
+                _mm_storeu_ps(out + 4, mixed[1]);
+                _mm_storeu_ps(out + 8, mixed[2]);
+                _mm_storeu_ps(out + 12, mixed[3]);
+            } else if (dst_chans == 6) {
+                a = _mm_unpacklo_ps(mixed[4], mixed[5]);
+                b = _mm_unpackhi_ps(mixed[4], mixed[5]);
+                _mm_storeu_ps(out, mixed[0]);
+                _mm_storel_pi((__m64 *) (out + 4), a);
+                _mm_storeu_ps(out + 6, mixed[1]);
+                _mm_storeh_pi((__m64 *) (out + 10), a);
+                _mm_storeu_ps(out + 12, mixed[2]);
+                _mm_storel_pi((__m64 *) (out + 16), b);
+                _mm_storeu_ps(out + 18, mixed[3]);
+                _mm_storeh_pi((__m64 *) (out + 22), b);
+            } else {
+                _MM_TRANSPOSE4_PS(mixed[4], mixed[5], mixed[6], mixed[7]);
+                _mm_storeu_ps(out, mixed[0]);
+                _mm_storeu_ps(out + 4, mixed[4]);
+                _mm_storeu_ps(out + 8, mixed[1]);
+                _mm_storeu_ps(out + 12, mixed[5]);
+                _mm_storeu_ps(out + 16, mixed[2]);
+                _mm_storeu_ps(out + 20, mixed[6]);
+                _mm_storeu_ps(out + 24, mixed[3]);
+                _mm_storeu_ps(out + 28, mixed[7]);
+            }
+            break;
     }
 }
 
-
-/* Convert from 5.1 to stereo. Average left and right, distribute center, discard LFE. */
-static void SDLCALL
-SDL_Convert51ToStereo(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+SDL_FORCE_INLINE void
+ConvertChannels_SSE(const float *weights, const int src_chans, const int dst_chans, const float *src, float *dst, const int frames)
 {
-    float *dst = (float *) cvt->buf;
-    const float *src = dst;
-    int i;
-
-    LOG_DEBUG_CONVERT("5.1", "stereo");
-    SDL_assert(format == AUDIO_F32SYS);
-
-    /* SDL's 5.1 layout: FL+FR+FC+LFE+BL+BR */
-    for (i = cvt->len_cvt / (sizeof (float) * 6); i; --i, src += 6, dst += 2) {
-        const float front_center_distributed = src[2] * 0.5f;
-        dst[0] = (src[0] + front_center_distributed + src[4]) / 2.5f;  /* left */
-        dst[1] = (src[1] + front_center_distributed + src[5]) / 2.5f;  /* right */
+    const int blocks = frames / 4;
+    const int tail = frames % 4;
+    __m128 splats[CHANNEL_MATRIX_SIZE];
+    int i, o, n;
+
+    for (i = 0; i < src_chans; i++) {
+        for (o = 0; o < dst_chans; o++) {
+            splats[(i * 8) + o] = _mm_set1_ps(weights[(i * 8) + o]);
+        }
     }
 
-    cvt->len_cvt /= 3;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
+    if (dst_chans > src_chans) {  /* upmixing, go back to front. */
+        ConvertChannels_Scalar(weights, src_chans, dst_chans, src + (blocks * 4 * src_chans), dst + (blocks * 4 * dst_chans), tail);
+        for (n = blocks - 1; n >= 0; n--) {
+            ConvertChannelBlock_SSE(splats, src_chans, dst_chans, src + (n * 4 * src_chans), dst + (n * 4 * dst_chans));
+        }
+    } else {
+        for (n = 0; n < blocks; n++) {
+            ConvertChannelBlock_SSE(splats, src_chans, dst_chans, src + (n * 4 * src_chans), dst + (n * 4 * dst_chans));
+        }
+        ConvertChannels_Scalar(weights, src_chans, dst_chans, src + (blocks * 4 * src_chans), dst + (blocks * 4 * dst_chans), tail);
     }
 }
+#endif
 
+#if HAVE_NEON_INTRINSICS
+SDL_FORCE_INLINE void
+ConvertChannels_NEON(const float *weights, const int src_chans, const int dst_chans, const float *src, float *dst, const int frames)
+{
+    const int step = (dst_chans > src_chans) ? -1 : 1;
+    int frame = (step < 0) ? (frames - 1) : 0;
+    float32x4_t columns[8][2];  /* kept out of memory that (dst) might alias. */
+    int i, n;
+
+    for (i = 0; i < src_chans; i++) {
+        columns[i][0] = vld1q_f32(weights + (i * 8));
+        columns[i][1] = vld1q_f32(weights + (i * 8) + 4);
+    }
+
+    for (n = frames; n; --n, frame += step) {
+        const float *in = src + (frame * src_chans);
+        float *out = dst + (frame * dst_chans);
+        float32x4_t lo = vdupq_n_f32(0.0f);
+        float32x4_t hi = vdupq_n_f32(0.0f);
+        for (i = 0; i < src_chans; i++) {
+            lo = vmlaq_n_f32(lo, columns[i][0], in[i]);
+            if (dst_chans > 4) {
+                hi = vmlaq_n_f32(hi, columns[i][1], in[i]);
+            }
+        }
+        switch (dst_chans) {
+            case 1: vst1q_lane_f32(out, lo, 0); break;
+            case 2: vst1_f32(out, vget_low_f32(lo)); break;
+            case 4: vst1q_f32(out, lo); break;
+            case 6: vst1q_f32(out, lo); vst1_f32(out + 4, vget_low_f32(hi)); break;
+            case 8: vst1q_f32(out, lo); vst1q_f32(out + 4, hi); break;
+            default: SDL_assert(!"unexpected channel count"); break;
+        }
+    }
+}
+#endif
 
-/* Convert from quad to stereo. Average left and right. */
-static void SDLCALL
-SDL_ConvertQuadToStereo(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+SDL_FORCE_INLINE void
+ConvertChannels(const float *weights, const int src_chans, const int dst_chans, const float *src, float *dst, const int frames)
 {
-    float *dst = (float *) cvt->buf;
-    const float *src = dst;
-    int i;
+#if HAVE_SSE_INTRINSICS
+    ConvertChannels_SSE(weights, src_chans, dst_chans, src, dst, frames);
+#elif HAVE_NEON_INTRINSICS
+    ConvertChannels_NEON(weights, src_chans, dst_chans, src, dst, frames);
+#else
+    ConvertChannels_Scalar(weights, src_chans, dst_chans, src, dst, frames);
+#endif
+}
 
-    LOG_DEBUG_CONVERT("quad", "stereo");
-    SDL_assert(format == AUDIO_F32SYS);
+/* The steps SDL has always converted between its channel layouts with, as
+   (dst_chans x src_chans) matrices. The default matrix for any conversion
+   is these steps multiplied together, in the order SDL_BuildChannelMatrix()
+   picks them. SDL's layouts are: mono, stereo (FL+FR), quad (FL+FR+BL+BR),
+   5.1 (FL+FR+FC+LFE+BL+BR) and 7.1 (FL+FR+FC+LFE+BL+BR+SL+SR). */
 
-    for (i = cvt->len_cvt / (sizeof (float) * 4); i; --i, src += 4, dst += 2) {
-        dst[0] = (src[0] + src[2]) * 0.5f; /* left */
-        dst[1] = (src[1] + src[3]) * 0.5f; /* right */
-    }
+/* Upmix mono to stereo (by duplication) */
+static const float ChannelsMonoToStereo[2 * 1] = {
+    1.0f,
+    1.0f
+};
 
-    cvt->len_cvt /= 2;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
-    }
-}
+/* Upmix stereo to a pseudo-5.1 stream: widen the fronts around a derived center. */
+static const float ChannelsStereoTo51[6 * 2] = {
+    1.5f, -0.5f,  /* FL */
+    -0.5f, 1.5f,  /* FR */
+    0.5f, 0.5f,   /* FC */
+    0.0f, 0.0f,   /* LFE (only meant for special LFE effects) */
+    1.0f, 0.0f,   /* BL */
+    0.0f, 1.0f    /* BR */
+};
 
+/* Upmix quad to a pseudo-5.1 stream */
+static const float ChannelsQuadTo51[6 * 4] = {
+    1.5f, -0.5f, 0.0f, 0.0f,  /* FL */
+    -0.5f, 1.5f, 0.0f, 0.0f,  /* FR */
+    0.5f, 0.5f, 0.0f, 0.0f,   /* FC */
+    0.0f, 0.0f, 0.0f, 0.0f,   /* LFE */
+    0.0f, 0.0f, 1.0f, 0.0f,   /* BL */
+    0.0f, 0.0f, 0.0f, 1.0f    /* BR */
+};
 
-/* Convert from 7.1 to 5.1. Distribute sides across front and back. */
-static void SDLCALL
-SDL_Convert71To51(SDL_AudioCVT * cvt, SDL_AudioFormat format)
-{
-    float *dst = (float *) cvt->buf;
-    const float *src = dst;
-    int i;
+/* Upmix 5.1 to 7.1: the sides are the average of front and back, which are
+   widened away from them. */
+static const float Channels51To71[8 * 6] = {
+    1.5f, 0.0f, 0.0f, 0.0f, -0.5f, 0.0f,  /* FL */
+    0.0f, 1.5f, 0.0f, 0.0f, 0.0f, -0.5f,  /* FR */
+    0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,   /* FC */
+    0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,   /* LFE */
+    -0.5f, 0.0f, 0.0f, 0.0f, 1.5f, 0.0f,  /* BL */
+    0.0f, -0.5f, 0.0f, 0.0f, 0.0f, 1.5f,  /* BR */
+    0.5f, 0.0f, 0.0f, 0.0f, 0.5f, 0.0f,   /* SL */
+    0.0f, 0.5f, 0.0f, 0.0f, 0.0f, 0.5f    /* SR */
+};
 
-    LOG_DEBUG_CONVERT("7.1", "5.1");
-    SDL_assert(format == AUDIO_F32SYS);
+/* Upmix stereo to a pseudo-4.0 stream (by duplication) */
+static const float ChannelsStereoToQuad[4 * 2] = {
+    1.0f, 0.0f,  /* FL */
+    0.0f, 1.0f,  /* FR */
+    1.0f, 0.0f,  /* BL */
+    0.0f, 1.0f   /* BR */
+};
 
-    for (i = cvt->len_cvt / (sizeof (float) * 8); i; --i, src += 8, dst += 6) {
-        const float surround_left_distributed = src[6] * 0.5f;
-        const float surround_right_distributed = src[7] * 0.5f;
-        dst[0] = (src[0] + surround_left_distributed) / 1.5f;  /* FL */
-        dst[1] = (src[1] + surround_right_distributed) / 1.5f;  /* FR */
-        dst[2] = src[2] / 1.5f; /* CC */
-        dst[3] = src[3] / 1.5f; /* LFE */
-        dst[4] = (src[4] + surround_left_distributed) / 1.5f;  /* BL */
-        dst[5] = (src[5] + surround_right_distributed) / 1.5f;  /* BR */
-    }
+/* Downmix 7.1 to 5.1: distribute the sides across front and back. */
+static const float Channels71To51[6 * 8] = {
+    1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f / 1.5f, 0.0f,  /* FL */
+    0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f / 1.5f,  /* FR */
+    0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,         /* FC */
+    0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f,         /* LFE */
+    0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.5f / 1.5f, 0.0f,  /* BL */
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.5f / 1.5f   /* BR */
+};
 
-    cvt->len_cvt /= 8;
-    cvt->len_cvt *= 6;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
-    }
-}
+/* Downmix 5.1 to stereo: average left and right, distribute center, discard LFE. */
+static const float Channels51ToStereo[2 * 6] = {
+    1.0f / 2.5f, 0.0f, 0.5f / 2.5f, 0.0f, 1.0f / 2.5f, 0.0f,  /* left */
+    0.0f, 1.0f / 2.5f, 0.5f / 2.5f, 0.0f, 0.0f, 1.0f / 2.5f   /* right */
+};
 
+/* Downmix 5.1 to quad: distribute center across front, discard LFE. */
+static const float Channels51ToQuad[4 * 6] = {
+    1.0f / 1.5f, 0.0f, 0.5f / 1.5f, 0.0f, 0.0f, 0.0f,  /* FL */
+    0.0f, 1.0f / 1.5f, 0.5f / 1.5f, 0.0f, 0.0f, 0.0f,  /* FR */
+    0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f,         /* BL */
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f          /* BR */
+};
 
-/* Convert from 5.1 to quad. Distribute center across front, discard LFE. */
-static void SDLCALL
-SDL_Convert51ToQuad(SDL_AudioCVT * cvt, SDL_AudioFormat format)
-{
-    float *dst = (float *) cvt->buf;
-    const float *src = dst;
-    int i;
+/* Downmix quad to stereo: average front and back. */
+static const float ChannelsQuadToStereo[2 * 4] = {
+    0.5f, 0.0f, 0.5f, 0.0f,  /* left */
+    0.0f, 0.5f, 0.0f, 0.5f   /* right */
+};
 
-    LOG_DEBUG_CONVERT("5.1", "quad");
-    SDL_assert(format == AUDIO_F32SYS);
+/* Downmix stereo to mono: average left and right. */
+static const float ChannelsStereoToMono[1 * 2] = {
+    0.5f, 0.5f
+};
 
-    /* SDL's 4.0 layout: FL+FR+BL+BR */
-    /* SDL's 5.1 layout: FL+FR+FC+LFE+BL+BR */
-    for (i = cvt->len_cvt / (sizeof (float) * 6); i; --i, src += 6, dst += 4) {
-        const float front_center_distributed = src[2] * 0.5f;
-        dst[0] = (src[0] + front_center_distributed) / 1.5f;  /* FL */
-        dst[1] = (src[1] + front_center_distributed) / 1.5f;  /* FR */
-        dst[2] = src[4] / 1.5f;  /* BL */
-        dst[3] = src[5] / 1.5f;  /* BR */
+/* Apply one of the steps above to (weights), which maps (src_chans) channels
+   to (*chans), and update (*chans) to the step's output count. */
+static void
+ApplyChannelStep(float *weights, const int src_chans, int *chans, const float *step, const int step_chans)
+{
+    float product[CHANNEL_MATRIX_SIZE];
+    int i, o, k;
+
+    SDL_zeroa(product);
+    for (i = 0; i < src_chans; i++) {
+        for (o = 0; o < step_chans; o++) {
+            double sum = 0.0;
+            for (k = 0; k < *chans; k++) {
+                sum += ((double) step[(o * (*chans)) + k]) * ((double) weights[(i * 8) + k]);
+            }
+            product[(i * 8) + o] = (float) sum;
+        }
     }
 
-    cvt->len_cvt /= 6;
-    cvt->len_cvt *= 4;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
-    }
+    SDL_memcpy(weights, product, sizeof (product));
+    *chans = step_chans;
 }
 
-
-/* Upmix mono to stereo (by duplication) */
-static void SDLCALL
-SDL_ConvertMonoToStereo(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+/* Build the default matrix from (src_chans) to (dst_chans) channels. */
+static void
+SDL_BuildChannelMatrix(float *weights, const int src_chans, const int dst_chans)
 {
-    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
-    float *dst = (float *) (cvt->buf + cvt->len_cvt * 2);
+    int chans = src_chans;
     int i;
 
-    LOG_DEBUG_CONVERT("mono", "stereo");
-    SDL_assert(format == AUDIO_F32SYS);
-
-    for (i = cvt->len_cvt / sizeof (float); i; --i) {
-        src--;
-        dst -= 2;
-        dst[0] = dst[1] = *src;
+    SDL_memset(weights, '\0', CHANNEL_MATRIX_SIZE * sizeof (float));
+    for (i = 0; i < src_chans; i++) {
+        weights[(i * 8) + i] = 1.0f;
     }
 
-    cvt->len_cvt *= 2;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
+    if (chans < dst_chans) {
+        /* Mono -> Stereo [-> ...] */
+        if (chans == 1) {
+            ApplyChannelStep(weights, src_chans, &chans, ChannelsMonoToStereo, 2);
+        }
+        /* [Mono ->] Stereo -> 5.1 [-> 7.1] */
+        if ((chans == 2) && (dst_chans >= 6)) {
+            ApplyChannelStep(weights, src_chans, &chans, ChannelsStereoTo51, 6);
+        }
+        /* Quad -> 5.1 [-> 7.1] */
+        if ((chans == 4) && (dst_chans >= 6)) {
+            ApplyChannelStep(weights, src_chans, &chans, ChannelsQuadTo51, 6);
+        }
+        /* [[Mono ->] Stereo ->] 5.1 -> 7.1 */
+        if ((chans == 6) && (dst_chans == 8)) {
+            ApplyChannelStep(weights, src_chans, &chans, Channels51To71, 8);
+        }
+        /* [Mono ->] Stereo -> Quad */
+        if ((chans == 2) && (dst_chans == 4)) {
+            ApplyChannelStep(weights, src_chans, &chans, ChannelsStereoToQuad, 4);
+        }
+    } else if (chans > dst_chans) {
+        /* 7.1 -> 5.1 [-> Stereo [-> Mono]] */
+        /* 7.1 -> 5.1 [-> Quad] */
+        if ((chans == 8) && (dst_chans <= 6)) {
+            ApplyChannelStep(weights, src_chans, &chans, Channels71To51, 6);
+        }
+        /* [7.1 ->] 5.1 -> Stereo [-> Mono] */
+        if ((chans == 6) && (dst_chans <= 2)) {
+            ApplyChannelStep(weights, src_chans, &chans, Channels51ToStereo, 2);
+        }
+        /* 5.1 -> Quad */
+        if ((chans == 6) && (dst_chans == 4)) {
+            ApplyChannelStep(weights, src_chans, &chans, Channels51ToQuad, 4);
+        }
+        /* Quad -> Stereo [-> Mono] */
+        if ((chans == 4) && (dst_chans <= 2)) {
+            ApplyChannelStep(weights, src_chans, &chans, ChannelsQuadToStereo, 2);
+        }
+        /* [... ->] Stereo -> Mono */
+        if ((chans == 2) && (dst_chans == 1)) {
+            ApplyChannelStep(weights, src_chans, &chans, ChannelsStereoToMono, 1);
+        }
     }
-}
 
+    /* All combinations of supported channel counts are handled above. */
+    SDL_assert(chans == dst_chans);
+}
 
-/* Upmix stereo to a pseudo-5.1 stream */
-static void SDLCALL
-SDL_ConvertStereoTo51(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+/* Copy an app's (dst_chans x src_chans) matrix into column form. */
+static void
+SDL_SetChannelMatrix(float *weights, const int src_chans, const int dst_chans, const float *matrix)
 {
-    int i;
-    float lf, rf, ce;
-    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
-    float *dst = (float *) (cvt->buf + cvt->len_cvt * 3);
-
-    LOG_DEBUG_CONVERT("stereo", "5.1");
-    SDL_assert(format == AUDIO_F32SYS);
+    int i, o;
 
-    for (i = cvt->len_cvt / (sizeof(float) * 2); i; --i) {
-        dst -= 6;
-        src -= 2;
-        lf = src[0];
-        rf = src[1];
-        ce = (lf + rf) * 0.5f;
-        /* !!! FIXME: FL and FR may clip */
-        dst[0] = lf + (lf - ce);  /* FL */
-        dst[1] = rf + (rf - ce);  /* FR */
-        dst[2] = ce;  /* FC */
-        dst[3] = 0;   /* LFE (only meant for special LFE effects) */
-        dst[4] = lf;  /* BL */
-        dst[5] = rf;  /* BR */
-    }
-
-    cvt->len_cvt *= 3;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
+    SDL_memset(weights, '\0', CHANNEL_MATRIX_SIZE * sizeof (float));
+    for (o = 0; o < dst_chans; o++) {
+        for (i = 0; i < src_chans; i++) {
+            weights[(i * 8) + o] = matrix[(o * src_chans) + i];
+        }
     }
 }
 
+/* The default matrices for SDL_AudioCVT, indexed by SDL_ChannelLayoutIndex().
+   SDL_AudioCVT has no room for a pointer to one, so each pair of channel
+   counts gets its own small filter function that looks up its matrix. */
+static float ChannelMatrices[5][5][CHANNEL_MATRIX_SIZE];
+static SDL_atomic_t ChannelMatricesBuilt;
 
-/* Upmix quad to a pseudo-5.1 stream */
-static void SDLCALL
-SDL_ConvertQuadTo51(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+static int
+SDL_ChannelLayoutIndex(const int channels)
 {
-    int i;
-    float lf, rf, lb, rb, ce;
-    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
-    float *dst = (float *) (cvt->buf + cvt->len_cvt * 3 / 2);
-
-    LOG_DEBUG_CONVERT("quad", "5.1");
-    SDL_assert(format == AUDIO_F32SYS);
-    SDL_assert(cvt->len_cvt % (sizeof(float) * 4) == 0);
-
-    for (i = cvt->len_cvt / (sizeof(float) * 4); i; --i) {
-        dst -= 6;
-        src -= 4;
-        lf = src[0];
-        rf = src[1];
-        lb = src[2];
-        rb = src[3];
-        ce = (lf + rf) * 0.5f;
-        /* !!! FIXME: FL and FR may clip */
-        dst[0] = lf + (lf - ce);  /* FL */
-        dst[1] = rf + (rf - ce);  /* FR */
-        dst[2] = ce;  /* FC */
-        dst[3] = 0;   /* LFE (only meant for special LFE effects) */
-        dst[4] = lb;  /* BL */
-        dst[5] = rb;  /* BR */
-    }
-
-    cvt->len_cvt = cvt->len_cvt * 3 / 2;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
+    switch (channels) {
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        case 6: return 3;
+        case 8: return 4;
+        default: SDL_assert(!"unsupported channel count"); return 0;
     }
 }
 
-
-/* Upmix stereo to a pseudo-4.0 stream (by duplication) */
-static void SDLCALL
-SDL_ConvertStereoToQuad(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+static void
+SDL_PrepareChannelMatrices(void)
 {
-    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
-    float *dst = (float *) (cvt->buf + cvt->len_cvt * 2);
-    float lf, rf;
-    int i;
+    static const int layouts[] = { 1, 2, 4, 6, 8 };
+    static SDL_SpinLock lock;
+    int i, o;
 
-    LOG_DEBUG_CONVERT("stereo", "quad");
-    SDL_assert(format == AUDIO_F32SYS);
-
-    for (i = cvt->len_cvt / (sizeof(float) * 2); i; --i) {
-        dst -= 4;
-        src -= 2;
-        lf = src[0];
-        rf = src[1];
-        dst[0] = lf;  /* FL */
-        dst[1] = rf;  /* FR */
-        dst[2] = lf;  /* BL */
-        dst[3] = rf;  /* BR */
+    if (SDL_AtomicGet(&ChannelMatricesBuilt)) {
+        return;
     }
 
-    cvt->len_cvt *= 2;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
+    /* Streams can be created on several threads at once, only one builds the tables */
+    SDL_AtomicLock(&lock);
+    if (!SDL_AtomicGet(&ChannelMatricesBuilt)) {
+        for (i = 0; i < SDL_arraysize(layouts); i++) {
+            for (o = 0; o < SDL_arraysize(layouts); o++) {
+                SDL_BuildChannelMatrix(ChannelMatrices[i][o], layouts[i], layouts[o]);
+            }
+        }
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSet(&ChannelMatricesBuilt, 1);
     }
+    SDL_AtomicUnlock(&lock);
 }
 
+#define CHANNEL_CONVERTER(src, dst) \
+    static void SDLCALL \
+    SDL_ConvertChannels_##src##_to_##dst(SDL_AudioCVT *cvt, SDL_AudioFormat format) { \
+        const int frames = cvt->len_cvt / (sizeof (float) * src); \
+        LOG_DEBUG_CONVERT(#src " channels", #dst " channels"); \
+        SDL_assert(format == AUDIO_F32SYS); \
+        SDL_assert(SDL_AtomicGet(&ChannelMatricesBuilt)); \
+        ConvertChannels(ChannelMatrices[SDL_ChannelLayoutIndex(src)][SDL_ChannelLayoutIndex(dst)], \
+                        src, dst, (const float *) cvt->buf, (float *) cvt->buf, frames); \
+        cvt->len_cvt = frames * sizeof (float) * dst; \
+        if (cvt->filters[++cvt->filter_index]) { \
+            cvt->filters[cvt->filter_index](cvt, format); \
+        } \
+    }
+
+#define CHANNEL_CONVERTERS(src) \
+    CHANNEL_CONVERTER(src, 1) \
+    CHANNEL_CONVERTER(src, 2) \
+    CHANNEL_CONVERTER(src, 4) \
+    CHANNEL_CONVERTER(src, 6) \
+    CHANNEL_CONVERTER(src, 8)
+
+CHANNEL_CONVERTERS(1)
+CHANNEL_CONVERTERS(2)
+CHANNEL_CONVERTERS(4)
+CHANNEL_CONVERTERS(6)
+CHANNEL_CONVERTERS(8)
+
+#undef CHANNEL_CONVERTERS
+#undef CHANNEL_CONVERTER
+
+#define CHANNEL_CONVERTER_ROW(src) { \
+    SDL_ConvertChannels_##src##_to_1, SDL_ConvertChannels_##src##_to_2, SDL_ConvertChannels_##src##_to_4, \
+    SDL_ConvertChannels_##src##_to_6, SDL_ConvertChannels_##src##_to_8 }
+
+static const SDL_AudioFilter ChannelConverters[5][5] = {
+    CHANNEL_CONVERTER_ROW(1),
+    CHANNEL_CONVERTER_ROW(2),
+    CHANNEL_CONVERTER_ROW(4),
+    CHANNEL_CONVERTER_ROW(6),
+    CHANNEL_CONVERTER_ROW(8)
+};
 
-/* Upmix 5.1 to 7.1 */
-static void SDLCALL
-SDL_Convert51To71(SDL_AudioCVT * cvt, SDL_AudioFormat format)
-{
-    float lf, rf, lb, rb, ls, rs;
-    int i;
-    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
-    float *dst = (float *) (cvt->buf + cvt->len_cvt * 4 / 3);
-
-    LOG_DEBUG_CONVERT("5.1", "7.1");
-    SDL_assert(format == AUDIO_F32SYS);
-    SDL_assert(cvt->len_cvt % (sizeof(float) * 6) == 0);
-
-    for (i = cvt->len_cvt / (sizeof(float) * 6); i; --i) {
-        dst -= 8;
-        src -= 6;
-        lf = src[0];
-        rf = src[1];
-        lb = src[4];
-        rb = src[5];
-        ls = (lf + lb) * 0.5f;
-        rs = (rf + rb) * 0.5f;
-        /* !!! FIXME: these four may clip */
-        lf += lf - ls;
-        rf += rf - ls;
-        lb += lb - ls;
-        rb += rb - ls;
-        dst[3] = src[3];  /* LFE */
-        dst[2] = src[2];  /* FC */
-        dst[7] = rs; /* SR */
-        dst[6] = ls; /* SL */
-        dst[5] = rb;  /* BR */
-        dst[4] = lb;  /* BL */
-        dst[1] = rf;  /* FR */
-        dst[0] = lf;  /* FL */
-    }
-
-    cvt->len_cvt = cvt->len_cvt * 4 / 3;
-
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
-    }
-}
+#undef CHANNEL_CONVERTER_ROW
 
 /* SDL's resampler uses a "bandlimited interpolation" algorithm:
      https://ccrma.stanford.edu/~jos/resample/ */
@@ -427,34 +579,306 @@ kaiser_and_sinc(float *table, float *diffs, const int tablelen, const double bet
 }
 
 
+/* A windowed sinc filter, along with the per-phase weights SDL_ResampleAudio
+   applies it through. Each output frame reads (taps) input frames, from
+   (srcindex - (taps / 2) + 1) to (srcindex + (taps / 2)). phases holds, for
+   each of the RESAMPLER_SAMPLES_PER_ZERO_CROSSING phases between two input
+   frames, the tap weights at the start of the phase followed by how much each
+   weight changes across the phase, so a weight is (base + (fraction * slope)). */
+typedef void (*SDL_ResampleFrameFunc)(const float *src, const float *weights, const int chans, float *dst);
+
+typedef struct
+{
+    int zero_crossings;
+    int taps;  /* always a multiple of 4, for the SIMD kernels. */
+    double dB;
+    SDL_bool normalize;
+    float *filter;
+    float *differences;
+    float *phases;
+    SDL_ResampleFrameFunc resample_frame;  /* a kernel built for exactly (taps). */
+} SDL_ResampleSinc;
+
+#define RESAMPLER_TAPS ((RESAMPLER_ZERO_CROSSINGS + 1) * 2)
+
+/* The short sinc drops the very ends of its window, where the weights are tiny,
+   so it fits in four taps and only needs two frames of padding. */
+#define RESAMPLER_SHORT_ZERO_CROSSINGS 2
+#define RESAMPLER_SHORT_TAPS (RESAMPLER_SHORT_ZERO_CROSSINGS * 2)
+
 static SDL_SpinLock ResampleFilterSpinlock = 0;
-static float *ResamplerFilter = NULL;
-static float *ResamplerFilterDifference = NULL;
+static SDL_ResampleSinc ResamplerSinc = { RESAMPLER_ZERO_CROSSINGS, RESAMPLER_TAPS, 80.0, SDL_FALSE, NULL, NULL, NULL, NULL };
+static SDL_ResampleSinc ResamplerShortSinc = { RESAMPLER_SHORT_ZERO_CROSSINGS, RESAMPLER_SHORT_TAPS, 50.0, SDL_TRUE, NULL, NULL, NULL, NULL };
+
+/* Rate pairs that reduce to a ratio with at most this many output frames per
+   cycle get a cyclic table of finished weights, one entry per phase they can
+   actually land on, so each output frame is a plain dot product. */
+#define RESAMPLER_MAX_RATIONAL_PHASES 1024
+
+static void
+build_phase_table(const SDL_ResampleSinc *sinc)
+{
+    const int filtersize = (RESAMPLER_SAMPLES_PER_ZERO_CROSSING * sinc->zero_crossings) + 1;
+    const int center = (sinc->taps / 2) - 1;
+    const float *filter = sinc->filter;
+    const float *diffs = sinc->differences;
+    int phase, j;
+
+    for (phase = 0; phase < RESAMPLER_SAMPLES_PER_ZERO_CROSSING; phase++) {
+        float *base = sinc->phases + (phase * sinc->taps * 2);
+        float *slope = base + sinc->taps;
+        const double interpolation = ((double) phase) / ((double) RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+
+        for (j = 0; j < (sinc->taps / 2); j++) {
+            /* the left wing applies to input frame (srcindex - j), the right wing to (srcindex + 1 + j). */
+            const int leftindex = phase + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+            const int rightindex = (RESAMPLER_SAMPLES_PER_ZERO_CROSSING - 1 - phase) + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+            const int lefttap = center - j;
+            const int righttap = center + 1 + j;
+
+            if (leftindex < filtersize) {
+                base[lefttap] = (float) (filter[leftindex] + (interpolation * diffs[leftindex]));
+                slope[lefttap] = diffs[leftindex] / ((float) RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+            }
+            if (rightindex < filtersize) {
+                base[righttap] = (float) (filter[rightindex] + ((1.0 - interpolation) * diffs[rightindex]));
+                slope[righttap] = -diffs[rightindex] / ((float) RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+            }
+        }
+    }
+}
+
+static void
+FreeResampleSinc(SDL_ResampleSinc *sinc)
+{
+    SDL_free(sinc->filter);
+    SDL_free(sinc->differences);
+    SDL_free(sinc->phases);
+    sinc->filter = NULL;
+    sinc->differences = NULL;
+    sinc->phases = NULL;
+}
+
+static int
+PrepareResampleSinc(SDL_ResampleSinc *sinc)
+{
+    /* if dB > 50, beta=(0.1102 * (dB - 8.7)), according to Matlab. */
+    const double beta = 0.1102 * (sinc->dB - 8.7);
+    const int filtersize = (RESAMPLER_SAMPLES_PER_ZERO_CROSSING * sinc->zero_crossings) + 1;
+    const size_t alloclen = filtersize * sizeof (float);
+
+    sinc->filter = (float *) SDL_malloc(alloclen);
+    sinc->differences = (float *) SDL_malloc(alloclen);
+    /* calloc, so taps that fall off the end of the filter stay zero. */
+    sinc->phases = (float *) SDL_calloc(RESAMPLER_SAMPLES_PER_ZERO_CROSSING * sinc->taps * 2, sizeof (float));
+    if (!sinc->filter || !sinc->differences || !sinc->phases) {
+        FreeResampleSinc(sinc);
+        return SDL_OutOfMemory();
+    }
+
+    kaiser_and_sinc(sinc->filter, sinc->differences, filtersize, beta);
+    build_phase_table(sinc);
+
+    if (sinc->normalize) {
+        /* A filter this short loses a noticeable amount of gain to the window, and
+           unevenly across phases, so scale each phase to pass DC through as-is. */
+        int phase, tap;
+        for (phase = 0; phase < RESAMPLER_SAMPLES_PER_ZERO_CROSSING; phase++) {
+            float *base = sinc->phases + (phase * sinc->taps * 2);
+            double sum = 0.0;
+            for (tap = 0; tap < sinc->taps; tap++) {
+                sum += base[tap];
+            }
+            for (tap = 0; tap < sinc->taps * 2; tap++) {
+                base[tap] = (float) (base[tap] / sum);
+            }
+        }
+    }
+    return 0;
+}
+
+static SDL_INLINE void
+ResamplerWeights(float *weights, const float *phase, const int taps, const float fraction)
+{
+    int tap;
+    for (tap = 0; tap < taps; tap++) {
+        weights[tap] = phase[tap] + (fraction * phase[taps + tap]);
+    }
+}
+
+/* Compute one output frame from (taps) input frames at (src). */
+SDL_FORCE_INLINE void
+ResampleFrame_Scalar(const float *src, const float *weights, const int taps, const int chans, float *dst)
+{
+    int tap, chan;
+
+    for (chan = 0; chan < chans; chan++) {
+        float outsample = 0.0f;
+        for (tap = 0; tap < taps; tap++) {
+            outsample += src[(tap * chans) + chan] * weights[tap];
+        }
+        dst[chan] = outsample;
+    }
+}
+
+/* Each kernel is instantiated for both filters' tap counts, so the loops over the taps have constant bounds. */
+#define RESAMPLE_FRAME_FUNCS(simd) \
+    static void \
+    SDL_ResampleFrame_##simd(const float *src, const float *weights, const int chans, float *dst) { \
+        ResampleFrame_##simd(src, weights, RESAMPLER_TAPS, chans, dst); \
+    } \
+    static void \
+    SDL_ResampleFrameShort_##simd(const float *src, const float *weights, const int chans, float *dst) { \
+        ResampleFrame_##simd(src, weights, RESAMPLER_SHORT_TAPS, chans, dst); \
+    }
+
+RESAMPLE_FRAME_FUNCS(Scalar)
+
+#if HAVE_SSE_INTRINSICS
+SDL_FORCE_INLINE void
+ResampleFrame_SSE(const float *src, const float *weights, const int taps, const int chans, float *dst)
+{
+    int tap, chan;
+
+    switch (chans) {
+        case 1: {
+            __m128 sum = _mm_setzero_ps();
+            for (tap = 0; tap < taps; tap += 4) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + tap), _mm_loadu_ps(weights + tap)));
+            }
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_store_ss(dst, sum);
+            break;
+        }
+
+        case 2: {
+            /* each vector holds two stereo frames, so pair each weight up with itself. */
+            __m128 sum = _mm_setzero_ps();
+            for (tap = 0; tap < taps; tap += 4) {
+                const __m128 w = _mm_loadu_ps(weights + tap);
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + (tap * 2)), _mm_unpacklo_ps(w, w)));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + (tap * 2) + 4), _mm_unpackhi_ps(w, w)));
+            }
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            _mm_storel_pi((__m64 *) dst, sum);
+            break;
+        }
+
+        default: {
+            /* do four channels at a time, then any stragglers. */
+            for (chan = 0; (chan + 4) <= chans; chan += 4) {
+                __m128 sum = _mm_setzero_ps();
+                for (tap = 0; tap < taps; tap++) {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + (tap * chans) + chan), _mm_set1_ps(weights[tap])));
+                }
+                _mm_storeu_ps(dst + chan, sum);
+            }
+
+            for (; chan < chans; chan++) {
+                float outsample = 0.0f;
+                for (tap = 0; tap < taps; tap++) {
+                    outsample += src[(tap * chans) + chan] * weights[tap];
+                }
+                dst[chan] = outsample;
+            }
+            break;
+        }
+    }
+}
+
+RESAMPLE_FRAME_FUNCS(SSE)
+#endif
+
+#if HAVE_NEON_INTRINSICS
+SDL_FORCE_INLINE void
+ResampleFrame_NEON(const float *src, const float *weights, const int taps, const int chans, float *dst)
+{
+    int tap, chan;
+
+    switch (chans) {
+        case 1: {
+            float32x4_t sum = vdupq_n_f32(0.0f);
+            float32x2_t half;
+            for (tap = 0; tap < taps; tap += 4) {
+                sum = vmlaq_f32(sum, vld1q_f32(src + tap), vld1q_f32(weights + tap));
+            }
+            half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+            half = vpadd_f32(half, half);
+            vst1_lane_f32(dst, half, 0);
+            break;
+        }
+
+        case 2: {
+            /* each vector holds two stereo frames, so pair each weight up with itself. */
+            float32x4_t sum = vdupq_n_f32(0.0f);
+            for (tap = 0; tap < taps; tap += 4) {
+                const float32x4_t w = vld1q_f32(weights + tap);
+                const float32x4x2_t pairs = vzipq_f32(w, w);
+                sum = vmlaq_f32(sum, vld1q_f32(src + (tap * 2)), pairs.val[0]);
+                sum = vmlaq_f32(sum, vld1q_f32(src + (tap * 2) + 4), pairs.val[1]);
+            }
+            vst1_f32(dst, vadd_f32(vget_low_f32(sum), vget_high_f32(sum)));
+            break;
+        }
+
+        default: {
+            /* do four channels at a time, then any stragglers. */
+            for (chan = 0; (chan + 4) <= chans; chan += 4) {
+                float32x4_t sum = vdupq_n_f32(0.0f);
+                for (tap = 0; tap < taps; tap++) {
+                    sum = vmlaq_n_f32(sum, vld1q_f32(src + (tap * chans) + chan), weights[tap]);
+                }
+                vst1q_f32(dst + chan, sum);
+            }
+
+            for (; chan < chans; chan++) {
+                float outsample = 0.0f;
+                for (tap = 0; tap < taps; tap++) {
+                    outsample += src[(tap * chans) + chan] * weights[tap];
+                }
+                dst[chan] = outsample;
+            }
+            break;
+        }
+    }
+}
+
+RESAMPLE_FRAME_FUNCS(NEON)
+#endif
+
+#undef RESAMPLE_FRAME_FUNCS
 
 int
 SDL_PrepareResampleFilter(void)
 {
     SDL_AtomicLock(&ResampleFilterSpinlock);
-    if (!ResamplerFilter) {
-        /* if dB > 50, beta=(0.1102 * (dB - 8.7)), according to Matlab. */
-        const double dB = 80.0;
-        const double beta = 0.1102 * (dB - 8.7);
-        const size_t alloclen = RESAMPLER_FILTER_SIZE * sizeof (float);
-
-        ResamplerFilter = (float *) SDL_malloc(alloclen);
-        if (!ResamplerFilter) {
+    if (!ResamplerSinc.filter) {
+        if (PrepareResampleSinc(&ResamplerSinc) < 0) {
             SDL_AtomicUnlock(&ResampleFilterSpinlock);
-            return SDL_OutOfMemory();
+            return -1;
         }
 
-        ResamplerFilterDifference = (float *) SDL_malloc(alloclen);
-        if (!ResamplerFilterDifference) {
-            SDL_free(ResamplerFilter);
-            ResamplerFilter = NULL;
+        if (PrepareResampleSinc(&ResamplerShortSinc) < 0) {
+            FreeResampleSinc(&ResamplerSinc);
             SDL_AtomicUnlock(&ResampleFilterSpinlock);
-            return SDL_OutOfMemory();
+            return -1;
+        }
+
+        ResamplerSinc.resample_frame = SDL_ResampleFrame_Scalar;
+        ResamplerShortSinc.resample_frame = SDL_ResampleFrameShort_Scalar;
+        #if HAVE_SSE_INTRINSICS
+        if (SDL_HasSSE()) {
+            ResamplerSinc.resample_frame = SDL_ResampleFrame_SSE;
+            ResamplerShortSinc.resample_frame = SDL_ResampleFrameShort_SSE;
         }
-        kaiser_and_sinc(ResamplerFilter, ResamplerFilterDifference, RESAMPLER_FILTER_SIZE, beta);
+        #endif
+        #if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            ResamplerSinc.resample_frame = SDL_ResampleFrame_NEON;
+            ResamplerShortSinc.resample_frame = SDL_ResampleFrameShort_NEON;
+        }
+        #endif
     }
     SDL_AtomicUnlock(&ResampleFilterSpinlock);
     return 0;
@@ -463,77 +887,266 @@ SDL_PrepareResampleFilter(void)
 void
 SDL_FreeResampleFilter(void)
 {
-    SDL_free(ResamplerFilter);
-    SDL_free(ResamplerFilterDifference);
-    ResamplerFilter = NULL;
-    ResamplerFilterDifference = NULL;
+    FreeResampleSinc(&ResamplerSinc);
+    FreeResampleSinc(&ResamplerShortSinc);
+}
+
+static const SDL_ResampleSinc *
+ResamplerSincForQuality(const SDL_AudioResampleQuality quality)
+{
+    return (quality == SDL_AUDIO_RESAMPLE_SHORT_SINC) ? &ResamplerShortSinc : &ResamplerSinc;
 }
 
+/* Frames of input the resampler needs on either side of a buffer. */
 static int
-ResamplerPadding(const int inrate, const int outrate)
+ResamplerPadding(const SDL_AudioResampleQuality quality, const int inrate, const int outrate)
 {
     if (inrate == outrate) {
         return 0;
-    } else if (inrate > outrate) {
+    }
+
+    switch (quality) {
+        case SDL_AUDIO_RESAMPLE_ZERO_ORDER_HOLD: return 0;
+        case SDL_AUDIO_RESAMPLE_LINEAR: return 1;
+        case SDL_AUDIO_RESAMPLE_SHORT_SINC: return ResamplerShortSinc.taps / 2;
+        default: break;
+    }
+
+    if (inrate > outrate) {
         return (int) SDL_ceil(((float) (RESAMPLER_SAMPLES_PER_ZERO_CROSSING * inrate) / ((float) outrate)));
     }
     return RESAMPLER_SAMPLES_PER_ZERO_CROSSING;
 }
 
-/* lpadding and rpadding are expected to be buffers of (ResamplePadding(inrate, outrate) * chans * sizeof (float)) bytes. */
+static int
+ResamplerGCD(int a, int b)
+{
+    while (b != 0) {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Number of entries SDL_BuildResamplePhases() would need, or 0 if the rates don't reduce to a small enough ratio. */
+static int
+ResamplerPhaseCount(const int inrate, const int outrate)
+{
+    int count;
+
+    if ((inrate <= 0) || (outrate <= 0) || (inrate == outrate)) {
+        return 0;
+    }
+
+    count = outrate / ResamplerGCD(inrate, outrate);
+    return (count <= RESAMPLER_MAX_RATIONAL_PHASES) ? count : 0;
+}
+
+/* Build the cyclic weight table for a rate pair: entry (i) holds the weights for
+   an output frame that lands (i / count) of the way between two input frames.
+   SDL_PrepareResampleFilter() must have been called. Returns NULL if the ratio
+   isn't a candidate or memory ran out. */
+static float *
+SDL_BuildResamplePhases(const SDL_AudioResampleQuality quality, const int inrate, const int outrate)
+{
+    const SDL_ResampleSinc *sinc = ResamplerSincForQuality(quality);
+    const int taps = sinc->taps;
+    const int count = ResamplerPhaseCount(inrate, outrate);
+    float *phases;
+    int i;
+
+    if (count == 0) {
+        return NULL;
+    }
+
+    phases = (float *) SDL_malloc(count * taps * sizeof (float));
+    if (!phases) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        const double position = i * (((double) RESAMPLER_SAMPLES_PER_ZERO_CROSSING) / ((double) count));
+        const int phase = (int) position;
+        ResamplerWeights(phases + (i * taps), sinc->phases + (phase * taps * 2), taps, (float) (position - phase));
+    }
+
+    /* Exact 2x upsampling is a half-band filter: every other output frame is an
+       input frame, and the rest sit exactly halfway between two input frames,
+       so they use the filter's own samples at the half zero crossings, the
+       same on both wings, instead of interpolated ones. */
+    if ((count == 2) && ((inrate * 2) == outrate)) {
+        const int filtersize = (RESAMPLER_SAMPLES_PER_ZERO_CROSSING * sinc->zero_crossings) + 1;
+        const int center = (taps / 2) - 1;
+        float *halfway = phases + taps;
+        int j;
+
+        SDL_memset(halfway, '\0', taps * sizeof (float));
+        for (j = 0; j < (taps / 2); j++) {
+            const int index = (RESAMPLER_SAMPLES_PER_ZERO_CROSSING / 2) + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+            if (index < filtersize) {
+                halfway[center - j] = sinc->filter[index];
+                halfway[center + 1 + j] = sinc->filter[index];
+            }
+        }
+
+        if (sinc->normalize) {
+            float sum = 0.0f;
+            for (j = 0; j < taps; j++) {
+                sum += halfway[j];
+            }
+            for (j = 0; j < taps; j++) {
+                halfway[j] /= sum;
+            }
+        }
+    }
+
+    return phases;
+}
+
+/* lpadding and rpadding are expected to be buffers of (ResamplePadding(quality, inrate, outrate) * chans * sizeof (float)) bytes.
+   phases is NULL, or the table from SDL_BuildResamplePhases(quality, inrate, outrate).
+   quality picks the sinc filter; zero-order hold and linear go through SDL_ResampleAudioSimple.
+
+   The input position advances in exact integer steps of (inrate / outrate)
+   frames plus (inrate % outrate) 1/outrate'ths of a frame, so it doesn't
+   drift over long buffers. The remainder picks the filter phase. The weights
+   match interpolating the filter table per output frame, as this used to do,
+   to within 1e-5 for full scale input. The exception is an output frame that
+   lands exactly on a phase boundary, where the old code used the next table
+   entry for the right wing; there the two differ by up to one table step,
+   about 1.5e-3 (-56dB). */
 static int
 SDL_ResampleAudio(const int chans, const int inrate, const int outrate,
-                        const float *lpadding, const float *rpadding,
+                        const SDL_AudioResampleQuality quality,
+                        const float *phases, const float *lpadding, const float *rpadding,
                         const float *inbuf, const int inbuflen,
                         float *outbuf, const int outbuflen)
 {
-    const double finrate = (double) inrate;
-    const double outtimeincr = 1.0 / ((float) outrate);
-    const double  ratio = ((float) outrate) / ((float) inrate);
-    const int paddinglen = ResamplerPadding(inrate, outrate);
+    const SDL_ResampleSinc *sinc = ResamplerSincForQuality(quality);
+    const int taps = sinc->taps;
+    const double ratio = ((float) outrate) / ((float) inrate);
+    const int paddinglen = ResamplerPadding(quality, inrate, outrate);
     const int framelen = chans * (int)sizeof (float);
     const int inframes = inbuflen / framelen;
     const int wantedoutframes = (int) ((inbuflen / framelen) * ratio);  /* outbuflen isn't total to write, it's total available. */
     const int maxoutframes = outbuflen / framelen;
     const int outframes = SDL_min(wantedoutframes, maxoutframes);
+    /* with a phase table, step in units of the reduced ratio so the remainder indexes the table directly. */
+    const int divisor = phases ? ResamplerGCD(inrate, outrate) : 1;
+    const int stepin = inrate / divisor;
+    const int stepout = outrate / divisor;
+    const int incrframes = stepin / stepout;
+    const int incrremainder = stepin % stepout;
+    const double phasescale = ((double) RESAMPLER_SAMPLES_PER_ZERO_CROSSING) / ((double) stepout);
+    const SDL_ResampleFrameFunc resample_frame = sinc->resample_frame;
+    float window[RESAMPLER_TAPS * 8];
+    float weights[RESAMPLER_TAPS];
     float *dst = outbuf;
-    double outtime = 0.0;
-    int i, j, chan;
+    int srcindex = 0;
+    int remainder = 0;
+    int i, tap;
+
+    SDL_assert(chans <= 8);
+    SDL_assert(resample_frame != NULL);
 
     for (i = 0; i < outframes; i++) {
-        const int srcindex = (int) (outtime * inrate);
-        const double intime = ((double) srcindex) / finrate;
-        const double innexttime = ((double) (srcindex + 1)) / finrate;
-        const double interpolation1 = 1.0 - ((innexttime - outtime) / (innexttime - intime));
-        const int filterindex1 = (int) (interpolation1 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
-        const double interpolation2 = 1.0 - interpolation1;
-        const int filterindex2 = (int) (interpolation2 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
-
-        for (chan = 0; chan < chans; chan++) {
-            float outsample = 0.0f;
-
-            /* do this twice to calculate the sample, once for the "left wing" and then same for the right. */
-            /* !!! FIXME: do both wings in one loop */
-            for (j = 0; (filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
-                const int srcframe = srcindex - j;
-                /* !!! FIXME: we can bubble this conditional out of here by doing a pre loop. */
-                const float insample = (srcframe < 0) ? lpadding[((paddinglen + srcframe) * chans) + chan] : inbuf[(srcframe * chans) + chan];
-                outsample += (float)(insample * (ResamplerFilter[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation1 * ResamplerFilterDifference[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
+        if (phases && (remainder == 0)) {
+            /* landed right on an input frame, and every other tap is at a zero crossing, so just copy it. */
+            SDL_memcpy(dst, inbuf + (srcindex * chans), framelen);
+        } else {
+            const int firstframe = srcindex - ((taps / 2) - 1);
+            const float *src;
+
+            if ((firstframe >= 0) && ((firstframe + taps) <= inframes)) {
+                src = inbuf + (firstframe * chans);
+            } else {
+                /* near either end of the buffer, gather the frames into one place, pulling from the padding as needed. */
+                for (tap = 0; tap < taps; tap++) {
+                    const int srcframe = firstframe + tap;
+                    const float *frame;
+                    if (srcframe < 0) {
+                        frame = lpadding + ((paddinglen + srcframe) * chans);
+                    } else if (srcframe >= inframes) {
+                        frame = rpadding + ((srcframe - inframes) * chans);
+                    } else {
+                        frame = inbuf + (srcframe * chans);
+                    }
+                    SDL_memcpy(window + (tap * chans), frame, framelen);
+                }
+                src = window;
             }
 
-            for (j = 0; (filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
-                const int srcframe = srcindex + 1 + j;
-                /* !!! FIXME: we can bubble this conditional out of here by doing a post loop. */
-                const float insample = (srcframe >= inframes) ? rpadding[((srcframe - inframes) * chans) + chan] : inbuf[(srcframe * chans) + chan];
-                outsample += (float)(insample * (ResamplerFilter[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation2 * ResamplerFilterDifference[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
+            if (phases) {
+                resample_frame(src, phases + (remainder * taps), chans, dst);
+            } else {
+                const double position = remainder * phasescale;
+                const int phase = (int) position;
+                ResamplerWeights(weights, sinc->phases + (phase * taps * 2), taps, (float) (position - phase));
+                resample_frame(src, weights, chans, dst);
             }
-            *(dst++) = outsample;
         }
+        dst += chans;
 
-        outtime += outtimeincr;
+        srcindex += incrframes;
+        remainder += incrremainder;
+        if (remainder >= stepout) {
+            remainder -= stepout;
+            srcindex++;
+        }
     }
 
-    return outframes * chans * sizeof (float);
+    return outframes * framelen;
+}
+
+/* The cheap tiers: repeat the last input frame (zero-order hold), or linearly
+   interpolate between it and the next one. The input is stepped through the
+   same way as SDL_ResampleAudio. rpadding needs one frame for linear, and
+   nothing for a hold; neither looks back, so there's no left padding. */
+static int
+SDL_ResampleAudioSimple(const int chans, const int inrate, const int outrate,
+                        const SDL_bool interpolate, const float *rpadding,
+                        const float *inbuf, const int inbuflen,
+                        float *outbuf, const int outbuflen)
+{
+    const double ratio = ((float) outrate) / ((float) inrate);
+    const int framelen = chans * (int)sizeof (float);
+    const int inframes = inbuflen / framelen;
+    const int wantedoutframes = (int) ((inbuflen / framelen) * ratio);  /* outbuflen isn't total to write, it's total available. */
+    const int maxoutframes = outbuflen / framelen;
+    const int outframes = SDL_min(wantedoutframes, maxoutframes);
+    const int incrframes = inrate / outrate;
+    const int incrremainder = inrate % outrate;
+    const double fractionscale = 1.0 / ((double) outrate);
+    float *dst = outbuf;
+    int srcindex = 0;
+    int remainder = 0;
+    int i, chan;
+
+    for (i = 0; i < outframes; i++) {
+        const float *frame = inbuf + (srcindex * chans);
+
+        if (!interpolate || (remainder == 0)) {
+            SDL_memcpy(dst, frame, framelen);
+        } else {
+            const float *next = ((srcindex + 1) < inframes) ? (frame + chans) : rpadding;
+            const float fraction = (float) (remainder * fractionscale);
+            for (chan = 0; chan < chans; chan++) {
+                dst[chan] = frame[chan] + (fraction * (next[chan] - frame[chan]));
+            }
+        }
+        dst += chans;
+
+        srcindex += incrframes;
+        remainder += incrremainder;
+        if (remainder >= outrate) {
+            remainder -= outrate;
+            srcindex++;
+        }
+    }
+
+    return outframes * framelen;
 }
 
 int
@@ -704,7 +1317,7 @@ SDL_BuildAudioTypeCVTFromFloat(SDL_AudioCVT *cvt, const SDL_AudioFormat dst_fmt)
 }
 
 static void
-SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format)
+SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format, const SDL_bool rational)
 {
     /* !!! FIXME in 2.1: there are ten slots in the filter list, and the theoretical maximum we use is six (seven with NULL terminator).
        !!! FIXME in 2.1:   We need to store data for this resampler, because the cvt structure doesn't store the original sample rates,
@@ -718,9 +1331,10 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
     /* !!! FIXME: remove this if we can get the resampler to work in-place again. */
     float *dst = (float *) (cvt->buf + srclen);
     const int dstlen = (cvt->len * cvt->len_mult) - srclen;
-    const int requestedpadding = ResamplerPadding(inrate, outrate);
+    const int requestedpadding = ResamplerPadding(SDL_AUDIO_RESAMPLE_HIGH_QUALITY, inrate, outrate);
     int paddingsamples;
     float *padding;
+    float *phases = NULL;
 
     if (requestedpadding < SDL_MAX_SINT32 / chans) {
         paddingsamples = requestedpadding * chans;
@@ -736,8 +1350,18 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
         return;
     }
 
-    cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    /* the cvt has nowhere to keep the phase table between calls, but it's small next to the buffer. */
+    if (rational) {
+        phases = SDL_BuildResamplePhases(SDL_AUDIO_RESAMPLE_HIGH_QUALITY, inrate, outrate);
+        if (!phases) {
+            SDL_free(padding);
+            return;  /* SDL_BuildResamplePhases should have called SDL_OutOfMemory. */
+        }
+    }
 
+    cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, SDL_AUDIO_RESAMPLE_HIGH_QUALITY, phases, padding, padding, src, srclen, dst, dstlen);
+
+    SDL_free(phases);
     SDL_free(padding);
 
     SDL_memmove(cvt->buf, dst, cvt->len_cvt);  /* !!! FIXME: remove this if we can get the resampler to work in-place again. */
@@ -754,7 +1378,11 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
 #define RESAMPLER_FUNCS(chans) \
     static void SDLCALL \
     SDL_ResampleCVT_c##chans(SDL_AudioCVT *cvt, SDL_AudioFormat format) { \
-        SDL_ResampleCVT(cvt, chans, format); \
+        SDL_ResampleCVT(cvt, chans, format, SDL_FALSE); \
+    } \
+    static void SDLCALL \
+    SDL_ResampleCVTRational_c##chans(SDL_AudioCVT *cvt, SDL_AudioFormat format) { \
+        SDL_ResampleCVT(cvt, chans, format, SDL_TRUE); \
     }
 RESAMPLER_FUNCS(1)
 RESAMPLER_FUNCS(2)
@@ -764,15 +1392,26 @@ RESAMPLER_FUNCS(8)
 #undef RESAMPLER_FUNCS
 
 static SDL_AudioFilter
-ChooseCVTResampler(const int dst_channels)
+ChooseCVTResampler(const int dst_channels, const SDL_bool rational)
 {
-    switch (dst_channels) {
-        case 1: return SDL_ResampleCVT_c1;
-        case 2: return SDL_ResampleCVT_c2;
-        case 4: return SDL_ResampleCVT_c4;
-        case 6: return SDL_ResampleCVT_c6;
-        case 8: return SDL_ResampleCVT_c8;
-        default: break;
+    if (rational) {
+        switch (dst_channels) {
+            case 1: return SDL_ResampleCVTRational_c1;
+            case 2: return SDL_ResampleCVTRational_c2;
+            case 4: return SDL_ResampleCVTRational_c4;
+            case 6: return SDL_ResampleCVTRational_c6;
+            case 8: return SDL_ResampleCVTRational_c8;
+            default: break;
+        }
+    } else {
+        switch (dst_channels) {
+            case 1: return SDL_ResampleCVT_c1;
+            case 2: return SDL_ResampleCVT_c2;
+            case 4: return SDL_ResampleCVT_c4;
+            case 6: return SDL_ResampleCVT_c6;
+            case 8: return SDL_ResampleCVT_c8;
+            default: break;
+        }
     }
 
     return NULL;
@@ -788,7 +1427,7 @@ SDL_BuildAudioResampleCVT(SDL_AudioCVT * cvt, const int dst_channels,
         return 0;  /* no conversion necessary. */
     }
 
-    filter = ChooseCVTResampler(dst_channels);
+    filter = ChooseCVTResampler(dst_channels, (ResamplerPhaseCount(src_rate, dst_rate) > 0) ? SDL_TRUE : SDL_FALSE);
     if (filter == NULL) {
         return SDL_SetError("No conversion available for these rates");
     }
@@ -958,120 +1597,20 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
         return -1;              /* shouldn't happen, but just in case... */
     }
 
-    /* Channel conversion */
-    if (src_channels < dst_channels) {
-        /* Upmixing */
-        /* Mono -> Stereo [-> ...] */
-        if ((src_channels == 1) && (dst_channels > 1)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertMonoToStereo) < 0) {
-                return -1;
-            }
-            cvt->len_mult *= 2;
-            src_channels = 2;
-            cvt->len_ratio *= 2;
-        }
-        /* [Mono ->] Stereo -> 5.1 [-> 7.1] */
-        if ((src_channels == 2) && (dst_channels >= 6)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertStereoTo51) < 0) {
-                return -1;
-            }
-            src_channels = 6;
-            cvt->len_mult *= 3;
-            cvt->len_ratio *= 3;
-        }
-        /* Quad -> 5.1 [-> 7.1] */
-        if ((src_channels == 4) && (dst_channels >= 6)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertQuadTo51) < 0) {
-                return -1;
-            }
-            src_channels = 6;
-            cvt->len_mult = (cvt->len_mult * 3 + 1) / 2;
-            cvt->len_ratio *= 1.5;
-        }
-        /* [[Mono ->] Stereo ->] 5.1 -> 7.1 */
-        if ((src_channels == 6) && (dst_channels == 8)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_Convert51To71) < 0) {
-                return -1;
-            }
-            src_channels = 8;
-            cvt->len_mult = (cvt->len_mult * 4 + 2) / 3;
-            /* Should be numerically exact with every valid input to this
-               function */
-            cvt->len_ratio = cvt->len_ratio * 4 / 3;
-        }
-        /* [Mono ->] Stereo -> Quad */
-        if ((src_channels == 2) && (dst_channels == 4)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertStereoToQuad) < 0) {
-                return -1;
-            }
-            src_channels = 4;
-            cvt->len_mult *= 2;
-            cvt->len_ratio *= 2;
-        }
-    } else if (src_channels > dst_channels) {
-        /* Downmixing */
-        /* 7.1 -> 5.1 [-> Stereo [-> Mono]] */
-        /* 7.1 -> 5.1 [-> Quad] */
-        if ((src_channels == 8) && (dst_channels <= 6)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_Convert71To51) < 0) {
-                return -1;
-            }
-            src_channels = 6;
-            cvt->len_ratio *= 0.75;
-        }
-        /* [7.1 ->] 5.1 -> Stereo [-> Mono] */
-        if ((src_channels == 6) && (dst_channels <= 2)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_Convert51ToStereo) < 0) {
-                return -1;
-            }
-            src_channels = 2;
-            cvt->len_ratio /= 3;
-        }
-        /* 5.1 -> Quad */
-        if ((src_channels == 6) && (dst_channels == 4)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_Convert51ToQuad) < 0) {
-                return -1;
-            }
-            src_channels = 4;
-            cvt->len_ratio = cvt->len_ratio * 2 / 3;
-        }
-        /* Quad -> Stereo [-> Mono] */
-        if ((src_channels == 4) && (dst_channels <= 2)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertQuadToStereo) < 0) {
-                return -1;
-            }
-            src_channels = 2;
-            cvt->len_ratio /= 2;
+    /* Channel conversion, in one pass through a mixing matrix. */
+    if (src_channels != dst_channels) {
+        const SDL_AudioFilter filter = ChannelConverters[SDL_ChannelLayoutIndex(src_channels)][SDL_ChannelLayoutIndex(dst_channels)];
+        SDL_PrepareChannelMatrices();
+        if (SDL_AddAudioCVTFilter(cvt, filter) < 0) {
+            return -1;
         }
-        /* [... ->] Stereo -> Mono */
-        if ((src_channels == 2) && (dst_channels == 1)) {
-            SDL_AudioFilter filter = NULL;
-
-            #if HAVE_SSE3_INTRINSICS
-            if (SDL_HasSSE3()) {
-                filter = SDL_ConvertStereoToMono_SSE3;
-            }
-            #endif
-
-            if (!filter) {
-                filter = SDL_ConvertStereoToMono;
-            }
-
-            if (SDL_AddAudioCVTFilter(cvt, filter) < 0) {
-                return -1;
-            }
-
-            src_channels = 1;
-            cvt->len_ratio /= 2;
+        if (dst_channels > src_channels) {
+            cvt->len_mult *= (dst_channels + src_channels - 1) / src_channels;
         }
+        cvt->len_ratio = (cvt->len_ratio * dst_channels) / src_channels;
+        src_channels = dst_channels;
     }
 
-    if (src_channels != dst_channels) {
-        /* All combinations of supported channel counts should have been
-           handled by now, but let's be defensive */
-      return SDL_SetError("Invalid channel combination");
-    }
-    
     /* Do rate conversion, if necessary. Updates (cvt). */
     if (SDL_BuildAudioResampleCVT(cvt, dst_channels, src_rate, dst_rate) < 0) {
         return -1;              /* shouldn't happen, but just in case... */
@@ -1111,9 +1650,13 @@ struct _SDL_AudioStream
     int dst_rate;
     double rate_incr;
     Uint8 pre_resample_channels;
+    SDL_bool custom_channels;
+    float channel_weights[CHANNEL_MATRIX_SIZE];
     int packetlen;
     int resampler_padding_samples;
     float *resampler_padding;
+    float *resampler_phases;
+    SDL_AudioResampleQuality resample_quality;
     void *resampler_state;
     SDL_ResampleAudioStreamFunc resampler_func;
     SDL_ResetAudioStreamResamplerFunc reset_resampler_func;
@@ -1244,7 +1787,17 @@ SDL_ResampleAudioStream(SDL_AudioStream *stream, const void *_inbuf, const int i
 
     SDL_assert(inbuf != ((const float *) outbuf));  /* SDL_AudioStreamPut() shouldn't allow in-place resamples. */
 
-    retval = SDL_ResampleAudio(chans, inrate, outrate, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    switch (stream->resample_quality) {
+        case SDL_AUDIO_RESAMPLE_ZERO_ORDER_HOLD:
+            retval = SDL_ResampleAudioSimple(chans, inrate, outrate, SDL_FALSE, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+            break;
+        case SDL_AUDIO_RESAMPLE_LINEAR:
+            retval = SDL_ResampleAudioSimple(chans, inrate, outrate, SDL_TRUE, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+            break;
+        default:
+            retval = SDL_ResampleAudio(chans, inrate, outrate, stream->resample_quality, stream->resampler_phases, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+            break;
+    }
 
     /* update our left padding with end of current input, for next run. */
     SDL_memcpy((lpadding + paddingsamples) - (cpy / sizeof (float)), inbufend - cpy, cpy);
@@ -1263,6 +1816,128 @@ static void
 SDL_CleanupAudioStreamResampler(SDL_AudioStream *stream)
 {
     SDL_free(stream->resampler_state);
+    SDL_free(stream->resampler_phases);
+
+    stream->resampler_state = NULL;
+    stream->resampler_phases = NULL;
+    stream->resampler_func = NULL;
+    stream->reset_resampler_func = NULL;
+    stream->cleanup_resampler_func = NULL;
+}
+
+/* (Re)build the resampler for the stream's current quality. The padding the
+   stream holds back depends on it, so any pending input is dropped. */
+static int
+SetupAudioStreamResampler(SDL_AudioStream *stream)
+{
+    const SDL_AudioResampleQuality quality = stream->resample_quality;
+
+    if (stream->cleanup_resampler_func) {
+        stream->cleanup_resampler_func(stream);
+    }
+
+    SDL_free(stream->resampler_padding);
+    SDL_free(stream->staging_buffer);
+    stream->resampler_padding = NULL;
+    stream->staging_buffer = NULL;
+    stream->staging_buffer_filled = 0;
+    stream->first_run = SDL_TRUE;
+
+    stream->resampler_padding_samples = ResamplerPadding(quality, stream->src_rate, stream->dst_rate) * stream->pre_resample_channels;
+    stream->resampler_padding = (float *) SDL_calloc(stream->resampler_padding_samples ? stream->resampler_padding_samples : 1, sizeof (float));
+    if (stream->resampler_padding == NULL) {
+        return SDL_OutOfMemory();
+    }
+
+    stream->staging_buffer_size = ((stream->resampler_padding_samples / stream->pre_resample_channels) * stream->src_sample_frame_size);
+    if (stream->staging_buffer_size > 0) {
+        stream->staging_buffer = (Uint8 *) SDL_malloc(stream->staging_buffer_size);
+        if (stream->staging_buffer == NULL) {
+            return SDL_OutOfMemory();
+        }
+    }
+
+#ifdef HAVE_LIBSAMPLERATE_H
+    if (quality == SDL_AUDIO_RESAMPLE_HIGH_QUALITY) {
+        SetupLibSampleRateResampling(stream);
+    }
+#endif
+
+    if (!stream->resampler_func) {
+        stream->resampler_state = SDL_calloc(stream->resampler_padding_samples ? stream->resampler_padding_samples : 1, sizeof (float));
+        if (!stream->resampler_state) {
+            return SDL_OutOfMemory();
+        }
+
+        if (SDL_PrepareResampleFilter() < 0) {
+            SDL_free(stream->resampler_state);
+            stream->resampler_state = NULL;
+            return -1;
+        }
+
+        /* common rate pairs reduce to a small ratio; give those a cyclic phase table. */
+        if ((quality >= SDL_AUDIO_RESAMPLE_SHORT_SINC) && (ResamplerPhaseCount(stream->src_rate, stream->dst_rate) > 0)) {
+            stream->resampler_phases = SDL_BuildResamplePhases(quality, stream->src_rate, stream->dst_rate);
+            if (!stream->resampler_phases) {
+                SDL_free(stream->resampler_state);
+                stream->resampler_state = NULL;
+                return -1;  /* SDL_BuildResamplePhases should have called SDL_OutOfMemory. */
+            }
+        }
+
+        stream->resampler_func = SDL_ResampleAudioStream;
+        stream->reset_resampler_func = SDL_ResetAudioStreamResampler;
+        stream->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
+    }
+
+    return 0;
+}
+
+/* Build the format conversions on either side of the resampler. Usually
+   SDL_AudioCVT changes the channels too, but a stream with its own channel
+   matrix keeps its channels through the CVTs and mixes them itself, in
+   SDL_AudioStreamPutInternal(), at the same point the CVT would have. */
+static int
+SetupAudioStreamConverters(SDL_AudioStream *stream)
+{
+    const SDL_AudioFormat src_format = stream->src_format;
+    const SDL_AudioFormat dst_format = stream->dst_format;
+    const int src_rate = stream->src_rate;
+    const int dst_rate = stream->dst_rate;
+    const Uint8 src_channels = stream->src_channels;
+    const Uint8 dst_channels = stream->dst_channels;
+    const Uint8 before_channels = stream->custom_channels ? src_channels : stream->pre_resample_channels;
+    const Uint8 after_channels = stream->custom_channels ? dst_channels : stream->pre_resample_channels;
+
+    /* Not resampling? It's an easy conversion (and maybe not even that!) */
+    if ((src_rate == dst_rate) && !stream->custom_channels) {
+        stream->cvt_before_resampling.needed = SDL_FALSE;
+        if (SDL_BuildAudioCVT(&stream->cvt_after_resampling, src_format, src_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
+            return -1;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
+        }
+        return 0;
+    }
+
+    /* Don't resample at first. Just get us to Float32 format. */
+    /* !!! FIXME: convert to int32 on devices without hardware float. */
+    if (SDL_BuildAudioCVT(&stream->cvt_before_resampling, src_format, src_channels, src_rate, AUDIO_F32SYS, before_channels, src_rate) < 0) {
+        return -1;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
+    }
+
+    /* Convert us to the final format after resampling. */
+    if (SDL_BuildAudioCVT(&stream->cvt_after_resampling, AUDIO_F32SYS, after_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
+        return -1;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
+    }
+    return 0;
+}
+
+/* Run a stream's own channel matrix over (buflen) bytes of float data. */
+static int
+ConvertAudioStreamChannels(SDL_AudioStream *stream, Uint8 *buf, const int buflen)
+{
+    const int frames = buflen / (int) (stream->src_channels * sizeof (float));
+    ConvertChannels(stream->channel_weights, stream->src_channels, stream->dst_channels, (const float *) buf, (float *) buf, frames);
+    return frames * (int) (stream->dst_channels * sizeof (float));
 }
 
 SDL_AudioStream *
@@ -1300,69 +1975,16 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
     retval->pre_resample_channels = pre_resample_channels;
     retval->packetlen = packetlen;
     retval->rate_incr = ((double) dst_rate) / ((double) src_rate);
-    retval->resampler_padding_samples = ResamplerPadding(retval->src_rate, retval->dst_rate) * pre_resample_channels;
-    retval->resampler_padding = (float *) SDL_calloc(retval->resampler_padding_samples ? retval->resampler_padding_samples : 1, sizeof (float));
+    retval->resample_quality = SDL_AUDIO_RESAMPLE_HIGH_QUALITY;
 
-    if (retval->resampler_padding == NULL) {
+    if (SetupAudioStreamConverters(retval) < 0) {
         SDL_FreeAudioStream(retval);
-        SDL_OutOfMemory();
-        return NULL;
+        return NULL;  /* SetupAudioStreamConverters should have called SDL_SetError. */
     }
 
-    retval->staging_buffer_size = ((retval->resampler_padding_samples / retval->pre_resample_channels) * retval->src_sample_frame_size);
-    if (retval->staging_buffer_size > 0) {
-        retval->staging_buffer = (Uint8 *) SDL_malloc(retval->staging_buffer_size);
-        if (retval->staging_buffer == NULL) {
-            SDL_FreeAudioStream(retval);
-            SDL_OutOfMemory();
-            return NULL;
-        }
-    }
-
-    /* Not resampling? It's an easy conversion (and maybe not even that!) */
-    if (src_rate == dst_rate) {
-        retval->cvt_before_resampling.needed = SDL_FALSE;
-        if (SDL_BuildAudioCVT(&retval->cvt_after_resampling, src_format, src_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
-            SDL_FreeAudioStream(retval);
-            return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
-        }
-    } else {
-        /* Don't resample at first. Just get us to Float32 format. */
-        /* !!! FIXME: convert to int32 on devices without hardware float. */
-        if (SDL_BuildAudioCVT(&retval->cvt_before_resampling, src_format, src_channels, src_rate, AUDIO_F32SYS, pre_resample_channels, src_rate) < 0) {
-            SDL_FreeAudioStream(retval);
-            return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
-        }
-
-#ifdef HAVE_LIBSAMPLERATE_H
-        SetupLibSampleRateResampling(retval);
-#endif
-
-        if (!retval->resampler_func) {
-            retval->resampler_state = SDL_calloc(retval->resampler_padding_samples, sizeof (float));
-            if (!retval->resampler_state) {
-                SDL_FreeAudioStream(retval);
-                SDL_OutOfMemory();
-                return NULL;
-            }
-
-            if (SDL_PrepareResampleFilter() < 0) {
-                SDL_free(retval->resampler_state);
-                retval->resampler_state = NULL;
-                SDL_FreeAudioStream(retval);
-                return NULL;
-            }
-
-            retval->resampler_func = SDL_ResampleAudioStream;
-            retval->reset_resampler_func = SDL_ResetAudioStreamResampler;
-            retval->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
-        }
-
-        /* Convert us to the final format after resampling. */
-        if (SDL_BuildAudioCVT(&retval->cvt_after_resampling, AUDIO_F32SYS, pre_resample_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
-            SDL_FreeAudioStream(retval);
-            return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
-        }
+    if ((src_rate != dst_rate) && (SetupAudioStreamResampler(retval) < 0)) {
+        SDL_FreeAudioStream(retval);
+        return NULL;  /* SetupAudioStreamResampler should have called SDL_SetError. */
     }
 
     retval->queue = SDL_NewDataQueue(packetlen, packetlen * 2);
@@ -1415,6 +2037,10 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
         workbuflen += resamplebuflen;
     }
 
+    if (stream->custom_channels && (stream->dst_channels > stream->src_channels)) {
+        workbuflen *= (stream->dst_channels + stream->src_channels - 1) / stream->src_channels;
+    }
+
     if (stream->cvt_after_resampling.needed) {
         /* !!! FIXME: buffer might be big enough already? */
         workbuflen *= stream->cvt_after_resampling.len_mult;
@@ -1448,7 +2074,16 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
         #endif
     }
 
+    /* mix down before resampling, or mix up after it, like SDL_AudioCVT would. */
+    if (stream->custom_channels && (stream->dst_channels <= stream->src_channels)) {
+        buflen = ConvertAudioStreamChannels(stream, workbuf + paddingbytes, buflen);
+    }
+
     if (stream->dst_rate != stream->src_rate) {
+        if (!stream->resampler_func) {
+            return SDL_SetError("Audio stream has no resampler");  /* a failed SDL_AudioStreamSetResampleQuality() left it without one. */
+        }
+
         /* save off some samples at the end; they are used for padding now so
            the resampler is coherent and then used at the start of the next
            put operation. Prepend last put operation's padding, too. */
@@ -1475,6 +2110,10 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
         #endif
     }
 
+    if (stream->custom_channels && (stream->dst_channels > stream->src_channels)) {
+        buflen = ConvertAudioStreamChannels(stream, resamplebuf, buflen);
+    }
+
     if (stream->cvt_after_resampling.needed && (buflen > 0)) {
         stream->cvt_after_resampling.buf = resamplebuf;
         stream->cvt_after_resampling.len = buflen;
@@ -1530,6 +2169,7 @@ SDL_AudioStreamPut(SDL_AudioStream *stream, const void *buf, int len)
 
     if (!stream->cvt_before_resampling.needed &&
         (stream->dst_rate == stream->src_rate) &&
+        !stream->custom_channels &&
         !stream->cvt_after_resampling.needed) {
         #if DEBUG_AUDIOSTREAM
         printf("AUDIOSTREAM: no conversion needed at all, queueing %d bytes.\n", len);
@@ -1663,6 +2303,43 @@ SDL_AudioStreamClear(SDL_AudioStream *stream)
     }
 }
 
+int
+SDL_AudioStreamSetResampleQuality(SDL_AudioStream *stream, SDL_AudioResampleQuality quality)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if ((quality < SDL_AUDIO_RESAMPLE_ZERO_ORDER_HOLD) || (quality > SDL_AUDIO_RESAMPLE_HIGH_QUALITY)) {
+        return SDL_InvalidParamError("quality");
+    }
+
+    if ((quality == stream->resample_quality) && (stream->resampler_func || (stream->src_rate == stream->dst_rate))) {
+        return 0;  /* nothing to change. */
+    }
+
+    stream->resample_quality = quality;
+    if (stream->src_rate == stream->dst_rate) {
+        return 0;  /* not resampling, so there is nothing to rebuild. */
+    }
+    return SetupAudioStreamResampler(stream);
+}
+
+int
+SDL_AudioStreamSetChannelMatrix(SDL_AudioStream *stream, const float *matrix)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    }
+
+    if (matrix) {
+        SDL_SetChannelMatrix(stream->channel_weights, stream->src_channels, stream->dst_channels, matrix);
+        stream->custom_channels = SDL_TRUE;
+    } else {
+        stream->custom_channels = SDL_FALSE;
+    }
+
+    return SetupAudioStreamConverters(stream);
+}
+
 /* dispose of a stream */
 void
 SDL_FreeAudioStream(SDL_AudioStream *stream)
@@ -25,8 +25,34 @@
 #include "SDL_cpuinfo.h"
 #include "SDL_timer.h"
 #include "SDL_audio.h"
+#include "SDL_assert.h"
 #include "SDL_sysaudio.h"
 
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
+#endif
+
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
+/* The AVX2 mixers are compiled with a per-function target attribute, so they
+   don't need AVX2 enabled globally. They are only used when SDL_HasAVX2(). */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || (__GNUC__ >= 5)) && HAVE_SSE2_INTRINSICS && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#define HAVE_AVX2_INTRINSICS 1
+#define SDL_TARGETING(x) __attribute__((target(x)))
+#elif defined(_MSC_VER) && (_MSC_VER >= 1800) && (defined(_M_IX86) || defined(_M_X64)) && \
+    HAVE_SSE2_INTRINSICS && !defined(__clang__)
+#define HAVE_AVX2_INTRINSICS 1
+#define SDL_TARGETING(x)
+#endif
+
 /* This table is used to add two sound values together and pin
  * the value to avoid overflow.  (used with permission from ARDI)
  * Changed to use 0xFE instead of 0xFF for better sound quality.
@@ -85,6 +111,480 @@ static const Uint8 mix8[] = {
 #define ADJUST_VOLUME(s, v) (s = (s*v)/SDL_MIX_MAXVOLUME)
 #define ADJUST_VOLUME_U8(s, v)  (s = (((s-128)*v)/SDL_MIX_MAXVOLUME)+128)
 
+/* The SIMD mixers below give exactly the same results as the scalar code in
+   SDL_MixAudioFormat(), which mixes whatever they leave over at the end.
+   They only handle volumes from 1 to SDL_MIX_MAXVOLUME, where the scaled
+   source sample always fits its own type again. Each one returns how many
+   bytes it mixed.
+
+   Scaling by the volume truncates toward zero, like the C division in
+   ADJUST_VOLUME, so negative products are biased by 127 before the shift.
+   32-bit samples are split into (s >> 7) and (s & 127) so every product
+   fits in 32 bits, and there is no 32-bit saturating add on x86, so those
+   clamp by checking the signs of the sum. The U8 table is the same as
+   clamping (dst + src - 128) to 0..254. Float mixing does the scalar code's
+   two multiplies and one add, without fusing them, and clamps to +/-FLT_MAX
+   like it does. */
+typedef Uint32 (*SDL_MixFunc)(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
+
+#if HAVE_SSE2_INTRINSICS
+static __m128i
+SDL_ScaleS16_SSE2(const __m128i samples, const __m128i volume)
+{
+    const __m128i product = _mm_mullo_epi16(samples, volume);
+    const __m128i bias = _mm_and_si128(_mm_srai_epi16(product, 15), _mm_set1_epi16(127));
+    return _mm_srai_epi16(_mm_add_epi16(product, bias), 7);
+}
+
+static __m128i
+SDL_ScaleS32Product_SSE2(const __m128i product)
+{
+    const __m128i bias = _mm_and_si128(_mm_srai_epi32(product, 31), _mm_set1_epi32(127));
+    return _mm_srai_epi32(_mm_add_epi32(product, bias), 7);
+}
+
+static Uint32
+SDL_MixAudio_S8_SSE2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m128i vol = _mm_set1_epi16((Sint16) volume);
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        const __m128i lo = SDL_ScaleS16_SSE2(_mm_srai_epi16(_mm_unpacklo_epi8(s, s), 8), vol);
+        const __m128i hi = SDL_ScaleS16_SSE2(_mm_srai_epi16(_mm_unpackhi_epi8(s, s), 8), vol);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_adds_epi8(d, _mm_packs_epi16(lo, hi)));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_U8_SSE2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m128i vol = _mm_set1_epi16((Sint16) volume);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi16(128);
+    const __m128i maxval = _mm_set1_epi8((char) 0xFE);
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        const __m128i slo = SDL_ScaleS16_SSE2(_mm_sub_epi16(_mm_unpacklo_epi8(s, zero), offset), vol);
+        const __m128i shi = SDL_ScaleS16_SSE2(_mm_sub_epi16(_mm_unpackhi_epi8(s, zero), offset), vol);
+        const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(d, zero), slo);
+        const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(d, zero), shi);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_min_epu8(_mm_packus_epi16(lo, hi), maxval));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_S16_SSE2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m128i vol = _mm_set1_epi16((Sint16) volume);
+    Uint32 i;
+
+    if (volume == SDL_MIX_MAXVOLUME) {
+        for (i = 0; (i + 16) <= len; i += 16) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+            _mm_storeu_si128((__m128i *) (dst + i), _mm_adds_epi16(d, s));
+        }
+        return i;
+    }
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        const __m128i plo = _mm_mullo_epi16(s, vol);
+        const __m128i phi = _mm_mulhi_epi16(s, vol);
+        const __m128i lo = SDL_ScaleS32Product_SSE2(_mm_unpacklo_epi16(plo, phi));
+        const __m128i hi = SDL_ScaleS32Product_SSE2(_mm_unpackhi_epi16(plo, phi));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_adds_epi16(d, _mm_packs_epi32(lo, hi)));
+    }
+    return i;
+}
+
+static __m128i
+SDL_AddSaturateS32_SSE2(const __m128i a, const __m128i b)
+{
+    const __m128i sum = _mm_add_epi32(a, b);
+    const __m128i overflow = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(a, sum), _mm_xor_si128(b, sum)), 31);
+    const __m128i saturated = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(0x7FFFFFFF));
+    return _mm_or_si128(_mm_and_si128(overflow, saturated), _mm_andnot_si128(overflow, sum));
+}
+
+static Uint32
+SDL_MixAudio_S32_SSE2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m128i vol = _mm_set1_epi32(volume);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lomask = _mm_set1_epi32(127);
+    Uint32 i;
+
+    if (volume == SDL_MIX_MAXVOLUME) {
+        for (i = 0; (i + 16) <= len; i += 16) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+            _mm_storeu_si128((__m128i *) (dst + i), SDL_AddSaturateS32_SSE2(d, s));
+        }
+        return i;
+    }
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        const __m128i hi = _mm_srai_epi32(s, 7);
+        /* (lo * volume) fits in 16 bits, so madd only has one product per lane. */
+        const __m128i loproduct = _mm_madd_epi16(_mm_and_si128(s, lomask), vol);
+        /* SSE2 has no 32-bit mullo; multiply the even and odd lanes apart. */
+        const __m128i even = _mm_mul_epu32(hi, vol);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_si128(hi, 4), vol);
+        const __m128i hiproduct = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                                     _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        const __m128i floored = _mm_add_epi32(hiproduct, _mm_srli_epi32(loproduct, 7));
+        /* round negative results up to truncate; subtracting -1 adds one. */
+        const __m128i inexact = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(loproduct, lomask), zero), _mm_srai_epi32(s, 31));
+        _mm_storeu_si128((__m128i *) (dst + i), SDL_AddSaturateS32_SSE2(d, _mm_sub_epi32(floored, inexact)));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_F32_SSE2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m128 fvolume = _mm_set1_ps((float) volume);
+    const __m128 fmaxvolume = _mm_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m128 maxval = _mm_set1_ps(3.402823466e+38F);
+    const __m128 minval = _mm_set1_ps(-3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const __m128 s = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps((const float *) (src + i)), fvolume), fmaxvolume);
+        const __m128 sum = _mm_add_ps(_mm_loadu_ps((const float *) (dst + i)), s);
+        /* the bound goes first so a NaN sum passes through like it does in the scalar code. */
+        _mm_storeu_ps((float *) (dst + i), _mm_min_ps(maxval, _mm_max_ps(minval, sum)));
+    }
+    return i;
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+/* The same as the SSE2 mixers, twice as wide. The unpacks and packs work
+   within each 128-bit lane, so they hand back samples in their original
+   order. */
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2")
+SDL_ScaleS16_AVX2(const __m256i samples, const __m256i volume)
+{
+    const __m256i product = _mm256_mullo_epi16(samples, volume);
+    const __m256i bias = _mm256_and_si256(_mm256_srai_epi16(product, 15), _mm256_set1_epi16(127));
+    return _mm256_srai_epi16(_mm256_add_epi16(product, bias), 7);
+}
+
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2")
+SDL_ScaleS32Product_AVX2(const __m256i product)
+{
+    const __m256i bias = _mm256_and_si256(_mm256_srai_epi32(product, 31), _mm256_set1_epi32(127));
+    return _mm256_srai_epi32(_mm256_add_epi32(product, bias), 7);
+}
+
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2")
+SDL_AddSaturateS32_AVX2(const __m256i a, const __m256i b)
+{
+    const __m256i sum = _mm256_add_epi32(a, b);
+    const __m256i overflow = _mm256_srai_epi32(_mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum)), 31);
+    const __m256i saturated = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(0x7FFFFFFF));
+    return _mm256_blendv_epi8(sum, saturated, overflow);
+}
+
+static Uint32 SDL_TARGETING("avx2")
+SDL_MixAudio_S8_AVX2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m256i vol = _mm256_set1_epi16((Sint16) volume);
+    Uint32 i;
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+        const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        const __m256i lo = SDL_ScaleS16_AVX2(_mm256_srai_epi16(_mm256_unpacklo_epi8(s, s), 8), vol);
+        const __m256i hi = SDL_ScaleS16_AVX2(_mm256_srai_epi16(_mm256_unpackhi_epi8(s, s), 8), vol);
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_adds_epi8(d, _mm256_packs_epi16(lo, hi)));
+    }
+    return i;
+}
+
+static Uint32 SDL_TARGETING("avx2")
+SDL_MixAudio_U8_AVX2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m256i vol = _mm256_set1_epi16((Sint16) volume);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i offset = _mm256_set1_epi16(128);
+    const __m256i maxval = _mm256_set1_epi8((char) 0xFE);
+    Uint32 i;
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+        const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        const __m256i slo = SDL_ScaleS16_AVX2(_mm256_sub_epi16(_mm256_unpacklo_epi8(s, zero), offset), vol);
+        const __m256i shi = SDL_ScaleS16_AVX2(_mm256_sub_epi16(_mm256_unpackhi_epi8(s, zero), offset), vol);
+        const __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(d, zero), slo);
+        const __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(d, zero), shi);
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_min_epu8(_mm256_packus_epi16(lo, hi), maxval));
+    }
+    return i;
+}
+
+static Uint32 SDL_TARGETING("avx2")
+SDL_MixAudio_S16_AVX2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m256i vol = _mm256_set1_epi16((Sint16) volume);
+    Uint32 i;
+
+    if (volume == SDL_MIX_MAXVOLUME) {
+        for (i = 0; (i + 32) <= len; i += 32) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+            const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+            _mm256_storeu_si256((__m256i *) (dst + i), _mm256_adds_epi16(d, s));
+        }
+        return i;
+    }
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+        const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        const __m256i plo = _mm256_mullo_epi16(s, vol);
+        const __m256i phi = _mm256_mulhi_epi16(s, vol);
+        const __m256i lo = SDL_ScaleS32Product_AVX2(_mm256_unpacklo_epi16(plo, phi));
+        const __m256i hi = SDL_ScaleS32Product_AVX2(_mm256_unpackhi_epi16(plo, phi));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_adds_epi16(d, _mm256_packs_epi32(lo, hi)));
+    }
+    return i;
+}
+
+static Uint32 SDL_TARGETING("avx2")
+SDL_MixAudio_S32_AVX2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m256i vol = _mm256_set1_epi32(volume);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lomask = _mm256_set1_epi32(127);
+    Uint32 i;
+
+    if (volume == SDL_MIX_MAXVOLUME) {
+        for (i = 0; (i + 32) <= len; i += 32) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+            const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+            _mm256_storeu_si256((__m256i *) (dst + i), SDL_AddSaturateS32_AVX2(d, s));
+        }
+        return i;
+    }
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+        const __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        const __m256i loproduct = _mm256_mullo_epi32(_mm256_and_si256(s, lomask), vol);
+        const __m256i hiproduct = _mm256_mullo_epi32(_mm256_srai_epi32(s, 7), vol);
+        const __m256i floored = _mm256_add_epi32(hiproduct, _mm256_srli_epi32(loproduct, 7));
+        const __m256i inexact = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_and_si256(loproduct, lomask), zero), _mm256_srai_epi32(s, 31));
+        _mm256_storeu_si256((__m256i *) (dst + i), SDL_AddSaturateS32_AVX2(d, _mm256_sub_epi32(floored, inexact)));
+    }
+    return i;
+}
+
+static Uint32 SDL_TARGETING("avx2")
+SDL_MixAudio_F32_AVX2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const __m256 fvolume = _mm256_set1_ps((float) volume);
+    const __m256 fmaxvolume = _mm256_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m256 maxval = _mm256_set1_ps(3.402823466e+38F);
+    const __m256 minval = _mm256_set1_ps(-3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; (i + 32) <= len; i += 32) {
+        const __m256 s = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps((const float *) (src + i)), fvolume), fmaxvolume);
+        const __m256 sum = _mm256_add_ps(_mm256_loadu_ps((const float *) (dst + i)), s);
+        _mm256_storeu_ps((float *) (dst + i), _mm256_min_ps(maxval, _mm256_max_ps(minval, sum)));
+    }
+    return i;
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+static int16x8_t
+SDL_ScaleS16_NEON(const int16x8_t samples, const int16_t volume)
+{
+    const int16x8_t product = vmulq_n_s16(samples, volume);
+    const int16x8_t bias = vandq_s16(vshrq_n_s16(product, 15), vdupq_n_s16(127));
+    return vshrq_n_s16(vaddq_s16(product, bias), 7);
+}
+
+static int32x4_t
+SDL_ScaleS32Product_NEON(const int32x4_t product)
+{
+    const int32x4_t bias = vandq_s32(vshrq_n_s32(product, 31), vdupq_n_s32(127));
+    return vshrq_n_s32(vaddq_s32(product, bias), 7);
+}
+
+static int32x2_t
+SDL_ScaleS64Product_NEON(const int64x2_t product)
+{
+    const int64x2_t bias = vandq_s64(vshrq_n_s64(product, 63), vdupq_n_s64(127));
+    return vmovn_s64(vshrq_n_s64(vaddq_s64(product, bias), 7));
+}
+
+static Uint32
+SDL_MixAudio_S8_NEON(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const int8x16_t s = vld1q_s8((const int8_t *) (src + i));
+        const int8x16_t d = vld1q_s8((const int8_t *) (dst + i));
+        const int16x8_t lo = SDL_ScaleS16_NEON(vmovl_s8(vget_low_s8(s)), (int16_t) volume);
+        const int16x8_t hi = SDL_ScaleS16_NEON(vmovl_s8(vget_high_s8(s)), (int16_t) volume);
+        vst1q_s8((int8_t *) (dst + i), vqaddq_s8(d, vcombine_s8(vmovn_s16(lo), vmovn_s16(hi))));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_U8_NEON(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const int16x8_t offset = vdupq_n_s16(128);
+    const uint8x16_t maxval = vdupq_n_u8(0xFE);
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const uint8x16_t s = vld1q_u8(src + i);
+        const uint8x16_t d = vld1q_u8(dst + i);
+        const int16x8_t slo = SDL_ScaleS16_NEON(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(s))), offset), (int16_t) volume);
+        const int16x8_t shi = SDL_ScaleS16_NEON(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(s))), offset), (int16_t) volume);
+        const int16x8_t lo = vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(d))), slo);
+        const int16x8_t hi = vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(d))), shi);
+        vst1q_u8(dst + i, vminq_u8(vcombine_u8(vqmovun_s16(lo), vqmovun_s16(hi)), maxval));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_S16_NEON(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const int16x8_t s = vld1q_s16((const int16_t *) (src + i));
+        const int16x8_t d = vld1q_s16((const int16_t *) (dst + i));
+        int16x8_t scaled = s;
+        if (volume != SDL_MIX_MAXVOLUME) {
+            const int32x4_t lo = SDL_ScaleS32Product_NEON(vmull_n_s16(vget_low_s16(s), (int16_t) volume));
+            const int32x4_t hi = SDL_ScaleS32Product_NEON(vmull_n_s16(vget_high_s16(s), (int16_t) volume));
+            scaled = vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+        }
+        vst1q_s16((int16_t *) (dst + i), vqaddq_s16(d, scaled));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_S32_NEON(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const int32x4_t s = vld1q_s32((const int32_t *) (src + i));
+        const int32x4_t d = vld1q_s32((const int32_t *) (dst + i));
+        int32x4_t scaled = s;
+        if (volume != SDL_MIX_MAXVOLUME) {
+            /* NEON widens to 64 bits cheaply, so it doesn't need the split. */
+            const int32x2_t lo = SDL_ScaleS64Product_NEON(vmull_n_s32(vget_low_s32(s), volume));
+            const int32x2_t hi = SDL_ScaleS64Product_NEON(vmull_n_s32(vget_high_s32(s), volume));
+            scaled = vcombine_s32(lo, hi);
+        }
+        vst1q_s32((int32_t *) (dst + i), vqaddq_s32(d, scaled));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_F32_NEON(Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
+{
+    const float fvolume = (float) volume;
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    const float32x4_t maxval = vdupq_n_f32(3.402823466e+38F);
+    const float32x4_t minval = vdupq_n_f32(-3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; (i + 16) <= len; i += 16) {
+        const float32x4_t s = vmulq_n_f32(vmulq_n_f32(vld1q_f32((const float *) (src + i)), fvolume), fmaxvolume);
+        const float32x4_t sum = vaddq_f32(vld1q_f32((const float *) (dst + i)), s);
+        vst1q_f32((float *) (dst + i), vminq_f32(vmaxq_f32(sum, minval), maxval));
+    }
+    return i;
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+static SDL_MixFunc SDL_MixAudio_S8 = NULL;
+static SDL_MixFunc SDL_MixAudio_U8 = NULL;
+static SDL_MixFunc SDL_MixAudio_S16 = NULL;
+static SDL_MixFunc SDL_MixAudio_S32 = NULL;
+static SDL_MixFunc SDL_MixAudio_F32 = NULL;
+
+static void
+SDL_ChooseMixFuncs(void)
+{
+    static SDL_bool mixers_chosen = SDL_FALSE;
+
+    if (mixers_chosen) {
+        return;
+    }
+
+#define SET_MIX_FUNCS(fntype) \
+        SDL_MixAudio_S8 = SDL_MixAudio_S8_##fntype; \
+        SDL_MixAudio_U8 = SDL_MixAudio_U8_##fntype; \
+        SDL_MixAudio_S16 = SDL_MixAudio_S16_##fntype; \
+        SDL_MixAudio_S32 = SDL_MixAudio_S32_##fntype; \
+        SDL_MixAudio_F32 = SDL_MixAudio_F32_##fntype
+
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        SET_MIX_FUNCS(AVX2);
+    } else
+#endif
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        SET_MIX_FUNCS(SSE2);
+    } else
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        SET_MIX_FUNCS(NEON);
+    } else
+#endif
+    {
+        /* no SIMD; SDL_MixAudioFormat() mixes everything itself. */
+    }
+
+#undef SET_MIX_FUNCS
+
+    mixers_chosen = SDL_TRUE;
+}
+
+static SDL_MixFunc
+SDL_GetMixFunc(SDL_AudioFormat format)
+{
+    SDL_ChooseMixFuncs();
+
+    switch (format) {
+    case AUDIO_S8: return SDL_MixAudio_S8;
+    case AUDIO_U8: return SDL_MixAudio_U8;
+    case AUDIO_S16SYS: return SDL_MixAudio_S16;
+    case AUDIO_S32SYS: return SDL_MixAudio_S32;
+    case AUDIO_F32SYS: return SDL_MixAudio_F32;
+    default: return NULL;
+    }
+}
+
 
 void
 SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
@@ -94,6 +594,17 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
         return;
     }
 
+    /* let a SIMD mixer take all the whole vectors; the rest is mixed below. */
+    if ((volume > 0) && (volume <= SDL_MIX_MAXVOLUME)) {
+        const SDL_MixFunc mix = SDL_GetMixFunc(format);
+        if (mix) {
+            const Uint32 mixed = mix(dst, src, len, volume);
+            dst += mixed;
+            src += mixed;
+            len -= mixed;
+        }
+    }
+
     switch (format) {
 
     case AUDIO_U8:
@@ -366,4 +877,179 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
     }
 }
 
+
+/* The voice mixer sums every voice into one float bus, and only clips and
+   converts once at the end, instead of saturating into the output format
+   once per voice like SDL_MixAudioFormat() does. The bus is a single
+   callback's worth of samples, so it stays in cache across the voices. */
+
+void
+SDL_SetAudioVoiceGains(SDL_AudioVoice *voice, const int channels, const float gain, const float pan)
+{
+    /* Turn the far side down, leaving the near side at full gain. */
+    const float left = gain * ((pan > 0.0f) ? (1.0f - pan) : 1.0f);
+    const float right = gain * ((pan < 0.0f) ? (1.0f + pan) : 1.0f);
+    float *gains = voice->gains;
+    int i;
+
+    SDL_assert(channels <= 8);
+
+    for (i = 0; i < channels; i++) {
+        gains[i] = gain;
+    }
+
+    /* Pan the left/right pairs of SDL's channel layouts; center and LFE
+       channels just get the gain. */
+    switch (channels) {
+    case 8:  /* FL, FR, FC, LFE, BL, BR, SL, SR */
+        gains[6] = left;
+        gains[7] = right;
+        /* fallthrough */
+    case 6:  /* FL, FR, FC, LFE, BL, BR */
+        gains[4] = left;
+        gains[5] = right;
+        /* fallthrough */
+    case 2:
+        gains[0] = left;
+        gains[1] = right;
+        break;
+    case 4:  /* FL, FR, BL, BR */
+        gains[0] = gains[2] = left;
+        gains[1] = gains[3] = right;
+        break;
+    default:
+        break;
+    }
+
+    for (i = 1; i < SDL_AUDIO_VOICE_GAIN_FRAMES; i++) {
+        SDL_memcpy(gains + (i * channels), gains, channels * sizeof (float));
+    }
+}
+
+/* Add (samples) samples of (src) into (bus), scaled by (gains), which repeats
+   every (period) samples. */
+static void
+SDL_MixVoiceToBus_Scalar(float *bus, const float *src, const float *gains, const int period, int samples)
+{
+    int i = 0;
+    while (samples--) {
+        *(bus++) += *(src++) * gains[i];
+        if (++i == period) {
+            i = 0;
+        }
+    }
+}
+
+/* Clamp the bus to the float sample range, into (dst). */
+static void
+SDL_ClipBus_Scalar(float *dst, const float *bus, int samples)
+{
+    while (samples--) {
+        const float sample = *(bus++);
+        *(dst++) = (sample > 1.0f) ? 1.0f : ((sample < -1.0f) ? -1.0f : sample);
+    }
+}
+
+#if HAVE_SSE_INTRINSICS
+static void
+SDL_MixVoiceToBus_SSE(float *bus, const float *src, const float *gains, const int period, int samples)
+{
+    while (samples >= period) {
+        int i;
+        for (i = 0; i < period; i += 4) {
+            const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(gains + i));
+            _mm_storeu_ps(bus + i, _mm_add_ps(_mm_loadu_ps(bus + i), scaled));
+        }
+        bus += period;
+        src += period;
+        samples -= period;
+    }
+    SDL_MixVoiceToBus_Scalar(bus, src, gains, period, samples);
+}
+
+static void
+SDL_ClipBus_SSE(float *dst, const float *bus, int samples)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 negone = _mm_set1_ps(-1.0f);
+    while (samples >= 4) {
+        _mm_storeu_ps(dst, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(bus), negone), one));
+        dst += 4;
+        bus += 4;
+        samples -= 4;
+    }
+    SDL_ClipBus_Scalar(dst, bus, samples);
+}
+#define SDL_MixVoiceToBus SDL_MixVoiceToBus_SSE
+#define SDL_ClipBus SDL_ClipBus_SSE
+#elif HAVE_NEON_INTRINSICS
+static void
+SDL_MixVoiceToBus_NEON(float *bus, const float *src, const float *gains, const int period, int samples)
+{
+    while (samples >= period) {
+        int i;
+        for (i = 0; i < period; i += 4) {
+            vst1q_f32(bus + i, vmlaq_f32(vld1q_f32(bus + i), vld1q_f32(src + i), vld1q_f32(gains + i)));
+        }
+        bus += period;
+        src += period;
+        samples -= period;
+    }
+    SDL_MixVoiceToBus_Scalar(bus, src, gains, period, samples);
+}
+
+static void
+SDL_ClipBus_NEON(float *dst, const float *bus, int samples)
+{
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t negone = vdupq_n_f32(-1.0f);
+    while (samples >= 4) {
+        vst1q_f32(dst, vminq_f32(vmaxq_f32(vld1q_f32(bus), negone), one));
+        dst += 4;
+        bus += 4;
+        samples -= 4;
+    }
+    SDL_ClipBus_Scalar(dst, bus, samples);
+}
+#define SDL_MixVoiceToBus SDL_MixVoiceToBus_NEON
+#define SDL_ClipBus SDL_ClipBus_NEON
+#else
+#define SDL_MixVoiceToBus SDL_MixVoiceToBus_Scalar
+#define SDL_ClipBus SDL_ClipBus_Scalar
+#endif
+
+void
+SDL_MixAudioVoices(SDL_AudioDevice *device, Uint8 *data, int len)
+{
+    const int channels = device->callbackspec.channels;
+    const int samples = device->callbackspec.samples * channels;
+    const int buslen = samples * (int) sizeof (float);
+    float *bus = device->mix_bus;
+    SDL_AudioVoice *voice;
+
+    SDL_assert(len == (samples * (SDL_AUDIO_BITSIZE(device->callbackspec.format) / 8)));
+
+    SDL_memset(bus, '\0', buslen);
+    for (voice = device->voices; voice != NULL; voice = voice->next) {
+        const int got = SDL_AudioStreamGet(voice->stream, device->mix_scratch, buslen);
+        if (got > 0) {
+            SDL_MixVoiceToBus(bus, device->mix_scratch, voice->gains, channels * SDL_AUDIO_VOICE_GAIN_FRAMES, got / (int) sizeof (float));
+        }
+    }
+
+    if (device->callbackspec.format == AUDIO_F32SYS) {
+        SDL_ClipBus((float *) data, bus, samples);
+    } else {
+        /* the converters clamp as they go. */
+        device->mix_cvt.buf = (Uint8 *) bus;
+        device->mix_cvt.len = buslen;
+        if (SDL_ConvertAudio(&device->mix_cvt) < 0) {
+            SDL_memset(data, device->callbackspec.silence, len);
+        } else {
+            SDL_assert(device->mix_cvt.len_cvt == len);
+            SDL_memcpy(data, bus, len);
+        }
+    }
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -51,6 +51,25 @@ extern void SDL_RemoveAudioDevice(const int iscapture, void *handle);
    as appropriate so SDL's list of devices is accurate. */
 extern void SDL_OpenedAudioDeviceDisconnected(SDL_AudioDevice *device);
 
+/* A stream mixed into a playback device by SDL_MixAudioVoices(). gains holds
+   the voice's gain for each of the device's channels, repeated over
+   SDL_AUDIO_VOICE_GAIN_FRAMES frames so that it spans a whole number of
+   SIMD vectors whatever the channel count. */
+#define SDL_AUDIO_VOICE_GAIN_FRAMES 4
+typedef struct SDL_AudioVoice
+{
+    SDL_AudioStream *stream;
+    float gains[8 * SDL_AUDIO_VOICE_GAIN_FRAMES];
+    struct SDL_AudioVoice *next;
+} SDL_AudioVoice;
+
+/* Fill in a voice's gains for a device with (channels) channels. */
+extern void SDL_SetAudioVoiceGains(SDL_AudioVoice *voice, const int channels, const float gain, const float pan);
+
+/* Mix all of a device's voices into (data), in the callback's format, in
+   place of the callback. Call this with the device locked. */
+extern void SDL_MixAudioVoices(SDL_AudioDevice *device, Uint8 *data, int len);
+
 /* This is the size of a packet when using SDL_QueueAudio(). We allocate
    these as necessary and pool them, under the assumption that we'll
    eventually end up with a handful that keep recycling, meeting whatever
@@ -155,6 +174,13 @@ struct SDL_AudioDevice
     /* Size, in bytes, of work_buffer. */
     Uint32 work_buffer_len;
 
+    /* If the callback wants a different buffer size than the device, but the
+       same format, it fills the device's buffers directly. A callback's worth
+       that doesn't fit in one device buffer finishes at the end of
+       work_buffer, and this many bytes of it go into the next one. */
+    SDL_bool rebuffer;
+    Uint32 work_buffer_pending;
+
     /* A mutex for locking the mixing buffers */
     SDL_mutex *mixer_lock;
 
@@ -165,6 +191,14 @@ struct SDL_AudioDevice
     /* Queued buffers (if app not using callback). */
     SDL_DataQueue *buffer_queue;
 
+    /* Voices mixed in place of the callback, if any. The bus and scratch
+       buffers hold one callback's worth of float samples, and mix_cvt
+       converts the bus to the callback's format when that isn't float. */
+    SDL_AudioVoice *voices;
+    float *mix_bus;
+    float *mix_scratch;
+    SDL_AudioCVT mix_cvt;
+
     /* * * */
     /* Data private to this driver */
     struct SDL_PrivateAudioData *hidden;
@@ -32,6 +32,14 @@
 #endif
 #endif
 
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
 /* Microsoft WAVE file loading routines */
 
 #include "SDL_log.h"
@@ -39,6 +47,7 @@
 #include "SDL_audio.h"
 #include "SDL_wave.h"
 #include "SDL_audio_c.h"
+#include "SDL_cpuinfo.h"
 
 /* Reads the value stored at the location of the f1 pointer, multiplies it
  * with the second argument and then stores the result to f1.
@@ -333,6 +342,130 @@ WaveAdjustToFactValue(WaveFile *file, Sint64 sampleframes)
     return sampleframes;
 }
 
+/* Every ADPCM block starts with a header that resets the decoder state, so the
+ * blocks can be decoded independently of each other. Big files get their full
+ * blocks split into ranges which are decoded by the task pool.
+ */
+#define ADPCM_MAX_DECODER_THREADS 8
+#define ADPCM_MIN_BLOCKS_PER_THREAD 256
+
+typedef int (*ADPCM_BlockDecoder)(ADPCM_DecoderState *state);
+
+typedef struct ADPCM_DecoderJob
+{
+    ADPCM_DecoderState state;       /* Private copy of the decoder state. */
+    ADPCM_BlockDecoder decodeheader;
+    ADPCM_BlockDecoder decodedata;
+    size_t inputbase;               /* Input position of block 0. */
+    size_t outputbase;              /* Output position of block 0. */
+    size_t firstblock;
+    size_t lastblock;               /* One past the last block of the range. */
+    size_t decodedblock;            /* One past the last successfully decoded block. */
+} ADPCM_DecoderJob;
+
+static void SDLCALL
+ADPCM_DecodeBlockRange(void *data)
+{
+    ADPCM_DecoderJob *job = (ADPCM_DecoderJob *)data;
+    ADPCM_DecoderState *state = &job->state;
+    size_t block;
+
+    for (block = job->firstblock; block < job->lastblock; block++) {
+        state->block.data = state->input.data + job->inputbase + block * state->blocksize;
+        state->block.size = state->blocksize;
+        state->block.pos = 0;
+        state->output.pos = job->outputbase + block * state->samplesperblock * state->channels;
+        state->framesleft = state->samplesperblock;
+
+        if (job->decodeheader(state) == -1 || job->decodedata(state) == -1) {
+            break;
+        }
+    }
+
+    job->decodedblock = block;
+}
+
+/* Decodes the full blocks at the start of the remaining input on multiple
+ * threads and advances the state past them. Does nothing if there aren't
+ * enough blocks to make it worthwhile. A block that fails to decode ends the
+ * parallel part early; the serial loop of the caller will run into the same
+ * error again and handle it as usual.
+ */
+static void
+ADPCM_DecodeFullBlocks(ADPCM_DecoderState *state, size_t cstatesize, ADPCM_BlockDecoder decodeheader, ADPCM_BlockDecoder decodedata)
+{
+    ADPCM_DecoderJob *jobs;
+    SDL_TaskGroup *group;
+    Uint8 *cstates;
+    size_t fullblocks, decodedblocks, blocksperthread;
+    int i, numthreads;
+
+    fullblocks = (state->input.size - state->input.pos) / state->blocksize;
+    if ((Uint64)state->framesleft / state->samplesperblock < fullblocks) {
+        fullblocks = (size_t)(state->framesleft / state->samplesperblock);
+    }
+    /* Small files never touch the task pool, so loading them doesn't start it. */
+    if (fullblocks < 2 * ADPCM_MIN_BLOCKS_PER_THREAD) {
+        return;
+    }
+
+    numthreads = SDL_min(SDL_GetTaskPoolThreadCount() + 1, ADPCM_MAX_DECODER_THREADS);
+    if ((size_t)numthreads > fullblocks / ADPCM_MIN_BLOCKS_PER_THREAD) {
+        numthreads = (int)(fullblocks / ADPCM_MIN_BLOCKS_PER_THREAD);
+    }
+    if (numthreads < 2) {
+        return;
+    }
+
+    jobs = (ADPCM_DecoderJob *)SDL_calloc(numthreads, sizeof(ADPCM_DecoderJob));
+    cstates = (Uint8 *)SDL_calloc((size_t)numthreads * state->channels, cstatesize);
+    if (jobs == NULL || cstates == NULL) {
+        /* Not fatal, the caller decodes everything on its own. */
+        SDL_free(jobs);
+        SDL_free(cstates);
+        return;
+    }
+
+    blocksperthread = (fullblocks + numthreads - 1) / numthreads;
+    for (i = 0; i < numthreads; i++) {
+        ADPCM_DecoderJob *job = &jobs[i];
+        job->state = *state;
+        job->state.cstate = cstates + (size_t)i * state->channels * cstatesize;
+        job->decodeheader = decodeheader;
+        job->decodedata = decodedata;
+        job->inputbase = state->input.pos;
+        job->outputbase = state->output.pos;
+        job->firstblock = SDL_min(fullblocks, i * blocksperthread);
+        job->lastblock = SDL_min(fullblocks, job->firstblock + blocksperthread);
+    }
+
+    /* The calling thread takes the first range and every range that couldn't be queued. */
+    group = SDL_CreateTaskGroup();
+    for (i = 1; i < numthreads; i++) {
+        if (group == NULL || SDL_RunTask(group, ADPCM_DecodeBlockRange, &jobs[i]) < 0) {
+            ADPCM_DecodeBlockRange(&jobs[i]);
+        }
+    }
+    ADPCM_DecodeBlockRange(&jobs[0]);
+    SDL_DestroyTaskGroup(group);
+
+    /* Only the blocks before the first failure are done. */
+    decodedblocks = fullblocks;
+    for (i = 0; i < numthreads; i++) {
+        ADPCM_DecoderJob *job = &jobs[i];
+        if (job->decodedblock < job->lastblock && job->decodedblock < decodedblocks) {
+            decodedblocks = job->decodedblock;
+        }
+    }
+
+    state->input.pos += decodedblocks * state->blocksize;
+    state->output.pos += decodedblocks * state->samplesperblock * state->channels;
+    state->framesleft -= (Sint64)(decodedblocks * state->samplesperblock);
+
+    SDL_free(jobs);
+    SDL_free(cstates);
+}
+
 static int
 MS_ADPCM_CalculateSampleFrames(WaveFile *file, size_t datalength)
 {
@@ -694,6 +827,8 @@ MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 
     state.cstate = cstate;
 
+    ADPCM_DecodeFullBlocks(&state, sizeof(MS_ADPCM_ChannelState), MS_ADPCM_DecodeBlockHeader, MS_ADPCM_DecodeBlockData);
+
     /* Decode block by block. A truncated block will stop the decoding. */
     bytesleft = state.input.size - state.input.pos;
     while (state.framesleft > 0 && bytesleft >= state.blockheadersize) {
@@ -1092,6 +1227,8 @@ IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     }
     state.cstate = cstate;
 
+    ADPCM_DecodeFullBlocks(&state, sizeof(Sint8), IMA_ADPCM_DecodeBlockHeader, IMA_ADPCM_DecodeBlockData);
+
     /* Decode block by block. A truncated block will stop the decoding. */
     bytesleft = state.input.size - state.input.pos;
     while (state.framesleft > 0 && bytesleft >= state.blockheadersize) {
@@ -1167,8 +1304,128 @@ LAW_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* The SIMD expanders compute the same formulas as the scalar code in LAW_Decode
+ * for 8 samples at once. They work backwards from sample i like the scalar
+ * loops, so the in-place expansion never overwrites input that hasn't been
+ * loaded yet. Returns the number of samples left for the scalar loops.
+ */
+#if HAVE_SSE2_INTRINSICS
+/* SSE2 has no variable 16-bit shifts, build 2^s (s < 8) for a multiplication. */
+static SDL_INLINE __m128i
+LAW_PowerOfTwo_SSE2(const __m128i s)
+{
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i b0 = _mm_and_si128(s, one);
+    const __m128i b1 = _mm_and_si128(_mm_srli_epi16(s, 1), one);
+    const __m128i b2 = _mm_and_si128(_mm_srli_epi16(s, 2), one);
+    __m128i p = _mm_add_epi16(one, b0);
+    p = _mm_mullo_epi16(p, _mm_add_epi16(one, _mm_mullo_epi16(b1, _mm_set1_epi16(3))));
+    return _mm_mullo_epi16(p, _mm_add_epi16(one, _mm_mullo_epi16(b2, _mm_set1_epi16(15))));
+}
+
+static size_t
+LAW_ExpandALaw_SSE2(const Uint8 *src, Sint16 *dst, size_t i)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+
+    while (i >= 8) {
+        const __m128i nibble = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + i - 8)), zero);
+        const __m128i bits = _mm_xor_si128(_mm_and_si128(nibble, _mm_set1_epi16(0x7f)), _mm_set1_epi16(0x55));
+        const __m128i exponent = _mm_srli_epi16(bits, 4);
+        const __m128i negative = _mm_cmpeq_epi16(_mm_and_si128(nibble, _mm_set1_epi16(0x80)), zero);
+        __m128i mantissa = _mm_and_si128(bits, _mm_set1_epi16(0xf));
+
+        mantissa = _mm_or_si128(mantissa, _mm_and_si128(_mm_cmpgt_epi16(exponent, zero), _mm_set1_epi16(0x10)));
+        mantissa = _mm_or_si128(_mm_slli_epi16(mantissa, 4), _mm_set1_epi16(0x8));
+        mantissa = _mm_mullo_epi16(mantissa, LAW_PowerOfTwo_SSE2(_mm_subs_epu16(exponent, one)));
+        mantissa = _mm_sub_epi16(_mm_xor_si128(mantissa, negative), negative);
+
+        i -= 8;
+        _mm_storeu_si128((__m128i *)(dst + i), mantissa);
+    }
+
+    return i;
+}
+
+static size_t
+LAW_ExpandMuLaw_SSE2(const Uint8 *src, Sint16 *dst, size_t i)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(132);
+
+    while (i >= 8) {
+        const __m128i raw = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + i - 8)), zero);
+        const __m128i nibble = _mm_xor_si128(raw, _mm_set1_epi16(0xff));
+        const __m128i exponent = _mm_and_si128(_mm_srli_epi16(nibble, 4), _mm_set1_epi16(0x7));
+        const __m128i negative = _mm_cmpeq_epi16(_mm_and_si128(nibble, _mm_set1_epi16(0x80)), _mm_set1_epi16(0x80));
+        __m128i mantissa = _mm_and_si128(nibble, _mm_set1_epi16(0xf));
+
+        /* (0x80 << e) + (8 << e) * m + (4 << e) - 132 */
+        mantissa = _mm_add_epi16(_mm_slli_epi16(mantissa, 3), bias);
+        mantissa = _mm_sub_epi16(_mm_mullo_epi16(mantissa, LAW_PowerOfTwo_SSE2(exponent)), bias);
+        mantissa = _mm_sub_epi16(_mm_xor_si128(mantissa, negative), negative);
+
+        i -= 8;
+        _mm_storeu_si128((__m128i *)(dst + i), mantissa);
+    }
+
+    return i;
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static size_t
+LAW_ExpandALaw_NEON(const Uint8 *src, Sint16 *dst, size_t i)
+{
+    const int16x8_t zero = vdupq_n_s16(0);
+
+    while (i >= 8) {
+        const int16x8_t nibble = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src + i - 8)));
+        const int16x8_t bits = veorq_s16(vandq_s16(nibble, vdupq_n_s16(0x7f)), vdupq_n_s16(0x55));
+        const int16x8_t exponent = vshrq_n_s16(bits, 4);
+        int16x8_t mantissa = vandq_s16(bits, vdupq_n_s16(0xf));
+
+        mantissa = vorrq_s16(mantissa, vandq_s16(vreinterpretq_s16_u16(vcgtq_s16(exponent, zero)), vdupq_n_s16(0x10)));
+        mantissa = vorrq_s16(vshlq_n_s16(mantissa, 4), vdupq_n_s16(0x8));
+        mantissa = vshlq_s16(mantissa, vmaxq_s16(vsubq_s16(exponent, vdupq_n_s16(1)), zero));
+        mantissa = vbslq_s16(vtstq_s16(nibble, vdupq_n_s16(0x80)), mantissa, vnegq_s16(mantissa));
+
+        i -= 8;
+        vst1q_s16(dst + i, mantissa);
+    }
+
+    return i;
+}
+
+static size_t
+LAW_ExpandMuLaw_NEON(const Uint8 *src, Sint16 *dst, size_t i)
+{
+    const int16x8_t bias = vdupq_n_s16(132);
+
+    while (i >= 8) {
+        const int16x8_t nibble = vreinterpretq_s16_u16(vmovl_u8(vmvn_u8(vld1_u8(src + i - 8))));
+        const int16x8_t exponent = vandq_s16(vshrq_n_s16(nibble, 4), vdupq_n_s16(0x7));
+        int16x8_t mantissa = vandq_s16(nibble, vdupq_n_s16(0xf));
+
+        /* (0x80 << e) + (8 << e) * m + (4 << e) - 132 */
+        mantissa = vaddq_s16(vshlq_n_s16(mantissa, 3), bias);
+        mantissa = vsubq_s16(vshlq_s16(mantissa, exponent), bias);
+        mantissa = vbslq_s16(vtstq_s16(nibble, vdupq_n_s16(0x80)), vnegq_s16(mantissa), mantissa);
+
+        i -= 8;
+        vst1q_s16(dst + i, mantissa);
+    }
+
+    return i;
+}
+#endif
+
+/* Expands sample_count companded bytes to 16-bit samples in place. The buffer
+ * must already be big enough for the expanded data.
+ */
 static int
-LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+LAW_Expand(Uint16 encoding, Uint8 *src, size_t sample_count)
 {
 #ifdef SDL_WAVE_LAW_LUT
     const Sint16 alaw_lut[256] = {
@@ -1209,53 +1466,32 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     };
 #endif
 
-    WaveFormat *format = &file->format;
-    WaveChunk *chunk = &file->chunk;
-    size_t i, sample_count, expanded_len;
-    Uint8 *src;
-    Sint16 *dst;
-
-    if (chunk->length != chunk->size) {
-        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
-        if (file->sampleframes < 0) {
-            return -1;
-        }
-    }
-
-    /* Nothing to decode, nothing to return. */
-    if (file->sampleframes == 0) {
-        *audio_buf = NULL;
-        *audio_len = 0;
-        return 0;
-    }
-
-    sample_count = (size_t)file->sampleframes;
-    if (SafeMult(&sample_count, format->channels)) {
-        return SDL_OutOfMemory();
-    }
-
-    expanded_len = sample_count;
-    if (SafeMult(&expanded_len, sizeof(Sint16))) {
-        return SDL_OutOfMemory();
-    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
-        return SDL_SetError("WAVE file too big");
-    }
-
-    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
-    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
-    if (src == NULL) {
-        return SDL_OutOfMemory();
-    }
-    chunk->data = NULL;
-    chunk->size = 0;
-
-    dst = (Sint16 *)src;
+    Sint16 *dst = (Sint16 *)src;
+    size_t i;
 
     /* Work backwards, since we're expanding in-place. SDL_AudioSpec.format will
      * inform the caller about the byte order.
      */
     i = sample_count;
-    switch (file->format.encoding) {
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        if (encoding == ALAW_CODE) {
+            i = LAW_ExpandALaw_SSE2(src, dst, i);
+        } else if (encoding == MULAW_CODE) {
+            i = LAW_ExpandMuLaw_SSE2(src, dst, i);
+        }
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        if (encoding == ALAW_CODE) {
+            i = LAW_ExpandALaw_NEON(src, dst, i);
+        } else if (encoding == MULAW_CODE) {
+            i = LAW_ExpandMuLaw_NEON(src, dst, i);
+        }
+    }
+#endif
+    switch (encoding) {
 #ifdef SDL_WAVE_LAW_LUT
     case ALAW_CODE:
         while (i--) {
@@ -1300,10 +1536,59 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         break;
 #endif
     default:
-        SDL_free(src);
         return SDL_SetError("Unknown companded encoding");
     }
 
+    return 0;
+}
+
+static int
+LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    size_t sample_count, expanded_len;
+    Uint8 *src;
+
+    if (chunk->length != chunk->size) {
+        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
+        if (file->sampleframes < 0) {
+            return -1;
+        }
+    }
+
+    /* Nothing to decode, nothing to return. */
+    if (file->sampleframes == 0) {
+        *audio_buf = NULL;
+        *audio_len = 0;
+        return 0;
+    }
+
+    sample_count = (size_t)file->sampleframes;
+    if (SafeMult(&sample_count, format->channels)) {
+        return SDL_OutOfMemory();
+    }
+
+    expanded_len = sample_count;
+    if (SafeMult(&expanded_len, sizeof(Sint16))) {
+        return SDL_OutOfMemory();
+    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
+        return SDL_SetError("WAVE file too big");
+    }
+
+    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
+    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
+    if (src == NULL) {
+        return SDL_OutOfMemory();
+    }
+    chunk->data = NULL;
+    chunk->size = 0;
+
+    if (LAW_Expand(format->encoding, src, sample_count) < 0) {
+        SDL_free(src);
+        return -1;
+    }
+
     *audio_buf = src;
     *audio_len = (Uint32)expanded_len;
 
@@ -1353,12 +1638,57 @@ PCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Widens sample_count 24-bit samples to 32 bits in place. The buffer must
+ * already be big enough for the widened data.
+ */
+static void
+PCM_ExpandSint24ToSint32(Uint8 *ptr, size_t sample_count)
+{
+    size_t i;
+
+    /* work from end to start, since we're expanding in-place. */
+    i = sample_count;
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        /* Deinterleave 8 samples into three byte planes and store them back
+         * with a zero plane as the least significant byte.
+         */
+        const uint8x8_t zero = vdup_n_u8(0);
+        while (i >= 8) {
+            uint8x8x3_t in;
+            uint8x8x4_t out;
+            i -= 8;
+            in = vld3_u8(ptr + i * 3);
+            out.val[0] = zero;
+            out.val[1] = in.val[0];
+            out.val[2] = in.val[1];
+            out.val[3] = in.val[2];
+            vst4_u8(ptr + i * 4, out);
+        }
+    }
+#endif
+    for (; i > 0; i--) {
+        const size_t o = i - 1;
+        uint8_t b[4];
+
+        b[0] = 0;
+        b[1] = ptr[o * 3];
+        b[2] = ptr[o * 3 + 1];
+        b[3] = ptr[o * 3 + 2];
+
+        ptr[o * 4 + 0] = b[0];
+        ptr[o * 4 + 1] = b[1];
+        ptr[o * 4 + 2] = b[2];
+        ptr[o * 4 + 3] = b[3];
+    }
+}
+
 static int
 PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, expanded_len, sample_count;
+    size_t expanded_len, sample_count;
     Uint8 *ptr;
 
     sample_count = (size_t)file->sampleframes;
@@ -1386,21 +1716,7 @@ PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     *audio_buf = ptr;
     *audio_len = (Uint32)expanded_len;
 
-    /* work from end to start, since we're expanding in-place. */
-    for (i = sample_count; i > 0; i--) {
-        const size_t o = i - 1;
-        uint8_t b[4];
-
-        b[0] = 0;
-        b[1] = ptr[o * 3];
-        b[2] = ptr[o * 3 + 1];
-        b[3] = ptr[o * 3 + 2];
-
-        ptr[o * 4 + 0] = b[0];
-        ptr[o * 4 + 1] = b[1];
-        ptr[o * 4 + 2] = b[2];
-        ptr[o * 4 + 3] = b[3];
-    }
+    PCM_ExpandSint24ToSint32(ptr, sample_count);
 
     return 0;
 }
@@ -1784,8 +2100,11 @@ WaveCheckFormat(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Parses the RIFF structure and the fmt chunk and fills spec. Leaves the data
+ * chunk information in file->chunk without reading its data.
+ */
 static int
-WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+WaveLoadHeader(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Sint64 *endposition)
 {
     int result;
     Uint32 chunkcount = 0;
@@ -1996,11 +2315,75 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
     WaveDebugDumpFormat(file, RIFFchunk.length, fmtchunk.length, datachunk.length);
 #endif
 
+    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
+     * by checks earlier in this function.
+     */
+    SDL_zerop(spec);
+    spec->freq = format->frequency;
+    spec->channels = (Uint8)format->channels;
+    spec->samples = 4096;       /* Good default buffer size */
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+    case ALAW_CODE:
+    case MULAW_CODE:
+        /* These can be easily stored in the byte order of the system. */
+        spec->format = AUDIO_S16SYS;
+        break;
+    case IEEE_FLOAT_CODE:
+        spec->format = AUDIO_F32LSB;
+        break;
+    case PCM_CODE:
+        switch (format->bitspersample) {
+        case 8:
+            spec->format = AUDIO_U8;
+            break;
+        case 16:
+            spec->format = AUDIO_S16LSB;
+            break;
+        case 24: /* Has been shifted to 32 bits. */
+        case 32:
+            spec->format = AUDIO_S32LSB;
+            break;
+        default:
+            /* Just in case something unexpected happened in the checks. */
+            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
+        }
+        break;
+    }
+
+    spec->silence = SDL_SilenceValueForFormat(spec->format);
+
+    /* The position after the RIFF data, where src is left after loading. */
+    if (RIFFlengthknown) {
+        *endposition = RIFFend;
+    } else {
+        *endposition = lastchunkpos;
+    }
+
     WaveFreeChunkData(chunk);
 
-    /* Process data chunk. */
+    /* The data chunk gets processed by the caller. */
     *chunk = datachunk;
 
+    return 0;
+}
+
+static int
+WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    int result;
+    Sint64 endposition = 0;
+    SDL_AudioSpec wavespec;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+
+    if (WaveLoadHeader(src, file, &wavespec, &endposition) < 0) {
+        return -1;
+    }
+
+    /* Process data chunk. */
     if (chunk->length > 0) {
         result = WaveReadChunkData(src, chunk);
         if (result == -1) {
@@ -2044,52 +2427,10 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
         break;
     }
 
-    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
-     * by checks earlier in this function.
-     */
-    SDL_zerop(spec);
-    spec->freq = format->frequency;
-    spec->channels = (Uint8)format->channels;
-    spec->samples = 4096;       /* Good default buffer size */
-
-    switch (format->encoding) {
-    case MS_ADPCM_CODE:
-    case IMA_ADPCM_CODE:
-    case ALAW_CODE:
-    case MULAW_CODE:
-        /* These can be easily stored in the byte order of the system. */
-        spec->format = AUDIO_S16SYS;
-        break;
-    case IEEE_FLOAT_CODE:
-        spec->format = AUDIO_F32LSB;
-        break;
-    case PCM_CODE:
-        switch (format->bitspersample) {
-        case 8:
-            spec->format = AUDIO_U8;
-            break;
-        case 16:
-            spec->format = AUDIO_S16LSB;
-            break;
-        case 24: /* Has been shifted to 32 bits. */
-        case 32:
-            spec->format = AUDIO_S32LSB;
-            break;
-        default:
-            /* Just in case something unexpected happened in the checks. */
-            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
-        }
-        break;
-    }
-
-    spec->silence = SDL_SilenceValueForFormat(spec->format);
+    *spec = wavespec;
 
     /* Report the end position back to the cleanup code. */
-    if (RIFFlengthknown) {
-        chunk->position = RIFFend;
-    } else {
-        chunk->position = lastchunkpos;
-    }
+    chunk->position = endposition;
 
     return 0;
 }
@@ -2153,4 +2494,379 @@ SDL_FreeWAV(Uint8 *audio_buf)
     SDL_free(audio_buf);
 }
 
+/* Number of sample frames that get decoded at once for the formats that don't
+ * come in blocks.
+ */
+#define WAVE_STREAM_UNIT_FRAMES 4096
+
+struct _SDL_WAVStream
+{
+    SDL_RWops *src;
+    int freesrc;
+    WaveFile file;
+    Sint64 endposition;       /* Where src is left when the stream gets closed. */
+    size_t datalength;        /* Number of bytes of the data chunk that are in src. */
+    size_t unitframes;        /* Number of sample frames in a decoding unit. */
+    size_t unitsize;          /* Encoded size of a decoding unit in bytes. */
+    size_t framesize;         /* Decoded size of a sample frame in bytes. */
+    Sint64 position;          /* Next sample frame to read. */
+    Sint64 unit;              /* Index of the unit in the output buffer, or -1. */
+    size_t unitframesdecoded; /* Number of sample frames of that unit in the output buffer. */
+    Uint8 *input;             /* Encoded ADPCM block. */
+    Uint8 *output;            /* Decoded data of one unit. */
+    void *cstate;             /* ADPCM channel states. */
+};
+
+/* Recalculates the number of sample frames for a data chunk that is shorter than
+ * its header says, like the decoders do when they couldn't read all of it.
+ */
+static int
+WaveCalculateSampleFrames(WaveFile *file, size_t datalength)
+{
+    switch (file->format.encoding) {
+    case MS_ADPCM_CODE:
+        return MS_ADPCM_CalculateSampleFrames(file, datalength);
+    case IMA_ADPCM_CODE:
+        return IMA_ADPCM_CalculateSampleFrames(file, datalength);
+    default:
+        file->sampleframes = WaveAdjustToFactValue(file, datalength / file->format.blockalign);
+        return file->sampleframes < 0 ? -1 : 0;
+    }
+}
+
+static int
+WaveStreamOpen(SDL_WAVStream *stream, SDL_AudioSpec *spec)
+{
+    WaveFile *file = &stream->file;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    SDL_AudioSpec wavespec;
+    Sint64 srcsize;
+    size_t outputsize;
+
+    if (WaveLoadHeader(stream->src, file, &wavespec, &stream->endposition) < 0) {
+        return -1;
+    }
+
+    /* Check how much of the data chunk is actually there. */
+    stream->datalength = chunk->length;
+    srcsize = SDL_RWsize(stream->src);
+    if (srcsize >= 0 && srcsize - chunk->position < (Sint64)chunk->length) {
+        /* I/O issues or corrupt file. */
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            return SDL_SetError("Could not read data of WAVE data chunk");
+        }
+        stream->datalength = srcsize > chunk->position ? (size_t)(srcsize - chunk->position) : 0;
+        if (WaveCalculateSampleFrames(file, stream->datalength) < 0) {
+            return -1;
+        }
+    }
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+        stream->unitframes = format->samplesperblock;
+        stream->unitsize = format->blockalign;
+        stream->framesize = format->channels * sizeof(Sint16);
+        stream->input = (Uint8 *)SDL_malloc(stream->unitsize);
+        /* Big enough for the channel states of both decoders. */
+        stream->cstate = SDL_calloc(format->channels, sizeof(MS_ADPCM_ChannelState));
+        if (stream->input == NULL || stream->cstate == NULL) {
+            return SDL_OutOfMemory();
+        }
+        break;
+    case ALAW_CODE:
+    case MULAW_CODE:
+        stream->unitframes = WAVE_STREAM_UNIT_FRAMES;
+        stream->unitsize = WAVE_STREAM_UNIT_FRAMES * format->blockalign;
+        stream->framesize = format->channels * sizeof(Sint16);
+        break;
+    default:
+        stream->unitframes = WAVE_STREAM_UNIT_FRAMES;
+        stream->unitsize = WAVE_STREAM_UNIT_FRAMES * format->blockalign;
+        /* 24-bit samples get shifted to 32 bits. */
+        stream->framesize = format->bitspersample == 24 ? format->channels * sizeof(Sint32) : format->blockalign;
+        break;
+    }
+
+    outputsize = stream->unitframes;
+    if (SafeMult(&outputsize, stream->framesize)) {
+        return SDL_OutOfMemory();
+    }
+    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
+    stream->output = (Uint8 *)SDL_malloc(outputsize ? outputsize : 1);
+    if (stream->output == NULL) {
+        return SDL_OutOfMemory();
+    }
+
+    *spec = wavespec;
+
+    return 0;
+}
+
+/* Decodes the ADPCM block in the input buffer. Returns the number of sample
+ * frames that were decoded, or -1 on error. A truncated block is an error
+ * with the strict truncation hints, like in SDL_LoadWAV_RW().
+ */
+static Sint64
+WaveStreamDecodeBlock(SDL_WAVStream *stream, size_t blocklength, Sint64 frames)
+{
+    WaveFile *file = &stream->file;
+    ADPCM_DecoderState state;
+    int result;
+
+    SDL_zero(state);
+    state.channels = file->format.channels;
+    state.blocksize = file->format.blockalign;
+    state.samplesperblock = file->format.samplesperblock;
+    state.framesize = stream->framesize;
+    state.ddata = file->decoderdata;
+    state.cstate = stream->cstate;
+    state.framestotal = frames;
+    state.framesleft = frames;
+
+    state.block.data = stream->input;
+    state.block.size = blocklength;
+    state.block.pos = 0;
+
+    state.output.data = (Sint16 *)stream->output;
+    state.output.size = stream->unitframes * state.channels;
+    state.output.pos = 0;
+
+    if (file->format.encoding == MS_ADPCM_CODE) {
+        state.blockheadersize = (size_t)state.channels * 7;
+        if (blocklength < state.blockheadersize) {
+            result = -1;
+        } else if (MS_ADPCM_DecodeBlockHeader(&state) == -1) {
+            return -1;
+        } else {
+            result = MS_ADPCM_DecodeBlockData(&state);
+        }
+    } else {
+        state.blockheadersize = (size_t)state.channels * 4;
+        if (blocklength < state.blockheadersize) {
+            result = -1;
+        } else {
+            result = IMA_ADPCM_DecodeBlockHeader(&state);
+            if (result == 0) {
+                result = IMA_ADPCM_DecodeBlockData(&state);
+            }
+        }
+    }
+
+    if (result == -1) {
+        /* Unexpected end of the block. Keep the complete sample frames only if
+         * the hint asks for it, like SDL_LoadWAV_RW() does.
+         */
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            return SDL_SetError("Truncated data chunk");
+        } else if (file->trunchint != TruncDropFrame) {
+            return 0;
+        }
+    }
+
+    return SDL_min(frames, (Sint64)(state.output.pos / state.channels));
+}
+
+static int
+WaveStreamDecodeUnit(SDL_WAVStream *stream, Sint64 unit)
+{
+    WaveFile *file = &stream->file;
+    WaveFormat *format = &file->format;
+    const size_t offset = (size_t)unit * stream->unitsize;
+    const Sint64 position = file->chunk.position + (Sint64)offset;
+    Uint8 *data = stream->input != NULL ? stream->input : stream->output;
+    Sint64 frames = file->sampleframes - unit * (Sint64)stream->unitframes;
+    size_t length = 0, readlength = 0;
+
+    if (frames > (Sint64)stream->unitframes) {
+        frames = stream->unitframes;
+    }
+    if (offset < stream->datalength) {
+        length = SDL_min(stream->unitsize, stream->datalength - offset);
+    }
+
+    stream->unit = -1;
+
+    if (length > 0) {
+        if (SDL_RWseek(stream->src, position, RW_SEEK_SET) != position) {
+            return SDL_SetError("Could not seek data of WAVE data chunk");
+        }
+        readlength = SDL_RWread(stream->src, data, 1, length);
+        if (readlength != length) {
+            /* I/O issues or corrupt file. */
+            if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+                return SDL_SetError("Could not read data of WAVE data chunk");
+            }
+        }
+    }
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+        frames = WaveStreamDecodeBlock(stream, readlength, frames);
+        if (frames < 0) {
+            return -1;
+        }
+        break;
+    case ALAW_CODE:
+    case MULAW_CODE:
+        frames = SDL_min(frames, (Sint64)(readlength / format->blockalign));
+        if (LAW_Expand(format->encoding, data, (size_t)frames * format->channels) < 0) {
+            return -1;
+        }
+        break;
+    default:
+        frames = SDL_min(frames, (Sint64)(readlength / format->blockalign));
+        if (format->bitspersample == 24) {
+            PCM_ExpandSint24ToSint32(data, (size_t)frames * format->channels);
+        }
+        break;
+    }
+
+    stream->unit = unit;
+    stream->unitframesdecoded = (size_t)frames;
+
+    return 0;
+}
+
+SDL_WAVStream *
+SDL_OpenWAVStream_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec)
+{
+    SDL_WAVStream *stream;
+
+    /* Make sure we are passed a valid data source */
+    if (src == NULL) {
+        /* Error may come from RWops. */
+        return NULL;
+    } else if (spec == NULL) {
+        SDL_InvalidParamError("spec");
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+
+    stream = (SDL_WAVStream *)SDL_calloc(1, sizeof(SDL_WAVStream));
+    if (stream == NULL) {
+        SDL_OutOfMemory();
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+
+    stream->src = src;
+    stream->freesrc = freesrc;
+    stream->endposition = SDL_RWtell(src);
+    stream->unit = -1;
+    stream->file.riffhint = WaveGetRiffSizeHint();
+    stream->file.trunchint = WaveGetTruncationHint();
+    stream->file.facthint = WaveGetFactChunkHint();
+
+    if (WaveStreamOpen(stream, spec) < 0) {
+        SDL_CloseWAVStream(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+int
+SDL_WAVStreamRead(SDL_WAVStream *stream, void *buf, int frames)
+{
+    Uint8 *dst = (Uint8 *)buf;
+    int total = 0;
+
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (buf == NULL) {
+        return SDL_InvalidParamError("buf");
+    } else if (frames < 0) {
+        return SDL_InvalidParamError("frames");
+    }
+
+    while (total < frames && stream->position < stream->file.sampleframes) {
+        const Sint64 unit = stream->position / (Sint64)stream->unitframes;
+        size_t offset, count;
+
+        if (unit != stream->unit && WaveStreamDecodeUnit(stream, unit) < 0) {
+            return -1;
+        }
+
+        offset = (size_t)(stream->position - unit * (Sint64)stream->unitframes);
+        if (offset >= stream->unitframesdecoded) {
+            /* The data ended early. There's nothing more to read. */
+            if (stream->file.trunchint == TruncVeryStrict || stream->file.trunchint == TruncStrict) {
+                return SDL_SetError("Truncated data chunk");
+            }
+            stream->file.sampleframes = stream->position;
+            break;
+        }
+
+        count = SDL_min(stream->unitframesdecoded - offset, (size_t)(frames - total));
+        SDL_memcpy(dst, stream->output + offset * stream->framesize, count * stream->framesize);
+        dst += count * stream->framesize;
+        total += (int)count;
+        stream->position += count;
+    }
+
+    return total;
+}
+
+int
+SDL_WAVStreamSeek(SDL_WAVStream *stream, Sint64 frame)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+
+    if (frame < 0) {
+        frame = 0;
+    } else if (frame > stream->file.sampleframes) {
+        frame = stream->file.sampleframes;
+    }
+    stream->position = frame;
+
+    return 0;
+}
+
+Sint64
+SDL_WAVStreamTell(SDL_WAVStream *stream)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+    return stream->position;
+}
+
+Sint64
+SDL_WAVStreamLength(SDL_WAVStream *stream)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+    return stream->file.sampleframes;
+}
+
+void
+SDL_CloseWAVStream(SDL_WAVStream *stream)
+{
+    if (stream == NULL) {
+        return;
+    }
+
+    if (stream->freesrc) {
+        SDL_RWclose(stream->src);
+    } else {
+        SDL_RWseek(stream->src, stream->endposition, RW_SEEK_SET);
+    }
+    WaveFreeChunkData(&stream->file.chunk);
+    SDL_free(stream->file.decoderdata);
+    SDL_free(stream->input);
+    SDL_free(stream->output);
+    SDL_free(stream->cstate);
+    SDL_free(stream);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
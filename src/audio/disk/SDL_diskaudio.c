@@ -42,6 +42,7 @@
 #define DISKENVR_INFILE         "SDL_DISKAUDIOFILEIN"
 #define DISKDEFAULT_INFILE      "sdlaudio-in.raw"
 #define DISKENVR_IODELAY      "SDL_DISKAUDIODELAY"
+#define DISKENVR_SAMPLES      "SDL_DISKAUDIOSAMPLES"
 
 /* This function waits until it is possible to write a full sound buffer */
 static void
@@ -132,6 +133,7 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     /* handle != NULL means "user specified the placeholder name on the fake detected device list" */
     const char *fname = get_filename(iscapture, handle ? NULL : devname);
     const char *envr = SDL_getenv(DISKENVR_IODELAY);
+    const char *samples = SDL_getenv(DISKENVR_SAMPLES);
 
     this->hidden = (struct SDL_PrivateAudioData *)
         SDL_malloc(sizeof(*this->hidden));
@@ -140,6 +142,12 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     }
     SDL_zerop(this->hidden);
 
+    /* Act like hardware with a fixed buffer size, to test rebuffering */
+    if (samples != NULL && SDL_atoi(samples) > 0) {
+        this->spec.samples = (Uint16) SDL_atoi(samples);
+        SDL_CalculateAudioSpec(&this->spec);
+    }
+
     if (envr != NULL) {
         this->hidden->io_delay = SDL_atoi(envr);
     } else {
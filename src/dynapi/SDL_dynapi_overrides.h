@@ -739,3 +739,35 @@
 #define SDL_JoystickSetPlayerIndex SDL_JoystickSetPlayerIndex_REAL
 #define SDL_SetTextureScaleMode SDL_SetTextureScaleMode_REAL
 #define SDL_GetTextureScaleMode SDL_GetTextureScaleMode_REAL
+#define SDL_PollEvents SDL_PollEvents_REAL
+#define SDL_RenderGeometry SDL_RenderGeometry_REAL
+#define SDL_RenderCopiesF SDL_RenderCopiesF_REAL
+#define SDL_RenderGetStats SDL_RenderGetStats_REAL
+#define SDL_SoftStretchLinear SDL_SoftStretchLinear_REAL
+#define SDL_AudioStreamSetResampleQuality SDL_AudioStreamSetResampleQuality_REAL
+#define SDL_AddAudioDeviceVoice SDL_AddAudioDeviceVoice_REAL
+#define SDL_SetAudioDeviceVoiceGain SDL_SetAudioDeviceVoiceGain_REAL
+#define SDL_RemoveAudioDeviceVoice SDL_RemoveAudioDeviceVoice_REAL
+#define SDL_AudioStreamSetChannelMatrix SDL_AudioStreamSetChannelMatrix_REAL
+#define SDL_OpenWAVStream_RW SDL_OpenWAVStream_RW_REAL
+#define SDL_WAVStreamRead SDL_WAVStreamRead_REAL
+#define SDL_WAVStreamSeek SDL_WAVStreamSeek_REAL
+#define SDL_WAVStreamTell SDL_WAVStreamTell_REAL
+#define SDL_WAVStreamLength SDL_WAVStreamLength_REAL
+#define SDL_CloseWAVStream SDL_CloseWAVStream_REAL
+#define SDL_GetTicksNS SDL_GetTicksNS_REAL
+#define SDL_DelayNS SDL_DelayNS_REAL
+#define SDL_AddTimerNS SDL_AddTimerNS_REAL
+#define SDL_GetTaskPoolThreadCount SDL_GetTaskPoolThreadCount_REAL
+#define SDL_CreateTaskGroup SDL_CreateTaskGroup_REAL
+#define SDL_RunTask SDL_RunTask_REAL
+#define SDL_WaitTaskGroup SDL_WaitTaskGroup_REAL
+#define SDL_DestroyTaskGroup SDL_DestroyTaskGroup_REAL
+#define SDL_ParallelFor SDL_ParallelFor_REAL
+#define SDL_CreateRWLock SDL_CreateRWLock_REAL
+#define SDL_LockRWLockForReading SDL_LockRWLockForReading_REAL
+#define SDL_LockRWLockForWriting SDL_LockRWLockForWriting_REAL
+#define SDL_TryLockRWLockForReading SDL_TryLockRWLockForReading_REAL
+#define SDL_TryLockRWLockForWriting SDL_TryLockRWLockForWriting_REAL
+#define SDL_UnlockRWLock SDL_UnlockRWLock_REAL
+#define SDL_DestroyRWLock SDL_DestroyRWLock_REAL
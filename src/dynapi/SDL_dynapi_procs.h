@@ -795,3 +795,35 @@ SDL_DYNAPI_PROC(SDL_Joystick*,SDL_JoystickFromPlayerIndex,(int a),(a),return)
 SDL_DYNAPI_PROC(void,SDL_JoystickSetPlayerIndex,(SDL_Joystick *a, int b),(a,b),)
 SDL_DYNAPI_PROC(int,SDL_SetTextureScaleMode,(SDL_Texture *a, SDL_ScaleMode b),(a,b),return)
 SDL_DYNAPI_PROC(int,SDL_GetTextureScaleMode,(SDL_Texture *a, SDL_ScaleMode *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_PollEvents,(SDL_Event *a, int b, Uint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGeometry,(SDL_Renderer *a, SDL_Texture *b, const SDL_Vertex *c, int d, const int *e, int f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(int,SDL_RenderCopiesF,(SDL_Renderer *a, SDL_Texture *b, const SDL_Rect *c, const SDL_FRect *d, int e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGetStats,(SDL_Renderer *a, SDL_RenderStats *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_SoftStretchLinear,(SDL_Surface *a, const SDL_Rect *b, SDL_Surface *c, const SDL_Rect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamSetResampleQuality,(SDL_AudioStream *a, SDL_AudioResampleQuality b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_AudioStream*,SDL_AddAudioDeviceVoice,(SDL_AudioDeviceID a, const SDL_AudioFormat b, const Uint8 c, const int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_SetAudioDeviceVoiceGain,(SDL_AudioDeviceID a, SDL_AudioStream *b, float c, float d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(void,SDL_RemoveAudioDeviceVoice,(SDL_AudioDeviceID a, SDL_AudioStream *b),(a,b),)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamSetChannelMatrix,(SDL_AudioStream *a, const float *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_WAVStream*,SDL_OpenWAVStream_RW,(SDL_RWops *a, int b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamRead,(SDL_WAVStream *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamSeek,(SDL_WAVStream *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVStreamTell,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVStreamLength,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_CloseWAVStream,(SDL_WAVStream *a),(a),)
+SDL_DYNAPI_PROC(Uint64,SDL_GetTicksNS,(void),(),return)
+SDL_DYNAPI_PROC(void,SDL_DelayNS,(Uint64 a),(a),)
+SDL_DYNAPI_PROC(SDL_TimerID,SDL_AddTimerNS,(Uint64 a, SDL_NSTimerCallback b, void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_GetTaskPoolThreadCount,(void),(),return)
+SDL_DYNAPI_PROC(SDL_TaskGroup*,SDL_CreateTaskGroup,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_RunTask,(SDL_TaskGroup *a, SDL_TaskFunction b, void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_WaitTaskGroup,(SDL_TaskGroup *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_DestroyTaskGroup,(SDL_TaskGroup *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_ParallelFor,(int a, int b, int c, SDL_ParallelForFunction d, void *e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(SDL_rwlock*,SDL_CreateRWLock,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForReading,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForWriting,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForReading,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForWriting,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_UnlockRWLock,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRWLock,(SDL_rwlock *a),(a),)
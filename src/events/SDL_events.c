@@ -26,6 +26,7 @@
 #include "SDL_events.h"
 #include "SDL_thread.h"
 #include "SDL_events_c.h"
+#include "../SDL_hints_c.h"
 #include "../timer/SDL_timer_c.h"
 #if !SDL_JOYSTICK_DISABLED
 #include "../joystick/SDL_joystick_c.h"
@@ -36,6 +37,9 @@
 /* An arbitrary limit so we don't have unbounded growth */
 #define SDL_MAX_QUEUED_EVENTS   65535
 
+/* Number of preallocated slots in the lock-free event ring, must be a power of two */
+#define SDL_EVENT_RING_SIZE     4096
+
 typedef struct SDL_EventWatcher {
     SDL_EventFilter callback;
     void *userdata;
@@ -71,6 +75,17 @@ typedef struct _SDL_SysWMEntry
     struct _SDL_SysWMEntry *next;
 } SDL_SysWMEntry;
 
+/* A slot in the lock-free event ring.
+   The sequence number tells producers and consumers whose turn it is:
+   it equals the slot's position when the slot is free to be written,
+   and position + 1 once an event has been published into it.
+ */
+typedef struct
+{
+    SDL_atomic_t sequence;
+    SDL_Event event;
+} SDL_EventSlot;
+
 static struct
 {
     SDL_mutex *lock;
@@ -82,18 +97,33 @@ static struct
     SDL_EventEntry *free;
     SDL_SysWMEntry *wmmsg_used;
     SDL_SysWMEntry *wmmsg_free;
-} SDL_EventQ = { NULL, { 1 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL };
+    SDL_EventSlot *ring;
+    SDL_atomic_t ring_head;
+    SDL_atomic_t ring_tail;
+    SDL_atomic_t ring_users;
+} SDL_EventQ = { NULL, { 1 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL, NULL, { 0 }, { 0 }, { 0 } };
 
 
 /* 0 (default) means no logging, 1 means logging, 2 means logging with mouse and finger motion */
 static int SDL_DoEventLogging = 0;
 
+/* Whether motion events are merged into an unconsumed motion event at the queue tail,
+   the hint is applied at the start of each SDL_PumpEvents() */
+static SDL_bool SDL_CoalesceMotionEventsHint = SDL_FALSE;
+static SDL_bool SDL_CoalesceMotionEvents = SDL_FALSE;
+
 static void SDLCALL
 SDL_EventLoggingChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
 {
     SDL_DoEventLogging = (hint && *hint) ? SDL_max(SDL_min(SDL_atoi(hint), 2), 0) : 0;
 }
 
+static void SDLCALL
+SDL_MotionCoalescingChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_CoalesceMotionEventsHint = SDL_GetStringBoolean(hint, SDL_FALSE);
+}
+
 static void
 SDL_LogEvent(const SDL_Event *event)
 {
@@ -350,6 +380,11 @@ SDL_StopEventLoop(void)
 
     SDL_AtomicSet(&SDL_EventQ.active, 0);
 
+    /* Producers push into the ring without the lock, let them finish first */
+    while (SDL_AtomicGet(&SDL_EventQ.ring_users) > 0) {
+        SDL_Delay(0);
+    }
+
     if (report && SDL_atoi(report)) {
         SDL_Log("SDL EVENT QUEUE: Maximum events in-flight: %d\n",
                 SDL_EventQ.max_events_seen);
@@ -384,6 +419,10 @@ SDL_StopEventLoop(void)
     SDL_EventQ.free = NULL;
     SDL_EventQ.wmmsg_used = NULL;
     SDL_EventQ.wmmsg_free = NULL;
+    SDL_free(SDL_EventQ.ring);
+    SDL_EventQ.ring = NULL;
+    SDL_AtomicSet(&SDL_EventQ.ring_head, 0);
+    SDL_AtomicSet(&SDL_EventQ.ring_tail, 0);
 
     /* Clear disabled event state */
     for (i = 0; i < SDL_arraysize(SDL_disabled_events); ++i) {
@@ -434,6 +473,19 @@ SDL_StartEventLoop(void)
             return -1;
         }
     }
+
+    /* The lock-free ring is optional, the mutex protected list is always available */
+    if (!SDL_EventQ.ring && SDL_GetHintBoolean(SDL_HINT_EVENT_QUEUE_LOCKFREE, SDL_FALSE)) {
+        SDL_EventQ.ring = (SDL_EventSlot *)SDL_malloc(SDL_EVENT_RING_SIZE * sizeof(*SDL_EventQ.ring));
+        if (SDL_EventQ.ring) {
+            int i;
+            for (i = 0; i < SDL_EVENT_RING_SIZE; ++i) {
+                SDL_AtomicSet(&SDL_EventQ.ring[i].sequence, i);
+            }
+            SDL_AtomicSet(&SDL_EventQ.ring_head, 0);
+            SDL_AtomicSet(&SDL_EventQ.ring_tail, 0);
+        }
+    }
 #endif /* !SDL_THREADS_DISABLED */
 
     /* Process most event types */
@@ -451,33 +503,31 @@ SDL_StartEventLoop(void)
 }
 
 
-/* Add an event to the event queue -- called with the queue locked */
-static int
-SDL_AddEvent(SDL_Event * event)
+static void
+SDL_UpdateMaxEventsSeen(int count)
 {
-    SDL_EventEntry *entry;
-    const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
-    int final_count;
-
-    if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
-        SDL_SetError("Event queue is full (%d events)", initial_count);
-        return 0;
+    /* This is only a statistic, a lost update between racing producers is harmless */
+    if (count > SDL_EventQ.max_events_seen) {
+        SDL_EventQ.max_events_seen = count;
     }
+}
+
+/* Add an entry to the tail of the event list -- called with the queue locked */
+static SDL_EventEntry *
+SDL_LinkEvent(const SDL_Event * event)
+{
+    SDL_EventEntry *entry;
 
     if (SDL_EventQ.free == NULL) {
         entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
         if (!entry) {
-            return 0;
+            return NULL;
         }
     } else {
         entry = SDL_EventQ.free;
         SDL_EventQ.free = entry->next;
     }
 
-    if (SDL_DoEventLogging) {
-        SDL_LogEvent(event);
-    }
-
     entry->event = *event;
     if (event->type == SDL_SYSWMEVENT) {
         entry->msg = *event->syswm.msg;
@@ -496,15 +546,221 @@ SDL_AddEvent(SDL_Event * event)
         entry->prev = NULL;
         entry->next = NULL;
     }
+    return entry;
+}
+
+/* Start using the lock-free ring without the queue lock, returns SDL_FALSE if the event loop is stopping.
+   SDL_StopEventLoop() waits for every user to call SDL_LeaveEventRing() before freeing it.
+ */
+static SDL_bool
+SDL_EnterEventRing(void)
+{
+    SDL_AtomicIncRef(&SDL_EventQ.ring_users);
+    if (SDL_AtomicGet(&SDL_EventQ.active)) {
+        return SDL_TRUE;
+    }
+    SDL_AtomicAdd(&SDL_EventQ.ring_users, -1);
+    return SDL_FALSE;
+}
+
+static void
+SDL_LeaveEventRing(void)
+{
+    SDL_AtomicAdd(&SDL_EventQ.ring_users, -1);
+}
+
+/* Publish an event into the lock-free ring, returns SDL_FALSE if the ring is full.
+   This is a bounded multi-producer queue: each producer claims a position by
+   advancing ring_tail, then publishes the slot by bumping its sequence number.
+ */
+static SDL_bool
+SDL_RingPush(const SDL_Event * event)
+{
+    SDL_EventSlot *slot;
+    Uint32 pos = (Uint32)SDL_AtomicGet(&SDL_EventQ.ring_tail);
+
+    for (;;) {
+        Sint32 diff;
+
+        slot = &SDL_EventQ.ring[pos & (SDL_EVENT_RING_SIZE - 1)];
+        diff = (Sint32)((Uint32)SDL_AtomicGet(&slot->sequence) - pos);
+        if (diff == 0) {
+            if (SDL_AtomicCAS(&SDL_EventQ.ring_tail, (int)pos, (int)(pos + 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            return SDL_FALSE;
+        }
+        pos = (Uint32)SDL_AtomicGet(&SDL_EventQ.ring_tail);
+    }
+
+    slot->event = *event;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&slot->sequence, (int)(pos + 1));
+    return SDL_TRUE;
+}
+
+/* Take the oldest published event out of the lock-free ring, returns SDL_FALSE if the ring is empty */
+static SDL_bool
+SDL_RingPop(SDL_Event * event)
+{
+    SDL_EventSlot *slot;
+    Uint32 pos = (Uint32)SDL_AtomicGet(&SDL_EventQ.ring_head);
+
+    for (;;) {
+        Sint32 diff;
+
+        slot = &SDL_EventQ.ring[pos & (SDL_EVENT_RING_SIZE - 1)];
+        diff = (Sint32)((Uint32)SDL_AtomicGet(&slot->sequence) - (pos + 1));
+        if (diff == 0) {
+            if (SDL_AtomicCAS(&SDL_EventQ.ring_head, (int)pos, (int)(pos + 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            return SDL_FALSE;
+        }
+        pos = (Uint32)SDL_AtomicGet(&SDL_EventQ.ring_head);
+    }
+
+    SDL_MemoryBarrierAcquire();
+    *event = slot->event;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&slot->sequence, (int)(pos + SDL_EVENT_RING_SIZE));
+    return SDL_TRUE;
+}
+
+/* Move the published events in the lock-free ring onto the event list -- called with the queue locked
+   Events in the ring are always newer than the ones in the list, so the order is kept.
+   Only producers use the ring without the lock, so nothing else can pop in the meantime.
+   This stops at the first slot that was claimed but not published yet, rather than
+   waiting for its producer, and returns SDL_TRUE if the ring was left empty.
+ */
+static SDL_bool
+SDL_DrainEventRing(void)
+{
+    SDL_Event event;
+    Uint32 tail;
+
+    if (!SDL_EventQ.ring) {
+        return SDL_TRUE;
+    }
+
+    tail = (Uint32)SDL_AtomicGet(&SDL_EventQ.ring_tail);
+    while ((Sint32)(tail - (Uint32)SDL_AtomicGet(&SDL_EventQ.ring_head)) > 0) {
+        if (!SDL_RingPop(&event)) {
+            return SDL_FALSE;
+        }
+        if (!SDL_LinkEvent(&event)) {
+            /* Out of memory, the event is lost */
+            SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        }
+    }
+    return (SDL_AtomicGet(&SDL_EventQ.ring_head) == SDL_AtomicGet(&SDL_EventQ.ring_tail));
+}
+
+/* Try to add an event without taking the queue lock.
+   Returns 1 if the event was added, 0 if the queue is full, or -1 if the
+   caller needs to fall back to the locked path.
+ */
+static int
+SDL_AddEventLockFree(SDL_Event * event)
+{
+    int count;
+
+    /* The wmmsg payload needs to be copied into a list entry */
+    if (event->type == SDL_SYSWMEVENT) {
+        return -1;
+    }
+
+    /* Reserve our place in the queue first so the limit holds across both paths */
+    count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
+    if (count > SDL_MAX_QUEUED_EVENTS) {
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        SDL_SetError("Event queue is full (%d events)", count - 1);
+        return 0;
+    }
+
+    if (SDL_DoEventLogging) {
+        SDL_LogEvent(event);
+    }
+
+    if (!SDL_RingPush(event)) {
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        return -1;
+    }
+
+    SDL_UpdateMaxEventsSeen(count);
+    return 1;
+}
+
+/* Add an event to the event queue -- called with the queue locked */
+static int
+SDL_AddEvent(SDL_Event * event)
+{
+    const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
+
+    if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
+        SDL_SetError("Event queue is full (%d events)", initial_count);
+        return 0;
+    }
 
-    final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
-    if (final_count > SDL_EventQ.max_events_seen) {
-        SDL_EventQ.max_events_seen = final_count;
+    if (!SDL_LinkEvent(event)) {
+        return 0;
     }
 
+    if (SDL_DoEventLogging) {
+        SDL_LogEvent(event);
+    }
+
+    SDL_UpdateMaxEventsSeen(SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1);
+
     return 1;
 }
 
+/* Add events through the lock-free ring, falling back to the list with the queue
+   locked when the ring is full or an event needs the list. The list only takes
+   new events once the ring is empty, so they can't get ahead of ring events.
+ */
+static int
+SDL_AddEventsToRing(SDL_Event * events, int numevents)
+{
+    int i = 0, used = 0;
+
+    for (;;) {
+        if (!SDL_EnterEventRing()) {
+            /* The event loop was stopped in the meantime */
+            return (used ? used : -1);
+        }
+        for (; i < numevents; ++i) {
+            const int added = SDL_AddEventLockFree(&events[i]);
+            if (added < 0) {
+                break;
+            }
+            used += added;
+        }
+        SDL_LeaveEventRing();
+        if (i == numevents) {
+            return (used);
+        }
+
+        if (SDL_LockMutex(SDL_EventQ.lock) < 0) {
+            return SDL_SetError("Couldn't lock event queue");
+        }
+        if (SDL_DrainEventRing()) {
+            for (; i < numevents; ++i) {
+                used += SDL_AddEvent(&events[i]);
+            }
+            SDL_UnlockMutex(SDL_EventQ.lock);
+            return (used);
+        }
+        SDL_UnlockMutex(SDL_EventQ.lock);
+
+        /* Another producer is still publishing into the ring, let it finish
+           without holding the lock, then retry the ring, which now has room */
+        SDL_Delay(0);
+    }
+}
+
 /* Remove an event from the queue -- called with the queue locked */
 static void
 SDL_CutEvent(SDL_EventEntry *entry)
@@ -546,9 +802,32 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
         }
         return (-1);
     }
-    /* Lock the event queue */
+
+    /* Try the lock-free ring before taking the lock */
+    if (action == SDL_ADDEVENT && SDL_EventQ.ring) {
+        return SDL_AddEventsToRing(events, numevents);
+    }
+
     used = 0;
+
+    /* Lock the event queue */
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        if (action == SDL_GETEVENT && events && !SDL_EventQ.head && SDL_EventQ.ring &&
+            minType <= SDL_FIRSTEVENT && maxType >= SDL_LASTEVENT) {
+            /* Nothing older is waiting in the list, so the ring holds the next events */
+            while (used < numevents && SDL_RingPop(&events[used])) {
+                SDL_AtomicAdd(&SDL_EventQ.count, -1);
+                ++used;
+            }
+            if (SDL_EventQ.lock) {
+                SDL_UnlockMutex(SDL_EventQ.lock);
+            }
+            return (used);
+        }
+
+        /* Filtered and peek operations see the whole queue */
+        SDL_DrainEventRing();
+
         if (action == SDL_ADDEVENT) {
             for (i = 0; i < numevents; ++i) {
                 used += SDL_AddEvent(&events[i]);
@@ -652,6 +931,7 @@ SDL_FlushEvents(Uint32 minType, Uint32 maxType)
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
         Uint32 type;
+        SDL_DrainEventRing();
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             type = entry->event.type;
@@ -671,6 +951,8 @@ SDL_PumpEvents(void)
 {
     SDL_VideoDevice *_this = SDL_GetVideoDevice();
 
+    SDL_CoalesceMotionEvents = SDL_CoalesceMotionEventsHint;
+
     /* Get events from the video subsystem */
     if (_this) {
         _this->PumpEvents(_this);
@@ -700,6 +982,114 @@ SDL_PollEvent(SDL_Event * event)
     return SDL_WaitEventTimeout(event, 0);
 }
 
+/* Merge a motion event into the previous one if they come from the same device */
+static SDL_bool
+SDL_CoalesceMotionEvent(SDL_Event * last, const SDL_Event * event)
+{
+    if (last->type != event->type) {
+        return SDL_FALSE;
+    }
+
+    switch (event->type) {
+    case SDL_MOUSEMOTION:
+        if (last->motion.windowID != event->motion.windowID ||
+            last->motion.which != event->motion.which) {
+            return SDL_FALSE;
+        }
+        last->motion.timestamp = event->motion.timestamp;
+        last->motion.state = event->motion.state;
+        last->motion.x = event->motion.x;
+        last->motion.y = event->motion.y;
+        last->motion.xrel += event->motion.xrel;
+        last->motion.yrel += event->motion.yrel;
+        return SDL_TRUE;
+
+    case SDL_FINGERMOTION:
+        if (last->tfinger.touchId != event->tfinger.touchId ||
+            last->tfinger.fingerId != event->tfinger.fingerId) {
+            return SDL_FALSE;
+        }
+        last->tfinger.timestamp = event->tfinger.timestamp;
+        last->tfinger.x = event->tfinger.x;
+        last->tfinger.y = event->tfinger.y;
+        last->tfinger.dx += event->tfinger.dx;
+        last->tfinger.dy += event->tfinger.dy;
+        last->tfinger.pressure = event->tfinger.pressure;
+        last->tfinger.windowID = event->tfinger.windowID;
+        return SDL_TRUE;
+
+    default:
+        return SDL_FALSE;
+    }
+}
+
+/* Merge a motion event into the event at the tail of the queue, or add it there.
+   Returns 1 if the event was merged or added, 0 if the queue is full, or -1 if the
+   caller needs to add it as usual because the lock-free ring holds newer events.
+   The ring isn't drained here, since that would happen for every motion event.
+ */
+static int
+SDL_AddCoalescedEvent(SDL_Event * event)
+{
+    int added = -1;
+
+    /* Don't look after we've quit */
+    if (!SDL_AtomicGet(&SDL_EventQ.active)) {
+        return -1;
+    }
+
+    if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        if (!SDL_EventQ.ring ||
+            SDL_AtomicGet(&SDL_EventQ.ring_head) == SDL_AtomicGet(&SDL_EventQ.ring_tail)) {
+            if (SDL_EventQ.tail && SDL_CoalesceMotionEvent(&SDL_EventQ.tail->event, event)) {
+                added = 1;
+            } else {
+                /* Keep it in the list, so the next motion event can be merged into it */
+                added = SDL_AddEvent(event);
+            }
+        }
+        if (SDL_EventQ.lock) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+        }
+    }
+    return added;
+}
+
+int
+SDL_PollEvents(SDL_Event * events, int numevents, Uint32 flags)
+{
+    int i, used;
+
+    if (!events) {
+        return SDL_InvalidParamError("events");
+    }
+    if (numevents <= 0) {
+        return 0;
+    }
+
+    if (flags & SDL_POLLEVENTS_PUMP) {
+        SDL_PumpEvents();
+    }
+
+    used = SDL_PeepEvents(events, numevents, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+    if (used <= 1 || !(flags & SDL_POLLEVENTS_COALESCE_MOTION)) {
+        return used;
+    }
+
+    /* Compact the array in place, folding runs of motion events together */
+    numevents = used;
+    used = 1;
+    for (i = 1; i < numevents; ++i) {
+        if (!SDL_CoalesceMotionEvent(&events[used - 1], &events[i])) {
+            if (used != i) {
+                events[used] = events[i];
+            }
+            ++used;
+        }
+    }
+    return used;
+}
+
 int
 SDL_WaitEvent(SDL_Event * event)
 {
@@ -737,9 +1127,11 @@ SDL_WaitEventTimeout(SDL_Event * event, int timeout)
     }
 }
 
-int
-SDL_PushEvent(SDL_Event * event)
+static int
+SDL_PushEventInternal(SDL_Event * event, SDL_bool coalesce)
 {
+    int added;
+
     event->common.timestamp = SDL_GetTicks();
 
     if (SDL_EventOK.callback || SDL_event_watchers_count > 0) {
@@ -782,7 +1174,11 @@ SDL_PushEvent(SDL_Event * event)
         }
     }
 
-    if (SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0, 0) <= 0) {
+    added = coalesce ? SDL_AddCoalescedEvent(event) : -1;
+    if (added < 0) {
+        added = SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0, 0);
+    }
+    if (added <= 0) {
         return -1;
     }
 
@@ -791,6 +1187,18 @@ SDL_PushEvent(SDL_Event * event)
     return 1;
 }
 
+int
+SDL_PushEvent(SDL_Event * event)
+{
+    return SDL_PushEventInternal(event, SDL_FALSE);
+}
+
+int
+SDL_PushCoalescedEvent(SDL_Event * event)
+{
+    return SDL_PushEventInternal(event, SDL_CoalesceMotionEvents);
+}
+
 void
 SDL_SetEventFilter(SDL_EventFilter filter, void *userdata)
 {
@@ -886,6 +1294,7 @@ SDL_FilterEvents(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
+        SDL_DrainEventRing();
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             if (!filter(userdata, &entry->event)) {
@@ -1002,8 +1411,10 @@ int
 SDL_EventsInit(void)
 {
     SDL_AddHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
+    SDL_AddHintCallback(SDL_HINT_MOTION_EVENT_COALESCING, SDL_MotionCoalescingChanged, NULL);
     if (SDL_StartEventLoop() < 0) {
         SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
+        SDL_DelHintCallback(SDL_HINT_MOTION_EVENT_COALESCING, SDL_MotionCoalescingChanged, NULL);
         return -1;
     }
 
@@ -1018,6 +1429,7 @@ SDL_EventsQuit(void)
     SDL_QuitQuit();
     SDL_StopEventLoop();
     SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
+    SDL_DelHintCallback(SDL_HINT_MOTION_EVENT_COALESCING, SDL_MotionCoalescingChanged, NULL);
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -47,6 +47,9 @@ extern int SDL_SendAppEvent(SDL_EventType eventType);
 extern int SDL_SendSysWMEvent(SDL_SysWMmsg * message);
 extern int SDL_SendKeymapChangedEvent(void);
 
+/* Push a motion event, merging it into the queue tail if motion coalescing is enabled */
+extern int SDL_PushCoalescedEvent(SDL_Event * event);
+
 extern int SDL_SendQuit(void);
 
 extern int SDL_EventsInit(void);
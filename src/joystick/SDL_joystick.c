@@ -84,7 +84,7 @@ static SDL_JoystickDriver *SDL_joystick_drivers[] = {
 static SDL_bool SDL_joystick_allows_background_events = SDL_FALSE;
 static SDL_Joystick *SDL_joysticks = NULL;
 static SDL_bool SDL_updating_joystick = SDL_FALSE;
-static SDL_mutex *SDL_joystick_lock = NULL; /* This needs to support recursive locks */
+static SDL_rwlock *SDL_joystick_lock = NULL; /* This needs to support recursive locks */
 static SDL_atomic_t SDL_next_joystick_instance_id;
 static int SDL_joystick_player_count = 0;
 static SDL_JoystickID *SDL_joystick_players = NULL;
@@ -93,7 +93,15 @@ void
 SDL_LockJoysticks(void)
 {
     if (SDL_joystick_lock) {
-        SDL_LockMutex(SDL_joystick_lock);
+        SDL_LockRWLockForWriting(SDL_joystick_lock);
+    }
+}
+
+void
+SDL_LockJoysticksForReading(void)
+{
+    if (SDL_joystick_lock) {
+        SDL_LockRWLockForReading(SDL_joystick_lock);
     }
 }
 
@@ -101,7 +109,7 @@ void
 SDL_UnlockJoysticks(void)
 {
     if (SDL_joystick_lock) {
-        SDL_UnlockMutex(SDL_joystick_lock);
+        SDL_UnlockRWLock(SDL_joystick_lock);
     }
 }
 
@@ -199,7 +207,7 @@ SDL_JoystickInit(void)
 
     /* Create the joystick list lock */
     if (!SDL_joystick_lock) {
-        SDL_joystick_lock = SDL_CreateMutex();
+        SDL_joystick_lock = SDL_CreateRWLock();
     }
 
     /* See if we should allow joystick events while in the background */
@@ -228,7 +236,7 @@ int
 SDL_NumJoysticks(void)
 {
     int i, total_joysticks = 0;
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     for (i = 0; i < SDL_arraysize(SDL_joystick_drivers); ++i) {
         total_joysticks += SDL_joystick_drivers[i]->GetCount();
     }
@@ -297,7 +305,7 @@ SDL_JoystickNameForIndex(int device_index)
     SDL_JoystickDriver *driver;
     const char *name = NULL;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     if (SDL_GetDriverAndJoystickIndex(device_index, &driver, &device_index)) {
         name = SDL_FixupJoystickName(driver->GetDeviceName(device_index));
     }
@@ -315,7 +323,7 @@ SDL_JoystickGetDevicePlayerIndex(int device_index)
 {
     int player_index;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     player_index = SDL_GetPlayerIndexForJoystickID(SDL_JoystickGetDeviceInstanceID(device_index));
     SDL_UnlockJoysticks();
 
@@ -674,7 +682,7 @@ SDL_JoystickFromInstanceID(SDL_JoystickID instance_id)
 {
     SDL_Joystick *joystick;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     for (joystick = SDL_joysticks; joystick; joystick = joystick->next) {
         if (joystick->instance_id == instance_id) {
             break;
@@ -693,7 +701,7 @@ SDL_JoystickFromPlayerIndex(int player_index)
     SDL_JoystickID instance_id;
     SDL_Joystick *joystick;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     instance_id = SDL_GetJoystickIDForPlayerIndex(player_index);
     for (joystick = SDL_joysticks; joystick; joystick = joystick->next) {
         if (joystick->instance_id == instance_id) {
@@ -729,7 +737,7 @@ SDL_JoystickGetPlayerIndex(SDL_Joystick * joystick)
         return -1;
     }
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     player_index = SDL_GetPlayerIndexForJoystickID(joystick->instance_id);
     SDL_UnlockJoysticks();
 
@@ -863,9 +871,9 @@ SDL_JoystickQuit(void)
                         SDL_JoystickAllowBackgroundEventsChanged, NULL);
 
     if (SDL_joystick_lock) {
-        SDL_mutex *mutex = SDL_joystick_lock;
+        SDL_rwlock *rwlock = SDL_joystick_lock;
         SDL_joystick_lock = NULL;
-        SDL_DestroyMutex(mutex);
+        SDL_DestroyRWLock(rwlock);
     }
 
     SDL_GameControllerQuitMappings();
@@ -1790,7 +1798,7 @@ SDL_JoystickGUID SDL_JoystickGetDeviceGUID(int device_index)
     SDL_JoystickDriver *driver;
     SDL_JoystickGUID guid;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     if (SDL_GetDriverAndJoystickIndex(device_index, &driver, &device_index)) {
         guid = driver->GetDeviceGUID(device_index);
     } else {
@@ -1847,7 +1855,7 @@ SDL_JoystickID SDL_JoystickGetDeviceInstanceID(int device_index)
     SDL_JoystickDriver *driver;
     SDL_JoystickID instance_id = -1;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     if (SDL_GetDriverAndJoystickIndex(device_index, &driver, &device_index)) {
         instance_id = driver->GetDeviceInstanceID(device_index);
     }
@@ -1860,7 +1868,7 @@ int SDL_JoystickGetDeviceIndexFromInstanceID(SDL_JoystickID instance_id)
 {
     int i, num_joysticks, device_index = -1;
 
-    SDL_LockJoysticks();
+    SDL_LockJoysticksForReading();
     num_joysticks = SDL_NumJoysticks();
     for (i = 0; i < num_joysticks; ++i) {
         if (SDL_JoystickGetDeviceInstanceID(i) == instance_id) {
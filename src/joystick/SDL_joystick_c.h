@@ -34,6 +34,11 @@ struct _SDL_JoystickDriver;
 extern int SDL_JoystickInit(void);
 extern void SDL_JoystickQuit(void);
 
+/* Lock the joystick list for looking things up, other threads can do the
+   same at the same time. SDL_LockJoysticks() locks it for changing things.
+   Either way it's unlocked with SDL_UnlockJoysticks(). */
+extern void SDL_LockJoysticksForReading(void);
+
 /* Function to get the next available joystick instance ID */
 extern SDL_JoystickID SDL_GetNextJoystickInstanceID(void);
 
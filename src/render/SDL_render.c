@@ -26,6 +26,7 @@
 #include "SDL_hints.h"
 #include "SDL_log.h"
 #include "SDL_render.h"
+#include "SDL_timer.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
 
@@ -202,16 +203,353 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
                         (int) cmd->data.draw.b, (int) cmd->data.draw.a,
                         (int) cmd->data.draw.blend, cmd->data.draw.texture);
                 break;
+
+            case SDL_RENDERCMD_GEOMETRY:
+                SDL_Log(" %u. geometry (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d, tex=%p)", i++,
+                        (unsigned int) cmd->data.draw.first,
+                        (unsigned int) cmd->data.draw.count,
+                        (int) cmd->data.draw.r, (int) cmd->data.draw.g,
+                        (int) cmd->data.draw.b, (int) cmd->data.draw.a,
+                        (int) cmd->data.draw.blend, cmd->data.draw.texture);
+                break;
         }
         cmd = cmd->next;
     }
 #endif
 }
 
+static void
+DebugLogRenderStats(const SDL_RenderStats *stats)
+{
+    SDL_Log("Render stats: viewport=%u cliprect=%u drawcolor=%u clear=%u points=%u lines=%u rects=%u copy=%u copyex=%u geometry=%u",
+            (unsigned int) stats->viewport_commands, (unsigned int) stats->cliprect_commands,
+            (unsigned int) stats->drawcolor_commands, (unsigned int) stats->clear_commands,
+            (unsigned int) stats->point_commands, (unsigned int) stats->line_commands,
+            (unsigned int) stats->rect_commands, (unsigned int) stats->copy_commands,
+            (unsigned int) stats->copyex_commands, (unsigned int) stats->geometry_commands);
+    SDL_Log("Render stats: texture switches=%u, vertex bytes=%u, vertex reallocations=%u, flushes=%u (forced=%u), backend=%uus",
+            (unsigned int) stats->texture_switches, (unsigned int) stats->vertex_bytes,
+            (unsigned int) stats->vertex_reallocations, (unsigned int) stats->flushes,
+            (unsigned int) stats->forced_flushes, (unsigned int) stats->backend_us);
+}
+
+static void
+CountRenderCommands(SDL_Renderer *renderer, const SDL_RenderCommand *cmd)
+{
+    SDL_RenderStats *stats = &renderer->stats;
+    while (cmd) {
+        switch (cmd->command) {
+            case SDL_RENDERCMD_NO_OP:
+                break;
+
+            case SDL_RENDERCMD_SETVIEWPORT:
+                stats->viewport_commands++;
+                break;
+
+            case SDL_RENDERCMD_SETCLIPRECT:
+                stats->cliprect_commands++;
+                break;
+
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+                stats->drawcolor_commands++;
+                break;
+
+            case SDL_RENDERCMD_CLEAR:
+                stats->clear_commands++;
+                break;
+
+            case SDL_RENDERCMD_DRAW_POINTS:
+                stats->point_commands++;
+                break;
+
+            case SDL_RENDERCMD_DRAW_LINES:
+                stats->line_commands++;
+                break;
+
+            case SDL_RENDERCMD_FILL_RECTS:
+                stats->rect_commands++;
+                break;
+
+            case SDL_RENDERCMD_COPY:
+                stats->copy_commands++;
+                break;
+
+            case SDL_RENDERCMD_COPY_EX:
+                stats->copyex_commands++;
+                break;
+
+            case SDL_RENDERCMD_GEOMETRY:
+                stats->geometry_commands++;
+                break;
+        }
+
+        switch (cmd->command) {
+            case SDL_RENDERCMD_COPY:
+            case SDL_RENDERCMD_COPY_EX:
+            case SDL_RENDERCMD_GEOMETRY:
+                if (cmd->data.draw.texture && cmd->data.draw.texture != renderer->stats_texture) {
+                    stats->texture_switches++;
+                    renderer->stats_texture = cmd->data.draw.texture;
+                }
+                break;
+            default:
+                break;
+        }
+        cmd = cmd->next;
+    }
+}
+
+static SDL_bool
+IsDrawRenderCommand(const SDL_RenderCommand *cmd)
+{
+    switch (cmd->command) {
+        case SDL_RENDERCMD_DRAW_POINTS:
+        case SDL_RENDERCMD_DRAW_LINES:
+        case SDL_RENDERCMD_FILL_RECTS:
+        case SDL_RENDERCMD_COPY:
+        case SDL_RENDERCMD_COPY_EX:
+        case SDL_RENDERCMD_GEOMETRY:
+            return SDL_TRUE;
+        default:
+            return SDL_FALSE;
+    }
+}
+
+/* Turn state commands that don't change anything, or that are replaced
+   before anything uses them, into no-ops. The first command of each kind
+   is always kept, since backends don't carry state over between flushes. */
+static void
+ElideRedundantRenderCommands(SDL_RenderCommand *cmd)
+{
+    const SDL_RenderCommand *viewport = NULL;
+    const SDL_RenderCommand *cliprect = NULL;
+    const SDL_RenderCommand *color = NULL;
+    SDL_RenderCommand *unused_viewport = NULL;
+    SDL_RenderCommand *unused_cliprect = NULL;
+    SDL_RenderCommand *unused_color = NULL;
+
+    for (; cmd; cmd = cmd->next) {
+        switch (cmd->command) {
+            case SDL_RENDERCMD_SETVIEWPORT:
+                if (viewport && SDL_memcmp(&viewport->data.viewport.rect, &cmd->data.viewport.rect, sizeof (SDL_Rect)) == 0) {
+                    cmd->command = SDL_RENDERCMD_NO_OP;
+                } else {
+                    if (unused_viewport) {
+                        unused_viewport->command = SDL_RENDERCMD_NO_OP;
+                    }
+                    viewport = unused_viewport = cmd;
+                }
+                break;
+
+            case SDL_RENDERCMD_SETCLIPRECT:
+                if (cliprect && cliprect->data.cliprect.enabled == cmd->data.cliprect.enabled &&
+                    (!cmd->data.cliprect.enabled || SDL_memcmp(&cliprect->data.cliprect.rect, &cmd->data.cliprect.rect, sizeof (SDL_Rect)) == 0)) {
+                    cmd->command = SDL_RENDERCMD_NO_OP;
+                } else {
+                    if (unused_cliprect) {
+                        unused_cliprect->command = SDL_RENDERCMD_NO_OP;
+                    }
+                    cliprect = unused_cliprect = cmd;
+                }
+                break;
+
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+                if (color && color->data.color.r == cmd->data.color.r && color->data.color.g == cmd->data.color.g &&
+                    color->data.color.b == cmd->data.color.b && color->data.color.a == cmd->data.color.a) {
+                    cmd->command = SDL_RENDERCMD_NO_OP;
+                } else {
+                    if (unused_color) {
+                        unused_color->command = SDL_RENDERCMD_NO_OP;
+                    }
+                    color = unused_color = cmd;
+                }
+                break;
+
+            case SDL_RENDERCMD_NO_OP:
+                break;
+
+            default:  /* draws and clears; be conservative and assume clears use all the state, too. */
+                unused_viewport = unused_cliprect = unused_color = NULL;
+                break;
+        }
+    }
+}
+
+static SDL_bool
+CanMergeRenderCopies(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    return (a->data.draw.texture == b->data.draw.texture) &&
+           (a->data.draw.blend == b->data.draw.blend) &&
+           (a->data.draw.r == b->data.draw.r) && (a->data.draw.g == b->data.draw.g) &&
+           (a->data.draw.b == b->data.draw.b) && (a->data.draw.a == b->data.draw.a);
+}
+
+/* Fold copies into the compatible copy before them. This relies on the
+   QueueCopies contract: with nothing but no-ops in between, the vertex
+   data of two copies is contiguous and concatenates into one batch. */
+static void
+MergeRenderCopies(SDL_RenderCommand *cmd)
+{
+    SDL_RenderCommand *copy = NULL;
+
+    for (; cmd; cmd = cmd->next) {
+        if (cmd->command == SDL_RENDERCMD_COPY) {
+            if (copy && CanMergeRenderCopies(copy, cmd)) {
+                copy->data.draw.count += cmd->data.draw.count;
+                cmd->command = SDL_RENDERCMD_NO_OP;
+            } else {
+                copy = cmd;
+            }
+        } else if (cmd->command != SDL_RENDERCMD_NO_OP) {
+            copy = NULL;
+        }
+    }
+}
+
+typedef struct
+{
+    SDL_RenderCommand cmd;
+    size_t size;
+    SDL_bool placed;
+} SDL_RenderCopyEntry;
+
+/* Stable-sort a run of copies (separated only by no-ops) by texture, so
+   MergeRenderCopies can join them. The vertex data of the run is moved
+   around to match, so it stays contiguous in the new order. */
+static void
+ReorderRenderCopyRun(SDL_Renderer *renderer, SDL_RenderCommand *start, SDL_RenderCommand *end, int count)
+{
+    Uint8 *vertex_data = (Uint8 *) renderer->vertex_data;
+    SDL_RenderCopyEntry *entries;
+    SDL_RenderCommand *cmd;
+    const SDL_RenderCommand *next;
+    size_t run_first, run_end, offset;
+    Uint8 *vertices;
+    SDL_bool changed = SDL_FALSE;
+    int i, j, n;
+
+    /* the run's vertex data ends where the next draw's begins. */
+    run_end = renderer->vertex_data_used;
+    for (next = end; next; next = next->next) {
+        if (IsDrawRenderCommand(next)) {
+            run_end = next->data.draw.first;
+            break;
+        }
+    }
+
+    entries = (SDL_RenderCopyEntry *) SDL_malloc(count * sizeof (*entries));
+    if (!entries) {
+        return;  /* it's just an optimization, draw it as it is. */
+    }
+
+    n = 0;
+    for (cmd = start; cmd != end; cmd = cmd->next) {
+        if (cmd->command == SDL_RENDERCMD_COPY) {
+            if (n > 0) {
+                entries[n - 1].size = cmd->data.draw.first - entries[n - 1].cmd.data.draw.first;
+            }
+            entries[n].cmd = *cmd;
+            entries[n].placed = SDL_FALSE;
+            n++;
+        }
+    }
+    SDL_assert(n == count);
+    entries[n - 1].size = run_end - entries[n - 1].cmd.data.draw.first;
+    run_first = entries[0].cmd.data.draw.first;
+
+    vertices = (Uint8 *) SDL_malloc(run_end - run_first);
+    if (!vertices) {
+        SDL_free(entries);
+        return;
+    }
+
+    /* place every copy of each texture, in order of first appearance. */
+    cmd = start;
+    offset = run_first;
+    for (i = 0; i < n; i++) {
+        if (entries[i].placed) {
+            continue;
+        }
+        for (j = i; j < n; j++) {
+            SDL_RenderCopyEntry *entry = &entries[j];
+            if (entry->placed || entry->cmd.data.draw.texture != entries[i].cmd.data.draw.texture) {
+                continue;
+            }
+            while (cmd->command != SDL_RENDERCMD_COPY) {
+                cmd = cmd->next;
+            }
+            if (entry->cmd.data.draw.first != offset) {
+                changed = SDL_TRUE;
+            }
+            SDL_memcpy(vertices + (offset - run_first), vertex_data + entry->cmd.data.draw.first, entry->size);
+            cmd->data.draw = entry->cmd.data.draw;
+            cmd->data.draw.first = offset;
+            offset += entry->size;
+            entry->placed = SDL_TRUE;
+            cmd = cmd->next;
+        }
+    }
+    SDL_assert(offset == run_end);
+
+    if (changed) {
+        SDL_memcpy(vertex_data + run_first, vertices, run_end - run_first);
+    }
+
+    SDL_free(vertices);
+    SDL_free(entries);
+}
+
+static void
+ReorderRenderCopies(SDL_Renderer *renderer)
+{
+    SDL_RenderCommand *cmd = renderer->render_commands;
+
+    while (cmd) {
+        SDL_RenderCommand *start;
+        const SDL_Texture *texture = NULL;
+        SDL_bool mixed = SDL_FALSE;
+        int count = 0;
+
+        if (cmd->command != SDL_RENDERCMD_COPY) {
+            cmd = cmd->next;
+            continue;
+        }
+
+        start = cmd;
+        for (; cmd && (cmd->command == SDL_RENDERCMD_COPY || cmd->command == SDL_RENDERCMD_NO_OP); cmd = cmd->next) {
+            if (cmd->command == SDL_RENDERCMD_COPY) {
+                if (count > 0 && cmd->data.draw.texture != texture) {
+                    mixed = SDL_TRUE;
+                }
+                texture = cmd->data.draw.texture;
+                count++;
+            }
+        }
+
+        if (mixed) {
+            ReorderRenderCopyRun(renderer, start, cmd, count);
+        }
+    }
+}
+
+static void
+OptimizeRenderCommands(SDL_Renderer *renderer)
+{
+    ElideRedundantRenderCommands(renderer->render_commands);
+
+    if (renderer->QueueCopies) {
+        if (renderer->optimize_level > 1) {
+            ReorderRenderCopies(renderer);
+        }
+        MergeRenderCopies(renderer->render_commands);
+    }
+}
+
 static int
 FlushRenderCommands(SDL_Renderer *renderer)
 {
     int retval;
+    Uint64 start = 0;
 
     SDL_assert((renderer->render_commands == NULL) == (renderer->render_commands_tail == NULL));
 
@@ -220,10 +558,25 @@ FlushRenderCommands(SDL_Renderer *renderer)
         return 0;
     }
 
+    if (renderer->optimize_level) {
+        OptimizeRenderCommands(renderer);
+    }
+
     DebugLogRenderCommands(renderer->render_commands);
 
+    if (renderer->stats_level) {
+        CountRenderCommands(renderer, renderer->render_commands);
+        renderer->stats.vertex_bytes += (Uint32) renderer->vertex_data_used;
+        renderer->stats.flushes++;
+        start = SDL_GetPerformanceCounter();
+    }
+
     retval = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
 
+    if (renderer->stats_level) {
+        renderer->stats.backend_us += (Uint32) (((SDL_GetPerformanceCounter() - start) * 1000000) / SDL_GetPerformanceFrequency());
+    }
+
     /* Move the whole render command queue to the unused pool so we can reuse them next time. */
     if (renderer->render_commands_tail != NULL) {
         renderer->render_commands_tail->next = renderer->render_commands_pool;
@@ -245,6 +598,9 @@ FlushRenderCommandsIfTextureNeeded(SDL_Texture *texture)
     SDL_Renderer *renderer = texture->renderer;
     if (texture->last_command_generation == renderer->render_command_generation) {
         /* the current command queue depends on this texture, flush the queue now before it changes */
+        if (renderer->stats_level && renderer->render_commands) {
+            renderer->stats.forced_flushes++;
+        }
         return FlushRenderCommands(renderer);
     }
     return 0;
@@ -262,6 +618,22 @@ SDL_RenderFlush(SDL_Renderer * renderer)
     return FlushRenderCommands(renderer);
 }
 
+int
+SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * stats)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    if (!renderer->stats_level) {
+        return SDL_SetError("Render statistics are disabled, see SDL_HINT_RENDER_STATS");
+    }
+
+    *stats = renderer->last_stats;
+    return 0;
+}
+
 void *
 SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const size_t alignment, size_t *offset)
 {
@@ -285,6 +657,7 @@ SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const
         }
         renderer->vertex_data = ptr;
         renderer->vertex_data_allocation = newsize;
+        renderer->stats.vertex_reallocations++;
     }
 
     if (offset) {
@@ -532,6 +905,34 @@ QueueCmdCopy(SDL_Renderer *renderer, SDL_Texture * texture, const SDL_Rect * src
     return retval;
 }
 
+static int
+QueueCmdCopies(SDL_Renderer *renderer, SDL_Texture * texture, const SDL_Rect * srcrects, const SDL_FRect * dstrects, const int count)
+{
+    SDL_RenderCommand *cmd;
+    int retval = -1;
+    int i;
+
+    if (!renderer->QueueCopies) {
+        /* one command per copy, but the caller still saved the per-call overhead. */
+        for (i = 0; i < count; i++) {
+            retval = QueueCmdCopy(renderer, texture, &srcrects[i], &dstrects[i]);
+            if (retval < 0) {
+                break;
+            }
+        }
+        return retval;
+    }
+
+    cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY);
+    if (cmd != NULL) {
+        retval = renderer->QueueCopies(renderer, cmd, texture, srcrects, dstrects, count);
+        if (retval < 0) {
+            cmd->command = SDL_RENDERCMD_NO_OP;
+        }
+    }
+    return retval;
+}
+
 static int
 QueueCmdCopyEx(SDL_Renderer *renderer, SDL_Texture * texture,
                const SDL_Rect * srcquad, const SDL_FRect * dstrect,
@@ -549,6 +950,28 @@ QueueCmdCopyEx(SDL_Renderer *renderer, SDL_Texture * texture,
     return retval;
 }
 
+static int
+QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
+                 const SDL_Vertex *vertices, const int num_vertices,
+                 const int *indices, const int num_indices)
+{
+    SDL_RenderCommand *cmd;
+    int retval = -1;
+    if (texture) {
+        cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_GEOMETRY);
+    } else {
+        cmd = PrepQueueCmdDrawSolid(renderer, SDL_RENDERCMD_GEOMETRY);
+    }
+    if (cmd != NULL) {
+        retval = renderer->QueueGeometry(renderer, cmd, texture, vertices, num_vertices, indices, num_indices,
+                                         renderer->scale.x, renderer->scale.y);
+        if (retval < 0) {
+            cmd->command = SDL_RENDERCMD_NO_OP;
+        }
+    }
+    return retval;
+}
+
 
 static int UpdateLogicalSize(SDL_Renderer *renderer);
 
@@ -764,6 +1187,13 @@ void VerifyDrawQueueFunctions(const SDL_Renderer *renderer)
     SDL_assert(renderer->RunCommandQueue != NULL);
 }
 
+static int
+GetRenderHintLevel(const char *name, int default_value)
+{
+    const char *hint = SDL_GetHint(name);
+    return (hint && *hint) ? SDL_atoi(hint) : default_value;
+}
+
 SDL_Renderer *
 SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
 {
@@ -855,6 +1285,8 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
     }
 
     renderer->batching = batching;
+    renderer->optimize_level = GetRenderHintLevel(SDL_HINT_RENDER_OPTIMIZE, 0);
+    renderer->stats_level = GetRenderHintLevel(SDL_HINT_RENDER_STATS, 0);
     renderer->magic = &renderer_magic;
     renderer->window = window;
     renderer->target_mutex = SDL_CreateMutex();
@@ -919,6 +1351,8 @@ SDL_CreateSoftwareRenderer(SDL_Surface * surface)
 
     if (renderer) {
         VerifyDrawQueueFunctions(renderer);
+        renderer->optimize_level = GetRenderHintLevel(SDL_HINT_RENDER_OPTIMIZE, 0);
+        renderer->stats_level = GetRenderHintLevel(SDL_HINT_RENDER_STATS, 0);
         renderer->magic = &renderer_magic;
         renderer->target_mutex = SDL_CreateMutex();
         renderer->scale.x = 1.0f;
@@ -3003,6 +3437,105 @@ SDL_RenderCopyF(SDL_Renderer * renderer, SDL_Texture * texture,
     return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
 }
 
+int
+SDL_RenderCopiesF(SDL_Renderer * renderer, SDL_Texture * texture,
+                  const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count)
+{
+    SDL_Rect texture_rect;
+    SDL_FRect viewport_rect;
+    SDL_Rect r;
+    int i, n, retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (renderer != texture->renderer) {
+        return SDL_SetError("Texture was not created with this renderer");
+    }
+
+    if (!dstrects) {
+        return SDL_InvalidParamError("dstrects");
+    }
+    if (count < 1) {
+        return 0;
+    }
+
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+
+    if (count > renderer->copies_allocation) {
+        SDL_Rect *srcrects_scratch;
+        SDL_FRect *dstrects_scratch;
+        int newcount = renderer->copies_allocation ? renderer->copies_allocation : 128;
+        while (newcount < count) {
+            newcount *= 2;
+        }
+        srcrects_scratch = (SDL_Rect *) SDL_realloc(renderer->copies_srcrects, newcount * sizeof (SDL_Rect));
+        if (!srcrects_scratch) {
+            return SDL_OutOfMemory();
+        }
+        renderer->copies_srcrects = srcrects_scratch;
+        dstrects_scratch = (SDL_FRect *) SDL_realloc(renderer->copies_dstrects, newcount * sizeof (SDL_FRect));
+        if (!dstrects_scratch) {
+            return SDL_OutOfMemory();
+        }
+        renderer->copies_dstrects = dstrects_scratch;
+        renderer->copies_allocation = newcount;
+    }
+
+    texture_rect.x = 0;
+    texture_rect.y = 0;
+    texture_rect.w = texture->w;
+    texture_rect.h = texture->h;
+
+    SDL_zero(r);
+    SDL_RenderGetViewport(renderer, &r);
+    viewport_rect.x = 0.0f;
+    viewport_rect.y = 0.0f;
+    viewport_rect.w = (float) r.w;
+    viewport_rect.h = (float) r.h;
+
+    /* Same clipping and culling as SDL_RenderCopyF(), once per element. */
+    n = 0;
+    for (i = 0; i < count; i++) {
+        SDL_Rect *srcrect = &renderer->copies_srcrects[n];
+        SDL_FRect *dstrect = &renderer->copies_dstrects[n];
+
+        if (srcrects) {
+            if (!SDL_IntersectRect(&srcrects[i], &texture_rect, srcrect)) {
+                continue;
+            }
+        } else {
+            *srcrect = texture_rect;
+        }
+
+        if (!SDL_HasIntersectionF(&dstrects[i], &viewport_rect)) {
+            continue;
+        }
+
+        dstrect->x = dstrects[i].x * renderer->scale.x;
+        dstrect->y = dstrects[i].y * renderer->scale.y;
+        dstrect->w = dstrects[i].w * renderer->scale.x;
+        dstrect->h = dstrects[i].h * renderer->scale.y;
+        n++;
+    }
+
+    if (n == 0) {
+        return 0;
+    }
+
+    if (texture->native) {
+        texture = texture->native;
+    }
+
+    texture->last_command_generation = renderer->render_command_generation;
+
+    retval = QueueCmdCopies(renderer, texture, renderer->copies_srcrects, renderer->copies_dstrects, n);
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
 int
 SDL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                const SDL_Rect * srcrect, const SDL_Rect * dstrect,
@@ -3107,6 +3640,62 @@ SDL_RenderCopyExF(SDL_Renderer * renderer, SDL_Texture * texture,
     return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
 }
 
+int
+SDL_RenderGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
+                   const SDL_Vertex *vertices, int num_vertices,
+                   const int *indices, int num_indices)
+{
+    int i, retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (texture) {
+        CHECK_TEXTURE_MAGIC(texture, -1);
+
+        if (renderer != texture->renderer) {
+            return SDL_SetError("Texture was not created with this renderer");
+        }
+    }
+
+    if (!vertices) {
+        return SDL_InvalidParamError("vertices");
+    }
+    if (num_vertices < 3) {
+        return SDL_InvalidParamError("num_vertices");
+    }
+    if (indices) {
+        if (num_indices < 3 || (num_indices % 3) != 0) {
+            return SDL_InvalidParamError("num_indices");
+        }
+        for (i = 0; i < num_indices; ++i) {
+            if (indices[i] < 0 || indices[i] >= num_vertices) {
+                return SDL_SetError("Index %d out of range (%d vertices)", indices[i], num_vertices);
+            }
+        }
+    } else if ((num_vertices % 3) != 0) {
+        return SDL_InvalidParamError("num_vertices");
+    }
+
+    if (!renderer->QueueGeometry) {
+        return SDL_Unsupported();
+    }
+
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+
+    if (texture) {
+        if (texture->native) {
+            texture = texture->native;
+        }
+        texture->last_command_generation = renderer->render_command_generation;
+    }
+
+    retval = QueueCmdGeometry(renderer, texture, vertices, num_vertices, indices, indices ? num_indices : 0);
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
 int
 SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 format, void * pixels, int pitch)
@@ -3153,6 +3742,14 @@ SDL_RenderPresent(SDL_Renderer * renderer)
 
     FlushRenderCommands(renderer);  /* time to send everything to the GPU! */
 
+    if (renderer->stats_level) {
+        renderer->last_stats = renderer->stats;
+        SDL_zero(renderer->stats);
+        if (renderer->stats_level > 1) {
+            DebugLogRenderStats(&renderer->last_stats);
+        }
+    }
+
     /* Don't present while we're hidden */
     if (renderer->hidden) {
         return;
@@ -3230,6 +3827,8 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
     }
 
     SDL_free(renderer->vertex_data);
+    SDL_free(renderer->copies_srcrects);
+    SDL_free(renderer->copies_dstrects);
 
     /* Free existing textures for this renderer */
     while (renderer->textures) {
@@ -74,7 +74,8 @@ typedef enum
     SDL_RENDERCMD_DRAW_LINES,
     SDL_RENDERCMD_FILL_RECTS,
     SDL_RENDERCMD_COPY,
-    SDL_RENDERCMD_COPY_EX
+    SDL_RENDERCMD_COPY_EX,
+    SDL_RENDERCMD_GEOMETRY
 } SDL_RenderCommandType;
 
 typedef struct SDL_RenderCommand
@@ -124,9 +125,17 @@ struct SDL_Renderer
                             int count);
     int (*QueueCopy) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
                        const SDL_Rect * srcrect, const SDL_FRect * dstrect);
+    /* Backends that provide QueueCopies must store each copy as a fixed-size
+       record and must not allocate vertex data for state commands, so the
+       queue optimizer can merge and reorder adjacent copies. */
+    int (*QueueCopies) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                        const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count);
     int (*QueueCopyEx) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
                         const SDL_Rect * srcquad, const SDL_FRect * dstrect,
                         const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
+    int (*QueueGeometry) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                          const SDL_Vertex * vertices, int num_vertices, const int * indices, int num_indices,
+                          float scale_x, float scale_y);
     int (*RunCommandQueue) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize);
     int (*UpdateTexture) (SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * rect, const void *pixels,
@@ -215,6 +224,20 @@ struct SDL_Renderer
     size_t vertex_data_used;
     size_t vertex_data_allocation;
 
+    /* scratch space for the clipped rectangles of SDL_RenderCopiesF() */
+    SDL_Rect *copies_srcrects;
+    SDL_FRect *copies_dstrects;
+    int copies_allocation;
+
+    /* see SDL_HINT_RENDER_OPTIMIZE */
+    int optimize_level;
+
+    /* per-frame counters, see SDL_HINT_RENDER_STATS */
+    int stats_level;
+    SDL_RenderStats stats;
+    SDL_RenderStats last_stats;
+    const SDL_Texture *stats_texture;
+
     void *driverdata;
 };
 
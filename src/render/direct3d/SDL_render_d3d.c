@@ -1431,6 +1431,7 @@ D3D_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY:  /* not supported in this backend. */
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
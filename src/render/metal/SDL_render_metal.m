@@ -1455,6 +1455,7 @@ METAL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY:  /* not supported in this backend. */
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
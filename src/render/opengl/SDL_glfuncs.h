@@ -36,11 +36,7 @@ SDL_PROC_UNUSED(void, glBitmap,
                 (GLsizei, GLsizei, GLfloat, GLfloat, GLfloat, GLfloat,
                  const GLubyte *))
 SDL_PROC(void, glBlendEquation, (GLenum))
-#ifdef __AMIGAOS4__
 SDL_PROC(void, glBlendFunc, (GLenum, GLenum))
-#else
-SDL_PROC_UNUSED(void, glBlendFunc, (GLenum, GLenum))
-#endif
 SDL_PROC(void, glBlendFuncSeparate, (GLenum, GLenum, GLenum, GLenum))
 SDL_PROC_UNUSED(void, glCallList, (GLuint))
 SDL_PROC_UNUSED(void, glCallLists, (GLsizei, GLenum, const GLvoid *))
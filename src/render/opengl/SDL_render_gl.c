@@ -900,46 +900,42 @@ GL_QueueFillRects(SDL_Renderer * renderer, SDL_RenderCommand *cmd, const SDL_FRe
 }
 
 static int
-GL_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
-             const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+GL_QueueCopies(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+               const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count)
 {
     GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
-    GLfloat minx, miny, maxx, maxy;
-    GLfloat minu, maxu, minv, maxv;
-    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, 8 * sizeof (GLfloat), 0, &cmd->data.draw.first);
+    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, count * 8 * sizeof (GLfloat), 0, &cmd->data.draw.first);
+    int i;
 
     if (!verts) {
         return -1;
     }
 
-    cmd->data.draw.count = 1;
-
-    minx = dstrect->x;
-    miny = dstrect->y;
-    maxx = dstrect->x + dstrect->w;
-    maxy = dstrect->y + dstrect->h;
+    cmd->data.draw.count = count;
 
-    minu = (GLfloat) srcrect->x / texture->w;
-    minu *= texturedata->texw;
-    maxu = (GLfloat) (srcrect->x + srcrect->w) / texture->w;
-    maxu *= texturedata->texw;
-    minv = (GLfloat) srcrect->y / texture->h;
-    minv *= texturedata->texh;
-    maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
-    maxv *= texturedata->texh;
+    for (i = 0; i < count; i++) {
+        const SDL_Rect *srcrect = &srcrects[i];
+        const SDL_FRect *dstrect = &dstrects[i];
+        *(verts++) = dstrect->x;
+        *(verts++) = dstrect->y;
+        *(verts++) = dstrect->x + dstrect->w;
+        *(verts++) = dstrect->y + dstrect->h;
+        *(verts++) = ((GLfloat) srcrect->x / texture->w) * texturedata->texw;
+        *(verts++) = ((GLfloat) (srcrect->x + srcrect->w) / texture->w) * texturedata->texw;
+        *(verts++) = ((GLfloat) srcrect->y / texture->h) * texturedata->texh;
+        *(verts++) = ((GLfloat) (srcrect->y + srcrect->h) / texture->h) * texturedata->texh;
+    }
 
-    cmd->data.draw.count = 1;
-    *(verts++) = minx;
-    *(verts++) = miny;
-    *(verts++) = maxx;
-    *(verts++) = maxy;
-    *(verts++) = minu;
-    *(verts++) = maxu;
-    *(verts++) = minv;
-    *(verts++) = maxv;
     return 0;
 }
 
+static int
+GL_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+             const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+{
+    return GL_QueueCopies(renderer, cmd, texture, srcrect, dstrect, 1);
+}
+
 static int
 GL_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
                const SDL_Rect * srcrect, const SDL_FRect * dstrect,
@@ -1000,6 +996,54 @@ GL_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * te
     return 0;
 }
 
+static int
+GL_QueueGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                 const SDL_Vertex * vertices, int num_vertices, const int * indices, int num_indices,
+                 float scale_x, float scale_y)
+{
+    GL_TextureData *texturedata = texture ? (GL_TextureData *) texture->driverdata : NULL;
+    const int count = indices ? num_indices : num_vertices;
+    const size_t sz = texture ? 8 : 6;
+    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, count * sz * sizeof (GLfloat), 0, &cmd->data.draw.first);
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    for (i = 0; i < count; i++) {
+        const SDL_Vertex *vertex = &vertices[indices ? indices[i] : i];
+        GLfloat r = vertex->color.r * inv255f;
+        GLfloat g = vertex->color.g * inv255f;
+        GLfloat b = vertex->color.b * inv255f;
+        GLfloat a = vertex->color.a * inv255f;
+
+        if (texture) {
+            /* the texture color and alpha modulation ride along with the vertex colors. */
+            r *= cmd->data.draw.r * inv255f;
+            g *= cmd->data.draw.g * inv255f;
+            b *= cmd->data.draw.b * inv255f;
+            a *= cmd->data.draw.a * inv255f;
+        }
+
+        *(verts++) = vertex->position.x * scale_x;
+        *(verts++) = vertex->position.y * scale_y;
+        *(verts++) = r;
+        *(verts++) = g;
+        *(verts++) = b;
+        *(verts++) = a;
+
+        if (texture) {
+            *(verts++) = vertex->tex_coord.x * texturedata->texw;
+            *(verts++) = vertex->tex_coord.y * texturedata->texh;
+        }
+    }
+
+    return 0;
+}
+
 static void
 GlBlendModeHack(GL_RenderData * data, const SDL_BlendMode mode)
 {
@@ -1337,24 +1381,27 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
 
             case SDL_RENDERCMD_COPY: {
                 const GLfloat *verts = (GLfloat *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const GLfloat minx = verts[0];
-                const GLfloat miny = verts[1];
-                const GLfloat maxx = verts[2];
-                const GLfloat maxy = verts[3];
-                const GLfloat minu = verts[4];
-                const GLfloat maxu = verts[5];
-                const GLfloat minv = verts[6];
-                const GLfloat maxv = verts[7];
+                const size_t count = cmd->data.draw.count;
                 SetCopyState(data, cmd);
-                data->glBegin(GL_TRIANGLE_STRIP);
-                data->glTexCoord2f(minu, minv);
-                data->glVertex2f(minx, miny);
-                data->glTexCoord2f(maxu, minv);
-                data->glVertex2f(maxx, miny);
-                data->glTexCoord2f(minu, maxv);
-                data->glVertex2f(minx, maxy);
-                data->glTexCoord2f(maxu, maxv);
-                data->glVertex2f(maxx, maxy);
+                data->glBegin(GL_QUADS);
+                for (i = 0; i < count; ++i, verts += 8) {
+                    const GLfloat minx = verts[0];
+                    const GLfloat miny = verts[1];
+                    const GLfloat maxx = verts[2];
+                    const GLfloat maxy = verts[3];
+                    const GLfloat minu = verts[4];
+                    const GLfloat maxu = verts[5];
+                    const GLfloat minv = verts[6];
+                    const GLfloat maxv = verts[7];
+                    data->glTexCoord2f(minu, minv);
+                    data->glVertex2f(minx, miny);
+                    data->glTexCoord2f(maxu, minv);
+                    data->glVertex2f(maxx, miny);
+                    data->glTexCoord2f(maxu, maxv);
+                    data->glVertex2f(maxx, maxy);
+                    data->glTexCoord2f(minu, maxv);
+                    data->glVertex2f(minx, maxy);
+                }
                 data->glEnd();
                 break;
             }
@@ -1392,6 +1439,37 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY: {
+                const GLfloat *verts = (GLfloat *) (((Uint8 *) vertices) + cmd->data.draw.first);
+                const size_t count = cmd->data.draw.count;
+                SDL_Texture *texture = cmd->data.draw.texture;
+                const size_t sz = texture ? 8 : 6;
+                const Uint32 color = data->drawstate.color;
+
+                if (texture) {
+                    SetCopyState(data, cmd);
+                } else {
+                    SetDrawState(data, cmd, SHADER_SOLID);
+                }
+
+                data->glBegin(GL_TRIANGLES);
+                for (i = 0; i < count; ++i, verts += sz) {
+                    data->glColor4f(verts[2], verts[3], verts[4], verts[5]);
+                    if (texture) {
+                        data->glTexCoord2f(verts[6], verts[7]);
+                    }
+                    data->glVertex2f(verts[0], verts[1]);
+                }
+                data->glEnd();
+
+                /* put back the current color for the draws that follow. */
+                data->glColor4f((GLfloat) ((color >> 16) & 0xFF) * inv255f,
+                                (GLfloat) ((color >> 8) & 0xFF) * inv255f,
+                                (GLfloat) (color & 0xFF) * inv255f,
+                                (GLfloat) ((color >> 24) & 0xFF) * inv255f);
+                break;
+            }
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -1663,7 +1741,9 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->QueueDrawLines = GL_QueueDrawPoints;  /* lines and points queue vertices the same way. */
     renderer->QueueFillRects = GL_QueueFillRects;
     renderer->QueueCopy = GL_QueueCopy;
+    renderer->QueueCopies = GL_QueueCopies;
     renderer->QueueCopyEx = GL_QueueCopyEx;
+    renderer->QueueGeometry = GL_QueueGeometry;
     renderer->RunCommandQueue = GL_RunCommandQueue;
     renderer->RenderReadPixels = GL_RenderReadPixels;
     renderer->RenderPresent = GL_RenderPresent;
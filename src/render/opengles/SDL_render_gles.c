@@ -952,6 +952,7 @@ GLES_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vert
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY:  /* not supported in this backend. */
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
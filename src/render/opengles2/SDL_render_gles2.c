@@ -89,7 +89,6 @@ typedef struct GLES2_ProgramCacheEntry
     GLES2_ShaderCacheEntry *vertex_shader;
     GLES2_ShaderCacheEntry *fragment_shader;
     GLuint uniform_locations[16];
-    Uint32 color;
     GLfloat projection[4][4];
     struct GLES2_ProgramCacheEntry *prev;
     struct GLES2_ProgramCacheEntry *next;
@@ -108,13 +107,13 @@ typedef enum
     GLES2_ATTRIBUTE_TEXCOORD = 1,
     GLES2_ATTRIBUTE_ANGLE = 2,
     GLES2_ATTRIBUTE_CENTER = 3,
+    GLES2_ATTRIBUTE_COLOR = 4,
 } GLES2_Attribute;
 
 typedef enum
 {
     GLES2_UNIFORM_PROJECTION,
     GLES2_UNIFORM_TEXTURE,
-    GLES2_UNIFORM_COLOR,
     GLES2_UNIFORM_TEXTURE_U,
     GLES2_UNIFORM_TEXTURE_V
 } GLES2_Uniform;
@@ -146,7 +145,10 @@ typedef struct
     SDL_Rect cliprect;
     SDL_bool texturing;
     SDL_bool is_copy_ex;
+    SDL_bool is_geometry;
     Uint32 color;
+    Uint32 vertex_color;
+    SDL_bool vertex_color_dirty;
     Uint32 clear_color;
     int drawablew;
     int drawableh;
@@ -463,6 +465,7 @@ GLES2_CacheProgram(GLES2_RenderData *data, GLES2_ShaderCacheEntry *vertex,
     data->myglBindAttribLocation(entry->id, GLES2_ATTRIBUTE_TEXCOORD, "a_texCoord");
     data->myglBindAttribLocation(entry->id, GLES2_ATTRIBUTE_ANGLE, "a_angle");
     data->myglBindAttribLocation(entry->id, GLES2_ATTRIBUTE_CENTER, "a_center");
+    data->myglBindAttribLocation(entry->id, GLES2_ATTRIBUTE_COLOR, "a_color");
     data->myglLinkProgram(entry->id);
     data->myglGetProgramiv(entry->id, GL_LINK_STATUS, &linkSuccessful);
     if (!linkSuccessful) {
@@ -481,10 +484,6 @@ GLES2_CacheProgram(GLES2_RenderData *data, GLES2_ShaderCacheEntry *vertex,
         data->myglGetUniformLocation(entry->id, "u_texture_u");
     entry->uniform_locations[GLES2_UNIFORM_TEXTURE] =
         data->myglGetUniformLocation(entry->id, "u_texture");
-    entry->uniform_locations[GLES2_UNIFORM_COLOR] =
-        data->myglGetUniformLocation(entry->id, "u_color");
-
-    entry->color = 0;
 
     data->myglUseProgram(entry->id);
     if (entry->uniform_locations[GLES2_UNIFORM_TEXTURE_V] != -1) {
@@ -499,9 +498,6 @@ GLES2_CacheProgram(GLES2_RenderData *data, GLES2_ShaderCacheEntry *vertex,
     if (entry->uniform_locations[GLES2_UNIFORM_PROJECTION] != -1) {
         data->myglUniformMatrix4fv(entry->uniform_locations[GLES2_UNIFORM_PROJECTION], 1, GL_FALSE, (GLfloat *)entry->projection);
     }
-    if (entry->uniform_locations[GLES2_UNIFORM_COLOR] != -1) {
-        data->myglUniform4f(entry->uniform_locations[GLES2_UNIFORM_COLOR], 0.0f, 0.0f, 0.0f, 0.0f);
-    }
 
     /* Cache the linked program */
     if (data->program_cache.head) {
@@ -815,50 +811,51 @@ GLES2_QueueFillRects(SDL_Renderer * renderer, SDL_RenderCommand *cmd, const SDL_
 }
 
 static int
-GLES2_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
-                          const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+GLES2_QueueCopies(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                  const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count)
 {
-    GLfloat minx, miny, maxx, maxy;
-    GLfloat minu, maxu, minv, maxv;
-    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, 16 * sizeof (GLfloat), 0, &cmd->data.draw.first);
+    /* every copy is two triangles, so the whole batch is a single glDrawArrays().
+       Vertices are interleaved (x, y, u, v) so each copy is a self-contained
+       record and adjacent copies can be merged by the command queue optimizer. */
+    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, count * 24 * sizeof (GLfloat), 0, &cmd->data.draw.first);
+    int i;
 
     if (!verts) {
         return -1;
     }
 
-    cmd->data.draw.count = 1;
-
-    minx = dstrect->x;
-    miny = dstrect->y;
-    maxx = dstrect->x + dstrect->w;
-    maxy = dstrect->y + dstrect->h;
-
-    minu = (GLfloat) srcrect->x / texture->w;
-    maxu = (GLfloat) (srcrect->x + srcrect->w) / texture->w;
-    minv = (GLfloat) srcrect->y / texture->h;
-    maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
-
-    *(verts++) = minx;
-    *(verts++) = miny;
-    *(verts++) = maxx;
-    *(verts++) = miny;
-    *(verts++) = minx;
-    *(verts++) = maxy;
-    *(verts++) = maxx;
-    *(verts++) = maxy;
+    cmd->data.draw.count = count;
 
-    *(verts++) = minu;
-    *(verts++) = minv;
-    *(verts++) = maxu;
-    *(verts++) = minv;
-    *(verts++) = minu;
-    *(verts++) = maxv;
-    *(verts++) = maxu;
-    *(verts++) = maxv;
+    for (i = 0; i < count; i++) {
+        const SDL_Rect *srcrect = &srcrects[i];
+        const SDL_FRect *dstrect = &dstrects[i];
+        const GLfloat minx = dstrect->x;
+        const GLfloat miny = dstrect->y;
+        const GLfloat maxx = dstrect->x + dstrect->w;
+        const GLfloat maxy = dstrect->y + dstrect->h;
+        const GLfloat minu = (GLfloat) srcrect->x / texture->w;
+        const GLfloat maxu = (GLfloat) (srcrect->x + srcrect->w) / texture->w;
+        const GLfloat minv = (GLfloat) srcrect->y / texture->h;
+        const GLfloat maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
+
+        *(verts++) = minx; *(verts++) = miny; *(verts++) = minu; *(verts++) = minv;
+        *(verts++) = maxx; *(verts++) = miny; *(verts++) = maxu; *(verts++) = minv;
+        *(verts++) = minx; *(verts++) = maxy; *(verts++) = minu; *(verts++) = maxv;
+        *(verts++) = minx; *(verts++) = maxy; *(verts++) = minu; *(verts++) = maxv;
+        *(verts++) = maxx; *(verts++) = miny; *(verts++) = maxu; *(verts++) = minv;
+        *(verts++) = maxx; *(verts++) = maxy; *(verts++) = maxu; *(verts++) = maxv;
+    }
 
     return 0;
 }
 
+static int
+GLES2_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                          const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+{
+    return GLES2_QueueCopies(renderer, cmd, texture, srcrect, dstrect, 1);
+}
+
 static int
 GLES2_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
                         const SDL_Rect * srcquad, const SDL_FRect * dstrect,
@@ -941,11 +938,67 @@ GLES2_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture *
     return 0;
 }
 
+static int
+GLES2_QueueGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                    const SDL_Vertex * vertices, int num_vertices, const int * indices, int num_indices,
+                    float scale_x, float scale_y)
+{
+    const SDL_bool colorswap = (renderer->target && (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 || renderer->target->format == SDL_PIXELFORMAT_RGB888));
+    const int count = indices ? num_indices : num_vertices;
+    const size_t vertlen = (sizeof (GLfloat) * 2 * (texture ? 2 : 1) + 4) * count;
+    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, vertlen, 0, &cmd->data.draw.first);
+    GLfloat *texcoords;
+    Uint8 *colors;
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    /* positions, then texture coordinates if textured, then one RGBA byte quad per vertex. */
+    texcoords = verts + (count * 2);
+    colors = (Uint8 *) (texture ? (texcoords + (count * 2)) : texcoords);
+
+    cmd->data.draw.count = count;
+
+    for (i = 0; i < count; i++) {
+        const SDL_Vertex *vertex = &vertices[indices ? indices[i] : i];
+        Uint8 r = vertex->color.r;
+        Uint8 g = vertex->color.g;
+        Uint8 b = vertex->color.b;
+        Uint8 a = vertex->color.a;
+
+        *(verts++) = vertex->position.x * scale_x;
+        *(verts++) = vertex->position.y * scale_y;
+
+        if (texture) {
+            /* the texture color and alpha modulation ride along with the vertex colors. */
+            r = (Uint8) ((r * cmd->data.draw.r) / 255);
+            g = (Uint8) ((g * cmd->data.draw.g) / 255);
+            b = (Uint8) ((b * cmd->data.draw.b) / 255);
+            a = (Uint8) ((a * cmd->data.draw.a) / 255);
+            *(texcoords++) = vertex->tex_coord.x;
+            *(texcoords++) = vertex->tex_coord.y;
+        }
+
+        *(colors++) = colorswap ? b : r;
+        *(colors++) = g;
+        *(colors++) = colorswap ? r : b;
+        *(colors++) = a;
+    }
+
+    return 0;
+}
+
 static int
 SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_ImageSource imgsrc)
 {
     const SDL_bool was_copy_ex = data->drawstate.is_copy_ex;
     const SDL_bool is_copy_ex = (cmd->command == SDL_RENDERCMD_COPY_EX);
+    const SDL_bool was_geometry = data->drawstate.is_geometry;
+    const SDL_bool is_geometry = (cmd->command == SDL_RENDERCMD_GEOMETRY);
+    const GLsizei stride = (cmd->command == SDL_RENDERCMD_COPY) ? (sizeof (GLfloat) * 4) : 0;
+    const size_t count = cmd->data.draw.count;
     SDL_Texture *texture = cmd->data.draw.texture;
     const SDL_BlendMode blend = cmd->data.draw.blend;
     GLES2_ProgramCacheEntry *program;
@@ -1017,7 +1070,15 @@ SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_I
     }
 
     if (texture) {
-        data->myglVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * 8)));
+        size_t offset;
+        if (is_geometry) {
+            offset = sizeof (GLfloat) * 2 * count;
+        } else if (is_copy_ex) {
+            offset = sizeof (GLfloat) * 8;
+        } else {
+            offset = sizeof (GLfloat) * 2;  /* interleaved with the positions. */
+        }
+        data->myglVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, (const GLvoid *) (cmd->data.draw.first + offset));
     }
 
     if (GLES2_SelectProgram(data, imgsrc, texture ? texture->w : 0, texture ? texture->h : 0) < 0) {
@@ -1033,15 +1094,28 @@ SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_I
         }
     }
 
-    if (program->uniform_locations[GLES2_UNIFORM_COLOR] != -1) {
-        if (data->drawstate.color != program->color) {
-            const Uint8 r = (data->drawstate.color >> 16) & 0xFF;
-            const Uint8 g = (data->drawstate.color >> 8) & 0xFF;
-            const Uint8 b = (data->drawstate.color >> 0) & 0xFF;
-            const Uint8 a = (data->drawstate.color >> 24) & 0xFF;
-            data->myglUniform4f(program->uniform_locations[GLES2_UNIFORM_COLOR], r * inv255f, g * inv255f, b * inv255f, a * inv255f);
-            program->color = data->drawstate.color;
+    if (is_geometry != was_geometry) {
+        if (is_geometry) {
+            data->myglEnableVertexAttribArray((GLenum) GLES2_ATTRIBUTE_COLOR);
+        } else {
+            /* the current attribute value is undefined after drawing from an array. */
+            data->myglDisableVertexAttribArray((GLenum) GLES2_ATTRIBUTE_COLOR);
+            data->drawstate.vertex_color_dirty = SDL_TRUE;
         }
+        data->drawstate.is_geometry = is_geometry;
+    }
+
+    if (is_geometry) {
+        const size_t offset = sizeof (GLfloat) * 2 * count * (texture ? 2 : 1);
+        data->myglVertexAttribPointer(GLES2_ATTRIBUTE_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (const GLvoid *) (cmd->data.draw.first + offset));
+    } else if (data->drawstate.vertex_color_dirty || (data->drawstate.color != data->drawstate.vertex_color)) {
+        const Uint8 r = (data->drawstate.color >> 16) & 0xFF;
+        const Uint8 g = (data->drawstate.color >> 8) & 0xFF;
+        const Uint8 b = (data->drawstate.color >> 0) & 0xFF;
+        const Uint8 a = (data->drawstate.color >> 24) & 0xFF;
+        data->myglVertexAttrib4f(GLES2_ATTRIBUTE_COLOR, r * inv255f, g * inv255f, b * inv255f, a * inv255f);
+        data->drawstate.vertex_color = data->drawstate.color;
+        data->drawstate.vertex_color_dirty = SDL_FALSE;
     }
 
     if (blend != data->drawstate.blend) {
@@ -1060,7 +1134,7 @@ SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_I
     }
 
     /* all drawing commands use this */
-    data->myglVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid *) cmd->data.draw.first);
+    data->myglVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, stride, (const GLvoid *) cmd->data.draw.first);
 
     if (is_copy_ex != was_copy_ex) {
         if (is_copy_ex) {
@@ -1321,7 +1395,13 @@ GLES2_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
-            case SDL_RENDERCMD_COPY:
+            case SDL_RENDERCMD_COPY: {
+                if (SetCopyState(renderer, cmd) == 0) {
+                    data->myglDrawArrays(GL_TRIANGLES, 0, (GLsizei) (cmd->data.draw.count * 6));
+                }
+                break;
+            }
+
             case SDL_RENDERCMD_COPY_EX: {
                 if (SetCopyState(renderer, cmd) == 0) {
                     data->myglDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -1329,6 +1409,14 @@ GLES2_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY: {
+                const int ret = cmd->data.draw.texture ? SetCopyState(renderer, cmd) : SetDrawState(data, cmd, GLES2_IMAGESOURCE_SOLID);
+                if (ret == 0) {
+                    data->myglDrawArrays(GL_TRIANGLES, 0, (GLsizei) cmd->data.draw.count);
+                }
+                break;
+            }
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -2101,7 +2189,9 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->QueueDrawLines      = GLES2_QueueDrawPoints;  /* lines and points queue vertices the same way. */
     renderer->QueueFillRects      = GLES2_QueueFillRects;
     renderer->QueueCopy           = GLES2_QueueCopy;
+    renderer->QueueCopies         = GLES2_QueueCopies;
     renderer->QueueCopyEx         = GLES2_QueueCopyEx;
+    renderer->QueueGeometry       = GLES2_QueueGeometry;
     renderer->RunCommandQueue     = GLES2_RunCommandQueue;
     renderer->RenderReadPixels    = GLES2_RenderReadPixels;
     renderer->RenderPresent       = GLES2_RenderPresent;
@@ -2131,6 +2221,7 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     data->drawstate.blend = SDL_BLENDMODE_INVALID;
     data->drawstate.color = 0xFFFFFFFF;
     data->drawstate.clear_color = 0xFFFFFFFF;
+    data->drawstate.vertex_color_dirty = SDL_TRUE;
     data->drawstate.projection[3][0] = -1.0f;
     data->drawstate.projection[3][3] = 1.0f;
 
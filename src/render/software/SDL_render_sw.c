@@ -26,6 +26,12 @@
 #include "SDL_render_sw_c.h"
 #include "SDL_hints.h"
 #include "SDL_assert.h"
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_thread.h"
+#include "../../thread/SDL_systhread.h"
+#include "../../video/SDL_blit.h"
+#include "../../video/SDL_RLEaccel_c.h"
 
 #include "SDL_draw.h"
 #include "SDL_blendfillrect.h"
@@ -44,10 +50,14 @@ typedef struct
     SDL_bool surface_cliprect_dirty;
 } SW_DrawStateCache;
 
+typedef struct SW_TileContext SW_TileContext;
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    int num_threads;
+    SW_TileContext *tiles;
 } SW_RenderData;
 
 
@@ -182,6 +192,7 @@ SW_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 static void
 SW_SetTextureScaleMode(SDL_Renderer * renderer, SDL_Texture * texture, SDL_ScaleMode scaleMode)
 {
+    /* texture->scaleMode is checked each time the texture is drawn scaled. */
 }
 
 static int
@@ -267,33 +278,46 @@ SW_QueueFillRects(SDL_Renderer * renderer, SDL_RenderCommand *cmd, const SDL_FRe
 }
 
 static int
-SW_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
-             const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+SW_QueueCopies(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+               const SDL_Rect * srcrects, const SDL_FRect * dstrects, int count)
 {
-    SDL_Rect *verts = (SDL_Rect *) SDL_AllocateRenderVertices(renderer, 2 * sizeof (SDL_Rect), 0, &cmd->data.draw.first);
+    SDL_Rect *verts = (SDL_Rect *) SDL_AllocateRenderVertices(renderer, count * 2 * sizeof (SDL_Rect), 0, &cmd->data.draw.first);
+    int i;
 
     if (!verts) {
         return -1;
     }
 
-    cmd->data.draw.count = 1;
+    cmd->data.draw.count = count;
 
-    SDL_memcpy(verts, srcrect, sizeof (SDL_Rect));
-    verts++;
+    for (i = 0; i < count; i++) {
+        const SDL_FRect *dstrect = &dstrects[i];
 
-    if (renderer->viewport.x || renderer->viewport.y) {
-        verts->x = (int)(renderer->viewport.x + dstrect->x);
-        verts->y = (int)(renderer->viewport.y + dstrect->y);
-    } else {
-        verts->x = (int)dstrect->x;
-        verts->y = (int)dstrect->y;
+        SDL_memcpy(verts, &srcrects[i], sizeof (SDL_Rect));
+        verts++;
+
+        if (renderer->viewport.x || renderer->viewport.y) {
+            verts->x = (int)(renderer->viewport.x + dstrect->x);
+            verts->y = (int)(renderer->viewport.y + dstrect->y);
+        } else {
+            verts->x = (int)dstrect->x;
+            verts->y = (int)dstrect->y;
+        }
+        verts->w = (int)dstrect->w;
+        verts->h = (int)dstrect->h;
+        verts++;
     }
-    verts->w = (int)dstrect->w;
-    verts->h = (int)dstrect->h;
 
     return 0;
 }
 
+static int
+SW_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+             const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+{
+    return SW_QueueCopies(renderer, cmd, texture, srcrect, dstrect, 1);
+}
+
 typedef struct CopyExData
 {
     SDL_Rect srcrect;
@@ -334,6 +358,252 @@ SW_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * te
     return 0;
 }
 
+typedef struct GeometryVertex
+{
+    Sint32 x, y;    /* 28.4 fixed point, viewport offset applied */
+    SDL_Color color;
+    float u, v;     /* in texels */
+} GeometryVertex;
+
+#define GEOMETRY_SUBPIXEL_BITS  4
+#define GEOMETRY_COORD_LIMIT    (1 << 20)
+
+static Sint32
+GeometryToFixed(float value)
+{
+    if (value < -GEOMETRY_COORD_LIMIT) {
+        value = -GEOMETRY_COORD_LIMIT;
+    } else if (value > GEOMETRY_COORD_LIMIT) {
+        value = GEOMETRY_COORD_LIMIT;
+    }
+    return (Sint32) SDL_floorf(value * (1 << GEOMETRY_SUBPIXEL_BITS) + 0.5f);
+}
+
+static int
+SW_QueueGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                 const SDL_Vertex * vertices, int num_vertices, const int * indices, int num_indices,
+                 float scale_x, float scale_y)
+{
+    const int count = indices ? num_indices : num_vertices;
+    GeometryVertex *verts = (GeometryVertex *) SDL_AllocateRenderVertices(renderer, count * sizeof (GeometryVertex), 0, &cmd->data.draw.first);
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    for (i = 0; i < count; i++, verts++) {
+        const SDL_Vertex *vertex = &vertices[indices ? indices[i] : i];
+        verts->x = GeometryToFixed(renderer->viewport.x + vertex->position.x * scale_x);
+        verts->y = GeometryToFixed(renderer->viewport.y + vertex->position.y * scale_y);
+        verts->color = vertex->color;
+        if (texture) {
+            /* the texture color and alpha modulation ride along with the vertex colors. */
+            verts->color.r = (Uint8) DRAW_MUL(vertex->color.r, cmd->data.draw.r);
+            verts->color.g = (Uint8) DRAW_MUL(vertex->color.g, cmd->data.draw.g);
+            verts->color.b = (Uint8) DRAW_MUL(vertex->color.b, cmd->data.draw.b);
+            verts->color.a = (Uint8) DRAW_MUL(vertex->color.a, cmd->data.draw.a);
+            verts->u = vertex->tex_coord.x * texture->w;
+            verts->v = vertex->tex_coord.y * texture->h;
+        } else {
+            verts->u = verts->v = 0.0f;
+        }
+    }
+
+    return 0;
+}
+
+static void
+GeometryGetPixel(const SDL_Surface *surface, int x, int y, unsigned *r, unsigned *g, unsigned *b, unsigned *a)
+{
+    const SDL_PixelFormat *fmt = surface->format;
+    const int bpp = fmt->BytesPerPixel;
+    const Uint8 *pixel = (const Uint8 *) surface->pixels + y * surface->pitch + x * bpp;
+    Uint32 Pixel;
+
+    if (fmt->palette) {
+        Uint8 pr, pg, pb, pa;
+        RETRIEVE_RGB_PIXEL(pixel, bpp, Pixel);
+        SDL_GetRGBA(Pixel, fmt, &pr, &pg, &pb, &pa);
+        *r = pr; *g = pg; *b = pb; *a = pa;
+        return;
+    }
+
+    DISEMBLE_RGBA(pixel, bpp, fmt, Pixel, *r, *g, *b, *a);
+    if (!fmt->Amask) {
+        *a = 0xFF;
+    }
+}
+
+static void
+GeometryPutPixel(SDL_Surface *surface, int x, int y, unsigned r, unsigned g, unsigned b, unsigned a)
+{
+    const SDL_PixelFormat *fmt = surface->format;
+    const int bpp = fmt->BytesPerPixel;
+    Uint8 *pixel = (Uint8 *) surface->pixels + y * surface->pitch + x * bpp;
+
+    if (fmt->palette) {
+        *pixel = (Uint8) SDL_MapRGBA(fmt, (Uint8) r, (Uint8) g, (Uint8) b, (Uint8) a);
+        return;
+    }
+
+    ASSEMBLE_RGBA(pixel, bpp, fmt, r, g, b, a);
+}
+
+/* The edge function of a->b evaluated at p; positive on the inside of a clockwise (on screen) triangle. */
+static SDL_INLINE Sint64
+GeometryEdge(const GeometryVertex *a, const GeometryVertex *b, Sint64 px, Sint64 py)
+{
+    return ((Sint64) (b->x - a->x)) * (py - a->y) - ((Sint64) (b->y - a->y)) * (px - a->x);
+}
+
+/* Pixels exactly on a shared edge belong to one triangle only: the one where the edge runs up, or right. */
+static SDL_INLINE Sint64
+GeometryEdgeBias(const GeometryVertex *a, const GeometryVertex *b)
+{
+    const Sint32 dx = b->x - a->x;
+    const Sint32 dy = b->y - a->y;
+    return ((dy < 0) || (dy == 0 && dx > 0)) ? 0 : -1;
+}
+
+static void
+SW_RenderTriangle(SDL_Surface *surface, SDL_Surface *src, const SDL_BlendMode blend,
+                  const GeometryVertex *v0, const GeometryVertex *v1, const GeometryVertex *v2)
+{
+    const SDL_Rect *clip = &surface->clip_rect;
+    const Sint64 half = 1 << (GEOMETRY_SUBPIXEL_BITS - 1);
+    Sint64 area = GeometryEdge(v0, v1, v2->x, v2->y);
+    Sint64 bias0, bias1, bias2;
+    int minx, miny, maxx, maxy;
+    int x, y;
+
+    if (area == 0) {
+        return;  /* degenerate triangle, nothing to draw. */
+    }
+    if (area < 0) {
+        const GeometryVertex *tmp = v1;
+        v1 = v2;
+        v2 = tmp;
+        area = -area;
+    }
+
+    bias0 = GeometryEdgeBias(v1, v2);
+    bias1 = GeometryEdgeBias(v2, v0);
+    bias2 = GeometryEdgeBias(v0, v1);
+
+    minx = SDL_min(v0->x, SDL_min(v1->x, v2->x)) >> GEOMETRY_SUBPIXEL_BITS;
+    miny = SDL_min(v0->y, SDL_min(v1->y, v2->y)) >> GEOMETRY_SUBPIXEL_BITS;
+    maxx = SDL_max(v0->x, SDL_max(v1->x, v2->x)) >> GEOMETRY_SUBPIXEL_BITS;
+    maxy = SDL_max(v0->y, SDL_max(v1->y, v2->y)) >> GEOMETRY_SUBPIXEL_BITS;
+    minx = SDL_max(minx, clip->x);
+    miny = SDL_max(miny, clip->y);
+    maxx = SDL_min(maxx, clip->x + clip->w - 1);
+    maxy = SDL_min(maxy, clip->y + clip->h - 1);
+
+    for (y = miny; y <= maxy; y++) {
+        const Sint64 py = ((Sint64) y << GEOMETRY_SUBPIXEL_BITS) + half;
+        for (x = minx; x <= maxx; x++) {
+            const Sint64 px = ((Sint64) x << GEOMETRY_SUBPIXEL_BITS) + half;
+            const Sint64 w0 = GeometryEdge(v1, v2, px, py);
+            const Sint64 w1 = GeometryEdge(v2, v0, px, py);
+            const Sint64 w2 = GeometryEdge(v0, v1, px, py);
+            unsigned r, g, b, a, inva;
+            unsigned dr, dg, db, da;
+
+            if ((w0 + bias0) < 0 || (w1 + bias1) < 0 || (w2 + bias2) < 0) {
+                continue;
+            }
+
+            r = (unsigned) ((v0->color.r * w0 + v1->color.r * w1 + v2->color.r * w2) / area);
+            g = (unsigned) ((v0->color.g * w0 + v1->color.g * w1 + v2->color.g * w2) / area);
+            b = (unsigned) ((v0->color.b * w0 + v1->color.b * w1 + v2->color.b * w2) / area);
+            a = (unsigned) ((v0->color.a * w0 + v1->color.a * w1 + v2->color.a * w2) / area);
+
+            if (src) {
+                const double fw0 = (double) w0 / area;
+                const double fw1 = (double) w1 / area;
+                const double fw2 = (double) w2 / area;
+                int tx = (int) SDL_floor(v0->u * fw0 + v1->u * fw1 + v2->u * fw2);
+                int ty = (int) SDL_floor(v0->v * fw0 + v1->v * fw1 + v2->v * fw2);
+                unsigned tr, tg, tb, ta;
+                tx = SDL_max(0, SDL_min(tx, src->w - 1));
+                ty = SDL_max(0, SDL_min(ty, src->h - 1));
+                GeometryGetPixel(src, tx, ty, &tr, &tg, &tb, &ta);
+                r = DRAW_MUL(r, tr);
+                g = DRAW_MUL(g, tg);
+                b = DRAW_MUL(b, tb);
+                a = DRAW_MUL(a, ta);
+            }
+
+            if (blend == SDL_BLENDMODE_NONE) {
+                GeometryPutPixel(surface, x, y, r, g, b, a);
+                continue;
+            }
+
+            inva = 0xFF - a;
+            GeometryGetPixel(surface, x, y, &dr, &dg, &db, &da);
+            switch (blend) {
+                case SDL_BLENDMODE_BLEND:
+                    dr = DRAW_MUL(inva, dr) + DRAW_MUL(r, a);
+                    dg = DRAW_MUL(inva, dg) + DRAW_MUL(g, a);
+                    db = DRAW_MUL(inva, db) + DRAW_MUL(b, a);
+                    da = DRAW_MUL(inva, da) + a;
+                    break;
+                case SDL_BLENDMODE_ADD:
+                    dr = SDL_min(dr + DRAW_MUL(r, a), 0xFF);
+                    dg = SDL_min(dg + DRAW_MUL(g, a), 0xFF);
+                    db = SDL_min(db + DRAW_MUL(b, a), 0xFF);
+                    break;
+                case SDL_BLENDMODE_MOD:
+                    dr = DRAW_MUL(dr, r);
+                    dg = DRAW_MUL(dg, g);
+                    db = DRAW_MUL(db, b);
+                    break;
+                case SDL_BLENDMODE_MUL:
+                    dr = SDL_min(DRAW_MUL(dr, r) + DRAW_MUL(inva, dr), 0xFF);
+                    dg = SDL_min(DRAW_MUL(dg, g) + DRAW_MUL(inva, dg), 0xFF);
+                    db = SDL_min(DRAW_MUL(db, b) + DRAW_MUL(inva, db), 0xFF);
+                    da = SDL_min(DRAW_MUL(da, a) + DRAW_MUL(inva, da), 0xFF);
+                    break;
+                default:
+                    break;
+            }
+            GeometryPutPixel(surface, x, y, dr, dg, db, da);
+        }
+    }
+}
+
+static int
+SW_RenderGeometry(SDL_Surface *surface, SDL_Surface *src, const SDL_BlendMode blend,
+                  const GeometryVertex *verts, const size_t count)
+{
+    size_t i;
+
+    if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) < 0) {
+        return -1;
+    }
+    if (src && SDL_MUSTLOCK(src) && SDL_LockSurface(src) < 0) {
+        if (SDL_MUSTLOCK(surface)) {
+            SDL_UnlockSurface(surface);
+        }
+        return -1;
+    }
+
+    for (i = 0; (i + 2) < count; i += 3) {
+        SW_RenderTriangle(surface, src, blend, &verts[i], &verts[i + 1], &verts[i + 2]);
+    }
+
+    if (src && SDL_MUSTLOCK(src)) {
+        SDL_UnlockSurface(src);
+    }
+    if (SDL_MUSTLOCK(surface)) {
+        SDL_UnlockSurface(surface);
+    }
+    return 0;
+}
+
 static int
 SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * texture,
                 const SDL_Rect * srcrect, const SDL_Rect * final_rect,
@@ -435,7 +705,8 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * tex
             retval = -1;
         } else {
             SDL_SetSurfaceBlendMode(src_clone, SDL_BLENDMODE_NONE);
-            retval = SDL_BlitScaled(src_clone, srcrect, src_scaled, &scale_rect);
+            retval = SDL_PrivateUpperBlitScaled(src_clone, srcrect, src_scaled, &scale_rect,
+                                                texture->scaleMode != SDL_ScaleModeNearest);
             SDL_FreeSurface(src_clone);
             src_clone = src_scaled;
             src_scaled = NULL;
@@ -562,15 +833,13 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * tex
 }
 
 static void
-PrepTextureForCopy(const SDL_RenderCommand *cmd)
+PrepTextureForCopy(const SDL_RenderCommand *cmd, SDL_Surface *surface)
 {
     const Uint8 r = cmd->data.draw.r;
     const Uint8 g = cmd->data.draw.g;
     const Uint8 b = cmd->data.draw.b;
     const Uint8 a = cmd->data.draw.a;
     const SDL_BlendMode blend = cmd->data.draw.blend;
-    SDL_Texture *texture = cmd->data.draw.texture;
-    SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
     const SDL_bool colormod = ((r & g & b) != 0xFF);
     const SDL_bool alphamod = (a != 0xFF);
     const SDL_bool blending = ((blend == SDL_BLENDMODE_ADD) || (blend == SDL_BLENDMODE_MOD) || (blend == SDL_BLENDMODE_MUL));
@@ -585,135 +854,133 @@ PrepTextureForCopy(const SDL_RenderCommand *cmd)
     SDL_SetSurfaceBlendMode(surface, blend);
 }
 
+static void
+GetDrawClipRect(const SW_DrawStateCache *drawstate, SDL_Rect *clip_rect)
+{
+    const SDL_Rect *viewport = drawstate->viewport;
+    const SDL_Rect *cliprect = drawstate->cliprect;
+    SDL_assert(viewport != NULL);  /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
+
+    if (cliprect != NULL) {
+        clip_rect->x = cliprect->x + viewport->x;
+        clip_rect->y = cliprect->y + viewport->y;
+        clip_rect->w = cliprect->w;
+        clip_rect->h = cliprect->h;
+        SDL_IntersectRect(viewport, clip_rect, clip_rect);
+    } else {
+        *clip_rect = *viewport;
+    }
+}
+
 static void
 SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
 {
     if (drawstate->surface_cliprect_dirty) {
-        const SDL_Rect *viewport = drawstate->viewport;
-        const SDL_Rect *cliprect = drawstate->cliprect;
-        SDL_assert(viewport != NULL);  /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
-
-        if (cliprect != NULL) {
-            SDL_Rect clip_rect;
-            clip_rect.x = cliprect->x + viewport->x;
-            clip_rect.y = cliprect->y + viewport->y;
-            clip_rect.w = cliprect->w;
-            clip_rect.h = cliprect->h;
-            SDL_IntersectRect(viewport, &clip_rect, &clip_rect);
-            SDL_SetClipRect(surface, &clip_rect);
-        } else {
-            SDL_SetClipRect(surface, drawstate->viewport);
-        }
+        SDL_Rect clip_rect;
+        GetDrawClipRect(drawstate, &clip_rect);
+        SDL_SetClipRect(surface, &clip_rect);
         drawstate->surface_cliprect_dirty = SDL_FALSE;
     }
 }
 
-static int
-SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+static void
+SW_RunCommand(SDL_Renderer * renderer, SDL_Surface *surface, SW_DrawStateCache *drawstate,
+              const SDL_RenderCommand *cmd, void *vertices)
 {
-    SDL_Surface *surface = SW_ActivateRenderer(renderer);
-    SW_DrawStateCache drawstate;
+    switch (cmd->command) {
+        case SDL_RENDERCMD_SETDRAWCOLOR: {
+            break;  /* Not used in this backend. */
+        }
 
-    if (!surface) {
-        return -1;
-    }
+        case SDL_RENDERCMD_SETVIEWPORT: {
+            drawstate->viewport = &cmd->data.viewport.rect;
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
 
-    drawstate.viewport = NULL;
-    drawstate.cliprect = NULL;
-    drawstate.surface_cliprect_dirty = SDL_TRUE;
+        case SDL_RENDERCMD_SETCLIPRECT: {
+            drawstate->cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;                
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
 
-    while (cmd) {
-        switch (cmd->command) {
-            case SDL_RENDERCMD_SETDRAWCOLOR: {
-                break;  /* Not used in this backend. */
-            }
+        case SDL_RENDERCMD_CLEAR: {
+            const Uint8 r = cmd->data.color.r;
+            const Uint8 g = cmd->data.color.g;
+            const Uint8 b = cmd->data.color.b;
+            const Uint8 a = cmd->data.color.a;
+            /* By definition the clear ignores the clip rect */
+            SDL_SetClipRect(surface, NULL);
+            SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
 
-            case SDL_RENDERCMD_SETVIEWPORT: {
-                drawstate.viewport = &cmd->data.viewport.rect;
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
-                break;
+        case SDL_RENDERCMD_DRAW_POINTS: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            SetDrawState(surface, drawstate);
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
             }
+            break;
+        }
 
-            case SDL_RENDERCMD_SETCLIPRECT: {
-                drawstate.cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;                
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
-                break;
+        case SDL_RENDERCMD_DRAW_LINES: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            SetDrawState(surface, drawstate);
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_DrawLines(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
             }
+            break;
+        }
 
-            case SDL_RENDERCMD_CLEAR: {
-                const Uint8 r = cmd->data.color.r;
-                const Uint8 g = cmd->data.color.g;
-                const Uint8 b = cmd->data.color.b;
-                const Uint8 a = cmd->data.color.a;
-                /* By definition the clear ignores the clip rect */
-                SDL_SetClipRect(surface, NULL);
-                SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
-                break;
+        case SDL_RENDERCMD_FILL_RECTS: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            SetDrawState(surface, drawstate);
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_FillRects(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
             }
+            break;
+        }
 
-            case SDL_RENDERCMD_DRAW_POINTS: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-                if (blend == SDL_BLENDMODE_NONE) {
-                    SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-                } else {
-                    SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
-                }
-                break;
-            }
+        case SDL_RENDERCMD_COPY: {
+            SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const size_t count = cmd->data.draw.count;
+            SDL_Texture *texture = cmd->data.draw.texture;
+            SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+            size_t i;
 
-            case SDL_RENDERCMD_DRAW_LINES: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-                if (blend == SDL_BLENDMODE_NONE) {
-                    SDL_DrawLines(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-                } else {
-                    SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
-                }
-                break;
-            }
+            SetDrawState(surface, drawstate);
 
-            case SDL_RENDERCMD_FILL_RECTS: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                const SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-                if (blend == SDL_BLENDMODE_NONE) {
-                    SDL_FillRects(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-                } else {
-                    SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
-                }
-                break;
-            }
+            PrepTextureForCopy(cmd, src);
 
-            case SDL_RENDERCMD_COPY: {
-                SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            for (i = 0; i < count; i++, verts += 2) {
                 const SDL_Rect *srcrect = verts;
                 SDL_Rect *dstrect = verts + 1;
-                SDL_Texture *texture = cmd->data.draw.texture;
-                SDL_Surface *src = (SDL_Surface *) texture->driverdata;
-
-                SetDrawState(surface, &drawstate);
-
-                PrepTextureForCopy(cmd);
-
                 if ( srcrect->w == dstrect->w && srcrect->h == dstrect->h ) {
                     SDL_BlitSurface(src, srcrect, surface, dstrect);
                 } else {
@@ -721,24 +988,674 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                      * to avoid potentially frequent RLE encoding/decoding.
                      */
                     SDL_SetSurfaceRLE(surface, 0);
-                    SDL_BlitScaled(src, srcrect, surface, dstrect);
+                    SDL_PrivateUpperBlitScaled(src, srcrect, surface, dstrect,
+                                               texture->scaleMode != SDL_ScaleModeNearest);
                 }
-                break;
             }
+            break;
+        }
 
-            case SDL_RENDERCMD_COPY_EX: {
-                const CopyExData *copydata = (CopyExData *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                SetDrawState(surface, &drawstate);
-                PrepTextureForCopy(cmd);
-                SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
-                                &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip);
-                break;
+        case SDL_RENDERCMD_COPY_EX: {
+            const CopyExData *copydata = (CopyExData *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            SetDrawState(surface, drawstate);
+            PrepTextureForCopy(cmd, (SDL_Surface *) cmd->data.draw.texture->driverdata);
+            SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
+                            &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip);
+            break;
+        }
+
+        case SDL_RENDERCMD_GEOMETRY: {
+            const GeometryVertex *verts = (GeometryVertex *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            SDL_Texture *texture = cmd->data.draw.texture;
+            SetDrawState(surface, drawstate);
+            SW_RenderGeometry(surface, texture ? (SDL_Surface *) texture->driverdata : NULL,
+                              cmd->data.draw.blend, verts, cmd->data.draw.count);
+            break;
+        }
+
+        case SDL_RENDERCMD_NO_OP:
+            break;
+    }
+}
+
+/* Tiled rendering for SDL_HINT_RENDER_SOFTWARE_THREADS.
+ *
+ * Commands whose pixels don't depend on how they are clipped (clears, points,
+ * filled rects, unscaled copies and geometry) are binned by their destination
+ * rect into tiles of the render target, and a pool of threads renders whole
+ * tiles, each clipped to its tile. Anything else (lines, scaled and rotated
+ * copies) waits for the binned work to finish and runs on the calling thread,
+ * so the output is identical to rendering the queue serially.
+ */
+#define SW_TILE_SIZE 128
+
+typedef struct
+{
+    const SDL_RenderCommand *cmd;
+    SDL_Rect clip;  /* the command's clip rect, narrowed to what this item can touch */
+    int index;      /* which rect of a FILL_RECTS or COPY command */
+    int source;     /* texture slot, or -1 */
+} SW_TileItem;
+
+typedef struct
+{
+    SW_TileContext *context;
+    SDL_Thread *thread;
+    SDL_sem *work_sem;
+    SDL_Surface *target;    /* shares the render target's pixels, with its own clip rect */
+    SDL_Surface **sources;  /* share the textures' pixels, with their own blit state */
+    int num_sources;
+    int max_sources;
+} SW_TileWorker;
+
+struct SW_TileContext
+{
+    SW_TileWorker *workers;  /* workers[0] is the thread running the command queue */
+    int num_workers;
+    SDL_sem *done_sem;
+    SDL_bool quit;
+
+    const Uint8 *vertices;
+    int tiles_x;
+    int tiles_y;
+    SDL_atomic_t next_tile;
+
+    SW_TileItem *items;
+    int num_items;
+    int max_items;
+    int *bins;         /* item indices of every tile, back to back */
+    int num_bin_items;
+    int max_bin_items;
+    int *bin_offsets;  /* where each tile starts in bins, plus one past the end */
+    int max_tiles;
+
+    SDL_Surface **sources;  /* texture surfaces referenced by items */
+    int num_sources;
+    int max_sources;
+};
+
+static void
+SW_RenderTileItem(SW_TileContext *ctx, SW_TileWorker *worker, const SW_TileItem *item, const SDL_Rect *tile)
+{
+    const SDL_RenderCommand *cmd = item->cmd;
+    SDL_Surface *surface = worker->target;
+    SDL_Rect clip_rect;
+
+    if (!SDL_IntersectRect(&item->clip, tile, &clip_rect)) {
+        return;
+    }
+    SDL_SetClipRect(surface, &clip_rect);
+
+    switch (cmd->command) {
+        case SDL_RENDERCMD_CLEAR: {
+            const Uint8 r = cmd->data.color.r;
+            const Uint8 g = cmd->data.color.g;
+            const Uint8 b = cmd->data.color.b;
+            const Uint8 a = cmd->data.color.a;
+            SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
+            break;
+        }
+
+        case SDL_RENDERCMD_DRAW_POINTS: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Point *verts = (const SDL_Point *) (ctx->vertices + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_FILL_RECTS: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const SDL_Rect *rect = ((const SDL_Rect *) (ctx->vertices + cmd->data.draw.first)) + item->index;
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_FillRect(surface, rect, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendFillRect(surface, rect, blend, r, g, b, a);
             }
+            break;
+        }
 
+        case SDL_RENDERCMD_COPY: {
+            const SDL_Rect *verts = ((const SDL_Rect *) (ctx->vertices + cmd->data.draw.first)) + (item->index * 2);
+            SDL_Surface *src = worker->sources[item->source];
+            SDL_Rect dstrect = verts[1];  /* SDL_BlitSurface() writes the final rect back. */
+            PrepTextureForCopy(cmd, src);
+            SDL_BlitSurface(src, &verts[0], surface, &dstrect);
+            break;
+        }
+
+        case SDL_RENDERCMD_GEOMETRY: {
+            const GeometryVertex *verts = (const GeometryVertex *) (ctx->vertices + cmd->data.draw.first);
+            SW_RenderGeometry(surface, (item->source >= 0) ? worker->sources[item->source] : NULL,
+                              cmd->data.draw.blend, verts, cmd->data.draw.count);
+            break;
+        }
+
+        default:
+            SDL_assert(!"Command was binned but can't be rendered by tile");
+            break;
+    }
+}
+
+static void
+SW_RenderTiles(SW_TileContext *ctx, SW_TileWorker *worker)
+{
+    const int num_tiles = ctx->tiles_x * ctx->tiles_y;
+    int tile;
+
+    while ((tile = SDL_AtomicAdd(&ctx->next_tile, 1)) < num_tiles) {
+        SDL_Rect rect;
+        int i;
+
+        rect.x = (tile % ctx->tiles_x) * SW_TILE_SIZE;
+        rect.y = (tile / ctx->tiles_x) * SW_TILE_SIZE;
+        rect.w = rect.h = SW_TILE_SIZE;
+
+        for (i = ctx->bin_offsets[tile]; i < ctx->bin_offsets[tile + 1]; i++) {
+            SW_RenderTileItem(ctx, worker, &ctx->items[ctx->bins[i]], &rect);
+        }
+    }
+}
+
+static int SDLCALL
+SW_TileThread(void *data)
+{
+    SW_TileWorker *worker = (SW_TileWorker *) data;
+    SW_TileContext *ctx = worker->context;
+
+    for (;;) {
+        SDL_SemWait(worker->work_sem);
+        if (ctx->quit) {
+            break;
+        }
+        SW_RenderTiles(ctx, worker);
+        SDL_SemPost(ctx->done_sem);
+    }
+    return 0;
+}
+
+static void
+SW_DestroyTileContext(SW_TileContext *ctx)
+{
+    int i;
+
+    if (!ctx) {
+        return;
+    }
+
+    ctx->quit = SDL_TRUE;
+    for (i = 1; i < ctx->num_workers; i++) {
+        SDL_SemPost(ctx->workers[i].work_sem);
+    }
+    for (i = 1; i < ctx->num_workers; i++) {
+        SW_TileWorker *worker = &ctx->workers[i];
+        SDL_WaitThread(worker->thread, NULL);
+        SDL_DestroySemaphore(worker->work_sem);
+        SDL_free(worker->sources);
+    }
+    if (ctx->done_sem) {
+        SDL_DestroySemaphore(ctx->done_sem);
+    }
+    SDL_free(ctx->workers);
+    SDL_free(ctx->items);
+    SDL_free(ctx->bins);
+    SDL_free(ctx->bin_offsets);
+    SDL_free(ctx->sources);
+    SDL_free(ctx);
+}
+
+static SW_TileContext *
+SW_CreateTileContext(int num_threads)
+{
+    SW_TileContext *ctx = (SW_TileContext *) SDL_calloc(1, sizeof (*ctx));
+    int i;
+
+    if (!ctx) {
+        return NULL;
+    }
+
+    ctx->workers = (SW_TileWorker *) SDL_calloc(num_threads, sizeof (*ctx->workers));
+    ctx->done_sem = SDL_CreateSemaphore(0);
+    if (!ctx->workers || !ctx->done_sem) {
+        SW_DestroyTileContext(ctx);
+        return NULL;
+    }
+
+    ctx->workers[0].context = ctx;
+    ctx->num_workers = 1;
+    for (i = 1; i < num_threads; i++) {
+        SW_TileWorker *worker = &ctx->workers[i];
+        char name[64];
+
+        worker->context = ctx;
+        worker->work_sem = SDL_CreateSemaphore(0);
+        if (!worker->work_sem) {
+            break;
+        }
+        SDL_snprintf(name, sizeof (name), "SDLRenderTiles%d", i);
+        worker->thread = SDL_CreateThreadInternal(SW_TileThread, name, 0, worker);
+        if (!worker->thread) {
+            SDL_DestroySemaphore(worker->work_sem);
+            worker->work_sem = NULL;
+            break;
+        }
+        ctx->num_workers++;
+    }
+
+    if (ctx->num_workers < 2) {
+        SW_DestroyTileContext(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+static int
+SW_BeginTiles(SW_TileContext *ctx, SDL_Surface *surface, void *vertices)
+{
+    const int tiles_x = (surface->w + SW_TILE_SIZE - 1) / SW_TILE_SIZE;
+    const int tiles_y = (surface->h + SW_TILE_SIZE - 1) / SW_TILE_SIZE;
+
+    /* the other threads render into surfaces that share the target's pixels,
+       which isn't safe for palettes and RLE, and pointless for tiny targets. */
+    if (SDL_MUSTLOCK(surface) || surface->format->BytesPerPixel < 2 || (tiles_x * tiles_y) < 2) {
+        return -1;
+    }
+
+    if ((tiles_x * tiles_y) > ctx->max_tiles) {
+        int *bin_offsets = (int *) SDL_realloc(ctx->bin_offsets, (tiles_x * tiles_y + 1) * sizeof (int));
+        if (!bin_offsets) {
+            return -1;
+        }
+        ctx->bin_offsets = bin_offsets;
+        ctx->max_tiles = tiles_x * tiles_y;
+    }
+
+    ctx->tiles_x = tiles_x;
+    ctx->tiles_y = tiles_y;
+    ctx->vertices = (const Uint8 *) vertices;
+    ctx->num_items = 0;
+    ctx->num_bin_items = 0;
+    ctx->num_sources = 0;
+    ctx->workers[0].target = surface;
+    return 0;
+}
+
+static void
+SW_EndTiles(SW_TileContext *ctx)
+{
+    int i, j;
+
+    for (i = 1; i < ctx->num_workers; i++) {
+        SW_TileWorker *worker = &ctx->workers[i];
+        for (j = 0; j < worker->num_sources; j++) {
+            SDL_FreeSurface(worker->sources[j]);
+        }
+        worker->num_sources = 0;
+        SDL_FreeSurface(worker->target);
+        worker->target = NULL;
+    }
+    ctx->workers[0].target = NULL;
+}
+
+/* Give a worker its own surfaces for the target and every texture binned so
+   far, since blitting changes state in both. This runs on the calling thread,
+   because creating surfaces isn't thread safe. */
+static SDL_bool
+SW_PrepTileWorker(SW_TileContext *ctx, SW_TileWorker *worker, SDL_Surface *surface)
+{
+    if (!worker->target) {
+        worker->target = SDL_CreateRGBSurfaceWithFormatFrom(surface->pixels, surface->w, surface->h,
+                                                            surface->format->BitsPerPixel, surface->pitch,
+                                                            surface->format->format);
+        if (!worker->target) {
+            return SDL_FALSE;
+        }
+    }
+
+    if (ctx->num_sources > worker->max_sources) {
+        SDL_Surface **sources = (SDL_Surface **) SDL_realloc(worker->sources, ctx->max_sources * sizeof (SDL_Surface *));
+        if (!sources) {
+            return SDL_FALSE;
+        }
+        worker->sources = sources;
+        worker->max_sources = ctx->max_sources;
+    }
+
+    while (worker->num_sources < ctx->num_sources) {
+        SDL_Surface *src = ctx->sources[worker->num_sources];
+        SDL_Surface *clone = SDL_CreateRGBSurfaceWithFormatFrom(src->pixels, src->w, src->h,
+                                                               src->format->BitsPerPixel, src->pitch,
+                                                               src->format->format);
+        if (!clone) {
+            return SDL_FALSE;
+        }
+        worker->sources[worker->num_sources++] = clone;
+    }
+    return SDL_TRUE;
+}
+
+static void
+SW_FlushTiles(SW_TileContext *ctx, SDL_Surface *surface, SW_DrawStateCache *drawstate)
+{
+    const int num_tiles = ctx->tiles_x * ctx->tiles_y;
+    int num_posted = 0;
+    int i, tile;
+
+    if (ctx->num_items == 0) {
+        return;
+    }
+
+    /* count the items of each tile, then fill the bins in queue order. */
+    SDL_memset(ctx->bin_offsets, 0, (num_tiles + 1) * sizeof (int));
+    for (i = 0; i < ctx->num_items; i++) {
+        const SDL_Rect *clip = &ctx->items[i].clip;
+        const int x0 = clip->x / SW_TILE_SIZE, x1 = (clip->x + clip->w - 1) / SW_TILE_SIZE;
+        const int y0 = clip->y / SW_TILE_SIZE, y1 = (clip->y + clip->h - 1) / SW_TILE_SIZE;
+        int x, y;
+        for (y = y0; y <= y1; y++) {
+            for (x = x0; x <= x1; x++) {
+                ctx->bin_offsets[(y * ctx->tiles_x) + x + 1]++;
+            }
+        }
+    }
+    for (tile = 0; tile < num_tiles; tile++) {
+        ctx->bin_offsets[tile + 1] += ctx->bin_offsets[tile];
+    }
+    SDL_assert(ctx->bin_offsets[num_tiles] == ctx->num_bin_items);
+    for (i = 0; i < ctx->num_items; i++) {
+        const SDL_Rect *clip = &ctx->items[i].clip;
+        const int x0 = clip->x / SW_TILE_SIZE, x1 = (clip->x + clip->w - 1) / SW_TILE_SIZE;
+        const int y0 = clip->y / SW_TILE_SIZE, y1 = (clip->y + clip->h - 1) / SW_TILE_SIZE;
+        int x, y;
+        for (y = y0; y <= y1; y++) {
+            for (x = x0; x <= x1; x++) {
+                ctx->bins[ctx->bin_offsets[(y * ctx->tiles_x) + x]++] = i;
+            }
+        }
+    }
+    for (tile = num_tiles; tile > 0; tile--) {
+        ctx->bin_offsets[tile] = ctx->bin_offsets[tile - 1];
+    }
+    ctx->bin_offsets[0] = 0;
+
+    /* the calling thread works on the real surfaces, the others on their own. */
+    ctx->workers[0].sources = ctx->sources;
+    SDL_AtomicSet(&ctx->next_tile, 0);
+    for (i = 1; i < ctx->num_workers; i++) {
+        SW_TileWorker *worker = &ctx->workers[i];
+        if (SW_PrepTileWorker(ctx, worker, surface)) {
+            SDL_SemPost(worker->work_sem);
+            num_posted++;
+        }
+    }
+    SW_RenderTiles(ctx, &ctx->workers[0]);
+    while (num_posted--) {
+        SDL_SemWait(ctx->done_sem);
+    }
+
+    ctx->num_items = 0;
+    ctx->num_bin_items = 0;
+    drawstate->surface_cliprect_dirty = SDL_TRUE;
+}
+
+static int
+SW_GetTileSource(SW_TileContext *ctx, SDL_Texture *texture)
+{
+    SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+    int i;
+
+    for (i = ctx->num_sources - 1; i >= 0; i--) {
+        if (ctx->sources[i] == src) {
+            return i;
+        }
+    }
+
+    /* the other threads read the pixels directly, so they can't be RLE encoded. */
+    SDL_SetSurfaceRLE(src, 0);
+#if SDL_HAVE_RLE
+    if (src->flags & SDL_RLEACCEL) {
+        SDL_UnRLESurface(src, 1);
+    }
+#endif
+    if (SDL_MUSTLOCK(src) || !src->pixels) {
+        return -1;
+    }
+
+    if (ctx->num_sources == ctx->max_sources) {
+        const int max_sources = ctx->max_sources ? (ctx->max_sources * 2) : 16;
+        SDL_Surface **sources = (SDL_Surface **) SDL_realloc(ctx->sources, max_sources * sizeof (SDL_Surface *));
+        if (!sources) {
+            return -1;
+        }
+        ctx->sources = sources;
+        ctx->max_sources = max_sources;
+    }
+    ctx->sources[ctx->num_sources] = src;
+    return ctx->num_sources++;
+}
+
+static int
+SW_AddTileItem(SW_TileContext *ctx, const SDL_RenderCommand *cmd, const SDL_Rect *clip, int index, int source)
+{
+    const int num_bin_items = ctx->num_bin_items +
+        (((clip->x + clip->w - 1) / SW_TILE_SIZE) - (clip->x / SW_TILE_SIZE) + 1) *
+        (((clip->y + clip->h - 1) / SW_TILE_SIZE) - (clip->y / SW_TILE_SIZE) + 1);
+    SW_TileItem *item;
+
+    if (ctx->num_items == ctx->max_items) {
+        const int max_items = ctx->max_items ? (ctx->max_items * 2) : 256;
+        SW_TileItem *items = (SW_TileItem *) SDL_realloc(ctx->items, max_items * sizeof (SW_TileItem));
+        if (!items) {
+            return -1;
+        }
+        ctx->items = items;
+        ctx->max_items = max_items;
+    }
+
+    if (num_bin_items > ctx->max_bin_items) {
+        const int max_bin_items = SDL_max(num_bin_items, ctx->max_bin_items * 2);
+        int *bins = (int *) SDL_realloc(ctx->bins, max_bin_items * sizeof (int));
+        if (!bins) {
+            return -1;
+        }
+        ctx->bins = bins;
+        ctx->max_bin_items = max_bin_items;
+    }
+
+    item = &ctx->items[ctx->num_items++];
+    item->cmd = cmd;
+    item->clip = *clip;
+    item->index = index;
+    item->source = source;
+    ctx->num_bin_items = num_bin_items;
+    return 0;
+}
+
+/* Queue a command for the tiles. Returns -1 if it has to be rendered
+   serially instead, in which case nothing of it was queued. */
+static int
+SW_BinCommand(SW_TileContext *ctx, SDL_Surface *surface, const SW_DrawStateCache *drawstate,
+              const SDL_RenderCommand *cmd)
+{
+    const int num_items = ctx->num_items;
+    const int num_bin_items = ctx->num_bin_items;
+    SDL_Rect clip_rect, bounds, rect;
+    int i, source = -1;
+
+    bounds.x = bounds.y = 0;
+    bounds.w = surface->w;
+    bounds.h = surface->h;
+
+    if (cmd->command == SDL_RENDERCMD_CLEAR) {
+        /* By definition the clear ignores the clip rect */
+        return SW_AddTileItem(ctx, cmd, &bounds, 0, -1);
+    }
+
+    GetDrawClipRect(drawstate, &clip_rect);
+    if (!SDL_IntersectRect(&clip_rect, &bounds, &clip_rect)) {
+        return 0;  /* nothing to draw. */
+    }
+
+    switch (cmd->command) {
+        case SDL_RENDERCMD_DRAW_POINTS: {
+            const SDL_Point *verts = (const SDL_Point *) (ctx->vertices + cmd->data.draw.first);
+            const int count = (int) cmd->data.draw.count;
+            if (!SDL_EnclosePoints(verts, count, &clip_rect, &rect)) {
+                return 0;
+            }
+            return SW_AddTileItem(ctx, cmd, &rect, 0, -1);
+        }
+
+        case SDL_RENDERCMD_FILL_RECTS: {
+            const SDL_Rect *verts = (const SDL_Rect *) (ctx->vertices + cmd->data.draw.first);
+            const int count = (int) cmd->data.draw.count;
+            for (i = 0; i < count; i++) {
+                if (SDL_IntersectRect(&verts[i], &clip_rect, &rect) &&
+                    SW_AddTileItem(ctx, cmd, &rect, i, -1) < 0) {
+                    goto failed;
+                }
+            }
+            return 0;
+        }
+
+        case SDL_RENDERCMD_COPY: {
+            const SDL_Rect *verts = (const SDL_Rect *) (ctx->vertices + cmd->data.draw.first);
+            const int count = (int) cmd->data.draw.count;
+            for (i = 0; i < count; i++) {
+                if (verts[i * 2].w != verts[i * 2 + 1].w || verts[i * 2].h != verts[i * 2 + 1].h) {
+                    return -1;  /* scaling doesn't give the same pixels when clipped differently. */
+                }
+            }
+            source = SW_GetTileSource(ctx, cmd->data.draw.texture);
+            if (source < 0) {
+                return -1;
+            }
+            for (i = 0; i < count; i++) {
+                if (SDL_IntersectRect(&verts[i * 2 + 1], &clip_rect, &rect) &&
+                    SW_AddTileItem(ctx, cmd, &rect, i, source) < 0) {
+                    goto failed;
+                }
+            }
+            return 0;
+        }
+
+        case SDL_RENDERCMD_GEOMETRY: {
+            const GeometryVertex *verts = (const GeometryVertex *) (ctx->vertices + cmd->data.draw.first);
+            const size_t count = cmd->data.draw.count;
+            Sint32 minx, miny, maxx, maxy;
+            size_t j;
+
+            if (count < 3) {
+                return 0;
+            }
+            if (cmd->data.draw.texture) {
+                source = SW_GetTileSource(ctx, cmd->data.draw.texture);
+                if (source < 0) {
+                    return -1;
+                }
+            }
+            minx = maxx = verts[0].x;
+            miny = maxy = verts[0].y;
+            for (j = 1; j < count; j++) {
+                minx = SDL_min(minx, verts[j].x);
+                miny = SDL_min(miny, verts[j].y);
+                maxx = SDL_max(maxx, verts[j].x);
+                maxy = SDL_max(maxy, verts[j].y);
+            }
+            rect.x = minx >> GEOMETRY_SUBPIXEL_BITS;
+            rect.y = miny >> GEOMETRY_SUBPIXEL_BITS;
+            rect.w = (maxx >> GEOMETRY_SUBPIXEL_BITS) - rect.x + 1;
+            rect.h = (maxy >> GEOMETRY_SUBPIXEL_BITS) - rect.y + 1;
+            if (!SDL_IntersectRect(&rect, &clip_rect, &rect)) {
+                return 0;
+            }
+            return SW_AddTileItem(ctx, cmd, &rect, 0, source);
+        }
+
+        default:
+            return -1;
+    }
+
+failed:
+    ctx->num_items = num_items;
+    ctx->num_bin_items = num_bin_items;
+    return -1;
+}
+
+static int
+SW_RunCommandQueueTiled(SDL_Renderer * renderer, SDL_Surface *surface, SDL_RenderCommand *cmd, void *vertices)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SW_TileContext *ctx = data->tiles;
+    SW_DrawStateCache drawstate;
+
+    drawstate.viewport = NULL;
+    drawstate.cliprect = NULL;
+    drawstate.surface_cliprect_dirty = SDL_TRUE;
+
+    while (cmd) {
+        switch (cmd->command) {
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+            case SDL_RENDERCMD_SETVIEWPORT:
+            case SDL_RENDERCMD_SETCLIPRECT:
             case SDL_RENDERCMD_NO_OP:
+                SW_RunCommand(renderer, surface, &drawstate, cmd, vertices);
+                break;
+
+            default:
+                if (SW_BinCommand(ctx, surface, &drawstate, cmd) < 0) {
+                    SW_FlushTiles(ctx, surface, &drawstate);
+                    SW_RunCommand(renderer, surface, &drawstate, cmd, vertices);
+                }
                 break;
         }
+        cmd = cmd->next;
+    }
+
+    SW_FlushTiles(ctx, surface, &drawstate);
+    SW_EndTiles(ctx);
+    return 0;
+}
 
+static int
+SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SW_DrawStateCache drawstate;
+
+    if (!surface) {
+        return -1;
+    }
+
+    if (data->num_threads > 1 && !data->tiles) {
+        data->tiles = SW_CreateTileContext(data->num_threads);
+        if (!data->tiles) {
+            data->num_threads = 1;  /* don't try again, just render serially. */
+        }
+    }
+    if (data->tiles && SW_BeginTiles(data->tiles, surface, vertices) == 0) {
+        return SW_RunCommandQueueTiled(renderer, surface, cmd, vertices);
+    }
+
+    drawstate.viewport = NULL;
+    drawstate.cliprect = NULL;
+    drawstate.surface_cliprect_dirty = SDL_TRUE;
+
+    while (cmd) {
+        SW_RunCommand(renderer, surface, &drawstate, cmd, vertices);
         cmd = cmd->next;
     }
 
@@ -799,6 +1716,9 @@ SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+    if (data) {
+        SW_DestroyTileContext(data->tiles);
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -808,6 +1728,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
 {
     SDL_Renderer *renderer;
     SW_RenderData *data;
+    const char *hint;
 
     if (!surface) {
         SDL_SetError("Can't create renderer for NULL surface");
@@ -829,6 +1750,15 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     data->surface = surface;
     data->window = surface;
 
+    data->num_threads = 1;
+    hint = SDL_GetHint(SDL_HINT_RENDER_SOFTWARE_THREADS);
+    if (hint && *hint) {
+        data->num_threads = SDL_atoi(hint);
+        if (data->num_threads <= 0) {
+            data->num_threads = SDL_GetCPUCount();
+        }
+    }
+
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
     renderer->CreateTexture = SW_CreateTexture;
@@ -843,7 +1773,9 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->QueueDrawLines = SW_QueueDrawPoints;  /* lines and points queue vertices the same way. */
     renderer->QueueFillRects = SW_QueueFillRects;
     renderer->QueueCopy = SW_QueueCopy;
+    renderer->QueueCopies = SW_QueueCopies;
     renderer->QueueCopyEx = SW_QueueCopyEx;
+    renderer->QueueGeometry = SW_QueueGeometry;
     renderer->RunCommandQueue = SW_RunCommandQueue;
     renderer->RenderReadPixels = SW_RenderReadPixels;
     renderer->RenderPresent = SW_RenderPresent;
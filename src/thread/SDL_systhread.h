@@ -65,6 +65,11 @@ extern SDL_Thread *
 SDL_CreateThreadInternal(int (SDLCALL * fn) (void *), const char *name,
                          const size_t stacksize, void *data);
 
+/* A mutex for internal hot paths that is never locked recursively. It's
+   used with the usual mutex functions, and is just a regular SDL_mutex on
+   platforms without a faster non-recursive lock. */
+extern SDL_mutex *SDL_CreateFastMutex(void);
+
 #endif /* SDL_systhread_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
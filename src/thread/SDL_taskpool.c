@@ -0,0 +1,649 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* The task pool, a few worker threads running short tasks */
+
+#include "SDL_thread.h"
+#include "SDL_atomic.h"
+#include "SDL_hints.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_assert.h"
+#include "SDL_systhread.h"
+#include "SDL_taskpool_c.h"
+
+/* Every worker owns a fixed size work-stealing deque, after Chase and Lev,
+ * "Dynamic Circular Work-Stealing Deque". The owner pushes and pops tasks at
+ * the bottom without locking, and other threads steal from the top with a
+ * compare-and-swap. Tasks added by threads outside the pool, and tasks that
+ * don't fit in a full deque, go into a queue shared by everyone that is
+ * protected by the pool lock.
+ *
+ * The top and bottom counters only ever grow (modulo 2^32), so differences
+ * between them are computed as unsigned values.
+ */
+#define SDL_TASK_DEQUE_SIZE 256     /* Must be a power of two */
+#define SDL_TASK_DEQUE_MASK (SDL_TASK_DEQUE_SIZE - 1)
+
+/* SDL_ParallelFor() makes at most about this many pieces per thread */
+#define SDL_TASKS_PER_THREAD 8
+
+typedef struct SDL_Task SDL_Task;
+typedef struct SDL_ParallelForJob SDL_ParallelForJob;
+
+struct SDL_TaskGroup
+{
+    SDL_atomic_t pending;       /* Tasks added but not finished yet */
+};
+
+struct SDL_Task
+{
+    SDL_TaskFunction fn;
+    void *data;
+    SDL_TaskGroup *group;
+    SDL_ParallelForJob *job;    /* Set for the pieces of SDL_ParallelFor() */
+    int start;
+    int end;
+    SDL_bool allocated;         /* Freed once it has run */
+    SDL_Task *next;             /* Next task in the shared queue */
+};
+
+struct SDL_ParallelForJob
+{
+    SDL_ParallelForFunction fn;
+    void *data;
+    int grain;
+    SDL_Task *tasks;            /* Storage for all the pieces */
+    SDL_atomic_t nexttask;
+};
+
+typedef struct SDL_TaskPool SDL_TaskPool;
+
+typedef struct SDL_TaskWorker
+{
+    /* Written by thieves */
+    SDL_atomic_t top;
+
+    /* Padding to separate cache lines between threads */
+    char cache_pad1[SDL_CACHELINE_SIZE];
+
+    /* Written by the owner */
+    SDL_atomic_t bottom;
+    SDL_Task *tasks[SDL_TASK_DEQUE_SIZE];
+
+    SDL_TaskPool *pool;
+    SDL_Thread *thread;
+    Uint32 seed;                /* For picking whom to steal from */
+
+    char cache_pad2[SDL_CACHELINE_SIZE];
+} SDL_TaskWorker;
+
+struct SDL_TaskPool
+{
+    SDL_TaskWorker *workers;
+    int maxworkers;             /* Workers allocated */
+    int numworkers;             /* Workers actually running */
+
+    SDL_mutex *lock;
+    SDL_cond *wakeup;           /* Signaled when tasks are added for sleeping workers */
+    SDL_cond *finished;         /* Broadcast when a task group finishes */
+    SDL_Task *queue_head;       /* The shared queue, protected by the lock */
+    SDL_Task *queue_tail;
+    SDL_atomic_t queued;        /* Number of tasks in the shared queue */
+    SDL_atomic_t sleeping;      /* Number of workers waiting for tasks */
+    SDL_atomic_t shutdown;
+};
+
+static SDL_TaskPool *SDL_task_pool = NULL;
+static SDL_SpinLock SDL_task_pool_lock = 0;
+static SDL_TLSID SDL_task_worker_tls = 0;
+
+static SDL_bool
+SDL_PushWorkerTask(SDL_TaskWorker *worker, SDL_Task *task)
+{
+    const Uint32 bottom = (Uint32)SDL_AtomicGet(&worker->bottom);
+    const Uint32 top = (Uint32)SDL_AtomicGet(&worker->top);
+
+    if (bottom - top >= SDL_TASK_DEQUE_SIZE) {
+        return SDL_FALSE;
+    }
+    worker->tasks[bottom & SDL_TASK_DEQUE_MASK] = task;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&worker->bottom, (int)(bottom + 1));
+    return SDL_TRUE;
+}
+
+/* Takes the task pushed last. Only called by the owner of the deque. */
+static SDL_Task *
+SDL_PopWorkerTask(SDL_TaskWorker *worker)
+{
+    /* Claim the bottom slot before looking at the top, with a full barrier */
+    const Uint32 bottom = (Uint32)SDL_AtomicAdd(&worker->bottom, -1) - 1;
+    const Uint32 top = (Uint32)SDL_AtomicGet(&worker->top);
+    SDL_Task *task = NULL;
+
+    if ((Sint32)(bottom - top) >= 0) {
+        task = worker->tasks[bottom & SDL_TASK_DEQUE_MASK];
+        if (bottom == top) {
+            /* This is the last task, race the thieves for it */
+            if (!SDL_AtomicCAS(&worker->top, (int)top, (int)(top + 1))) {
+                task = NULL;
+            }
+            SDL_AtomicSet(&worker->bottom, (int)(bottom + 1));
+        }
+    } else {
+        /* The deque was empty */
+        SDL_AtomicSet(&worker->bottom, (int)(bottom + 1));
+    }
+    return task;
+}
+
+/* Takes the oldest task of another worker. This may fail spuriously if
+   someone else takes a task at the same time. */
+static SDL_Task *
+SDL_StealWorkerTask(SDL_TaskWorker *worker)
+{
+    const Uint32 top = (Uint32)SDL_AtomicGet(&worker->top);
+    const Uint32 bottom = (Uint32)SDL_AtomicGet(&worker->bottom);
+
+    if ((Sint32)(bottom - top) > 0) {
+        SDL_Task *task = (SDL_Task *)SDL_AtomicGetPtr((void **)&worker->tasks[top & SDL_TASK_DEQUE_MASK]);
+        if (SDL_AtomicCAS(&worker->top, (int)top, (int)(top + 1))) {
+            return task;
+        }
+    }
+    return NULL;
+}
+
+static SDL_bool
+SDL_TaskPoolHasWork(SDL_TaskPool *pool)
+{
+    int i;
+
+    if (SDL_AtomicGet(&pool->queued) > 0) {
+        return SDL_TRUE;
+    }
+    for (i = 0; i < pool->maxworkers; ++i) {
+        SDL_TaskWorker *worker = &pool->workers[i];
+        if ((Sint32)((Uint32)SDL_AtomicGet(&worker->bottom) - (Uint32)SDL_AtomicGet(&worker->top)) > 0) {
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+/* Returns the worker running on the current thread, or NULL */
+static SDL_TaskWorker *
+SDL_GetCurrentTaskWorker(SDL_TaskPool *pool)
+{
+    SDL_TaskWorker *worker = (SDL_TaskWorker *)SDL_TLSGet(SDL_task_worker_tls);
+
+    if (worker && worker->pool == pool) {
+        return worker;
+    }
+    return NULL;
+}
+
+static void
+SDL_PushTask(SDL_TaskPool *pool, SDL_Task *task)
+{
+    SDL_TaskWorker *worker = SDL_GetCurrentTaskWorker(pool);
+
+    if (worker && SDL_PushWorkerTask(worker, task)) {
+        /* Read the number of sleeping workers with a full barrier, so either
+           we see them or they see the new task before going to sleep */
+        if (SDL_AtomicAdd(&pool->sleeping, 0) > 0) {
+            SDL_LockMutex(pool->lock);
+            SDL_CondSignal(pool->wakeup);
+            SDL_UnlockMutex(pool->lock);
+        }
+        return;
+    }
+
+    SDL_LockMutex(pool->lock);
+    task->next = NULL;
+    if (pool->queue_tail) {
+        pool->queue_tail->next = task;
+    } else {
+        pool->queue_head = task;
+    }
+    pool->queue_tail = task;
+    SDL_AtomicIncRef(&pool->queued);
+    if (SDL_AtomicGet(&pool->sleeping) > 0) {
+        SDL_CondSignal(pool->wakeup);
+    }
+    SDL_UnlockMutex(pool->lock);
+}
+
+static SDL_Task *
+SDL_FindTask(SDL_TaskPool *pool, SDL_TaskWorker *self)
+{
+    SDL_Task *task;
+    int i, first = 0;
+
+    /* Our own tasks first, newest first while they're still in the cache */
+    if (self) {
+        task = SDL_PopWorkerTask(self);
+        if (task) {
+            return task;
+        }
+    }
+
+    if (SDL_AtomicGet(&pool->queued) > 0) {
+        SDL_LockMutex(pool->lock);
+        task = pool->queue_head;
+        if (task) {
+            pool->queue_head = task->next;
+            if (!pool->queue_head) {
+                pool->queue_tail = NULL;
+            }
+            SDL_AtomicAdd(&pool->queued, -1);
+        }
+        SDL_UnlockMutex(pool->lock);
+        if (task) {
+            return task;
+        }
+    }
+
+    if (pool->maxworkers == 0) {
+        return NULL;
+    }
+
+    /* Steal from the others, starting with a random one */
+    if (self) {
+        self->seed ^= self->seed << 13;
+        self->seed ^= self->seed >> 17;
+        self->seed ^= self->seed << 5;
+        first = (int)(self->seed % (Uint32)pool->maxworkers);
+    }
+    for (i = 0; i < pool->maxworkers; ++i) {
+        SDL_TaskWorker *victim = &pool->workers[(first + i) % pool->maxworkers];
+        if (victim != self) {
+            task = SDL_StealWorkerTask(victim);
+            if (task) {
+                return task;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void
+SDL_RunPoolTask(SDL_TaskPool *pool, SDL_Task *task)
+{
+    SDL_TaskGroup *group = task->group;
+
+    if (task->job) {
+        /* Split off the upper half for someone else until the rest is small */
+        SDL_ParallelForJob *job = task->job;
+        int start = task->start;
+        int end = task->end;
+
+        while ((Sint64)end - start >= 2 * (Sint64)job->grain) {
+            const int mid = (int)(start + ((Sint64)end - start) / 2);
+            SDL_Task *split = &job->tasks[SDL_AtomicIncRef(&job->nexttask)];
+
+            split->fn = NULL;
+            split->data = NULL;
+            split->group = group;
+            split->job = job;
+            split->start = mid;
+            split->end = end;
+            split->allocated = SDL_FALSE;
+            SDL_AtomicIncRef(&group->pending);
+            SDL_PushTask(pool, split);
+
+            end = mid;
+        }
+        job->fn(job->data, start, end);
+    } else {
+        task->fn(task->data);
+    }
+
+    if (task->allocated) {
+        SDL_free(task);
+    }
+
+    /* The group may be gone as soon as it's finished, don't touch it after */
+    if (SDL_AtomicDecRef(&group->pending)) {
+        SDL_LockMutex(pool->lock);
+        SDL_CondBroadcast(pool->finished);
+        SDL_UnlockMutex(pool->lock);
+    }
+}
+
+static void
+SDL_WaitForTasks(SDL_TaskPool *pool, SDL_TaskGroup *group)
+{
+    SDL_TaskWorker *self = SDL_GetCurrentTaskWorker(pool);
+
+    while (SDL_AtomicGet(&group->pending) > 0) {
+        /* Help out while waiting, this also keeps nested waits from deadlocking */
+        SDL_Task *task = SDL_FindTask(pool, self);
+        if (task) {
+            SDL_RunPoolTask(pool, task);
+            continue;
+        }
+
+        SDL_LockMutex(pool->lock);
+        if (SDL_AtomicGet(&group->pending) > 0 && !SDL_TaskPoolHasWork(pool)) {
+            SDL_CondWait(pool->finished, pool->lock);
+        }
+        SDL_UnlockMutex(pool->lock);
+    }
+}
+
+static int SDLCALL
+SDL_TaskWorkerThread(void *data)
+{
+    SDL_TaskWorker *self = (SDL_TaskWorker *)data;
+    SDL_TaskPool *pool = self->pool;
+
+    SDL_TLSSet(SDL_task_worker_tls, self, NULL);
+
+    for ( ; ; ) {
+        SDL_Task *task = SDL_FindTask(pool, self);
+        if (task) {
+            SDL_RunPoolTask(pool, task);
+            continue;
+        }
+
+        SDL_LockMutex(pool->lock);
+        SDL_AtomicIncRef(&pool->sleeping);
+        if (!SDL_TaskPoolHasWork(pool)) {
+            if (SDL_AtomicGet(&pool->shutdown)) {
+                SDL_AtomicAdd(&pool->sleeping, -1);
+                SDL_UnlockMutex(pool->lock);
+                break;
+            }
+            SDL_CondWait(pool->wakeup, pool->lock);
+        }
+        SDL_AtomicAdd(&pool->sleeping, -1);
+        SDL_UnlockMutex(pool->lock);
+    }
+
+    SDL_TLSSet(SDL_task_worker_tls, NULL, NULL);
+    return 0;
+}
+
+static void
+SDL_DestroyTaskPool(SDL_TaskPool *pool)
+{
+    int i;
+
+    if (pool->lock) {
+        SDL_LockMutex(pool->lock);
+        SDL_AtomicSet(&pool->shutdown, 1);
+        SDL_CondBroadcast(pool->wakeup);
+        SDL_UnlockMutex(pool->lock);
+    }
+    for (i = 0; i < pool->maxworkers; ++i) {
+        if (pool->workers[i].thread) {
+            SDL_WaitThread(pool->workers[i].thread, NULL);
+        }
+    }
+
+    SDL_DestroyCond(pool->finished);
+    SDL_DestroyCond(pool->wakeup);
+    SDL_DestroyMutex(pool->lock);
+    SDL_free(pool->workers);
+    SDL_free(pool);
+}
+
+static SDL_TaskPool *
+SDL_CreateTaskPool(void)
+{
+    SDL_TaskPool *pool;
+    const char *hint;
+    int i;
+
+    if (!SDL_task_worker_tls) {
+        SDL_task_worker_tls = SDL_TLSCreate();
+        if (!SDL_task_worker_tls) {
+            return NULL;
+        }
+    }
+
+    pool = (SDL_TaskPool *)SDL_calloc(1, sizeof(*pool));
+    if (!pool) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* The thread waiting for tasks runs them too, so leave a CPU for it */
+    hint = SDL_GetHint(SDL_HINT_TASK_POOL_THREADS);
+    if (hint && *hint) {
+        pool->maxworkers = SDL_max(SDL_atoi(hint), 0);
+    } else {
+        pool->maxworkers = SDL_max(SDL_GetCPUCount() - 1, 0);
+    }
+    if (pool->maxworkers > 0) {
+        pool->workers = (SDL_TaskWorker *)SDL_calloc(pool->maxworkers, sizeof(*pool->workers));
+        if (!pool->workers) {
+            SDL_free(pool);
+            SDL_OutOfMemory();
+            return NULL;
+        }
+    }
+
+    pool->lock = SDL_CreateFastMutex();
+    pool->wakeup = SDL_CreateCond();
+    pool->finished = SDL_CreateCond();
+    if (!pool->lock || !pool->wakeup || !pool->finished) {
+        SDL_DestroyTaskPool(pool);
+        return NULL;
+    }
+
+    for (i = 0; i < pool->maxworkers; ++i) {
+        SDL_TaskWorker *worker = &pool->workers[i];
+        char name[64];
+
+        worker->pool = pool;
+        worker->seed = 0x9E3779B9u * (Uint32)(i + 1);
+        SDL_snprintf(name, sizeof(name), "SDLTaskWorker%d", i);
+        /* Tasks run code from the app, so we can't set a limited stack size here. */
+        worker->thread = SDL_CreateThreadInternal(SDL_TaskWorkerThread, name, 0, worker);
+        if (!worker->thread) {
+            /* The pool still works with fewer workers, or none at all */
+            break;
+        }
+        pool->numworkers++;
+    }
+    return pool;
+}
+
+static SDL_TaskPool *
+SDL_GetTaskPool(void)
+{
+    SDL_TaskPool *pool = (SDL_TaskPool *)SDL_AtomicGetPtr((void **)&SDL_task_pool);
+
+    if (!pool) {
+        SDL_AtomicLock(&SDL_task_pool_lock);
+        pool = SDL_task_pool;
+        if (!pool) {
+            pool = SDL_CreateTaskPool();
+            SDL_AtomicSetPtr((void **)&SDL_task_pool, pool);
+        }
+        SDL_AtomicUnlock(&SDL_task_pool_lock);
+    }
+    return pool;
+}
+
+void
+SDL_QuitTaskPool(void)
+{
+    SDL_TaskPool *pool;
+
+    SDL_AtomicLock(&SDL_task_pool_lock);
+    pool = SDL_task_pool;
+    SDL_AtomicSetPtr((void **)&SDL_task_pool, NULL);
+    SDL_AtomicUnlock(&SDL_task_pool_lock);
+
+    if (pool) {
+        SDL_DestroyTaskPool(pool);
+    }
+}
+
+int
+SDL_GetTaskPoolThreadCount(void)
+{
+    SDL_TaskPool *pool = SDL_GetTaskPool();
+
+    return pool ? pool->numworkers : 0;
+}
+
+SDL_TaskGroup *
+SDL_CreateTaskGroup(void)
+{
+    SDL_TaskGroup *group = (SDL_TaskGroup *)SDL_calloc(1, sizeof(*group));
+
+    if (!group) {
+        SDL_OutOfMemory();
+    }
+    return group;
+}
+
+int
+SDL_RunTask(SDL_TaskGroup *group, SDL_TaskFunction fn, void *data)
+{
+    SDL_TaskPool *pool;
+    SDL_Task *task;
+
+    if (!group) {
+        return SDL_InvalidParamError("group");
+    }
+    if (!fn) {
+        return SDL_InvalidParamError("fn");
+    }
+
+    pool = SDL_GetTaskPool();
+    if (!pool) {
+        /* No pool, e.g. without thread support, so just run it right away */
+        fn(data);
+        return 0;
+    }
+
+    task = (SDL_Task *)SDL_malloc(sizeof(*task));
+    if (!task) {
+        return SDL_OutOfMemory();
+    }
+    task->fn = fn;
+    task->data = data;
+    task->group = group;
+    task->job = NULL;
+    task->start = 0;
+    task->end = 0;
+    task->allocated = SDL_TRUE;
+
+    SDL_AtomicIncRef(&group->pending);
+    SDL_PushTask(pool, task);
+    return 0;
+}
+
+void
+SDL_WaitTaskGroup(SDL_TaskGroup *group)
+{
+    SDL_TaskPool *pool;
+
+    if (!group || SDL_AtomicGet(&group->pending) == 0) {
+        return;
+    }
+
+    pool = SDL_GetTaskPool();
+    if (pool) {
+        SDL_WaitForTasks(pool, group);
+    }
+}
+
+void
+SDL_DestroyTaskGroup(SDL_TaskGroup *group)
+{
+    if (group) {
+        SDL_WaitTaskGroup(group);
+        SDL_free(group);
+    }
+}
+
+int
+SDL_ParallelFor(int start, int end, int grain, SDL_ParallelForFunction fn, void *data)
+{
+    const Sint64 count = (Sint64)end - start;
+    SDL_TaskPool *pool;
+    SDL_TaskGroup group;
+    SDL_ParallelForJob job;
+    SDL_Task *root;
+    Sint64 maxtasks, mingrain;
+
+    if (!fn) {
+        return SDL_InvalidParamError("fn");
+    }
+    if (count <= 0) {
+        return 0;
+    }
+
+    pool = SDL_GetTaskPool();
+    if (!pool) {
+        fn(data, start, end);
+        return 0;
+    }
+
+    /* Bound the number of pieces, which also bounds the memory for them */
+    maxtasks = (Sint64)(pool->numworkers + 1) * SDL_TASKS_PER_THREAD;
+    mingrain = (count + maxtasks - 1) / maxtasks;
+    if (grain < mingrain) {
+        grain = (int)mingrain;
+    }
+
+    if (pool->numworkers == 0 || count < 2 * (Sint64)grain) {
+        fn(data, start, end);
+        return 0;
+    }
+
+    /* Every piece has at least grain indices */
+    job.tasks = (SDL_Task *)SDL_malloc((size_t)(count / grain + 1) * sizeof(SDL_Task));
+    if (!job.tasks) {
+        return SDL_OutOfMemory();
+    }
+    job.fn = fn;
+    job.data = data;
+    job.grain = grain;
+    SDL_AtomicSet(&job.nexttask, 1);
+    SDL_AtomicSet(&group.pending, 1);
+
+    /* Run the first piece right here, while the others get split off */
+    root = &job.tasks[0];
+    root->fn = NULL;
+    root->data = NULL;
+    root->group = &group;
+    root->job = &job;
+    root->start = start;
+    root->end = end;
+    root->allocated = SDL_FALSE;
+    SDL_RunPoolTask(pool, root);
+
+    SDL_WaitForTasks(pool, &group);
+
+    SDL_assert(SDL_AtomicGet(&job.nexttask) <= count / grain + 1);
+    SDL_free(job.tasks);
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
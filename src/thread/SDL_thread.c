@@ -441,6 +441,14 @@ SDL_CreateThreadInternal(int (SDLCALL * fn) (void *), const char *name,
 #endif
 }
 
+#if !SDL_THREAD_LINUX_FUTEX
+SDL_mutex *
+SDL_CreateFastMutex(void)
+{
+    return SDL_CreateMutex();
+}
+#endif
+
 SDL_threadID
 SDL_GetThreadID(SDL_Thread * thread)
 {
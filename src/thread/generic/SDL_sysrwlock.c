@@ -0,0 +1,261 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* An implementation of reader-writer locks using a mutex and a condition
+   variable */
+
+#include "SDL_thread.h"
+#include "../SDL_systhread.h"
+
+/* Writers wait until there are no readers left, and new readers wait while
+   a writer has the lock or is waiting for it, so a steady stream of readers
+   can't keep writers out. Readers are tracked by thread, so a thread that
+   already has it locked for reading can always lock it again.
+ */
+typedef struct
+{
+    SDL_threadID thread;
+    int count;
+} SDL_rwlock_reader;
+
+struct SDL_rwlock
+{
+    SDL_mutex *lock;
+    SDL_cond *cond;
+    SDL_rwlock_reader *readers;
+    int num_readers;
+    int max_readers;
+    int waiting_writers;
+    SDL_threadID writer;
+    int recursive;
+};
+
+/* Create a reader-writer lock */
+SDL_rwlock *
+SDL_CreateRWLock(void)
+{
+    SDL_rwlock *rwlock;
+
+    rwlock = (SDL_rwlock *) SDL_calloc(1, sizeof(*rwlock));
+    if (rwlock) {
+        rwlock->lock = SDL_CreateFastMutex();
+        rwlock->cond = SDL_CreateCond();
+        if (!rwlock->lock || !rwlock->cond) {
+            SDL_DestroyRWLock(rwlock);
+            rwlock = NULL;
+        }
+    } else {
+        SDL_OutOfMemory();
+    }
+    return (rwlock);
+}
+
+/* Destroy a reader-writer lock */
+void
+SDL_DestroyRWLock(SDL_rwlock * rwlock)
+{
+    if (rwlock) {
+        if (rwlock->cond) {
+            SDL_DestroyCond(rwlock->cond);
+        }
+        if (rwlock->lock) {
+            SDL_DestroyMutex(rwlock->lock);
+        }
+        SDL_free(rwlock->readers);
+        SDL_free(rwlock);
+    }
+}
+
+#if !SDL_THREADS_DISABLED
+/* Returns the reading entry of this thread, the rwlock mutex must be locked */
+static SDL_rwlock_reader *
+SDL_FindRWLockReader(SDL_rwlock * rwlock, SDL_threadID thread)
+{
+    int i;
+
+    for (i = 0; i < rwlock->num_readers; ++i) {
+        if (rwlock->readers[i].thread == thread) {
+            return &rwlock->readers[i];
+        }
+    }
+    return NULL;
+}
+
+static int
+SDL_LockRWLockReading(SDL_rwlock * rwlock, SDL_threadID this_thread, SDL_bool wait)
+{
+    SDL_rwlock_reader *reader;
+
+    reader = SDL_FindRWLockReader(rwlock, this_thread);
+    if (reader) {
+        ++reader->count;
+        return 0;
+    }
+
+    while (rwlock->writer || rwlock->waiting_writers > 0) {
+        if (!wait) {
+            return SDL_MUTEX_TIMEDOUT;
+        }
+        SDL_CondWait(rwlock->cond, rwlock->lock);
+    }
+
+    if (rwlock->num_readers == rwlock->max_readers) {
+        const int max_readers = rwlock->max_readers ? rwlock->max_readers * 2 : 4;
+        reader = (SDL_rwlock_reader *) SDL_realloc(rwlock->readers, max_readers * sizeof(*reader));
+        if (!reader) {
+            return SDL_OutOfMemory();
+        }
+        rwlock->readers = reader;
+        rwlock->max_readers = max_readers;
+    }
+    reader = &rwlock->readers[rwlock->num_readers++];
+    reader->thread = this_thread;
+    reader->count = 1;
+    return 0;
+}
+
+static int
+SDL_LockRWLockWriting(SDL_rwlock * rwlock, SDL_threadID this_thread, SDL_bool wait)
+{
+    if (rwlock->writer || rwlock->num_readers > 0) {
+        if (!wait) {
+            return SDL_MUTEX_TIMEDOUT;
+        }
+        ++rwlock->waiting_writers;
+        while (rwlock->writer || rwlock->num_readers > 0) {
+            SDL_CondWait(rwlock->cond, rwlock->lock);
+        }
+        --rwlock->waiting_writers;
+    }
+
+    /* The order of operations is important.
+       We set the writing thread id after we obtain the lock
+       so unlocks from other threads will fail.
+     */
+    rwlock->writer = this_thread;
+    rwlock->recursive = 0;
+    return 0;
+}
+#endif /* !SDL_THREADS_DISABLED */
+
+static int
+SDL_LockRWLock(SDL_rwlock * rwlock, SDL_bool writing, SDL_bool wait)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    SDL_threadID this_thread;
+    int retval;
+
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    /* The writer can lock it again for anything */
+    this_thread = SDL_ThreadID();
+    if (rwlock->writer == this_thread) {
+        ++rwlock->recursive;
+        return 0;
+    }
+
+    if (SDL_LockMutex(rwlock->lock) < 0) {
+        return -1;
+    }
+    if (writing) {
+        retval = SDL_LockRWLockWriting(rwlock, this_thread, wait);
+    } else {
+        retval = SDL_LockRWLockReading(rwlock, this_thread, wait);
+    }
+    SDL_UnlockMutex(rwlock->lock);
+
+    return retval;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int
+SDL_LockRWLockForReading(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLock(rwlock, SDL_FALSE, SDL_TRUE);
+}
+
+int
+SDL_LockRWLockForWriting(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLock(rwlock, SDL_TRUE, SDL_TRUE);
+}
+
+int
+SDL_TryLockRWLockForReading(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLock(rwlock, SDL_FALSE, SDL_FALSE);
+}
+
+int
+SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLock(rwlock, SDL_TRUE, SDL_FALSE);
+}
+
+/* Unlock the reader-writer lock */
+int
+SDL_UnlockRWLock(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    SDL_threadID this_thread;
+    SDL_rwlock_reader *reader;
+    int retval = 0;
+
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    this_thread = SDL_ThreadID();
+    if (rwlock->writer == this_thread) {
+        if (rwlock->recursive) {
+            --rwlock->recursive;
+            return 0;
+        }
+        SDL_LockMutex(rwlock->lock);
+        rwlock->writer = 0;
+    } else {
+        SDL_LockMutex(rwlock->lock);
+        reader = SDL_FindRWLockReader(rwlock, this_thread);
+        if (!reader) {
+            retval = SDL_SetError("rwlock not locked by this thread");
+        } else if (--reader->count == 0) {
+            *reader = rwlock->readers[--rwlock->num_readers];
+        }
+    }
+
+    /* Wake up the readers and writers waiting for it */
+    if (!rwlock->writer && rwlock->num_readers == 0) {
+        SDL_CondBroadcast(rwlock->cond);
+    }
+    SDL_UnlockMutex(rwlock->lock);
+
+    return retval;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
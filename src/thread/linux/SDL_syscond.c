@@ -0,0 +1,137 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* Condition variables built directly on Linux futexes */
+
+#include "SDL_thread.h"
+#include "SDL_sysfutex_c.h"
+
+/* Waiters sleep on a sequence number, which every signal changes, so a
+ * signal between unlocking the mutex and going to sleep isn't lost. The
+ * number of waiters is tracked so signals without waiters stay out of the
+ * kernel.
+ */
+struct SDL_cond
+{
+    SDL_atomic_t sequence;
+    SDL_atomic_t waiters;
+};
+
+/* Create a condition variable */
+SDL_cond *
+SDL_CreateCond(void)
+{
+    SDL_cond *cond;
+
+    cond = (SDL_cond *) SDL_calloc(1, sizeof(SDL_cond));
+    if (!cond) {
+        SDL_OutOfMemory();
+    }
+    return (cond);
+}
+
+/* Destroy a condition variable */
+void
+SDL_DestroyCond(SDL_cond * cond)
+{
+    if (cond) {
+        SDL_free(cond);
+    }
+}
+
+/* Restart one of the threads that are waiting on the condition variable */
+int
+SDL_CondSignal(SDL_cond * cond)
+{
+    if (!cond) {
+        return SDL_SetError("Passed a NULL condition variable");
+    }
+
+    SDL_AtomicIncRef(&cond->sequence);
+    if (SDL_AtomicGet(&cond->waiters) > 0) {
+        SDL_FutexWake(&cond->sequence, 1);
+    }
+    return 0;
+}
+
+/* Restart all threads that are waiting on the condition variable */
+int
+SDL_CondBroadcast(SDL_cond * cond)
+{
+    if (!cond) {
+        return SDL_SetError("Passed a NULL condition variable");
+    }
+
+    SDL_AtomicIncRef(&cond->sequence);
+    if (SDL_AtomicGet(&cond->waiters) > 0) {
+        SDL_FutexWake(&cond->sequence, SDL_MAX_SINT32);
+    }
+    return 0;
+}
+
+static int
+SDL_CondWaitNS(SDL_cond * cond, SDL_mutex * mutex, Uint64 timeout_ns)
+{
+    int sequence, result;
+
+    if (!cond) {
+        return SDL_SetError("Passed a NULL condition variable");
+    }
+    if (!mutex) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+
+    SDL_AtomicIncRef(&cond->waiters);
+    sequence = SDL_AtomicGet(&cond->sequence);
+
+    if (SDL_UnlockMutex(mutex) < 0) {
+        SDL_AtomicAdd(&cond->waiters, -1);
+        return -1;
+    }
+
+    /* Interruptions and wakeups meant for others come back as spurious wakeups */
+    result = SDL_FutexWait(&cond->sequence, sequence, timeout_ns);
+    SDL_AtomicAdd(&cond->waiters, -1);
+
+    SDL_LockMutex(mutex);
+    return (result == ETIMEDOUT) ? SDL_MUTEX_TIMEDOUT : 0;
+}
+
+int
+SDL_CondWaitTimeout(SDL_cond * cond, SDL_mutex * mutex, Uint32 ms)
+{
+    if (ms == SDL_MUTEX_MAXWAIT) {
+        return SDL_CondWaitNS(cond, mutex, SDL_FUTEX_FOREVER);
+    }
+    return SDL_CondWaitNS(cond, mutex, (Uint64)ms * 1000000);
+}
+
+/* Wait on the condition variable, unlocking the provided mutex.
+   The mutex must be locked before entering this function!
+ */
+int
+SDL_CondWait(SDL_cond * cond, SDL_mutex * mutex)
+{
+    return SDL_CondWaitNS(cond, mutex, SDL_FUTEX_FOREVER);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
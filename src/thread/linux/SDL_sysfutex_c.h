@@ -0,0 +1,76 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#ifndef SDL_sysfutex_c_h_
+#define SDL_sysfutex_c_h_
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "SDL_atomic.h"
+#include "SDL_timer.h"
+
+/* Hint to the CPU that we're spinning, so it can give the other hyperthread
+   a chance and save some power */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#define SDL_FUTEX_PAUSE()   __asm__ __volatile__("pause\n")
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__arm__) || defined(__aarch64__))
+#define SDL_FUTEX_PAUSE()   __asm__ __volatile__("yield" ::: "memory")
+#else
+#define SDL_FUTEX_PAUSE()   SDL_CompilerBarrier()
+#endif
+
+/* Sleeps while the value is still val, for at most timeout_ns nanoseconds if
+   that isn't SDL_FUTEX_FOREVER. Returns 0 when woken up, or an errno value:
+   EAGAIN if the value had already changed, ETIMEDOUT or EINTR. */
+#define SDL_FUTEX_FOREVER   (~(Uint64)0)
+
+SDL_FORCE_INLINE int
+SDL_FutexWait(SDL_atomic_t *futex, int val, Uint64 timeout_ns)
+{
+    struct timespec timeout;
+    struct timespec *ptimeout = NULL;
+
+    if (timeout_ns != SDL_FUTEX_FOREVER) {
+        timeout.tv_sec = (time_t)(timeout_ns / 1000000000);
+        timeout.tv_nsec = (long)(timeout_ns % 1000000000);
+        ptimeout = &timeout;
+    }
+    if (syscall(SYS_futex, &futex->value, FUTEX_WAIT_PRIVATE, val, ptimeout, NULL, 0) < 0) {
+        return errno;
+    }
+    return 0;
+}
+
+/* Wakes up to count threads sleeping on the value */
+SDL_FORCE_INLINE void
+SDL_FutexWake(SDL_atomic_t *futex, int count)
+{
+    syscall(SYS_futex, &futex->value, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+#endif /* SDL_sysfutex_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
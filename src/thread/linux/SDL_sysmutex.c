@@ -0,0 +1,202 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* Mutexes built directly on Linux futexes */
+
+#include "SDL_thread.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_sysfutex_c.h"
+#include "../SDL_systhread.h"
+
+/* The lock state follows Drepper, "Futexes Are Tricky": 0 is unlocked,
+ * 1 is locked, and 2 is locked with threads (maybe) sleeping on it.
+ *
+ * Before sleeping, a thread spins for a while in case the owner lets go
+ * soon. Like the glibc adaptive mutex, each mutex learns how long it
+ * usually takes to get it, so short critical sections are waited out by
+ * spinning and long ones go to sleep right away.
+ */
+#define SDL_MUTEX_MAX_SPINS 100
+
+struct SDL_mutex
+{
+    SDL_atomic_t state;
+    int spins;                  /* Running average of spins needed to lock */
+    SDL_bool recursive;
+    SDL_threadID owner;         /* Only kept for recursive mutexes */
+    int recursion;
+};
+
+/* Spinning only helps if the owner can run at the same time */
+static int SDL_mutex_max_spins = -1;
+
+static SDL_mutex *
+SDL_CreateMutexWithRecursion(SDL_bool recursive)
+{
+    SDL_mutex *mutex;
+
+    if (SDL_mutex_max_spins < 0) {
+        SDL_mutex_max_spins = (SDL_GetCPUCount() > 1) ? SDL_MUTEX_MAX_SPINS : 0;
+    }
+
+    /* Allocate the structure */
+    mutex = (SDL_mutex *) SDL_calloc(1, sizeof(*mutex));
+    if (mutex) {
+        mutex->recursive = recursive;
+    } else {
+        SDL_OutOfMemory();
+    }
+    return mutex;
+}
+
+SDL_mutex *
+SDL_CreateMutex(void)
+{
+    return SDL_CreateMutexWithRecursion(SDL_TRUE);
+}
+
+SDL_mutex *
+SDL_CreateFastMutex(void)
+{
+    return SDL_CreateMutexWithRecursion(SDL_FALSE);
+}
+
+void
+SDL_DestroyMutex(SDL_mutex * mutex)
+{
+    if (mutex) {
+        SDL_free(mutex);
+    }
+}
+
+static void
+SDL_LockMutexContended(SDL_mutex * mutex)
+{
+    const int maxspins = SDL_min(mutex->spins * 2 + 10, SDL_mutex_max_spins);
+    int spins, state;
+
+    for (spins = 0; spins < maxspins; ++spins) {
+        SDL_FUTEX_PAUSE();
+        if (SDL_AtomicGet(&mutex->state) == 0 && SDL_AtomicCAS(&mutex->state, 0, 1)) {
+            mutex->spins += (spins - mutex->spins) / 8;
+            return;
+        }
+    }
+    mutex->spins += (maxspins - mutex->spins) / 8;
+
+    /* Mark the lock as having sleepers, and sleep until it's free */
+    state = SDL_AtomicSet(&mutex->state, 2);
+    while (state != 0) {
+        SDL_FutexWait(&mutex->state, 2, SDL_FUTEX_FOREVER);
+        state = SDL_AtomicSet(&mutex->state, 2);
+    }
+}
+
+/* Lock the mutex */
+int
+SDL_LockMutex(SDL_mutex * mutex)
+{
+    SDL_threadID this_thread = 0;
+
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+
+    if (mutex->recursive) {
+        this_thread = SDL_ThreadID();
+        if (mutex->owner == this_thread) {
+            ++mutex->recursion;
+            return 0;
+        }
+    }
+
+    if (!SDL_AtomicCAS(&mutex->state, 0, 1)) {
+        SDL_LockMutexContended(mutex);
+    }
+
+    /* The order of operations is important.
+       We set the locking thread id after we obtain the lock
+       so unlocks from other threads will fail.
+     */
+    mutex->owner = this_thread;
+    mutex->recursion = 0;
+    return 0;
+}
+
+int
+SDL_TryLockMutex(SDL_mutex * mutex)
+{
+    SDL_threadID this_thread = 0;
+
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+
+    if (mutex->recursive) {
+        this_thread = SDL_ThreadID();
+        if (mutex->owner == this_thread) {
+            ++mutex->recursion;
+            return 0;
+        }
+    }
+
+    if (!SDL_AtomicCAS(&mutex->state, 0, 1)) {
+        return SDL_MUTEX_TIMEDOUT;
+    }
+    mutex->owner = this_thread;
+    mutex->recursion = 0;
+    return 0;
+}
+
+int
+SDL_UnlockMutex(SDL_mutex * mutex)
+{
+    if (mutex == NULL) {
+        return SDL_SetError("Passed a NULL mutex");
+    }
+
+    if (mutex->recursive) {
+        /* We can only unlock the mutex if we own it */
+        if (mutex->owner != SDL_ThreadID()) {
+            return SDL_SetError("mutex not owned by this thread");
+        }
+        if (mutex->recursion) {
+            --mutex->recursion;
+            return 0;
+        }
+        /* The order of operations is important.
+           First reset the owner so another thread doesn't lock
+           the mutex and set the ownership before we reset it,
+           then release the lock.
+         */
+        mutex->owner = 0;
+    }
+
+    /* Only go into the kernel if someone might be sleeping */
+    if (SDL_AtomicAdd(&mutex->state, -1) != 1) {
+        SDL_AtomicSet(&mutex->state, 0);
+        SDL_FutexWake(&mutex->state, 1);
+    }
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
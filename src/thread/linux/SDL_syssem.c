@@ -0,0 +1,170 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* Semaphores built directly on Linux futexes */
+
+#include "SDL_thread.h"
+#include "SDL_timer.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_sysfutex_c.h"
+
+/* Waiting threads sleep on the count while it's zero. The number of
+ * waiters is tracked so posts without waiters stay out of the kernel, and
+ * a waiter spins briefly first since the post often comes right away.
+ */
+#define SDL_SEM_SPINS 100
+
+/* Spinning only helps if the poster can run at the same time */
+static int SDL_sem_spins = -1;
+
+struct SDL_semaphore
+{
+    SDL_atomic_t count;
+    SDL_atomic_t waiters;
+};
+
+/* Create a semaphore, initialized with value */
+SDL_sem *
+SDL_CreateSemaphore(Uint32 initial_value)
+{
+    SDL_sem *sem;
+
+    if (initial_value > SDL_MAX_SINT32) {
+        SDL_SetError("Semaphore value too large");
+        return NULL;
+    }
+
+    if (SDL_sem_spins < 0) {
+        SDL_sem_spins = (SDL_GetCPUCount() > 1) ? SDL_SEM_SPINS : 0;
+    }
+
+    sem = (SDL_sem *) SDL_calloc(1, sizeof(SDL_sem));
+    if (sem) {
+        SDL_AtomicSet(&sem->count, (int)initial_value);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return sem;
+}
+
+void
+SDL_DestroySemaphore(SDL_sem * sem)
+{
+    if (sem) {
+        SDL_free(sem);
+    }
+}
+
+int
+SDL_SemTryWait(SDL_sem * sem)
+{
+    int count;
+
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+
+    for (count = SDL_AtomicGet(&sem->count); count > 0; count = SDL_AtomicGet(&sem->count)) {
+        if (SDL_AtomicCAS(&sem->count, count, count - 1)) {
+            return 0;
+        }
+    }
+    return SDL_MUTEX_TIMEDOUT;
+}
+
+int
+SDL_SemWaitTimeout(SDL_sem * sem, Uint32 timeout)
+{
+    Uint64 deadline = 0;
+    int i, retval;
+
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+
+    /* Try the easy cases first */
+    retval = SDL_SemTryWait(sem);
+    if (retval == 0 || timeout == 0) {
+        return retval;
+    }
+    for (i = 0; i < SDL_sem_spins; ++i) {
+        SDL_FUTEX_PAUSE();
+        if (SDL_SemTryWait(sem) == 0) {
+            return 0;
+        }
+    }
+
+    if (timeout != SDL_MUTEX_MAXWAIT) {
+        deadline = SDL_GetTicksNS() + (Uint64)timeout * 1000000;
+    }
+
+    SDL_AtomicIncRef(&sem->waiters);
+    while ((retval = SDL_SemTryWait(sem)) == SDL_MUTEX_TIMEDOUT) {
+        Uint64 timeout_ns = SDL_FUTEX_FOREVER;
+
+        if (timeout != SDL_MUTEX_MAXWAIT) {
+            const Uint64 now = SDL_GetTicksNS();
+            if (now >= deadline) {
+                break;
+            }
+            timeout_ns = deadline - now;
+        }
+        SDL_FutexWait(&sem->count, 0, timeout_ns);
+    }
+    SDL_AtomicAdd(&sem->waiters, -1);
+    return retval;
+}
+
+int
+SDL_SemWait(SDL_sem * sem)
+{
+    return SDL_SemWaitTimeout(sem, SDL_MUTEX_MAXWAIT);
+}
+
+Uint32
+SDL_SemValue(SDL_sem * sem)
+{
+    int ret = 0;
+    if (sem) {
+        ret = SDL_AtomicGet(&sem->count);
+        if (ret < 0) {
+            ret = 0;
+        }
+    }
+    return (Uint32) ret;
+}
+
+int
+SDL_SemPost(SDL_sem * sem)
+{
+    if (!sem) {
+        return SDL_SetError("Passed a NULL semaphore");
+    }
+
+    SDL_AtomicIncRef(&sem->count);
+    if (SDL_AtomicGet(&sem->waiters) > 0) {
+        SDL_FutexWake(&sem->count, 1);
+    }
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -32,11 +32,15 @@ typedef struct _SDL_Timer
 {
     int timerID;
     SDL_TimerCallback callback;
+    SDL_NSTimerCallback callback_ns;
     void *param;
-    Uint32 interval;
-    Uint32 scheduled;
+    Uint64 interval;            /* In milliseconds, or nanoseconds if callback_ns is set */
+    Uint64 scheduled;           /* In nanoseconds, see SDL_GetTicksNS() */
+    Uint32 sequence;
     SDL_atomic_t canceled;
     struct _SDL_Timer *next;
+    struct _SDL_Timer *child;
+    struct _SDL_Timer *sibling;
 } SDL_Timer;
 
 typedef struct _SDL_TimerMap
@@ -46,12 +50,22 @@ typedef struct _SDL_TimerMap
     struct _SDL_TimerMap *next;
 } SDL_TimerMap;
 
-/* The timers are kept in a sorted list */
+/* Initial number of buckets in the timer ID hash table, a power of two */
+#define SDL_TIMERMAP_MIN_SIZE 64
+
+/* The timer thread sleeps on the semaphore until this close to the next
+ * nanosecond timer, then sleeps the rest with SDL_DelayNS() to get
+ * sub-millisecond precision. Millisecond timers only use the semaphore. */
+#define SDL_TIMER_PRECISE_WAIT_NS   2000000
+
+/* The timers are kept in a pairing heap */
 typedef struct {
     /* Data used by the main thread */
     SDL_Thread *thread;
     SDL_atomic_t nextID;
-    SDL_TimerMap *timermap;
+    SDL_TimerMap **timermap;    /* Hash table indexed by timer ID */
+    int timermap_size;
+    int timermap_count;
     SDL_mutex *timermap_lock;
 
     /* Padding to separate cache lines between threads */
@@ -64,37 +78,92 @@ typedef struct {
     SDL_Timer *freelist;
     SDL_atomic_t active;
 
-    /* List of timers - this is only touched by the timer thread */
+    /* Heap of timers - this is only touched by the timer thread */
     SDL_Timer *timers;
+    Uint32 sequence;
 } SDL_TimerData;
 
 static SDL_TimerData SDL_timer_data;
 
 /* The idea here is that any thread might add a timer, but a single
- * thread manages the active timer queue, sorted by scheduling time.
+ * thread manages the active timer queue, ordered by scheduling time.
+ *
+ * The queue is a pairing heap linked through the child and sibling
+ * pointers of the timers, so adding a timer is O(1) and taking the next
+ * one is O(log n) amortized, without any allocations on the timer thread.
+ * Timers scheduled for the same tick run in the order they were added.
  *
  * Timers are removed by simply setting a canceled flag
  */
 
-static void
-SDL_AddTimerInternal(SDL_TimerData *data, SDL_Timer *timer)
+static SDL_bool
+SDL_TimerIsBefore(const SDL_Timer *a, const SDL_Timer *b)
 {
-    SDL_Timer *prev, *curr;
+    if (a->scheduled != b->scheduled) {
+        return (a->scheduled < b->scheduled) ? SDL_TRUE : SDL_FALSE;
+    }
+    return ((Sint32)(a->sequence - b->sequence) < 0) ? SDL_TRUE : SDL_FALSE;
+}
 
-    prev = NULL;
-    for (curr = data->timers; curr; prev = curr, curr = curr->next) {
-        if ((Sint32)(timer->scheduled-curr->scheduled) < 0) {
-            break;
+static SDL_Timer *
+SDL_MergeTimers(SDL_Timer *a, SDL_Timer *b)
+{
+    if (SDL_TimerIsBefore(b, a)) {
+        SDL_Timer *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    b->sibling = a->child;
+    a->child = b;
+    return a;
+}
+
+/* Merges the children of a removed heap root, in the usual two passes. */
+static SDL_Timer *
+SDL_MergeTimerChildren(SDL_Timer *first)
+{
+    SDL_Timer *merged = NULL;
+    SDL_Timer *root = NULL;
+
+    /* Merge pairs from left to right, collecting them in reverse order */
+    while (first) {
+        SDL_Timer *a = first;
+        SDL_Timer *b = a->sibling;
+        if (b) {
+            first = b->sibling;
+            a = SDL_MergeTimers(a, b);
+        } else {
+            first = NULL;
         }
+        a->sibling = merged;
+        merged = a;
     }
 
-    /* Insert the timer here! */
-    if (prev) {
-        prev->next = timer;
-    } else {
-        data->timers = timer;
+    /* Merge the pairs from right to left into a single heap */
+    while (merged) {
+        SDL_Timer *next = merged->sibling;
+        merged->sibling = NULL;
+        root = root ? SDL_MergeTimers(root, merged) : merged;
+        merged = next;
     }
-    timer->next = curr;
+    return root;
+}
+
+static void
+SDL_AddTimerInternal(SDL_TimerData *data, SDL_Timer *timer)
+{
+    timer->sequence = data->sequence++;
+    timer->child = NULL;
+    timer->sibling = NULL;
+    data->timers = data->timers ? SDL_MergeTimers(data->timers, timer) : timer;
+}
+
+static SDL_Timer *
+SDL_RemoveNextTimer(SDL_TimerData *data)
+{
+    SDL_Timer *timer = data->timers;
+    data->timers = SDL_MergeTimerChildren(timer->child);
+    return timer;
 }
 
 static int SDLCALL
@@ -105,7 +174,8 @@ SDL_TimerThread(void *_data)
     SDL_Timer *current;
     SDL_Timer *freelist_head = NULL;
     SDL_Timer *freelist_tail = NULL;
-    Uint32 tick, now, interval, delay;
+    Uint64 tick, now, interval, delay;
+    SDL_bool precise;
 
     /* Threaded timer loop:
      *  1. Queue timers added by other threads
@@ -143,33 +213,46 @@ SDL_TimerThread(void *_data)
         }
 
         /* Initial delay if there are no timers */
-        delay = SDL_MUTEX_MAXWAIT;
+        delay = ~(Uint64)0;
+        precise = SDL_FALSE;
 
-        tick = SDL_GetTicks();
+        tick = SDL_GetTicksNS();
 
         /* Process all the pending timers for this tick */
         while (data->timers) {
             current = data->timers;
 
-            if ((Sint32)(tick-current->scheduled) < 0) {
+            if (tick < current->scheduled) {
                 /* Scheduled for the future, wait a bit */
                 delay = (current->scheduled - tick);
+                precise = (current->callback_ns != NULL);
                 break;
             }
 
             /* We're going to do something with this timer */
-            data->timers = current->next;
+            SDL_RemoveNextTimer(data);
 
             if (SDL_AtomicGet(&current->canceled)) {
                 interval = 0;
+            } else if (current->callback_ns) {
+                interval = current->callback_ns(current->interval, current->param);
             } else {
-                interval = current->callback(current->interval, current->param);
+                interval = current->callback((Uint32)current->interval, current->param);
             }
 
             if (interval > 0) {
                 /* Reschedule this timer */
                 current->interval = interval;
-                current->scheduled = tick + interval;
+                if (current->callback_ns) {
+                    /* Keep to the original schedule so lateness doesn't
+                       accumulate, unless we've fallen a whole interval behind */
+                    current->scheduled += interval;
+                    if (current->scheduled <= tick) {
+                        current->scheduled = tick + interval;
+                    }
+                } else {
+                    current->scheduled = tick + interval * 1000000;
+                }
                 SDL_AddTimerInternal(data, current);
             } else {
                 if (!freelist_head) {
@@ -185,7 +268,7 @@ SDL_TimerThread(void *_data)
         }
 
         /* Adjust the delay based on processing time */
-        now = SDL_GetTicks();
+        now = SDL_GetTicksNS();
         interval = (now - tick);
         if (interval > delay) {
             delay = 0;
@@ -197,12 +280,55 @@ SDL_TimerThread(void *_data)
            immediately, but we process the timers added all at once.
            That's okay, it just means we run through the loop a few
            extra times.
+
+           The semaphore wait only has millisecond resolution, so for a
+           nanosecond timer it's only used to get close, and the last
+           stretch is slept precisely. A timer added during that last
+           stretch is picked up when it ends.
          */
-        SDL_SemWaitTimeout(data->sem, delay);
+        if (delay == ~(Uint64)0) {
+            SDL_SemWaitTimeout(data->sem, SDL_MUTEX_MAXWAIT);
+        } else if (!precise) {
+            delay = (delay + 999999) / 1000000;
+            SDL_SemWaitTimeout(data->sem, (Uint32)SDL_min(delay, SDL_MUTEX_MAXWAIT - 1));
+        } else if (delay > SDL_TIMER_PRECISE_WAIT_NS) {
+            delay = (delay - SDL_TIMER_PRECISE_WAIT_NS / 2) / 1000000;
+            SDL_SemWaitTimeout(data->sem, (Uint32)SDL_min(delay, SDL_MUTEX_MAXWAIT - 1));
+        } else if (delay > 0) {
+            SDL_DelayNS(delay);
+        }
     }
     return 0;
 }
 
+/* Doubles the number of buckets of the timer ID hash table. Called with the
+ * timermap lock held. If this fails the old table stays in use, just with
+ * longer chains.
+ */
+static void
+SDL_GrowTimerMap(SDL_TimerData *data)
+{
+    const int size = data->timermap_size ? data->timermap_size * 2 : SDL_TIMERMAP_MIN_SIZE;
+    SDL_TimerMap **timermap = (SDL_TimerMap **)SDL_calloc(size, sizeof(*timermap));
+    int i;
+
+    if (!timermap) {
+        return;
+    }
+
+    for (i = 0; i < data->timermap_size; ++i) {
+        while (data->timermap[i]) {
+            SDL_TimerMap *entry = data->timermap[i];
+            data->timermap[i] = entry->next;
+            entry->next = timermap[entry->timerID & (size - 1)];
+            timermap[entry->timerID & (size - 1)] = entry;
+        }
+    }
+    SDL_free(data->timermap);
+    data->timermap = timermap;
+    data->timermap_size = size;
+}
+
 int
 SDL_TimerInit(void)
 {
@@ -210,7 +336,7 @@ SDL_TimerInit(void)
 
     if (!SDL_AtomicGet(&data->active)) {
         const char *name = "SDLTimer";
-        data->timermap_lock = SDL_CreateMutex();
+        data->timermap_lock = SDL_CreateFastMutex();
         if (!data->timermap_lock) {
             return -1;
         }
@@ -241,6 +367,7 @@ SDL_TimerQuit(void)
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
     SDL_TimerMap *entry;
+    int i;
 
     if (SDL_AtomicCAS(&data->active, 1, 0)) {  /* active? Move to inactive. */
         /* Shutdown the timer thread */
@@ -253,30 +380,45 @@ SDL_TimerQuit(void)
         SDL_DestroySemaphore(data->sem);
         data->sem = NULL;
 
-        /* Clean up the timer entries */
-        while (data->timers) {
-            timer = data->timers;
-            data->timers = timer->next;
-            SDL_free(timer);
+        /* Clean up the timer entries, rotating children up to walk the heap */
+        timer = data->timers;
+        while (timer) {
+            SDL_Timer *child = timer->child;
+            if (child) {
+                timer->child = child->sibling;
+                child->sibling = timer;
+                timer = child;
+            } else {
+                SDL_Timer *next = timer->sibling;
+                SDL_free(timer);
+                timer = next;
+            }
         }
+        data->timers = NULL;
         while (data->freelist) {
             timer = data->freelist;
             data->freelist = timer->next;
             SDL_free(timer);
         }
-        while (data->timermap) {
-            entry = data->timermap;
-            data->timermap = entry->next;
-            SDL_free(entry);
+        for (i = 0; i < data->timermap_size; ++i) {
+            while (data->timermap[i]) {
+                entry = data->timermap[i];
+                data->timermap[i] = entry->next;
+                SDL_free(entry);
+            }
         }
+        SDL_free(data->timermap);
+        data->timermap = NULL;
+        data->timermap_size = 0;
+        data->timermap_count = 0;
 
         SDL_DestroyMutex(data->timermap_lock);
         data->timermap_lock = NULL;
     }
 }
 
-SDL_TimerID
-SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
+static SDL_TimerID
+SDL_CreateTimer(Uint64 interval, SDL_TimerCallback callback, SDL_NSTimerCallback callback_ns, void *param)
 {
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
@@ -307,9 +449,10 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     }
     timer->timerID = SDL_AtomicIncRef(&data->nextID);
     timer->callback = callback;
+    timer->callback_ns = callback_ns;
     timer->param = param;
     timer->interval = interval;
-    timer->scheduled = SDL_GetTicks() + interval;
+    timer->scheduled = SDL_GetTicksNS() + (callback_ns ? interval : interval * 1000000);
     SDL_AtomicSet(&timer->canceled, 0);
 
     entry = (SDL_TimerMap *)SDL_malloc(sizeof(*entry));
@@ -322,8 +465,19 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     entry->timerID = timer->timerID;
 
     SDL_LockMutex(data->timermap_lock);
-    entry->next = data->timermap;
-    data->timermap = entry;
+    if (data->timermap_count >= data->timermap_size * 2) {
+        SDL_GrowTimerMap(data);
+        if (!data->timermap) {
+            SDL_UnlockMutex(data->timermap_lock);
+            SDL_free(entry);
+            SDL_free(timer);
+            SDL_OutOfMemory();
+            return 0;
+        }
+    }
+    entry->next = data->timermap[entry->timerID & (data->timermap_size - 1)];
+    data->timermap[entry->timerID & (data->timermap_size - 1)] = entry;
+    data->timermap_count++;
     SDL_UnlockMutex(data->timermap_lock);
 
     /* Add the timer to the pending list for the timer thread */
@@ -338,24 +492,40 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     return entry->timerID;
 }
 
+SDL_TimerID
+SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
+{
+    return SDL_CreateTimer(interval, callback, NULL, param);
+}
+
+SDL_TimerID
+SDL_AddTimerNS(Uint64 interval, SDL_NSTimerCallback callback, void *param)
+{
+    return SDL_CreateTimer(interval, NULL, callback, param);
+}
+
 SDL_bool
 SDL_RemoveTimer(SDL_TimerID id)
 {
     SDL_TimerData *data = &SDL_timer_data;
-    SDL_TimerMap *prev, *entry;
+    SDL_TimerMap *prev, *entry = NULL;
     SDL_bool canceled = SDL_FALSE;
 
     /* Find the timer */
     SDL_LockMutex(data->timermap_lock);
-    prev = NULL;
-    for (entry = data->timermap; entry; prev = entry, entry = entry->next) {
-        if (entry->timerID == id) {
-            if (prev) {
-                prev->next = entry->next;
-            } else {
-                data->timermap = entry->next;
+    if (data->timermap) {
+        const int bucket = id & (data->timermap_size - 1);
+        prev = NULL;
+        for (entry = data->timermap[bucket]; entry; prev = entry, entry = entry->next) {
+            if (entry->timerID == id) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    data->timermap[bucket] = entry->next;
+                }
+                data->timermap_count--;
+                break;
             }
-            break;
         }
     }
     SDL_UnlockMutex(data->timermap_lock);
@@ -370,4 +540,47 @@ SDL_RemoveTimer(SDL_TimerID id)
     return canceled;
 }
 
+#if !defined(SDL_TIMER_UNIX) && !defined(SDL_TIMER_DUMMY) && !defined(SDL_TIMERS_DISABLED)
+/* Platforms without a native nanosecond clock derive one from the
+ * performance counter, counting from SDL_TicksInit() like SDL_GetTicks().
+ */
+static SDL_bool ticks_ns_started = SDL_FALSE;
+static Uint64 ticks_ns_start;
+
+void
+SDL_TicksNSInit(void)
+{
+    ticks_ns_start = SDL_GetPerformanceCounter();
+    ticks_ns_started = SDL_TRUE;
+}
+
+Uint64
+SDL_GetTicksNS(void)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 ticks;
+
+    if (!ticks_ns_started) {
+        SDL_TicksInit();
+    }
+
+    ticks = SDL_GetPerformanceCounter() - ticks_ns_start;
+    return (ticks / frequency) * 1000000000 + ((ticks % frequency) * 1000000000) / frequency;
+}
+
+void
+SDL_DelayNS(Uint64 ns)
+{
+    const Uint64 then = SDL_GetTicksNS();
+    Uint64 elapsed, remaining;
+
+    /* The system sleep only takes milliseconds, so round up rather than
+       spinning through the last one */
+    while ((elapsed = SDL_GetTicksNS() - then) < ns) {
+        remaining = ns - elapsed;
+        SDL_Delay((Uint32)SDL_min((remaining - 1) / 1000000 + 1, 0xFFFFFFFF));
+    }
+}
+#endif /* !SDL_TIMER_UNIX && !SDL_TIMER_DUMMY && !SDL_TIMERS_DISABLED */
+
 /* vi: set ts=4 sw=4 expandtab: */
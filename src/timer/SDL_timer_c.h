@@ -32,6 +32,7 @@
 
 extern void SDL_TicksInit(void);
 extern void SDL_TicksQuit(void);
+extern void SDL_TicksNSInit(void);
 extern int SDL_TimerInit(void);
 extern void SDL_TimerQuit(void);
 
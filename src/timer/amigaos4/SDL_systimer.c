@@ -26,6 +26,7 @@
 
 #include "SDL_timer.h"
 #include "SDL_os4timer_c.h"
+#include "../SDL_timer_c.h"
 
 #undef DEBUG
 #include "../../main/amigaos4/SDL_os4debug.h"
@@ -39,6 +40,8 @@ SDL_TicksInit(void)
         return;
     }
     started = SDL_TRUE;
+
+    SDL_TicksNSInit();
 }
 
 void
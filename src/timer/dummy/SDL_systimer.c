@@ -52,6 +52,12 @@ SDL_GetTicks(void)
     return 0;
 }
 
+Uint64
+SDL_GetTicksNS(void)
+{
+    return (Uint64)SDL_GetTicks() * 1000000;
+}
+
 Uint64
 SDL_GetPerformanceCounter(void)
 {
@@ -70,6 +76,12 @@ SDL_Delay(Uint32 ms)
     SDL_Unsupported();
 }
 
+void
+SDL_DelayNS(Uint64 ns)
+{
+    SDL_Unsupported();
+}
+
 #endif /* SDL_TIMER_DUMMY || SDL_TIMERS_DISABLED */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -25,6 +25,7 @@
 #include <kernel/OS.h>
 
 #include "SDL_timer.h"
+#include "../SDL_timer_c.h"
 
 static bigtime_t start;
 static SDL_bool ticks_started = SDL_FALSE;
@@ -39,6 +40,7 @@ SDL_TicksInit(void)
 
     /* Set first ticks value */
     start = system_time();
+    SDL_TicksNSInit();
 }
 
 void
@@ -43,6 +43,7 @@ SDL_TicksInit(void)
     ticks_started = SDL_TRUE;
 
     gettimeofday(&start, NULL);
+    SDL_TicksNSInit();
 }
 
 void
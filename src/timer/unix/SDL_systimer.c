@@ -129,6 +129,38 @@ SDL_GetTicks(void)
     return (ticks);
 }
 
+Uint64
+SDL_GetTicksNS(void)
+{
+    Uint64 ticks;
+    if (!ticks_started) {
+        SDL_TicksInit();
+    }
+
+    if (has_monotonic_time) {
+#if HAVE_CLOCK_GETTIME
+        struct timespec now;
+        clock_gettime(SDL_MONOTONIC_CLOCK, &now);
+        ticks = (Uint64)(now.tv_sec - start_ts.tv_sec) * 1000000000;
+        ticks += now.tv_nsec;
+        ticks -= start_ts.tv_nsec;
+#elif defined(__APPLE__)
+        uint64_t now = mach_absolute_time();
+        ticks = (((now - start_mach) * mach_base_info.numer) / mach_base_info.denom);
+#else
+        SDL_assert(SDL_FALSE);
+        ticks = 0;
+#endif
+    } else {
+        struct timeval now;
+
+        gettimeofday(&now, NULL);
+        ticks = (Uint64)(now.tv_sec - start_tv.tv_sec) * 1000000000;
+        ticks += (Sint64)(now.tv_usec - start_tv.tv_usec) * 1000;
+    }
+    return (ticks);
+}
+
 Uint64
 SDL_GetPerformanceCounter(void)
 {
@@ -234,6 +266,67 @@ SDL_Delay(Uint32 ms)
     } while (was_error && (errno == EINTR));
 }
 
+void
+SDL_DelayNS(Uint64 ns)
+{
+    int was_error;
+
+#if HAVE_CLOCK_GETTIME && defined(TIMER_ABSTIME) && !defined(__APPLE__)
+    /* Sleep until an absolute time, so an interrupted sleep doesn't drift */
+    struct timespec deadline;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &deadline) == 0) {
+        deadline.tv_sec += (time_t)(ns / 1000000000);
+        deadline.tv_nsec += (long)(ns % 1000000000);
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        do {
+            was_error = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+        } while (was_error == EINTR);
+        return;
+    }
+#endif
+
+    {
+#if HAVE_NANOSLEEP
+        struct timespec elapsed, tv;
+
+        elapsed.tv_sec = (time_t)(ns / 1000000000);
+        elapsed.tv_nsec = (long)(ns % 1000000000);
+        do {
+            errno = 0;
+            tv.tv_sec = elapsed.tv_sec;
+            tv.tv_nsec = elapsed.tv_nsec;
+            was_error = nanosleep(&tv, &elapsed);
+        } while (was_error && (errno == EINTR));
+#else
+        /* Calculate the time interval left (in case of interrupt) */
+        const Uint64 then = SDL_GetTicksNS();
+        Uint64 now;
+        do {
+            now = SDL_GetTicksNS();
+            if (now - then >= ns) {
+                break;
+            }
+            errno = 0;
+#ifdef __amigaos4__
+            was_error = usleep((useconds_t)((ns - (now - then) + 999) / 1000));
+#else
+            {
+                struct timeval tv;
+                const Uint64 us = (ns - (now - then) + 999) / 1000;
+                tv.tv_sec = (long)(us / 1000000);
+                tv.tv_usec = (long)(us % 1000000);
+                was_error = select(0, NULL, NULL, NULL, &tv);
+            }
+#endif
+        } while (!was_error || (errno == EINTR));
+#endif /* HAVE_NANOSLEEP */
+    }
+}
+
 #endif /* SDL_TIMER_UNIX */
 
 /* vi: set ts=4 sw=4 expandtab: */
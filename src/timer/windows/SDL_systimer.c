@@ -27,6 +27,7 @@
 
 #include "SDL_timer.h"
 #include "SDL_hints.h"
+#include "../SDL_timer_c.h"
 
 
 /* The first (low-resolution) ticks value of the application */
@@ -102,6 +103,8 @@ SDL_TicksInit(void)
         start = timeGetTime();
 #endif /* __WINRT__ */
     }
+
+    SDL_TicksNSInit();
 }
 
 void
@@ -99,8 +99,6 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
     return (okay ? 0 : -1);
 }
 
-#if SDL_HAVE_BLIT_AUTO
-
 #ifdef __MACOSX__
 #include <sys/sysctl.h>
 
@@ -126,12 +124,11 @@ SDL_UseAltivecPrefetch()
 }
 #endif /* __MACOSX__ */
 
-static SDL_BlitFunc
-SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
-                   SDL_BlitFuncEntry * entries)
+/* The CPU features the blitters may use, SDL_BLIT_CPU_FEATURES overrides them for testing */
+Uint32
+SDL_GetBlitCPUFeatures(void)
 {
-    int i, flagcheck = (flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_COLORKEY | SDL_COPY_NEAREST));
-    static int features = 0x7fffffff;
+    static Uint32 features = 0x7fffffff;
 
     /* Get the available CPU features */
     if (features == 0x7fffffff) {
@@ -162,8 +159,28 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
                     features |= SDL_CPU_ALTIVEC_NOPREFETCH;
                 }
             }
+            if (SDL_HasSSE41()) {
+                features |= SDL_CPU_SSE41;
+            }
+            if (SDL_HasAVX2()) {
+                features |= SDL_CPU_AVX2;
+            }
+            if (SDL_HasNEON()) {
+                features |= SDL_CPU_NEON;
+            }
         }
     }
+    return features;
+}
+
+#if SDL_HAVE_BLIT_AUTO
+
+static SDL_BlitFunc
+SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
+                   SDL_BlitFuncEntry * entries)
+{
+    int i, flagcheck = (flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_COLORKEY | SDL_COPY_NEAREST));
+    const Uint32 features = SDL_GetBlitCPUFeatures();
 
     for (i = 0; entries[i].func; ++i) {
         /* Check for matching pixel formats */
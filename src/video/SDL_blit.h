@@ -52,6 +52,24 @@ extern Uint8* SDL_expand_byte[9];
 #define SDL_CPU_SSE2                0x00000008
 #define SDL_CPU_ALTIVEC_PREFETCH    0x00000010
 #define SDL_CPU_ALTIVEC_NOPREFETCH  0x00000020
+#define SDL_CPU_SSE41               0x00000040
+#define SDL_CPU_AVX2                0x00000080
+#define SDL_CPU_NEON                0x00000100
+
+/* The SSE4.1 and AVX2 blitters are compiled with per-function target
+   attributes, so they don't need those instruction sets enabled globally.
+   They are only used when SDL_GetBlitCPUFeatures() reports them. */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || (__GNUC__ >= 5)) && \
+    defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#define SDL_SSE4_1_BLITTERS         1
+#define SDL_AVX2_BLITTERS           1
+#define SDL_TARGETING(x)            __attribute__((target(x)))
+#elif defined(_MSC_VER) && (_MSC_VER >= 1800) && (defined(_M_IX86) || defined(_M_X64)) && !defined(__clang__)
+#define SDL_SSE4_1_BLITTERS         1
+#define SDL_AVX2_BLITTERS           1
+#define SDL_TARGETING(x)
+#endif
 
 typedef struct
 {
@@ -100,6 +118,13 @@ typedef struct SDL_BlitMap
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
+extern Uint32 SDL_GetBlitCPUFeatures(void);
+
+/* Functions found in SDL_surface.c, SDL_BlitScaled() always samples the nearest pixel */
+extern int SDL_PrivateUpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect,
+                                      SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool linear);
+extern int SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
+                                      SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool linear);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
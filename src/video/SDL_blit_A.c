@@ -575,6 +575,147 @@ BlitRGBtoRGBPixelAlpha(SDL_BlitInfo * info)
     }
 }
 
+#if SDL_SSE4_1_BLITTERS || SDL_AVX2_BLITTERS
+/* One pixel of BlitRGBtoRGBPixelAlpha, for the ends of the rows */
+static SDL_INLINE Uint32
+BlendRGBtoRGBPixelAlpha(Uint32 s, Uint32 d)
+{
+    Uint32 alpha = s >> 24;
+    Uint32 dalpha, s1, d1;
+
+    if (alpha == 0) {
+        return d;
+    } else if (alpha == SDL_ALPHA_OPAQUE) {
+        return s;
+    }
+    dalpha = d >> 24;
+    s1 = s & 0xff00ff;
+    d1 = d & 0xff00ff;
+    d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;
+    s &= 0xff00;
+    d &= 0xff00;
+    d = (d + ((s - d) * alpha >> 8)) & 0xff00;
+    dalpha = alpha + (dalpha * (alpha ^ 0xFF) >> 8);
+    return d1 | d | (dalpha << 24);
+}
+#endif
+
+#if SDL_SSE4_1_BLITTERS
+/* Same arithmetic as BlitRGBtoRGBPixelAlpha, four pixels at a time.
+   _mm_mullo_epi32 keeps the low 32 bits of each product, just like the
+   Uint32 math above, so the results are identical. */
+static void SDL_TARGETING("sse4.1")
+BlitRGBtoRGBPixelAlphaSSE41(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi32(0xff);
+    const __m128i amask = _mm_set1_epi32(0xff000000);
+    const __m128i rbmask = _mm_set1_epi32(0x00ff00ff);
+    const __m128i gmask = _mm_set1_epi32(0x0000ff00);
+
+    while (height--) {
+        int n = width;
+
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) srcp);
+            __m128i d, alpha, s1, d1, sg, dg, dalpha;
+
+            if (_mm_testz_si128(s, amask)) {
+                continue;   /* fully transparent */
+            }
+            d = _mm_loadu_si128((const __m128i *) dstp);
+            alpha = _mm_srli_epi32(s, 24);
+
+            s1 = _mm_and_si128(s, rbmask);
+            d1 = _mm_and_si128(d, rbmask);
+            d1 = _mm_add_epi32(d1, _mm_srli_epi32(_mm_mullo_epi32(_mm_sub_epi32(s1, d1), alpha), 8));
+            d1 = _mm_and_si128(d1, rbmask);
+
+            sg = _mm_and_si128(s, gmask);
+            dg = _mm_and_si128(d, gmask);
+            dg = _mm_add_epi32(dg, _mm_srli_epi32(_mm_mullo_epi32(_mm_sub_epi32(sg, dg), alpha), 8));
+            dg = _mm_and_si128(dg, gmask);
+
+            dalpha = _mm_srli_epi32(_mm_mullo_epi32(_mm_srli_epi32(d, 24), _mm_xor_si128(alpha, opaque)), 8);
+            dalpha = _mm_slli_epi32(_mm_add_epi32(alpha, dalpha), 24);
+
+            d1 = _mm_or_si128(_mm_or_si128(d1, dg), dalpha);
+            d1 = _mm_blendv_epi8(d1, s, _mm_cmpeq_epi32(alpha, opaque));
+            d1 = _mm_blendv_epi8(d1, d, _mm_cmpeq_epi32(alpha, zero));
+            _mm_storeu_si128((__m128i *) dstp, d1);
+        }
+        for (; n; --n, ++srcp, ++dstp) {
+            *dstp = BlendRGBtoRGBPixelAlpha(*srcp, *dstp);
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+#endif /* SDL_SSE4_1_BLITTERS */
+
+#if SDL_AVX2_BLITTERS
+/* The AVX2 version of BlitRGBtoRGBPixelAlphaSSE41, eight pixels at a time */
+static void SDL_TARGETING("avx2")
+BlitRGBtoRGBPixelAlphaAVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i opaque = _mm256_set1_epi32(0xff);
+    const __m256i amask = _mm256_set1_epi32(0xff000000);
+    const __m256i rbmask = _mm256_set1_epi32(0x00ff00ff);
+    const __m256i gmask = _mm256_set1_epi32(0x0000ff00);
+
+    while (height--) {
+        int n = width;
+
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) srcp);
+            __m256i d, alpha, s1, d1, sg, dg, dalpha;
+
+            if (_mm256_testz_si256(s, amask)) {
+                continue;   /* fully transparent */
+            }
+            d = _mm256_loadu_si256((const __m256i *) dstp);
+            alpha = _mm256_srli_epi32(s, 24);
+
+            s1 = _mm256_and_si256(s, rbmask);
+            d1 = _mm256_and_si256(d, rbmask);
+            d1 = _mm256_add_epi32(d1, _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(s1, d1), alpha), 8));
+            d1 = _mm256_and_si256(d1, rbmask);
+
+            sg = _mm256_and_si256(s, gmask);
+            dg = _mm256_and_si256(d, gmask);
+            dg = _mm256_add_epi32(dg, _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(sg, dg), alpha), 8));
+            dg = _mm256_and_si256(dg, gmask);
+
+            dalpha = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(d, 24), _mm256_xor_si256(alpha, opaque)), 8);
+            dalpha = _mm256_slli_epi32(_mm256_add_epi32(alpha, dalpha), 24);
+
+            d1 = _mm256_or_si256(_mm256_or_si256(d1, dg), dalpha);
+            d1 = _mm256_blendv_epi8(d1, s, _mm256_cmpeq_epi32(alpha, opaque));
+            d1 = _mm256_blendv_epi8(d1, d, _mm256_cmpeq_epi32(alpha, zero));
+            _mm256_storeu_si256((__m256i *) dstp, d1);
+        }
+        for (; n; --n, ++srcp, ++dstp) {
+            *dstp = BlendRGBtoRGBPixelAlpha(*srcp, *dstp);
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+#endif /* SDL_AVX2_BLITTERS */
+
 #ifdef __3dNOW__
 /* fast (as in MMX with prefetch) ARGB888->(A)RGB888 blending with pixel alpha */
 static void
@@ -1381,6 +1522,14 @@ SDL_CalculateBlitA(SDL_Surface * surface)
             if (sf->Rmask == df->Rmask
                 && sf->Gmask == df->Gmask
                 && sf->Bmask == df->Bmask && sf->BytesPerPixel == 4) {
+#if SDL_AVX2_BLITTERS
+                if (sf->Amask == 0xff000000 && (SDL_GetBlitCPUFeatures() & SDL_CPU_AVX2))
+                    return BlitRGBtoRGBPixelAlphaAVX2;
+#endif
+#if SDL_SSE4_1_BLITTERS
+                if (sf->Amask == 0xff000000 && (SDL_GetBlitCPUFeatures() & SDL_CPU_SSE41))
+                    return BlitRGBtoRGBPixelAlphaSSE41;
+#endif
 #if defined(__MMX__) || defined(__3dNOW__)
                 if (sf->Rshift % 8 == 0
                     && sf->Gshift % 8 == 0
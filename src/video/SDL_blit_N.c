@@ -2503,6 +2503,106 @@ BlitNtoNCopyAlpha(SDL_BlitInfo * info)
     }
 }
 
+#if SDL_SSE4_1_BLITTERS || SDL_AVX2_BLITTERS
+/* The 4->4 byte permutation of BlitNtoN and BlitNtoNCopyAlpha as a byte
+   shuffle for four pixels, and the alpha value BlitNtoN stores afterwards */
+static void
+Get4to4Shuffle(SDL_BlitInfo * info, Uint8 shuffle[16], Uint32 *fill)
+{
+    SDL_PixelFormat *srcfmt = info->src_fmt;
+    SDL_PixelFormat *dstfmt = info->dst_fmt;
+    int alpha_channel, p[4], i;
+
+    get_permutation(srcfmt, dstfmt, &p[0], &p[1], &p[2], &p[3], &alpha_channel);
+
+    for (i = 0; i < 16; ++i) {
+        shuffle[i] = (Uint8) ((i & ~3) + p[i & 3]);
+    }
+    *fill = 0;
+    if (!srcfmt->Amask || !dstfmt->Amask) {
+        const Uint32 alpha = dstfmt->Amask ? info->a : 0;
+        for (i = alpha_channel; i < 16; i += 4) {
+            shuffle[i] = 0x80;  /* zero the byte */
+        }
+        *fill = alpha << (alpha_channel * 8);
+    }
+}
+#endif
+
+#if SDL_SSE4_1_BLITTERS
+static void SDL_TARGETING("sse4.1")
+Blit4to4PermuteSSE41(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    Uint8 shuffle[16];
+    Uint32 fill;
+    __m128i vshuffle, vfill;
+
+    Get4to4Shuffle(info, shuffle, &fill);
+    vshuffle = _mm_loadu_si128((const __m128i *) shuffle);
+    vfill = _mm_set1_epi32((int) fill);
+
+    while (height--) {
+        int n = width;
+
+        for (; n >= 4; n -= 4, src += 16, dst += 16) {
+            const __m128i pixels = _mm_loadu_si128((const __m128i *) src);
+            _mm_storeu_si128((__m128i *) dst, _mm_or_si128(_mm_shuffle_epi8(pixels, vshuffle), vfill));
+        }
+        for (; n; --n, src += 4, dst += 4) {
+            const __m128i pixel = _mm_cvtsi32_si128(*(const int *) src);
+            *(Uint32 *) dst = (Uint32) _mm_cvtsi128_si32(_mm_or_si128(_mm_shuffle_epi8(pixel, vshuffle), vfill));
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+#endif /* SDL_SSE4_1_BLITTERS */
+
+#if SDL_AVX2_BLITTERS
+static void SDL_TARGETING("avx2")
+Blit4to4PermuteAVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    Uint8 shuffle[16];
+    Uint32 fill;
+    __m128i vshuffle, vfill;
+    __m256i vshuffle256, vfill256;
+
+    Get4to4Shuffle(info, shuffle, &fill);
+    vshuffle = _mm_loadu_si128((const __m128i *) shuffle);
+    vfill = _mm_set1_epi32((int) fill);
+    /* _mm256_shuffle_epi8 works within each 128-bit half */
+    vshuffle256 = _mm256_broadcastsi128_si256(vshuffle);
+    vfill256 = _mm256_set1_epi32((int) fill);
+
+    while (height--) {
+        int n = width;
+
+        for (; n >= 8; n -= 8, src += 32, dst += 32) {
+            const __m256i pixels = _mm256_loadu_si256((const __m256i *) src);
+            _mm256_storeu_si256((__m256i *) dst, _mm256_or_si256(_mm256_shuffle_epi8(pixels, vshuffle256), vfill256));
+        }
+        for (; n; --n, src += 4, dst += 4) {
+            const __m128i pixel = _mm_cvtsi32_si128(*(const int *) src);
+            *(Uint32 *) dst = (Uint32) _mm_cvtsi128_si32(_mm_or_si128(_mm_shuffle_epi8(pixel, vshuffle), vfill));
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+#endif /* SDL_AVX2_BLITTERS */
+
 static void
 BlitNto1Key(SDL_BlitInfo * info)
 {
@@ -3437,6 +3537,30 @@ SDL_CalculateBlitN(SDL_Surface * surface)
                     blitfun = BlitNtoNCopyAlpha;
                 }
             }
+
+#if SDL_SSE4_1_BLITTERS || SDL_AVX2_BLITTERS
+            /* These C blitters write each destination pixel as a byte
+               permutation of the source pixel, plus a constant alpha for
+               some of them, which is exactly what Blit4to4Permute does. */
+            if (srcfmt->BytesPerPixel == 4 && dstfmt->BytesPerPixel == 4 &&
+                srcfmt->format != SDL_PIXELFORMAT_ARGB2101010 &&
+                dstfmt->format != SDL_PIXELFORMAT_ARGB2101010 &&
+                (blitfun == BlitNtoN || blitfun == BlitNtoNCopyAlpha ||
+                 (blitfun == Blit_3or4_to_3or4__inversed_rgb && dstfmt->Amask) ||
+                 (blitfun == Blit4to4MaskAlpha && !dstfmt->Amask))) {
+                const Uint32 features = SDL_GetBlitCPUFeatures();
+#if SDL_AVX2_BLITTERS
+                if (features & SDL_CPU_AVX2) {
+                    return Blit4to4PermuteAVX2;
+                }
+#endif
+#if SDL_SSE4_1_BLITTERS
+                if (features & SDL_CPU_SSE41) {
+                    return Blit4to4PermuteSSE41;
+                }
+#endif
+            }
+#endif
         }
         return (blitfun);
 
@@ -23,6 +23,7 @@
 /* General (mostly internal) pixel/color manipulation routines for SDL */
 
 #include "SDL_endian.h"
+#include "SDL_mutex.h"
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
@@ -496,46 +497,96 @@ SDL_MasksToPixelFormatEnum(int bpp, Uint32 Rmask, Uint32 Gmask, Uint32 Bmask,
     return SDL_PIXELFORMAT_UNKNOWN;
 }
 
+/* The cached formats are looked up far more often than they're added or
+   freed, so lookups from different threads don't wait for each other */
 static SDL_PixelFormat *formats;
-static SDL_SpinLock formats_lock = 0;
+static SDL_rwlock *formats_lock;
+
+static void
+SDL_LockFormats(SDL_bool writing)
+{
+#if !SDL_THREADS_DISABLED
+    /* Formats can be allocated before SDL_Init() */
+    if (!formats_lock) {
+        static SDL_SpinLock create_lock;
+        SDL_AtomicLock(&create_lock);
+        if (!formats_lock) {
+            SDL_rwlock *rwlock = SDL_CreateRWLock();
+            SDL_MemoryBarrierRelease();
+            formats_lock = rwlock;
+        }
+        SDL_AtomicUnlock(&create_lock);
+    }
+    SDL_MemoryBarrierAcquire();
+
+    if (formats_lock) {
+        if (writing) {
+            SDL_LockRWLockForWriting(formats_lock);
+        } else {
+            SDL_LockRWLockForReading(formats_lock);
+        }
+    }
+#endif /* !SDL_THREADS_DISABLED */
+}
+
+static void
+SDL_UnlockFormats(void)
+{
+    if (formats_lock) {
+        SDL_UnlockRWLock(formats_lock);
+    }
+}
 
 SDL_PixelFormat *
 SDL_AllocFormat(Uint32 pixel_format)
 {
-    SDL_PixelFormat *format;
+    SDL_PixelFormat *format, *cached;
 
-    SDL_AtomicLock(&formats_lock);
+    SDL_LockFormats(SDL_FALSE);
 
     /* Look it up in our list of previously allocated formats */
     for (format = formats; format; format = format->next) {
         if (pixel_format == format->format) {
-            ++format->refcount;
-            SDL_AtomicUnlock(&formats_lock);
+            /* Other readers may be adding references at the same time */
+            SDL_AtomicIncRef((SDL_atomic_t *) &format->refcount);
+            SDL_UnlockFormats();
             return format;
         }
     }
 
+    SDL_UnlockFormats();
+
     /* Allocate an empty pixel format structure, and initialize it */
     format = SDL_malloc(sizeof(*format));
     if (format == NULL) {
-        SDL_AtomicUnlock(&formats_lock);
         SDL_OutOfMemory();
         return NULL;
     }
     if (SDL_InitFormat(format, pixel_format) < 0) {
-        SDL_AtomicUnlock(&formats_lock);
         SDL_free(format);
         SDL_InvalidParamError("format");
         return NULL;
     }
 
     if (!SDL_ISPIXELFORMAT_INDEXED(pixel_format)) {
+        SDL_LockFormats(SDL_TRUE);
+
+        /* Another thread may have cached it in the meantime */
+        for (cached = formats; cached; cached = cached->next) {
+            if (pixel_format == cached->format) {
+                ++cached->refcount;
+                SDL_UnlockFormats();
+                SDL_free(format);
+                return cached;
+            }
+        }
+
         /* Cache the RGB formats */
         format->next = formats;
         formats = format;
-    }
 
-    SDL_AtomicUnlock(&formats_lock);
+        SDL_UnlockFormats();
+    }
 
     return format;
 }
@@ -615,10 +666,10 @@ SDL_FreeFormat(SDL_PixelFormat *format)
         return;
     }
 
-    SDL_AtomicLock(&formats_lock);
+    SDL_LockFormats(SDL_TRUE);
 
     if (--format->refcount > 0) {
-        SDL_AtomicUnlock(&formats_lock);
+        SDL_UnlockFormats();
         return;
     }
 
@@ -634,7 +685,7 @@ SDL_FreeFormat(SDL_PixelFormat *format)
         }
     }
 
-    SDL_AtomicUnlock(&formats_lock);
+    SDL_UnlockFormats();
 
     if (format->palette) {
         SDL_FreePalette(format->palette);
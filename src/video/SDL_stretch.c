@@ -28,6 +28,15 @@
 
 #include "SDL_video.h"
 #include "SDL_blit.h"
+#include "SDL_cpuinfo.h"
+
+#if defined(__SSE2__)
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#if defined(__ARM_NEON)
+#define HAVE_NEON_INTRINSICS 1
+#endif
 
 /* This isn't ready for general consumption yet - it should be folded
    into the general blitting mechanism.
@@ -350,4 +359,254 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
     return (0);
 }
 
+/* Linear filtering works on 8-bit channels with 7-bit weights, so the four
+   weights of a pixel add up to 1 << 14 and the scalar and SIMD versions can
+   all do the exact same integer math. */
+#define LINEAR_FRAC_BITS    7
+#define LINEAR_ONE          (1 << LINEAR_FRAC_BITS)
+
+/* Find the two source pixels around a 16.16 position and the weight of the second one */
+static SDL_INLINE void
+linear_coord(Sint64 pos, int first, int last, int *i0, int *i1, int *frac)
+{
+    const int i = (int) (pos >> 16);
+
+    if (pos <= ((Sint64) first << 16)) {
+        *i0 = *i1 = first;
+        *frac = 0;
+    } else if (i >= last) {
+        *i0 = *i1 = last;
+        *frac = 0;
+    } else {
+        *i0 = i;
+        *i1 = i + 1;
+        *frac = (int) ((pos >> (16 - LINEAR_FRAC_BITS)) & (LINEAR_ONE - 1));
+    }
+}
+
+typedef void (*SDL_StretchRowLinearFunc)(const Uint32 *row0, const Uint32 *row1, int fy,
+                                         Uint32 *dst, int dst_w, Sint64 pos, Sint64 inc,
+                                         int first, int last);
+
+/* The reference implementation, the SIMD versions must match it exactly */
+static void
+stretch_row_linear_scalar(const Uint32 *row0, const Uint32 *row1, int fy,
+                          Uint32 *dst, int dst_w, Sint64 pos, Sint64 inc,
+                          int first, int last)
+{
+    int i;
+
+    for (i = 0; i < dst_w; ++i, pos += inc) {
+        int x0, x1, fx, shift;
+        int w00, w01, w10, w11;
+        Uint32 p00, p01, p10, p11, pixel = 0;
+
+        linear_coord(pos, first, last, &x0, &x1, &fx);
+        w00 = (LINEAR_ONE - fx) * (LINEAR_ONE - fy);
+        w01 = fx * (LINEAR_ONE - fy);
+        w10 = (LINEAR_ONE - fx) * fy;
+        w11 = fx * fy;
+        p00 = row0[x0];
+        p01 = row0[x1];
+        p10 = row1[x0];
+        p11 = row1[x1];
+
+        for (shift = 0; shift < 32; shift += 8) {
+            const Uint32 c = ((((p00 >> shift) & 0xFF) * w00) + (((p01 >> shift) & 0xFF) * w01) +
+                              (((p10 >> shift) & 0xFF) * w10) + (((p11 >> shift) & 0xFF) * w11) +
+                              (1 << (2 * LINEAR_FRAC_BITS - 1))) >> (2 * LINEAR_FRAC_BITS);
+            pixel |= c << shift;
+        }
+        *dst++ = pixel;
+    }
+}
+
+#if HAVE_SSE2_INTRINSICS
+static void
+stretch_row_linear_SSE2(const Uint32 *row0, const Uint32 *row1, int fy,
+                        Uint32 *dst, int dst_w, Sint64 pos, Sint64 inc,
+                        int first, int last)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << (2 * LINEAR_FRAC_BITS - 1));
+    int i;
+
+    for (i = 0; i < dst_w; ++i, pos += inc) {
+        int x0, x1, fx;
+        __m128i top, bottom, wtop, wbottom, sum;
+
+        linear_coord(pos, first, last, &x0, &x1, &fx);
+
+        /* interleave the two pixels of each row channel by channel, as 16-bit values */
+        top = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int) row0[x0]), zero),
+                                 _mm_unpacklo_epi8(_mm_cvtsi32_si128((int) row0[x1]), zero));
+        bottom = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int) row1[x0]), zero),
+                                    _mm_unpacklo_epi8(_mm_cvtsi32_si128((int) row1[x1]), zero));
+        wtop = _mm_set1_epi32(((fx * (LINEAR_ONE - fy)) << 16) | ((LINEAR_ONE - fx) * (LINEAR_ONE - fy)));
+        wbottom = _mm_set1_epi32(((fx * fy) << 16) | ((LINEAR_ONE - fx) * fy));
+
+        sum = _mm_add_epi32(_mm_madd_epi16(top, wtop), _mm_madd_epi16(bottom, wbottom));
+        sum = _mm_srli_epi32(_mm_add_epi32(sum, round), 2 * LINEAR_FRAC_BITS);
+        sum = _mm_packs_epi32(sum, sum);
+        sum = _mm_packus_epi16(sum, sum);
+        *dst++ = (Uint32) _mm_cvtsi128_si32(sum);
+    }
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static void
+stretch_row_linear_NEON(const Uint32 *row0, const Uint32 *row1, int fy,
+                        Uint32 *dst, int dst_w, Sint64 pos, Sint64 inc,
+                        int first, int last)
+{
+    const uint32x4_t round = vdupq_n_u32(1 << (2 * LINEAR_FRAC_BITS - 1));
+    int i;
+
+    for (i = 0; i < dst_w; ++i, pos += inc) {
+        int x0, x1, fx;
+        uint16x8_t top, bottom;
+        uint32x4_t sum;
+        uint16x4_t sum16;
+        uint8x8_t sum8;
+
+        linear_coord(pos, first, last, &x0, &x1, &fx);
+
+        /* the low half holds the left pixel, the high half the right one */
+        top = vmovl_u8(vcreate_u8(((Uint64) row0[x1] << 32) | row0[x0]));
+        bottom = vmovl_u8(vcreate_u8(((Uint64) row1[x1] << 32) | row1[x0]));
+
+        sum = vmull_n_u16(vget_low_u16(top), (Uint16) ((LINEAR_ONE - fx) * (LINEAR_ONE - fy)));
+        sum = vmlal_n_u16(sum, vget_high_u16(top), (Uint16) (fx * (LINEAR_ONE - fy)));
+        sum = vmlal_n_u16(sum, vget_low_u16(bottom), (Uint16) ((LINEAR_ONE - fx) * fy));
+        sum = vmlal_n_u16(sum, vget_high_u16(bottom), (Uint16) (fx * fy));
+        sum16 = vshrn_n_u32(vaddq_u32(sum, round), 2 * LINEAR_FRAC_BITS);
+        sum8 = vmovn_u16(vcombine_u16(sum16, sum16));
+        *dst++ = vget_lane_u32(vreinterpret_u32_u8(sum8), 0);
+    }
+}
+#endif
+
+static SDL_StretchRowLinearFunc
+SDL_ChooseStretchRowLinear(void)
+{
+    /* SDL_BLIT_CPU_FEATURES=0 forces the scalar version, for testing. */
+    const Uint32 features = SDL_GetBlitCPUFeatures();
+
+#if HAVE_SSE2_INTRINSICS
+    if (features & SDL_CPU_SSE2) {
+        return stretch_row_linear_SSE2;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (features & SDL_CPU_NEON) {
+        return stretch_row_linear_NEON;
+    }
+#endif
+    return stretch_row_linear_scalar;
+}
+
+/* Perform a bilinear filtered stretch blit between two surfaces of the same
+   format, which must have four 8-bit channels. */
+int
+SDL_SoftStretchLinear(SDL_Surface * src, const SDL_Rect * srcrect,
+                      SDL_Surface * dst, const SDL_Rect * dstrect)
+{
+    static SDL_StretchRowLinearFunc stretch_row = NULL;
+    int src_locked;
+    int dst_locked;
+    int dst_row, dst_maxrow;
+    Sint64 pos, inc, xpos, xinc;
+    SDL_Rect full_src;
+    SDL_Rect full_dst;
+
+    if (src->format->format != dst->format->format) {
+        return SDL_SetError("Only works with same format surfaces");
+    }
+    if (src->format->BytesPerPixel != 4 || src->format->format == SDL_PIXELFORMAT_ARGB2101010) {
+        return SDL_SetError("Only works with 32-bit surfaces with 8-bit channels");
+    }
+
+    /* Verify the blit rectangles */
+    if (srcrect) {
+        if ((srcrect->x < 0) || (srcrect->y < 0) ||
+            ((srcrect->x + srcrect->w) > src->w) ||
+            ((srcrect->y + srcrect->h) > src->h)) {
+            return SDL_SetError("Invalid source blit rectangle");
+        }
+    } else {
+        full_src.x = 0;
+        full_src.y = 0;
+        full_src.w = src->w;
+        full_src.h = src->h;
+        srcrect = &full_src;
+    }
+    if (dstrect) {
+        if ((dstrect->x < 0) || (dstrect->y < 0) ||
+            ((dstrect->x + dstrect->w) > dst->w) ||
+            ((dstrect->y + dstrect->h) > dst->h)) {
+            return SDL_SetError("Invalid destination blit rectangle");
+        }
+    } else {
+        full_dst.x = 0;
+        full_dst.y = 0;
+        full_dst.w = dst->w;
+        full_dst.h = dst->h;
+        dstrect = &full_dst;
+    }
+
+    if (srcrect->w <= 0 || srcrect->h <= 0 || dstrect->w <= 0 || dstrect->h <= 0) {
+        return 0;
+    }
+
+    if (!stretch_row) {
+        stretch_row = SDL_ChooseStretchRowLinear();
+    }
+
+    /* Lock the destination if it's in hardware */
+    dst_locked = 0;
+    if (SDL_MUSTLOCK(dst)) {
+        if (SDL_LockSurface(dst) < 0) {
+            return SDL_SetError("Unable to lock destination surface");
+        }
+        dst_locked = 1;
+    }
+    /* Lock the source if it's in hardware */
+    src_locked = 0;
+    if (SDL_MUSTLOCK(src)) {
+        if (SDL_LockSurface(src) < 0) {
+            if (dst_locked) {
+                SDL_UnlockSurface(dst);
+            }
+            return SDL_SetError("Unable to lock source surface");
+        }
+        src_locked = 1;
+    }
+
+    /* Sample at the center of each destination pixel, in 16.16 source coordinates */
+    inc = ((Sint64) srcrect->h << 16) / dstrect->h;
+    pos = ((Sint64) srcrect->y << 16) + (inc / 2) - 0x8000;
+    xinc = ((Sint64) srcrect->w << 16) / dstrect->w;
+    xpos = ((Sint64) srcrect->x << 16) + (xinc / 2) - 0x8000;
+
+    for (dst_row = dstrect->y, dst_maxrow = dst_row + dstrect->h; dst_row < dst_maxrow; ++dst_row, pos += inc) {
+        Uint32 *dstp = (Uint32 *) ((Uint8 *) dst->pixels + (dst_row * dst->pitch)) + dstrect->x;
+        int y0, y1, fy;
+
+        linear_coord(pos, srcrect->y, srcrect->y + srcrect->h - 1, &y0, &y1, &fy);
+        stretch_row((const Uint32 *) ((const Uint8 *) src->pixels + (y0 * src->pitch)),
+                    (const Uint32 *) ((const Uint8 *) src->pixels + (y1 * src->pitch)),
+                    fy, dstp, dstrect->w, xpos, xinc, srcrect->x, srcrect->x + srcrect->w - 1);
+    }
+
+    /* We need to unlock the surfaces if they're locked */
+    if (dst_locked) {
+        SDL_UnlockSurface(dst);
+    }
+    if (src_locked) {
+        SDL_UnlockSurface(src);
+    }
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -723,6 +723,13 @@ SDL_UpperBlit(SDL_Surface * src, const SDL_Rect * srcrect,
 int
 SDL_UpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect,
               SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    return SDL_PrivateUpperBlitScaled(src, srcrect, dst, dstrect, SDL_FALSE);
+}
+
+int
+SDL_PrivateUpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect,
+              SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool linear)
 {
     double src_x0, src_y0, src_x1, src_y1;
     double dst_x0, dst_y0, dst_x1, dst_y1;
@@ -867,7 +874,7 @@ SDL_UpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect,
         return 0;
     }
 
-    return SDL_LowerBlitScaled(src, &final_src, dst, &final_dst);
+    return SDL_PrivateLowerBlitScaled(src, &final_src, dst, &final_dst, linear);
 }
 
 /**
@@ -878,11 +885,96 @@ int
 SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
                 SDL_Surface * dst, SDL_Rect * dstrect)
 {
-    static const Uint32 complex_copy_flags = (
-        SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
-        SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL |
-        SDL_COPY_COLORKEY
-    );
+    return SDL_PrivateLowerBlitScaled(src, srcrect, dst, dstrect, SDL_FALSE);
+}
+
+static const Uint32 complex_copy_flags = (
+    SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
+    SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL |
+    SDL_COPY_COLORKEY
+);
+
+static int
+SDL_LowerBlitScaledLinear(SDL_Surface * src, SDL_Rect * srcrect,
+                          SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    SDL_Surface *stretch_src = src;
+    SDL_Surface *tmp1 = NULL;
+    SDL_Surface *tmp2 = NULL;
+    SDL_Rect stretch_rect = *srcrect;
+    int ret;
+
+    if (src->format->BytesPerPixel != 4 || src->format->format == SDL_PIXELFORMAT_ARGB2101010) {
+        /* Convert the source rectangle to a format with four 8-bit channels */
+        tmp1 = SDL_CreateRGBSurfaceWithFormat(0, srcrect->w, srcrect->h, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!tmp1) {
+            return -1;
+        }
+        if (SDL_LockSurface(src) < 0) {
+            SDL_FreeSurface(tmp1);
+            return -1;
+        }
+        ret = SDL_ConvertPixels(srcrect->w, srcrect->h, src->format->format,
+                                (Uint8 *) src->pixels + srcrect->y * src->pitch + srcrect->x * src->format->BytesPerPixel,
+                                src->pitch, tmp1->format->format, tmp1->pixels, tmp1->pitch);
+        SDL_UnlockSurface(src);
+        if (ret < 0) {
+            SDL_FreeSurface(tmp1);
+            return ret;
+        }
+        stretch_src = tmp1;
+        stretch_rect.x = 0;
+        stretch_rect.y = 0;
+    }
+
+    if (!(src->map->info.flags & complex_copy_flags) &&
+        stretch_src->format->format == dst->format->format) {
+        ret = SDL_SoftStretchLinear(stretch_src, &stretch_rect, dst, dstrect);
+    } else {
+        /* Stretch into a temporary surface and let the regular blitter finish the job */
+        tmp2 = SDL_CreateRGBSurfaceWithFormat(0, dstrect->w, dstrect->h, 32, stretch_src->format->format);
+        if (!tmp2) {
+            SDL_FreeSurface(tmp1);
+            return -1;
+        }
+        ret = SDL_SoftStretchLinear(stretch_src, &stretch_rect, tmp2, NULL);
+        if (ret == 0) {
+            Uint8 r, g, b, a;
+            SDL_BlendMode blendMode;
+            SDL_Rect tmprect;
+
+            SDL_GetSurfaceColorMod(src, &r, &g, &b);
+            SDL_SetSurfaceColorMod(tmp2, r, g, b);
+            SDL_GetSurfaceAlphaMod(src, &a);
+            SDL_SetSurfaceAlphaMod(tmp2, a);
+            SDL_GetSurfaceBlendMode(src, &blendMode);
+            SDL_SetSurfaceBlendMode(tmp2, blendMode);
+
+            tmprect.x = 0;
+            tmprect.y = 0;
+            tmprect.w = dstrect->w;
+            tmprect.h = dstrect->h;
+            ret = SDL_LowerBlit(tmp2, &tmprect, dst, dstrect);
+        }
+    }
+
+    SDL_FreeSurface(tmp1);
+    SDL_FreeSurface(tmp2);
+    return ret;
+}
+
+int
+SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
+                SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool linear)
+{
+    /* Color keys and palettes don't filter well, those always use the nearest pixel */
+    if (linear &&
+        !(src->map->info.flags & SDL_COPY_COLORKEY) &&
+        !SDL_ISPIXELFORMAT_INDEXED(src->format->format) &&
+        !SDL_ISPIXELFORMAT_INDEXED(dst->format->format) &&
+        (srcrect->w != dstrect->w || srcrect->h != dstrect->h)) {
+        return SDL_LowerBlitScaledLinear(src, srcrect, dst, dstrect);
+    }
 
     if (!(src->map->info.flags & SDL_COPY_NEAREST)) {
         src->map->info.flags |= SDL_COPY_NEAREST;
@@ -967,6 +967,1254 @@ int audio_openCloseAudioDeviceConnected()
    return TEST_COMPLETED;
 }
 
+/**
+ * \brief Resamples sine waves and checks the result against the ideal signal.
+ *
+ * \sa https://wiki.libsdl.org/SDL_BuildAudioCVT
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_resampleLoss()
+{
+  /* Note: always test long input time (>= 5s from experience) in some test
+   * cases because an improper implementation may suffer from low resampling
+   * precision with long input due to e.g. doing subtraction with large floats. */
+  struct test_spec_t {
+    int time;
+    int freq;
+    int rate_in;
+    int rate_out;
+    double signal_to_noise;
+    double max_error;
+  } test_specs[] = {
+    { 50, 440, 44100, 48000, 60, 0.0025 },
+    { 50, 5000, 44100, 48000, 60, 0.0025 },
+    { 50, 440, 48000, 44100, 60, 0.0025 },
+    { 50, 440, 22050, 44100, 60, 0.0025 },
+    { 50, 440, 8000, 44100, 60, 0.0025 },
+    { 50, 440, 96000, 44100, 60, 0.0025 },
+    { 0 }
+  };
+
+  int spec_idx = 0;
+
+  for (spec_idx = 0; test_specs[spec_idx].time > 0; ++spec_idx) {
+    const struct test_spec_t *spec = &test_specs[spec_idx];
+    const int frames_in = spec->time * spec->rate_in;
+    const int len_in = frames_in * (int)sizeof(float);
+    const int skip = spec->rate_out / 100;  /* ignore the ramp up and down at the edges of the buffer. */
+    SDL_AudioCVT cvt;
+    int ret, i, frames_out;
+    float *buf;
+    double max_error = 0;
+    double sum_squared_error = 0;
+    double sum_squared_value = 0;
+    double signal_to_noise;
+
+    SDLTest_AssertPass("Test resampling of %i s %i Hz sine wave from sampling rate of %i Hz to %i Hz",
+                       spec->time, spec->freq, spec->rate_in, spec->rate_out);
+
+    ret = SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, 1, spec->rate_in, AUDIO_F32SYS, 1, spec->rate_out);
+    SDLTest_AssertPass("Call to SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, 1, %i, AUDIO_F32SYS, 1, %i)", spec->rate_in, spec->rate_out);
+    SDLTest_AssertCheck(ret == 1, "Expected SDL_BuildAudioCVT to succeed and conversion to be needed.");
+    if (ret != 1) {
+      return TEST_ABORTED;
+    }
+
+    cvt.len = len_in;
+    buf = (float *)SDL_malloc(len_in * cvt.len_mult);
+    SDLTest_AssertCheck(buf != NULL, "Expected input buffer to be created.");
+    if (buf == NULL) {
+      return TEST_ABORTED;
+    }
+
+    for (i = 0; i < frames_in; ++i) {
+      buf[i] = (float)(0.5 * SDL_sin(2.0 * M_PI * spec->freq * ((double) i / spec->rate_in)));
+    }
+
+    cvt.buf = (Uint8 *)buf;
+    ret = SDL_ConvertAudio(&cvt);
+    SDLTest_AssertPass("Call to SDL_ConvertAudio(&cvt)");
+    SDLTest_AssertCheck(ret == 0, "Expected SDL_ConvertAudio to succeed.");
+    if (ret != 0) {
+      SDL_free(buf);
+      return TEST_ABORTED;
+    }
+
+    frames_out = cvt.len_cvt / (int)sizeof(float);
+    SDLTest_AssertCheck(frames_out > (2 * skip), "Expected output frames; got: %i", frames_out);
+
+    for (i = skip; i < frames_out - skip; ++i) {
+      const double target = 0.5 * SDL_sin(2.0 * M_PI * spec->freq * ((double) i / spec->rate_out));
+      const double error = SDL_fabs(target - buf[i]);
+      max_error = SDL_max(max_error, error);
+      sum_squared_error += error * error;
+      sum_squared_value += target * target;
+    }
+    SDL_free(buf);
+
+    SDLTest_AssertCheck(sum_squared_value != 0.0, "Sum of squared target should not be zero.");
+    signal_to_noise = 10 * SDL_log10(sum_squared_value / sum_squared_error); /* decibel */
+    SDLTest_AssertCheck(signal_to_noise >= spec->signal_to_noise,
+                        "Expected resampling signal-to-noise ratio to be >= %f dB, got %f dB.", spec->signal_to_noise, signal_to_noise);
+    SDLTest_AssertCheck(max_error <= spec->max_error,
+                        "Expected resampling max absolute error to be <= %f, got %f.", spec->max_error, max_error);
+  }
+
+  return TEST_COMPLETED;
+}
+
+
+
+/**
+ * \brief Resamples a sine wave through an audio stream at each resampling quality.
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamSetResampleQuality
+ */
+int audio_resampleQuality()
+{
+  struct quality_spec_t {
+    SDL_AudioResampleQuality quality;
+    const char *name;
+    double signal_to_noise;
+  } quality_specs[] = {
+    { SDL_AUDIO_RESAMPLE_ZERO_ORDER_HOLD, "zero-order hold", 20 },
+    { SDL_AUDIO_RESAMPLE_LINEAR, "linear", 55 },
+    { SDL_AUDIO_RESAMPLE_SHORT_SINC, "short sinc", 55 },
+    { SDL_AUDIO_RESAMPLE_HIGH_QUALITY, "high quality", 60 }
+  };
+  const int freq = 440;
+  const int rate_in = 44100;
+  const int rate_out = 48000;
+  const int frames_in = rate_in;
+  const int skip = rate_out / 100;  /* ignore the edges of the buffer. */
+  float *buf_in;
+  float *buf_out;
+  int i, q, ret;
+
+  buf_in = (float *)SDL_malloc(frames_in * sizeof(float));
+  buf_out = (float *)SDL_malloc(rate_out * 2 * sizeof(float));
+  SDLTest_AssertCheck(buf_in != NULL && buf_out != NULL, "Expected buffers to be created.");
+  if (buf_in == NULL || buf_out == NULL) {
+    SDL_free(buf_in);
+    SDL_free(buf_out);
+    return TEST_ABORTED;
+  }
+
+  for (i = 0; i < frames_in; ++i) {
+    buf_in[i] = (float)(0.5 * SDL_sin(2.0 * M_PI * freq * ((double) i / rate_in)));
+  }
+
+  for (q = 0; q < (int) SDL_arraysize(quality_specs); ++q) {
+    const struct quality_spec_t *spec = &quality_specs[q];
+    SDL_AudioStream *stream = SDL_NewAudioStream(AUDIO_F32SYS, 1, rate_in, AUDIO_F32SYS, 1, rate_out);
+    double sum_squared_error = 0;
+    double sum_squared_value = 0;
+    double signal_to_noise;
+    int frames_out;
+
+    SDLTest_AssertPass("Call to SDL_NewAudioStream(AUDIO_F32SYS, 1, %i, AUDIO_F32SYS, 1, %i)", rate_in, rate_out);
+    SDLTest_AssertCheck(stream != NULL, "Expected stream to be created.");
+    if (stream == NULL) {
+      continue;
+    }
+
+    ret = SDL_AudioStreamSetResampleQuality(stream, spec->quality);
+    SDLTest_AssertPass("Call to SDL_AudioStreamSetResampleQuality(stream, %s)", spec->name);
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+
+    ret = SDL_AudioStreamPut(stream, buf_in, frames_in * sizeof(float));
+    SDLTest_AssertPass("Call to SDL_AudioStreamPut(stream, buf_in, %i)", (int) (frames_in * sizeof(float)));
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+
+    frames_out = SDL_AudioStreamGet(stream, buf_out, rate_out * 2 * sizeof(float)) / (int)sizeof(float);
+    SDLTest_AssertPass("Call to SDL_AudioStreamGet(stream, buf_out, ...)");
+    SDLTest_AssertCheck(frames_out > (2 * skip), "Expected output frames; got: %i", frames_out);
+
+    for (i = skip; i < frames_out - skip; ++i) {
+      const double target = 0.5 * SDL_sin(2.0 * M_PI * freq * ((double) i / rate_out));
+      const double error = target - buf_out[i];
+      sum_squared_error += error * error;
+      sum_squared_value += target * target;
+    }
+
+    if (sum_squared_error > 0.0) {
+      signal_to_noise = 10 * SDL_log10(sum_squared_value / sum_squared_error); /* decibel */
+      SDLTest_AssertCheck(signal_to_noise >= spec->signal_to_noise,
+                          "Expected %s signal-to-noise ratio to be >= %f dB, got %f dB.", spec->name, spec->signal_to_noise, signal_to_noise);
+    }
+
+    SDL_FreeAudioStream(stream);
+  }
+
+  SDL_free(buf_in);
+  SDL_free(buf_out);
+
+  /* Negative cases */
+  ret = SDL_AudioStreamSetResampleQuality(NULL, SDL_AUDIO_RESAMPLE_LINEAR);
+  SDLTest_AssertPass("Call to SDL_AudioStreamSetResampleQuality(NULL, SDL_AUDIO_RESAMPLE_LINEAR)");
+  SDLTest_AssertCheck(ret == -1, "Verify result value; expected: -1, got: %i", ret);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Converts channels through default and app-supplied mixing matrices.
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamSetChannelMatrix
+ * \sa https://wiki.libsdl.org/SDL_BuildAudioCVT
+ */
+int audio_channelMatrix()
+{
+  const float swap_matrix[2 * 2] = { 0.0f, 1.0f, 1.0f, 0.0f };
+  const float invert_matrix[2 * 1] = { 1.0f, -1.0f };
+  const Sint16 stereo_in[4 * 2] = { 100, -200, 300, -400, 500, -600, 700, -800 };
+  Sint16 stereo_out[4 * 2];
+  float surround_buf[8 * 4];
+  float *mono_in;
+  float *stereo_buf;
+  SDL_AudioStream *stream;
+  SDL_AudioCVT cvt;
+  int i, ret, len, frames;
+
+  /* The default 5.1 to 7.1 upmix widens each side away from its own average. */
+  SDL_zero(surround_buf);
+  surround_buf[1] = 1.0f;  /* FR */
+  ret = SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, 6, 48000, AUDIO_F32SYS, 8, 48000);
+  SDLTest_AssertPass("Call to SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, 6, 48000, AUDIO_F32SYS, 8, 48000)");
+  SDLTest_AssertCheck(ret == 1, "Verify result value; expected: 1, got: %i", ret);
+  cvt.buf = (Uint8 *)surround_buf;
+  cvt.len = 6 * sizeof(float);
+  ret = SDL_ConvertAudio(&cvt);
+  SDLTest_AssertPass("Call to SDL_ConvertAudio(&cvt)");
+  SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+  SDLTest_AssertCheck(cvt.len_cvt == 8 * sizeof(float), "Verify converted length; expected: %i, got: %i", (int) (8 * sizeof(float)), cvt.len_cvt);
+  SDLTest_AssertCheck(surround_buf[0] == 0.0f && surround_buf[1] == 1.5f && surround_buf[5] == -0.5f && surround_buf[6] == 0.0f && surround_buf[7] == 0.5f,
+                      "Verify 7.1 front right, back right, side left and side right; expected: 1.5, -0.5, 0, 0.5, got: %f, %f, %f, %f",
+                      surround_buf[1], surround_buf[5], surround_buf[6], surround_buf[7]);
+
+  /* An app matrix swapping left and right, without resampling. */
+  stream = SDL_NewAudioStream(AUDIO_S16SYS, 2, 44100, AUDIO_S16SYS, 2, 44100);
+  SDLTest_AssertPass("Call to SDL_NewAudioStream(AUDIO_S16SYS, 2, 44100, AUDIO_S16SYS, 2, 44100)");
+  SDLTest_AssertCheck(stream != NULL, "Expected stream to be created.");
+  if (stream != NULL) {
+    ret = SDL_AudioStreamSetChannelMatrix(stream, swap_matrix);
+    SDLTest_AssertPass("Call to SDL_AudioStreamSetChannelMatrix(stream, swap_matrix)");
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+    ret = SDL_AudioStreamPut(stream, stereo_in, sizeof(stereo_in));
+    SDLTest_AssertCheck(ret == 0, "Verify SDL_AudioStreamPut result value; expected: 0, got: %i", ret);
+    len = SDL_AudioStreamGet(stream, stereo_out, sizeof(stereo_out));
+    SDLTest_AssertCheck(len == sizeof(stereo_out), "Verify SDL_AudioStreamGet length; expected: %i, got: %i", (int) sizeof(stereo_out), len);
+    for (i = 0; i < 4; ++i) {
+      SDLTest_AssertCheck(stereo_out[i * 2] == stereo_in[(i * 2) + 1] && stereo_out[(i * 2) + 1] == stereo_in[i * 2],
+                          "Verify frame %i is swapped; expected: %i, %i, got: %i, %i",
+                          i, stereo_in[(i * 2) + 1], stereo_in[i * 2], stereo_out[i * 2], stereo_out[(i * 2) + 1]);
+    }
+
+    /* NULL goes back to the default, which leaves stereo alone. */
+    ret = SDL_AudioStreamSetChannelMatrix(stream, NULL);
+    SDLTest_AssertPass("Call to SDL_AudioStreamSetChannelMatrix(stream, NULL)");
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+    ret = SDL_AudioStreamPut(stream, stereo_in, sizeof(stereo_in));
+    SDLTest_AssertCheck(ret == 0, "Verify SDL_AudioStreamPut result value; expected: 0, got: %i", ret);
+    len = SDL_AudioStreamGet(stream, stereo_out, sizeof(stereo_out));
+    SDLTest_AssertCheck(len == sizeof(stereo_out) && SDL_memcmp(stereo_in, stereo_out, sizeof(stereo_out)) == 0,
+                        "Verify stereo passes through unchanged.");
+    SDL_FreeAudioStream(stream);
+  }
+
+  /* An app matrix upmixing mono to stereo with the right channel inverted, while resampling. */
+  frames = 22050;
+  mono_in = (float *)SDL_malloc(frames * sizeof(float));
+  stereo_buf = (float *)SDL_malloc(frames * 2 * 2 * sizeof(float));
+  stream = SDL_NewAudioStream(AUDIO_F32SYS, 1, 22050, AUDIO_F32SYS, 2, 44100);
+  SDLTest_AssertPass("Call to SDL_NewAudioStream(AUDIO_F32SYS, 1, 22050, AUDIO_F32SYS, 2, 44100)");
+  SDLTest_AssertCheck(stream != NULL && mono_in != NULL && stereo_buf != NULL, "Expected stream and buffers to be created.");
+  if (stream != NULL && mono_in != NULL && stereo_buf != NULL) {
+    for (i = 0; i < frames; ++i) {
+      mono_in[i] = (float)(0.5 * SDL_sin(2.0 * M_PI * 440 * ((double) i / 22050)));
+    }
+    ret = SDL_AudioStreamSetChannelMatrix(stream, invert_matrix);
+    SDLTest_AssertPass("Call to SDL_AudioStreamSetChannelMatrix(stream, invert_matrix)");
+    SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+    ret = SDL_AudioStreamPut(stream, mono_in, frames * sizeof(float));
+    SDLTest_AssertCheck(ret == 0, "Verify SDL_AudioStreamPut result value; expected: 0, got: %i", ret);
+    len = SDL_AudioStreamGet(stream, stereo_buf, frames * 2 * 2 * sizeof(float));
+    SDLTest_AssertCheck(len > (int) (frames * 2 * sizeof(float)), "Verify SDL_AudioStreamGet length; expected more than: %i, got: %i", (int) (frames * 2 * sizeof(float)), len);
+    for (i = 0; i < len / (int) (2 * sizeof(float)); ++i) {
+      if (stereo_buf[(i * 2) + 1] != -stereo_buf[i * 2]) {
+        break;
+      }
+    }
+    SDLTest_AssertCheck(i == len / (int) (2 * sizeof(float)), "Verify right channel is the inverted left channel; first mismatch at frame %i", i);
+  }
+  SDL_FreeAudioStream(stream);
+  SDL_free(mono_in);
+  SDL_free(stereo_buf);
+
+  /* Negative cases */
+  ret = SDL_AudioStreamSetChannelMatrix(NULL, swap_matrix);
+  SDLTest_AssertPass("Call to SDL_AudioStreamSetChannelMatrix(NULL, swap_matrix)");
+  SDLTest_AssertCheck(ret == -1, "Verify result value; expected: -1, got: %i", ret);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Mixes three voices into the disk audio driver's output file and checks the sum.
+ *
+ * \sa https://wiki.libsdl.org/SDL_AddAudioDeviceVoice
+ * \sa https://wiki.libsdl.org/SDL_SetAudioDeviceVoiceGain
+ * \sa https://wiki.libsdl.org/SDL_RemoveAudioDeviceVoice
+ */
+int audio_mixVoices()
+{
+  const int frames = 4800;
+  SDL_AudioSpec desired;
+  SDL_AudioDeviceID id;
+  SDL_AudioStream *voice1, *voice2, *voice3;
+  Sint16 *mono;
+  float *stereo2, *stereo3;
+  Sint16 frame[2];
+  SDL_RWops *rw;
+  int matched = 0, unexpected = 0;
+  int i, ret, available;
+
+  /* Switch the running audio subsystem over to playing into a file */
+  ret = SDL_AudioInit("disk");
+  SDLTest_AssertPass("Call to SDL_AudioInit('disk')");
+  SDLTest_AssertCheck(ret == 0, "Validate result value; expected: 0 got: %d", ret);
+
+  SDL_memset(&desired, 0, sizeof(desired));
+  desired.freq = 48000;
+  desired.format = AUDIO_S16SYS;
+  desired.channels = 2;
+  desired.samples = 512;
+  id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+  SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, desired, NULL, 0)");
+  SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >=2, got: %i", id);
+
+  mono = (Sint16 *)SDL_malloc(frames * sizeof(Sint16));
+  stereo2 = (float *)SDL_malloc(frames * 2 * sizeof(float));
+  stereo3 = (float *)SDL_malloc(frames * 2 * sizeof(float));
+  if (id == 0 || mono == NULL || stereo2 == NULL || stereo3 == NULL) {
+    SDL_free(mono);
+    SDL_free(stereo2);
+    SDL_free(stereo3);
+    SDL_QuitSubSystem( SDL_INIT_AUDIO );
+    _audioSetUp(NULL);
+    return TEST_ABORTED;
+  }
+
+  for (i = 0; i < frames; ++i) {
+    mono[i] = 16384;
+    stereo2[i * 2] = 0.25f;
+    stereo2[i * 2 + 1] = -0.5f;
+    stereo3[i * 2] = 0.75f;
+    stereo3[i * 2 + 1] = 0.0f;
+  }
+
+  /* Add all three voices while locked, so they start in the same buffer. */
+  SDL_LockAudioDevice(id);
+  voice1 = SDL_AddAudioDeviceVoice(id, AUDIO_S16SYS, 1, 48000);
+  SDLTest_AssertPass("Call to SDL_AddAudioDeviceVoice(id, AUDIO_S16SYS, 1, 48000)");
+  SDLTest_AssertCheck(voice1 != NULL, "Validate voice is not NULL");
+  voice2 = SDL_AddAudioDeviceVoice(id, AUDIO_F32SYS, 2, 48000);
+  SDLTest_AssertPass("Call to SDL_AddAudioDeviceVoice(id, AUDIO_F32SYS, 2, 48000)");
+  SDLTest_AssertCheck(voice2 != NULL, "Validate voice is not NULL");
+  voice3 = SDL_AddAudioDeviceVoice(id, AUDIO_F32SYS, 2, 48000);
+  SDLTest_AssertPass("Call to SDL_AddAudioDeviceVoice(id, AUDIO_F32SYS, 2, 48000)");
+  SDLTest_AssertCheck(voice3 != NULL, "Validate voice is not NULL");
+
+  /* Half gain, left only: (0.25, 0) */
+  ret = SDL_SetAudioDeviceVoiceGain(id, voice1, 0.5f, -1.0f);
+  SDLTest_AssertPass("Call to SDL_SetAudioDeviceVoiceGain(id, voice1, 0.5, -1.0)");
+  SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+
+  SDL_AudioStreamPut(voice1, mono, frames * sizeof(Sint16));
+  SDL_AudioStreamPut(voice2, stereo2, frames * 2 * sizeof(float));
+  SDL_AudioStreamPut(voice3, stereo3, frames * 2 * sizeof(float));
+  SDL_UnlockAudioDevice(id);
+
+  SDL_PauseAudioDevice(id, 0);
+  SDLTest_AssertPass("Call to SDL_PauseAudioDevice(id, 0)");
+  for (i = 0; i < 200; ++i) {
+    SDL_LockAudioDevice(id);
+    available = SDL_AudioStreamAvailable(voice1) + SDL_AudioStreamAvailable(voice2) + SDL_AudioStreamAvailable(voice3);
+    SDL_UnlockAudioDevice(id);
+    if (available == 0) {
+      break;
+    }
+    SDL_Delay(10);
+  }
+  SDLTest_AssertCheck(available == 0, "Validate voices were drained; %i bytes left", available);
+
+  /* Negative cases */
+  ret = SDL_SetAudioDeviceVoiceGain(id, voice1, -1.0f, 0.0f);
+  SDLTest_AssertPass("Call to SDL_SetAudioDeviceVoiceGain(id, voice1, -1.0, 0.0)");
+  SDLTest_AssertCheck(ret == -1, "Verify result value; expected: -1, got: %i", ret);
+  ret = SDL_SetAudioDeviceVoiceGain(id, voice1, 1.0f, 2.0f);
+  SDLTest_AssertPass("Call to SDL_SetAudioDeviceVoiceGain(id, voice1, 1.0, 2.0)");
+  SDLTest_AssertCheck(ret == -1, "Verify result value; expected: -1, got: %i", ret);
+
+  SDL_RemoveAudioDeviceVoice(id, voice1);
+  SDLTest_AssertPass("Call to SDL_RemoveAudioDeviceVoice(id, voice1)");
+  ret = SDL_SetAudioDeviceVoiceGain(id, voice1, 1.0f, 0.0f);
+  SDLTest_AssertPass("Call to SDL_SetAudioDeviceVoiceGain(id, <removed voice>, 1.0, 0.0)");
+  SDLTest_AssertCheck(ret == -1, "Verify result value; expected: -1, got: %i", ret);
+
+  /* voice2 and voice3 are freed along with the device. */
+  SDL_CloseAudioDevice(id);
+  SDLTest_AssertPass("Call to SDL_CloseAudioDevice(id)");
+
+  /* Every frame is either silence or the clipped sum: (0.25 + 0.25 + 0.75, 0 - 0.5 + 0) */
+  rw = SDL_RWFromFile("sdlaudio.raw", "rb");
+  SDLTest_AssertCheck(rw != NULL, "Validate disk audio output file was opened");
+  if (rw != NULL) {
+    while (SDL_RWread(rw, frame, sizeof(frame), 1) == 1) {
+      if (frame[0] == 0 && frame[1] == 0) {
+        continue;
+      } else if (frame[0] == 32767 && frame[1] >= -16384 && frame[1] <= -16383) {
+        matched++;
+      } else {
+        unexpected++;
+      }
+    }
+    SDL_RWclose(rw);
+  }
+  SDLTest_AssertCheck(matched == frames, "Validate mixed frames; expected: %i, got: %i", frames, matched);
+  SDLTest_AssertCheck(unexpected == 0, "Validate no other frames; got: %i", unexpected);
+
+  SDL_free(mono);
+  SDL_free(stereo2);
+  SDL_free(stereo3);
+
+  SDL_QuitSubSystem( SDL_INIT_AUDIO );
+  SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+
+  /* Restart audio again */
+  _audioSetUp(NULL);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Queues audio while the device plays it, and checks it all arrives in order.
+ *
+ * \sa https://wiki.libsdl.org/SDL_QueueAudio
+ * \sa https://wiki.libsdl.org/SDL_GetQueuedAudioSize
+ */
+int audio_queueAudio()
+{
+  const int frames = 96000;  /* more than the queue's ring holds. */
+  const int chunk = 1000;
+  SDL_AudioSpec desired;
+  SDL_AudioDeviceID id;
+  Sint16 *samples;
+  Sint16 sample;
+  SDL_RWops *rw;
+  Uint32 queued = 0;
+  int expected = 0, unexpected = 0;
+  int i, ret;
+
+  /* Switch the running audio subsystem over to playing into a file */
+  ret = SDL_AudioInit("disk");
+  SDLTest_AssertPass("Call to SDL_AudioInit('disk')");
+  SDLTest_AssertCheck(ret == 0, "Validate result value; expected: 0 got: %d", ret);
+
+  SDL_memset(&desired, 0, sizeof(desired));
+  desired.freq = 48000;
+  desired.format = AUDIO_S16SYS;
+  desired.channels = 1;
+  desired.samples = 512;
+  id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+  SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, desired, NULL, 0)");
+  SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >=2, got: %i", id);
+
+  samples = (Sint16 *)SDL_malloc(frames * sizeof(Sint16));
+  if (id == 0 || samples == NULL) {
+    SDL_free(samples);
+    SDL_QuitSubSystem( SDL_INIT_AUDIO );
+    _audioSetUp(NULL);
+    return TEST_ABORTED;
+  }
+
+  /* never zero, so silence can be told apart. */
+  for (i = 0; i < frames; ++i) {
+    samples[i] = (Sint16)((i % 30000) + 1);
+  }
+
+  /* Queue half up front, and the rest while the device is playing. */
+  ret = SDL_QueueAudio(id, samples, (frames / 2) * sizeof(Sint16));
+  SDLTest_AssertPass("Call to SDL_QueueAudio(id, samples, %i)", (int) ((frames / 2) * sizeof(Sint16)));
+  SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+  queued = SDL_GetQueuedAudioSize(id);
+  SDLTest_AssertCheck(queued == (frames / 2) * sizeof(Sint16), "Verify queued size; expected: %i, got: %i", (int) ((frames / 2) * sizeof(Sint16)), (int) queued);
+
+  SDL_PauseAudioDevice(id, 0);
+  SDLTest_AssertPass("Call to SDL_PauseAudioDevice(id, 0)");
+  for (i = frames / 2; i < frames; i += chunk) {
+    ret = SDL_QueueAudio(id, samples + i, SDL_min(chunk, frames - i) * sizeof(Sint16));
+    if (ret != 0) {
+      break;
+    }
+  }
+  SDLTest_AssertCheck(ret == 0, "Verify SDL_QueueAudio while playing; expected: 0, got: %i", ret);
+
+  for (i = 0; i < 400; ++i) {
+    queued = SDL_GetQueuedAudioSize(id);
+    if (queued == 0) {
+      break;
+    }
+    SDL_Delay(10);
+  }
+  SDLTest_AssertCheck(queued == 0, "Validate queue was drained; %i bytes left", (int) queued);
+
+  SDL_CloseAudioDevice(id);
+  SDLTest_AssertPass("Call to SDL_CloseAudioDevice(id)");
+
+  /* Everything but silence should be the queued samples, in order. */
+  rw = SDL_RWFromFile("sdlaudio.raw", "rb");
+  SDLTest_AssertCheck(rw != NULL, "Validate disk audio output file was opened");
+  if (rw != NULL) {
+    while (SDL_RWread(rw, &sample, sizeof(sample), 1) == 1) {
+      if (sample == 0) {
+        continue;
+      } else if (expected < frames && sample == samples[expected]) {
+        expected++;
+      } else {
+        unexpected++;
+      }
+    }
+    SDL_RWclose(rw);
+  }
+  SDLTest_AssertCheck(expected == frames, "Validate queued samples; expected: %i, got: %i", frames, expected);
+  SDLTest_AssertCheck(unexpected == 0, "Validate no other samples; got: %i", unexpected);
+
+  SDL_free(samples);
+
+  SDL_QuitSubSystem( SDL_INIT_AUDIO );
+  SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+
+  /* Restart audio again */
+  _audioSetUp(NULL);
+
+  return TEST_COMPLETED;
+}
+
+/* Counter for the ramp written by _audio_rampCallback */
+static int _audio_rampNext;
+
+/* Writes an ascending ramp that never hits zero, so silence can be told apart. */
+static void SDLCALL
+_audio_rampCallback(void *userdata, Uint8 *stream, int len)
+{
+  Sint16 *samples = (Sint16 *)stream;
+  int i;
+
+  for (i = 0; i < len / (int)sizeof(Sint16); ++i) {
+    samples[i] = (Sint16)((_audio_rampNext % 30000) + 1);
+    _audio_rampNext++;
+  }
+}
+
+/**
+ * \brief Plays into a device whose buffer size differs from the callback's, and compares the output with an audio stream.
+ *
+ * The device is filled straight from the callback without an SDL_AudioStream,
+ * so this checks that it comes out the same as re-chunking through a stream.
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenAudioDevice
+ */
+int audio_rebufferDevice()
+{
+  const int frames = 9600;
+  const int callbackSamples = 300;
+  const char *deviceSamples[] = { "256", "700", "2048" };
+  SDL_AudioSpec desired, obtained;
+  SDL_AudioDeviceID id;
+  SDL_AudioStream *stream;
+  Sint16 *reference, *output;
+  Sint16 sample;
+  SDL_RWops *rw;
+  Sint64 size;
+  int i, j, ret, got, mismatches;
+
+  reference = (Sint16 *)SDL_malloc(frames * sizeof(Sint16));
+  output = (Sint16 *)SDL_malloc(frames * sizeof(Sint16));
+  if (reference == NULL || output == NULL) {
+    SDL_free(reference);
+    SDL_free(output);
+    return TEST_ABORTED;
+  }
+
+  for (i = 0; i < SDL_arraysize(deviceSamples); i++) {
+    const int deviceSize = SDL_atoi(deviceSamples[i]) * sizeof(Sint16);
+
+    /* The converting path: callback buffers go through a stream and come out in device sized pieces */
+    stream = SDL_NewAudioStream(AUDIO_S16SYS, 1, 48000, AUDIO_S16SYS, 1, 48000);
+    SDLTest_AssertCheck(stream != NULL, "Validate stream is not NULL");
+    if (stream == NULL) {
+      break;
+    }
+    _audio_rampNext = 0;
+    got = 0;
+    while (got < frames * (int)sizeof(Sint16)) {
+      Uint8 chunk[2048 * sizeof(Sint16)];
+      _audio_rampCallback(NULL, chunk, callbackSamples * sizeof(Sint16));
+      SDL_AudioStreamPut(stream, chunk, callbackSamples * sizeof(Sint16));
+      while (got < frames * (int)sizeof(Sint16) && SDL_AudioStreamAvailable(stream) >= deviceSize) {
+        ret = SDL_AudioStreamGet(stream, chunk, deviceSize);
+        ret = SDL_min(ret, frames * (int)sizeof(Sint16) - got);
+        SDL_memcpy((Uint8 *)reference + got, chunk, ret);
+        got += ret;
+      }
+    }
+    SDL_FreeAudioStream(stream);
+
+    /* The direct path: a disk device with a fixed buffer size */
+    SDL_setenv("SDL_DISKAUDIOSAMPLES", deviceSamples[i], 1);
+    ret = SDL_AudioInit("disk");
+    SDLTest_AssertPass("Call to SDL_AudioInit('disk') with %s sample device buffers", deviceSamples[i]);
+    SDLTest_AssertCheck(ret == 0, "Validate result value; expected: 0 got: %d", ret);
+
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 48000;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 1;
+    desired.samples = callbackSamples;
+    desired.callback = _audio_rampCallback;
+    _audio_rampNext = 0;
+    id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, desired, obtained, 0)");
+    SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >=2, got: %i", id);
+    SDLTest_AssertCheck(obtained.samples == callbackSamples, "Validate obtained samples; expected: %i, got: %i", callbackSamples, obtained.samples);
+    if (id == 0) {
+      SDL_setenv("SDL_DISKAUDIOSAMPLES", "", 1);
+      break;
+    }
+
+    SDL_PauseAudioDevice(id, 0);
+    SDLTest_AssertPass("Call to SDL_PauseAudioDevice(id, 0)");
+    for (j = 0; j < 400; ++j) {
+      SDL_LockAudioDevice(id);
+      ret = _audio_rampNext;
+      SDL_UnlockAudioDevice(id);
+      if (ret >= frames + SDL_atoi(deviceSamples[i])) {
+        break;
+      }
+      SDL_Delay(10);
+    }
+    SDL_CloseAudioDevice(id);
+    SDLTest_AssertPass("Call to SDL_CloseAudioDevice(id)");
+    SDL_setenv("SDL_DISKAUDIOSAMPLES", "", 1);
+
+    /* Whole device buffers are written, with the ramp right after the silence from before unpausing */
+    got = 0;
+    rw = SDL_RWFromFile("sdlaudio.raw", "rb");
+    SDLTest_AssertCheck(rw != NULL, "Validate disk audio output file was opened");
+    if (rw != NULL) {
+      size = SDL_RWsize(rw);
+      SDLTest_AssertCheck(size > 0 && (size % deviceSize) == 0, "Validate output is whole device buffers; %i bytes", (int) size);
+      while (got < frames && SDL_RWread(rw, &sample, sizeof(sample), 1) == 1) {
+        if (got > 0 || sample != 0) {
+          output[got++] = sample;
+        }
+      }
+      SDL_RWclose(rw);
+    }
+    SDLTest_AssertCheck(got == frames, "Validate played samples; expected: %i, got: %i", frames, got);
+
+    mismatches = 0;
+    for (j = 0; j < got; ++j) {
+      if (output[j] != reference[j]) {
+        mismatches++;
+      }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Validate output matches the audio stream; %i samples differ", mismatches);
+  }
+
+  SDL_free(reference);
+  SDL_free(output);
+
+  SDL_QuitSubSystem( SDL_INIT_AUDIO );
+  SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+
+  /* Restart audio again */
+  _audioSetUp(NULL);
+
+  return TEST_COMPLETED;
+}
+
+/* Writes a little-endian value into a WAVE header */
+static void
+_audio_putLE(Uint8 *dst, Uint32 value, int bytes)
+{
+  int i;
+  for (i = 0; i < bytes; ++i) {
+    dst[i] = (Uint8)(value >> (i * 8));
+  }
+}
+
+/* A source that can't tell its size, so truncation is only found while reading */
+static Sint64 SDLCALL
+_audio_unsizedSize(SDL_RWops *context)
+{
+  return -1;
+}
+
+static Sint64 SDLCALL
+_audio_unsizedSeek(SDL_RWops *context, Sint64 offset, int whence)
+{
+  return SDL_RWseek((SDL_RWops *)context->hidden.unknown.data1, offset, whence);
+}
+
+static size_t SDLCALL
+_audio_unsizedRead(SDL_RWops *context, void *ptr, size_t size, size_t maxnum)
+{
+  return SDL_RWread((SDL_RWops *)context->hidden.unknown.data1, ptr, size, maxnum);
+}
+
+static int SDLCALL
+_audio_unsizedClose(SDL_RWops *context)
+{
+  SDL_RWclose((SDL_RWops *)context->hidden.unknown.data1);
+  SDL_FreeRW(context);
+  return 0;
+}
+
+static SDL_RWops *
+_audio_unsizedRW(const void *mem, int size)
+{
+  SDL_RWops *rw = SDL_AllocRW();
+  if (rw != NULL) {
+    rw->size = _audio_unsizedSize;
+    rw->seek = _audio_unsizedSeek;
+    rw->read = _audio_unsizedRead;
+    rw->write = NULL;
+    rw->close = _audio_unsizedClose;
+    rw->type = SDL_RWOPS_UNKNOWN;
+    rw->hidden.unknown.data1 = SDL_RWFromConstMem(mem, size);
+  }
+  return rw;
+}
+
+/**
+ * \brief Stream an IMA ADPCM file and compare it with SDL_LoadWAV_RW
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenWAVStream_RW
+ * \sa https://wiki.libsdl.org/SDL_WAVStreamRead
+ */
+int audio_wavStream()
+{
+  const int blocks = 40;
+  const int blockalign = 256;
+  const int spb = (256 - 8) * 8 / (4 * 2) + 1;  /* 4-bit stereo after the 8-byte header */
+  const Uint32 datalen = blocks * blockalign + 100;  /* with a truncated last block */
+  const char *truncationHints[] = { "dropblock", "dropframe", "strict" };
+  Uint8 *wav, *loaded = NULL, *streamed;
+  Uint32 loadedlen = 0, wavlen = 48 + datalen;
+  SDL_AudioSpec loadedspec, streamspec;
+  SDL_WAVStream *stream;
+  Sint64 length, pos;
+  int i, ret, chunk, total = 0;
+
+  wav = (Uint8 *)SDL_malloc(wavlen);
+  streamed = (Uint8 *)SDL_malloc(blocks * spb * 4);
+  if (wav == NULL || streamed == NULL) {
+    SDL_free(wav);
+    SDL_free(streamed);
+    return TEST_ABORTED;
+  }
+
+  SDL_memcpy(wav, "RIFF", 4);
+  _audio_putLE(wav + 4, wavlen - 8, 4);
+  SDL_memcpy(wav + 8, "WAVEfmt ", 8);
+  _audio_putLE(wav + 16, 20, 4);
+  _audio_putLE(wav + 20, 0x11, 2);    /* IMA ADPCM */
+  _audio_putLE(wav + 22, 2, 2);
+  _audio_putLE(wav + 24, 22050, 4);
+  _audio_putLE(wav + 28, 22050 * blockalign / spb, 4);
+  _audio_putLE(wav + 32, blockalign, 2);
+  _audio_putLE(wav + 34, 4, 2);
+  _audio_putLE(wav + 36, 2, 2);
+  _audio_putLE(wav + 38, spb, 2);
+  SDL_memcpy(wav + 40, "data", 4);
+  _audio_putLE(wav + 44, datalen, 4);
+  for (i = 0; i < (int)datalen; ++i) {
+    wav[48 + i] = SDLTest_RandomUint8();
+  }
+  /* Valid step indices in the block headers */
+  for (i = 0; i <= blocks; ++i) {
+    wav[48 + i * blockalign + 2] %= 89;
+    wav[48 + i * blockalign + 3] = 0;
+    wav[48 + i * blockalign + 6] %= 89;
+    wav[48 + i * blockalign + 7] = 0;
+  }
+
+  SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, wavlen), 1, &loadedspec, &loaded, &loadedlen);
+  SDLTest_AssertPass("Call to SDL_LoadWAV_RW()");
+  SDLTest_AssertCheck(loaded != NULL, "Validate loaded data; expected: non-NULL, got: %p", (void *)loaded);
+
+  stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, wavlen), 1, &streamspec);
+  SDLTest_AssertPass("Call to SDL_OpenWAVStream_RW()");
+  SDLTest_AssertCheck(stream != NULL, "Validate stream; expected: non-NULL, got: %p", (void *)stream);
+  if (loaded == NULL || stream == NULL) {
+    SDL_CloseWAVStream(stream);
+    SDL_FreeWAV(loaded);
+    SDL_free(streamed);
+    SDL_free(wav);
+    return TEST_ABORTED;
+  }
+
+  SDLTest_AssertCheck(streamspec.format == loadedspec.format && streamspec.channels == loadedspec.channels && streamspec.freq == loadedspec.freq,
+                      "Validate stream spec matches loaded spec");
+  length = SDL_WAVStreamLength(stream);
+  SDLTest_AssertCheck(length * 4 == loadedlen, "Validate stream length; expected: %i, got: %i", (int)(loadedlen / 4), (int)length);
+
+  /* Read in odd sizes that cross block boundaries */
+  chunk = 1;
+  while ((ret = SDL_WAVStreamRead(stream, streamed + total * 4, chunk)) > 0) {
+    total += ret;
+    chunk = (chunk * 7 + 3) % 500 + 1;
+  }
+  SDLTest_AssertCheck(ret == 0, "Validate end of stream; expected: 0, got: %i", ret);
+  SDLTest_AssertCheck(total * 4 == loadedlen, "Validate streamed frames; expected: %i, got: %i", (int)(loadedlen / 4), total);
+  SDLTest_AssertCheck(SDL_memcmp(streamed, loaded, SDL_min((Uint32)total * 4, loadedlen)) == 0, "Validate streamed data matches loaded data");
+
+  /* Seek backwards into the middle of a block */
+  pos = spb * 3 + 17;
+  ret = SDL_WAVStreamSeek(stream, pos);
+  SDLTest_AssertPass("Call to SDL_WAVStreamSeek(stream, %i)", (int)pos);
+  SDLTest_AssertCheck(ret == 0, "Validate result value; expected: 0, got: %i", ret);
+  ret = SDL_WAVStreamRead(stream, streamed, 300);
+  SDLTest_AssertCheck(ret == 300, "Validate result value; expected: 300, got: %i", ret);
+  SDLTest_AssertCheck(SDL_WAVStreamTell(stream) == pos + 300, "Validate position; expected: %i, got: %i", (int)pos + 300, (int)SDL_WAVStreamTell(stream));
+  SDLTest_AssertCheck(SDL_memcmp(streamed, loaded + pos * 4, 300 * 4) == 0, "Validate data after seek matches loaded data");
+
+  SDL_CloseWAVStream(stream);
+  SDLTest_AssertPass("Call to SDL_CloseWAVStream()");
+
+  ret = SDL_WAVStreamRead(NULL, streamed, 1);
+  SDLTest_AssertCheck(ret == -1, "Validate result value for NULL stream; expected: -1, got: %i", ret);
+
+  SDL_FreeWAV(loaded);
+
+  /* A file cut off in the middle of a block, with whole blocks in the header */
+  _audio_putLE(wav + 4, 40 + blocks * blockalign, 4);
+  _audio_putLE(wav + 44, blocks * blockalign, 4);
+  wavlen = 48 + blocks / 2 * blockalign + 37;
+  for (i = 0; i < (int)SDL_arraysize(truncationHints); ++i) {
+    const SDL_bool strict = (SDL_strcmp(truncationHints[i], "strict") == 0);
+
+    SDL_SetHint(SDL_HINT_WAVE_TRUNCATION, truncationHints[i]);
+    loaded = NULL;
+    SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, wavlen), 1, &loadedspec, &loaded, &loadedlen);
+    SDLTest_AssertPass("Call to SDL_LoadWAV_RW() with a truncated file and SDL_HINT_WAVE_TRUNCATION '%s'", truncationHints[i]);
+    SDLTest_AssertCheck(strict ? loaded == NULL : loaded != NULL, "Validate loaded data; expected: %s, got: %p", strict ? "NULL" : "non-NULL", (void *)loaded);
+
+    /* The size is unknown, so the truncation is found while reading */
+    stream = SDL_OpenWAVStream_RW(_audio_unsizedRW(wav, wavlen), 1, &streamspec);
+    SDLTest_AssertPass("Call to SDL_OpenWAVStream_RW() with a truncated file");
+    SDLTest_AssertCheck(stream != NULL, "Validate stream; expected: non-NULL, got: %p", (void *)stream);
+    total = 0;
+    ret = 0;
+    while (stream != NULL && (ret = SDL_WAVStreamRead(stream, streamed + total * 4, 500)) > 0) {
+      total += ret;
+    }
+    SDL_CloseWAVStream(stream);
+    if (strict) {
+      SDLTest_AssertCheck(ret == -1, "Validate read from a truncated file fails; expected: -1, got: %i", ret);
+    } else {
+      SDLTest_AssertCheck(ret == 0, "Validate end of stream; expected: 0, got: %i", ret);
+      SDLTest_AssertCheck(total * 4 == loadedlen, "Validate streamed frames; expected: %i, got: %i", (int)(loadedlen / 4), total);
+      if (loaded != NULL) {
+        SDLTest_AssertCheck(SDL_memcmp(streamed, loaded, SDL_min((Uint32)total * 4, loadedlen)) == 0, "Validate streamed data matches loaded data");
+      }
+    }
+    SDL_FreeWAV(loaded);
+  }
+  SDL_SetHint(SDL_HINT_WAVE_TRUNCATION, "");
+  SDL_free(streamed);
+  SDL_free(wav);
+
+  return TEST_COMPLETED;
+}
+
+/* Wraps IMA ADPCM blocks (4-bit stereo, 256 bytes each) in a WAVE file */
+static Uint8 *
+_audio_makeIMAWAV(const Uint8 *blocks, int numblocks, Uint32 *wavlen)
+{
+  const int blockalign = 256;
+  const int spb = (256 - 8) * 8 / (4 * 2) + 1;
+  const Uint32 datalen = numblocks * blockalign;
+  Uint8 *wav;
+
+  *wavlen = 48 + datalen;
+  wav = (Uint8 *)SDL_malloc(*wavlen);
+  if (wav == NULL) {
+    return NULL;
+  }
+  SDL_memcpy(wav, "RIFF", 4);
+  _audio_putLE(wav + 4, *wavlen - 8, 4);
+  SDL_memcpy(wav + 8, "WAVEfmt ", 8);
+  _audio_putLE(wav + 16, 20, 4);
+  _audio_putLE(wav + 20, 0x11, 2);    /* IMA ADPCM */
+  _audio_putLE(wav + 22, 2, 2);
+  _audio_putLE(wav + 24, 22050, 4);
+  _audio_putLE(wav + 28, 22050 * blockalign / spb, 4);
+  _audio_putLE(wav + 32, blockalign, 2);
+  _audio_putLE(wav + 34, 4, 2);
+  _audio_putLE(wav + 36, 2, 2);
+  _audio_putLE(wav + 38, spb, 2);
+  SDL_memcpy(wav + 40, "data", 4);
+  _audio_putLE(wav + 44, datalen, 4);
+  SDL_memcpy(wav + 48, blocks, datalen);
+  return wav;
+}
+
+/**
+ * \brief Loads an IMA ADPCM file big enough to be decoded on several threads, and compares it with decoding it in small pieces
+ *
+ * \sa https://wiki.libsdl.org/SDL_LoadWAV_RW
+ */
+int audio_loadADPCMParallel()
+{
+  const int blocks = 2000;
+  const int piece = 100;  /* too few blocks to be worth splitting up */
+  const char *hint;
+  Uint8 *data, *wav, *loaded = NULL, *pieceloaded;
+  Uint32 wavlen, loadedlen = 0, piecelen, offset = 0;
+  SDL_AudioSpec spec;
+  int i, mismatches = 0;
+
+  data = (Uint8 *)SDL_malloc(blocks * 256);
+  if (data == NULL) {
+    return TEST_ABORTED;
+  }
+  for (i = 0; i < blocks * 256; ++i) {
+    data[i] = SDLTest_RandomUint8();
+  }
+  /* Valid step indices in the block headers */
+  for (i = 0; i < blocks; ++i) {
+    data[i * 256 + 2] %= 89;
+    data[i * 256 + 3] = 0;
+    data[i * 256 + 6] %= 89;
+    data[i * 256 + 7] = 0;
+  }
+
+  /* Make sure the task pool has workers, unless it was started already */
+  hint = SDL_GetHint(SDL_HINT_TASK_POOL_THREADS);
+  SDL_SetHint(SDL_HINT_TASK_POOL_THREADS, "3");
+  SDLTest_Log("Task pool has %i worker threads", SDL_GetTaskPoolThreadCount());
+  SDL_SetHint(SDL_HINT_TASK_POOL_THREADS, hint);
+
+  wav = _audio_makeIMAWAV(data, blocks, &wavlen);
+  if (wav != NULL) {
+    SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, wavlen), 1, &spec, &loaded, &loadedlen);
+    SDLTest_AssertPass("Call to SDL_LoadWAV_RW() with %i blocks", blocks);
+    SDL_free(wav);
+  }
+  SDLTest_AssertCheck(loaded != NULL, "Validate loaded data; expected: non-NULL, got: %p", (void *)loaded);
+  if (loaded == NULL) {
+    SDL_free(data);
+    return TEST_ABORTED;
+  }
+
+  /* Every block starts from its own header, so the pieces have to add up to the same samples */
+  for (i = 0; i < blocks; i += piece) {
+    pieceloaded = NULL;
+    wav = _audio_makeIMAWAV(data + i * 256, piece, &wavlen);
+    if (wav != NULL) {
+      SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, wavlen), 1, &spec, &pieceloaded, &piecelen);
+      SDL_free(wav);
+    }
+    if (pieceloaded == NULL || offset + piecelen > loadedlen) {
+      SDL_FreeWAV(pieceloaded);
+      mismatches++;
+      break;
+    }
+    if (SDL_memcmp(loaded + offset, pieceloaded, piecelen) != 0) {
+      mismatches++;
+    }
+    offset += piecelen;
+    SDL_FreeWAV(pieceloaded);
+  }
+  SDLTest_AssertCheck(mismatches == 0, "Validate pieces match the whole file; %i pieces differ", mismatches);
+  SDLTest_AssertCheck(offset == loadedlen, "Validate decoded length; expected: %i, got: %i", (int)loadedlen, (int)offset);
+
+  SDL_FreeWAV(loaded);
+  SDL_free(data);
+
+  return TEST_COMPLETED;
+}
+
+/* Reference A-law expansion, one sample at a time */
+static Sint16
+_audio_expandALaw(Uint8 code)
+{
+  Uint8 exponent = (code & 0x7f) ^ 0x55;
+  Sint16 mantissa = exponent & 0xf;
+
+  exponent >>= 4;
+  if (exponent > 0) {
+    mantissa |= 0x10;
+  }
+  mantissa = (mantissa << 4) | 0x8;
+  if (exponent > 1) {
+    mantissa <<= exponent - 1;
+  }
+  return code & 0x80 ? mantissa : -mantissa;
+}
+
+/* Reference mu-law expansion, one sample at a time */
+static Sint16
+_audio_expandMuLaw(Uint8 code)
+{
+  Uint8 nibble = ~code;
+  Sint16 mantissa = nibble & 0xf;
+  Uint8 exponent = (nibble >> 4) & 0x7;
+  Sint16 step = 4 << (exponent + 1);
+
+  mantissa = (0x80 << exponent) + step * mantissa + step / 2 - 132;
+  return nibble & 0x80 ? -mantissa : mantissa;
+}
+
+/**
+ * \brief Loads A-law and mu-law files with every code and compares them with expanding one sample at a time
+ *
+ * \sa https://wiki.libsdl.org/SDL_LoadWAV_RW
+ */
+int audio_loadLawWAV()
+{
+  const Uint16 encodings[] = { 0x0006, 0x0007 };  /* A-law, mu-law */
+  const Uint32 datalen = 256 * 9 + 5;  /* odd length, for the SIMD tails */
+  Uint8 wav[46 + 256 * 9 + 5];
+  Uint8 *loaded;
+  Uint32 loadedlen, i;
+  SDL_AudioSpec spec;
+  int e, mismatches;
+
+  for (e = 0; e < SDL_arraysize(encodings); ++e) {
+    SDL_memcpy(wav, "RIFF", 4);
+    _audio_putLE(wav + 4, sizeof(wav) - 8, 4);
+    SDL_memcpy(wav + 8, "WAVEfmt ", 8);
+    _audio_putLE(wav + 16, 18, 4);
+    _audio_putLE(wav + 20, encodings[e], 2);
+    _audio_putLE(wav + 22, 1, 2);
+    _audio_putLE(wav + 24, 8000, 4);
+    _audio_putLE(wav + 28, 8000, 4);
+    _audio_putLE(wav + 32, 1, 2);
+    _audio_putLE(wav + 34, 8, 2);
+    _audio_putLE(wav + 36, 0, 2);
+    SDL_memcpy(wav + 38, "data", 4);
+    _audio_putLE(wav + 42, datalen, 4);
+    for (i = 0; i < datalen; ++i) {
+      wav[46 + i] = (Uint8)(i * 7);
+    }
+
+    loaded = NULL;
+    loadedlen = 0;
+    SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, sizeof(wav)), 1, &spec, &loaded, &loadedlen);
+    SDLTest_AssertPass("Call to SDL_LoadWAV_RW() with encoding 0x%04x", encodings[e]);
+    SDLTest_AssertCheck(loaded != NULL, "Validate loaded data; expected: non-NULL, got: %p", (void *)loaded);
+    if (loaded == NULL) {
+      continue;
+    }
+    SDLTest_AssertCheck(spec.format == AUDIO_S16SYS, "Validate format; expected: AUDIO_S16SYS, got: 0x%04x", spec.format);
+    SDLTest_AssertCheck(loadedlen == datalen * 2, "Validate length; expected: %i, got: %i", (int)(datalen * 2), (int)loadedlen);
+
+    mismatches = 0;
+    for (i = 0; i < loadedlen / 2 && i < datalen; ++i) {
+      const Uint8 code = wav[46 + i];
+      const Sint16 expected = encodings[e] == 0x0006 ? _audio_expandALaw(code) : _audio_expandMuLaw(code);
+      if (((Sint16 *)loaded)[i] != expected) {
+        mismatches++;
+      }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Validate expanded samples; %i samples differ", mismatches);
+    SDL_FreeWAV(loaded);
+  }
+
+  return TEST_COMPLETED;
+}
+
+/* The plain C mixing from SDL_MixAudioFormat(), to check the SIMD versions against */
+static void
+_audio_referenceMix(Uint8 *dst, const Uint8 *src, SDL_AudioFormat format, Uint32 len, int volume)
+{
+  Uint32 i;
+
+  if (volume == 0) {
+    return;  /* leaves dst alone, even where it's out of the mixing range */
+  }
+
+  switch (format) {
+    case AUDIO_U8:
+      for (i = 0; i < len; ++i) {
+        const int sample = dst[i] + ((((int) src[i] - 128) * volume) / SDL_MIX_MAXVOLUME);
+        dst[i] = (Uint8) ((sample < 0) ? 0 : ((sample > 0xFE) ? 0xFE : sample));
+      }
+      break;
+    case AUDIO_S8:
+      for (i = 0; i < len; ++i) {
+        const int sample = (Sint8) dst[i] + (((Sint8) src[i] * volume) / SDL_MIX_MAXVOLUME);
+        dst[i] = (Uint8) (Sint8) ((sample < -128) ? -128 : ((sample > 127) ? 127 : sample));
+      }
+      break;
+    case AUDIO_S16SYS:
+      for (i = 0; i < len / 2; ++i) {
+        const int sample = ((Sint16 *) dst)[i] + ((((const Sint16 *) src)[i] * volume) / SDL_MIX_MAXVOLUME);
+        ((Sint16 *) dst)[i] = (Sint16) ((sample < -32768) ? -32768 : ((sample > 32767) ? 32767 : sample));
+      }
+      break;
+    case AUDIO_S32SYS:
+      for (i = 0; i < len / 4; ++i) {
+        const Sint64 sample = ((Sint32 *) dst)[i] + ((((Sint64) ((const Sint32 *) src)[i]) * volume) / SDL_MIX_MAXVOLUME);
+        ((Sint32 *) dst)[i] = (Sint32) ((sample < SDL_MIN_SINT32) ? SDL_MIN_SINT32 : ((sample > SDL_MAX_SINT32) ? SDL_MAX_SINT32 : sample));
+      }
+      break;
+    case AUDIO_F32SYS:
+      for (i = 0; i < len / 4; ++i) {
+        const float scaled = (((const float *) src)[i] * (float) volume) * (1.0f / SDL_MIX_MAXVOLUME);
+        double sample = ((double) ((float *) dst)[i]) + ((double) scaled);
+        if (sample > 3.402823466e+38F) {
+          sample = 3.402823466e+38F;
+        } else if (sample < -3.402823466e+38F) {
+          sample = -3.402823466e+38F;
+        }
+        ((float *) dst)[i] = (float) sample;
+      }
+      break;
+  }
+}
+
+static void
+_audio_fillMixBuffer(Uint8 *buf, SDL_AudioFormat format, Uint32 len)
+{
+  Uint32 i;
+
+  if (format == AUDIO_F32SYS) {
+    for (i = 0; i < len / 4; ++i) {
+      /* mostly in range, some past full scale, and a few near FLT_MAX to check the clamping */
+      ((float *) buf)[i] = ((i % 97) == 0) ? SDLTest_RandomSint32() * 1e29f : SDLTest_RandomUnitFloat() * 3.0f - 1.5f;
+    }
+  } else {
+    for (i = 0; i < len; ++i) {
+      /* bias toward the extremes so the saturation gets exercised */
+      buf[i] = ((i % 5) == 0) ? (Uint8) ((i & 8) ? 0x80 : 0x7F) : SDLTest_RandomUint8();
+    }
+  }
+}
+
+static const SDL_AudioFormat _audio_mixFormats[] = { AUDIO_U8, AUDIO_S8, AUDIO_S16SYS, AUDIO_S32SYS, AUDIO_F32SYS };
+static const char *_audio_mixFormatNames[] = { "AUDIO_U8", "AUDIO_S8", "AUDIO_S16SYS", "AUDIO_S32SYS", "AUDIO_F32SYS" };
+
+/**
+ * \brief Checks that SDL_MixAudioFormat gives the same bits as plain C mixing, at every volume and alignment.
+ *
+ * \sa https://wiki.libsdl.org/SDL_MixAudioFormat
+ */
+int audio_mixAudioFormatExact()
+{
+  const Uint32 maxlen = 4096 + 64;
+  Uint8 *src = (Uint8 *)SDL_malloc(maxlen + 4);
+  Uint8 *dst = (Uint8 *)SDL_malloc(maxlen + 4);
+  Uint8 *expected = (Uint8 *)SDL_malloc(maxlen + 4);
+  const int volumes[] = { 0, 1, 37, 64, 100, 127, SDL_MIX_MAXVOLUME };
+  int f, v, mismatches;
+
+  SDLTest_AssertCheck(src != NULL && dst != NULL && expected != NULL, "Expected buffers to be created.");
+  if (src == NULL || dst == NULL || expected == NULL) {
+    SDL_free(src);
+    SDL_free(dst);
+    SDL_free(expected);
+    return TEST_ABORTED;
+  }
+
+  for (f = 0; f < (int) SDL_arraysize(_audio_mixFormats); ++f) {
+    const SDL_AudioFormat format = _audio_mixFormats[f];
+    const Uint32 samplesize = SDL_AUDIO_BITSIZE(format) / 8;
+
+    mismatches = 0;
+    for (v = 0; v < (int) SDL_arraysize(volumes); ++v) {
+      Uint32 offset;
+      for (offset = 0; offset < 4; offset += samplesize) {
+        /* a length that leaves a tail after any vector width */
+        const Uint32 len = (((4096 + 37) / samplesize) * samplesize) - offset;
+        _audio_fillMixBuffer(src + offset, format, len);
+        _audio_fillMixBuffer(dst + offset, format, len);
+        SDL_memcpy(expected, dst + offset, len);
+
+        SDL_MixAudioFormat(dst + offset, src + offset, format, len, volumes[v]);
+        _audio_referenceMix(expected, src + offset, format, len, volumes[v]);
+        if (SDL_memcmp(dst + offset, expected, len) != 0) {
+          mismatches++;
+        }
+      }
+    }
+    SDLTest_AssertPass("Call to SDL_MixAudioFormat(dst, src, %s, ...) at %i volumes", _audio_mixFormatNames[f], (int) SDL_arraysize(volumes));
+    SDLTest_AssertCheck(mismatches == 0, "Validate %s mixing matches plain C mixing; mismatched runs: %i", _audio_mixFormatNames[f], mismatches);
+  }
+
+  SDL_free(src);
+  SDL_free(dst);
+  SDL_free(expected);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Times SDL_MixAudioFormat against plain C mixing for each format.
+ *
+ * \sa https://wiki.libsdl.org/SDL_MixAudioFormat
+ */
+int audio_mixAudioFormatSpeed()
+{
+  const Uint32 len = 64 * 1024;
+  const int iterations = 64;
+  Uint8 *src = (Uint8 *)SDL_malloc(len);
+  Uint8 *dst = (Uint8 *)SDL_malloc(len);
+  const double freq = (double) SDL_GetPerformanceFrequency();
+  int f, i;
+
+  SDLTest_AssertCheck(src != NULL && dst != NULL, "Expected buffers to be created.");
+  if (src == NULL || dst == NULL) {
+    SDL_free(src);
+    SDL_free(dst);
+    return TEST_ABORTED;
+  }
+
+  for (f = 0; f < (int) SDL_arraysize(_audio_mixFormats); ++f) {
+    const SDL_AudioFormat format = _audio_mixFormats[f];
+    Uint64 start, mixtime, reftime;
+
+    _audio_fillMixBuffer(src, format, len);
+    _audio_fillMixBuffer(dst, format, len);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+      SDL_MixAudioFormat(dst, src, format, len, 100);
+    }
+    mixtime = SDL_GetPerformanceCounter() - start;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+      _audio_referenceMix(dst, src, format, len, 100);
+    }
+    reftime = SDL_GetPerformanceCounter() - start;
+
+    SDLTest_Log("%s: SDL_MixAudioFormat %.1f MB/s, plain C %.1f MB/s",
+                _audio_mixFormatNames[f],
+                (len * (double) iterations) / (1024.0 * 1024.0) / ((mixtime ? mixtime : 1) / freq),
+                (len * (double) iterations) / (1024.0 * 1024.0) / ((reftime ? reftime : 1) / freq));
+    SDLTest_AssertPass("Timed SDL_MixAudioFormat(dst, src, %s, %u, 100) x %i", _audio_mixFormatNames[f], (unsigned int) len, iterations);
+  }
+
+  SDL_free(src);
+  SDL_free(dst);
+
+  return TEST_COMPLETED;
+}
 
 
 /* ================= Test Case References ================== */
@@ -1022,11 +2270,46 @@ static const SDLTest_TestCaseReference audioTest14 =
 static const SDLTest_TestCaseReference audioTest15 =
         { (SDLTest_TestCaseFp)audio_pauseUnpauseAudio, "audio_pauseUnpauseAudio", "Pause and Unpause audio for various audio specs while testing callback.", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference audioTest16 =
+        { (SDLTest_TestCaseFp)audio_resampleLoss, "audio_resampleLoss", "Check signal-to-noise ratio and maximum error of audio resampling.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest17 =
+        { (SDLTest_TestCaseFp)audio_resampleQuality, "audio_resampleQuality", "Resample through audio streams at each resampling quality.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest18 =
+        { (SDLTest_TestCaseFp)audio_mixVoices, "audio_mixVoices", "Mix several voices with gain and pan into one device.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest19 =
+        { (SDLTest_TestCaseFp)audio_mixAudioFormatExact, "audio_mixAudioFormatExact", "Compare SDL_MixAudioFormat bit for bit with plain C mixing.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest20 =
+        { (SDLTest_TestCaseFp)audio_mixAudioFormatSpeed, "audio_mixAudioFormatSpeed", "Time SDL_MixAudioFormat against plain C mixing.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest21 =
+        { (SDLTest_TestCaseFp)audio_channelMatrix, "audio_channelMatrix", "Convert channels through default and custom mixing matrices.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest22 =
+        { (SDLTest_TestCaseFp)audio_queueAudio, "audio_queueAudio", "Queue audio while the device plays it.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest23 =
+        { (SDLTest_TestCaseFp)audio_wavStream, "audio_wavStream", "Stream a WAVE file and compare it with SDL_LoadWAV_RW.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest24 =
+        { (SDLTest_TestCaseFp)audio_rebufferDevice, "audio_rebufferDevice", "Fill device buffers of another size straight from the callback.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest25 =
+        { (SDLTest_TestCaseFp)audio_loadADPCMParallel, "audio_loadADPCMParallel", "Load a big IMA ADPCM file and compare it with loading it in pieces.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest26 =
+        { (SDLTest_TestCaseFp)audio_loadLawWAV, "audio_loadLawWAV", "Load A-law and mu-law files and compare them with scalar expansion.", TEST_ENABLED };
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] =  {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
-    &audioTest12, &audioTest13, &audioTest14, &audioTest15, NULL
+    &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16,
+    &audioTest17, &audioTest18, &audioTest19, &audioTest20, &audioTest21, &audioTest22,
+    &audioTest23, &audioTest24, &audioTest25, &audioTest26, NULL
 };
 
 /* Audio test suite (global) */
@@ -174,6 +174,205 @@ events_addDelEventWatchWithUserdata(void *arg)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Polls several events at once, merging consecutive motion events
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PollEvents
+ */
+int
+events_pollEventsCoalesceMotion(void *arg)
+{
+   SDL_Event event;
+   SDL_Event events[8];
+   int i, result;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   /* Three motion events for one mouse, then a user event, then one more motion */
+   for (i = 0; i < 4; ++i) {
+      SDL_zero(event);
+      event.type = SDL_MOUSEMOTION;
+      event.motion.windowID = 1;
+      event.motion.x = 10 * (i + 1);
+      event.motion.y = 20 * (i + 1);
+      event.motion.xrel = 10;
+      event.motion.yrel = 20;
+      if (i == 3) {
+         SDL_Event user;
+         SDL_zero(user);
+         user.type = SDL_USEREVENT;
+         SDL_PushEvent(&user);
+      }
+      SDL_PushEvent(&event);
+   }
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+
+   result = SDL_PollEvents(events, SDL_arraysize(events), SDL_POLLEVENTS_COALESCE_MOTION);
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == 3, "Check result from SDL_PollEvents, expected: 3, got: %d", result);
+   if (result == 3) {
+      SDLTest_AssertCheck(events[0].type == SDL_MOUSEMOTION, "Check first event type, expected: SDL_MOUSEMOTION, got: 0x%x", events[0].type);
+      SDLTest_AssertCheck(events[0].motion.x == 30 && events[0].motion.y == 60, "Check merged position, expected: 30,60, got: %d,%d", events[0].motion.x, events[0].motion.y);
+      SDLTest_AssertCheck(events[0].motion.xrel == 30 && events[0].motion.yrel == 60, "Check merged motion, expected: 30,60, got: %d,%d", events[0].motion.xrel, events[0].motion.yrel);
+      SDLTest_AssertCheck(events[1].type == SDL_USEREVENT, "Check second event type, expected: SDL_USEREVENT, got: 0x%x", events[1].type);
+      SDLTest_AssertCheck(events[2].type == SDL_MOUSEMOTION, "Check third event type, expected: SDL_MOUSEMOTION, got: 0x%x", events[2].type);
+   }
+
+   result = SDL_PollEvents(events, SDL_arraysize(events), 0);
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_PollEvents on empty queue, expected: 0, got: %d", result);
+
+   return TEST_COMPLETED;
+}
+/**
+ * @brief Moves the mouse several times with motion event coalescing on and off,
+ * and checks that the motion events are merged into one only when it's on.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_HINT_MOTION_EVENT_COALESCING
+ */
+int
+events_coalesceMotionHint(void *arg)
+{
+   SDL_Window *window;
+   SDL_Event events[8];
+   const char *hints[2] = { "1", "0" };
+   int i, j, result;
+
+   window = SDL_CreateWindow("events_coalesceMotionHint", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 320, 200, 0);
+   SDLTest_AssertPass("Call to SDL_CreateWindow()");
+   SDLTest_AssertCheck(window != NULL, "Check SDL_CreateWindow() result, expected: non-NULL, got: %s", (window != NULL) ? "non-NULL" : "NULL");
+   if (window == NULL) {
+      return TEST_ABORTED;
+   }
+
+   for (i = 0; i < SDL_arraysize(hints); ++i) {
+      SDL_WarpMouseInWindow(window, 10, 10);
+      SDLTest_AssertPass("Call to SDL_WarpMouseInWindow()");
+
+      /* The hint is applied by the next SDL_PumpEvents() */
+      SDL_SetHint(SDL_HINT_MOTION_EVENT_COALESCING, hints[i]);
+      SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_MOTION_EVENT_COALESCING, \"%s\")", hints[i]);
+      SDL_PumpEvents();
+      SDLTest_AssertPass("Call to SDL_PumpEvents()");
+      SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+      SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+      for (j = 1; j <= 3; ++j) {
+         SDL_WarpMouseInWindow(window, 10 + 20 * j, 10 + 10 * j);
+      }
+      SDLTest_AssertPass("Call to SDL_WarpMouseInWindow()");
+
+      result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_MOUSEMOTION, SDL_MOUSEMOTION);
+      SDLTest_AssertPass("Call to SDL_PeepEvents()");
+      if (i == 0) {
+         SDLTest_AssertCheck(result == 1, "Check result from SDL_PeepEvents, expected: 1, got: %d", result);
+         if (result == 1) {
+            SDLTest_AssertCheck(events[0].motion.x == 70 && events[0].motion.y == 40, "Check merged position, expected: 70,40, got: %d,%d", events[0].motion.x, events[0].motion.y);
+            SDLTest_AssertCheck(events[0].motion.xrel == 60 && events[0].motion.yrel == 30, "Check merged motion, expected: 60,30, got: %d,%d", events[0].motion.xrel, events[0].motion.yrel);
+         }
+      } else {
+         SDLTest_AssertCheck(result == 3, "Check result from SDL_PeepEvents, expected: 3, got: %d", result);
+         for (j = 0; j < result; ++j) {
+            SDLTest_AssertCheck(events[j].motion.xrel == 20 && events[j].motion.yrel == 10, "Check motion, expected: 20,10, got: %d,%d", events[j].motion.xrel, events[j].motion.yrel);
+         }
+      }
+   }
+
+   SDL_DestroyWindow(window);
+   SDLTest_AssertPass("Call to SDL_DestroyWindow()");
+
+   return TEST_COMPLETED;
+}
+
+#define EVENTS_NUM_PRODUCERS        4
+#define EVENTS_EVENTS_PER_PRODUCER  4000
+
+/* Number of events each producer failed to push */
+static SDL_atomic_t _producerFailures;
+
+/* Thread that pushes numbered user events, the code is the producer index */
+static int SDLCALL _events_producer(void *data)
+{
+   SDL_Event event;
+   int i;
+
+   for (i = 0; i < EVENTS_EVENTS_PER_PRODUCER; ++i) {
+      SDL_zero(event);
+      event.type = SDL_USEREVENT;
+      event.user.code = (Sint32)(intptr_t)data;
+      event.user.data1 = (void *)(intptr_t)i;
+      if (SDL_PushEvent(&event) != 1) {
+         SDL_AtomicIncRef(&_producerFailures);
+      }
+   }
+   return 0;
+}
+
+/**
+ * @brief Pushes events from several threads while polling them, and checks that none
+ * are lost or reordered. Set SDL_EVENT_QUEUE_LOCKFREE=1 in the environment to test the
+ * lock-free ring, which overflows into the locked queue here.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PushEvent
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PeepEvents
+ */
+int
+events_pushFromThreadsAndPoll(void *arg)
+{
+   SDL_Thread *threads[EVENTS_NUM_PRODUCERS];
+   SDL_Event events[64];
+   int next[EVENTS_NUM_PRODUCERS];
+   const int total = EVENTS_NUM_PRODUCERS * EVENTS_EVENTS_PER_PRODUCER;
+   int i, result, received = 0, reordered = 0;
+   Uint32 expiration;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   SDL_AtomicSet(&_producerFailures, 0);
+   for (i = 0; i < EVENTS_NUM_PRODUCERS; ++i) {
+      next[i] = 0;
+      threads[i] = SDL_CreateThread(_events_producer, "Producer", (void *)(intptr_t)i);
+      SDLTest_AssertCheck(threads[i] != NULL, "Check SDL_CreateThread() result, expected: non-NULL, got: %s", (threads[i] != NULL) ? "non-NULL" : "NULL");
+   }
+   SDLTest_AssertPass("Call to SDL_CreateThread()");
+
+   /* Poll while the producers are running, a producer's events must arrive in order */
+   expiration = SDL_GetTicks() + 10000;
+   while (received < total && !SDL_TICKS_PASSED(SDL_GetTicks(), expiration)) {
+      result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+      if (result < 0) {
+         break;
+      }
+      for (i = 0; i < result; ++i) {
+         const int producer = events[i].user.code;
+         if (events[i].type != SDL_USEREVENT || producer < 0 || producer >= EVENTS_NUM_PRODUCERS) {
+            continue;
+         }
+         if ((int)(intptr_t)events[i].user.data1 != next[producer]) {
+            ++reordered;
+         }
+         next[producer] = (int)(intptr_t)events[i].user.data1 + 1;
+         ++received;
+      }
+      if (result == 0) {
+         SDL_Delay(0);
+      }
+   }
+   SDLTest_AssertPass("Call to SDL_PeepEvents()");
+
+   for (i = 0; i < EVENTS_NUM_PRODUCERS; ++i) {
+      SDL_WaitThread(threads[i], NULL);
+   }
+   SDLTest_AssertPass("Call to SDL_WaitThread()");
+
+   SDLTest_AssertCheck(SDL_AtomicGet(&_producerFailures) == 0, "Check failed pushes, expected: 0, got: %d", SDL_AtomicGet(&_producerFailures));
+   SDLTest_AssertCheck(received == total, "Check received events, expected: %d, got: %d", total, received);
+   SDLTest_AssertCheck(reordered == 0, "Check events received out of order, expected: 0, got: %d", reordered);
+
+   return TEST_COMPLETED;
+}
 
 /* ================= Test References ================== */
 
@@ -187,9 +386,18 @@ static const SDLTest_TestCaseReference eventsTest2 =
 static const SDLTest_TestCaseReference eventsTest3 =
         { (SDLTest_TestCaseFp)events_addDelEventWatchWithUserdata, "events_addDelEventWatchWithUserdata", "Adds and deletes an event watch function with userdata", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference eventsTest4 =
+        { (SDLTest_TestCaseFp)events_pollEventsCoalesceMotion, "events_pollEventsCoalesceMotion", "Polls several events at once, merging consecutive motion events", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest5 =
+        { (SDLTest_TestCaseFp)events_pushFromThreadsAndPoll, "events_pushFromThreadsAndPoll", "Pushes events from several threads while polling them, checking their order", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest6 =
+        { (SDLTest_TestCaseFp)events_coalesceMotionHint, "events_coalesceMotionHint", "Moves the mouse with motion event coalescing on and off", TEST_ENABLED };
+
 /* Sequence of Events test cases */
 static const SDLTest_TestCaseReference *eventsTests[] =  {
-    &eventsTest1, &eventsTest2, &eventsTest3, NULL
+    &eventsTest1, &eventsTest2, &eventsTest3, &eventsTest4, &eventsTest5, &eventsTest6, NULL
 };
 
 /* Events test suite (global) */
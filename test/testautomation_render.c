@@ -420,6 +420,435 @@ render_testBlit(void *arg)
 }
 
 
+/**
+ * @brief Tests the per-frame render queue counters.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderGetStats
+ */
+int
+render_testRenderStats(void *arg)
+{
+   int ret;
+   SDL_Surface *surface;
+   SDL_Renderer *statsRenderer;
+   SDL_Texture *texture;
+   SDL_RenderStats stats;
+   SDL_Rect rect;
+   Uint32 pixel = 0xFFFFFFFF;
+
+   /* Statistics are off unless requested. */
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderGetStats without hint, expected: -1, got: %i", ret);
+
+   surface = SDL_CreateRGBSurfaceWithFormat(0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 32, RENDER_COMPARE_FORMAT);
+   SDLTest_AssertCheck(surface != NULL, "Verify result from SDL_CreateRGBSurfaceWithFormat is not NULL");
+   if (surface == NULL) {
+       return TEST_ABORTED;
+   }
+
+   SDL_SetHint(SDL_HINT_RENDER_STATS, "1");
+   statsRenderer = SDL_CreateSoftwareRenderer(surface);
+   SDL_SetHint(SDL_HINT_RENDER_STATS, NULL);
+   SDLTest_AssertCheck(statsRenderer != NULL, "Verify result from SDL_CreateSoftwareRenderer is not NULL");
+   if (statsRenderer == NULL) {
+       SDL_FreeSurface(surface);
+       return TEST_ABORTED;
+   }
+
+   texture = SDL_CreateTexture(statsRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+   SDLTest_AssertCheck(texture != NULL, "Verify result from SDL_CreateTexture is not NULL");
+
+   rect.x = rect.y = 0;
+   rect.w = rect.h = 8;
+   SDL_RenderClear(statsRenderer);
+   SDL_RenderFillRect(statsRenderer, &rect);
+   SDL_RenderCopy(statsRenderer, texture, NULL, &rect);
+   /* If the queue still needs the texture, this must flush first. */
+   SDL_UpdateTexture(texture, NULL, &pixel, sizeof (pixel));
+   SDL_RenderCopy(statsRenderer, texture, NULL, &rect);
+   SDL_RenderPresent(statsRenderer);
+
+   ret = SDL_RenderGetStats(statsRenderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.clear_commands == 1, "Validate clear count, expected: 1, got: %u", (unsigned int) stats.clear_commands);
+   SDLTest_AssertCheck(stats.rect_commands == 1, "Validate fill rect count, expected: 1, got: %u", (unsigned int) stats.rect_commands);
+   SDLTest_AssertCheck(stats.copy_commands == 2, "Validate copy count, expected: 2, got: %u", (unsigned int) stats.copy_commands);
+   /* Software renderers created on a surface don't batch, so every draw is a flush of its own. */
+   SDLTest_AssertCheck(stats.flushes >= 2, "Validate flush count, expected: >= 2, got: %u", (unsigned int) stats.flushes);
+   SDLTest_AssertCheck(stats.forced_flushes <= 1, "Validate forced flush count, expected: <= 1, got: %u", (unsigned int) stats.forced_flushes);
+   SDLTest_AssertCheck(stats.vertex_bytes > 0, "Validate vertex bytes are counted, got: %u", (unsigned int) stats.vertex_bytes);
+
+   /* A new frame starts from zero. */
+   SDL_RenderPresent(statsRenderer);
+   ret = SDL_RenderGetStats(statsRenderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.copy_commands == 0, "Validate copy count after empty frame, expected: 0, got: %u", (unsigned int) stats.copy_commands);
+
+   /* Clean up. */
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(statsRenderer);
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+
+/* Draws interleaved copies of two textures with the given SDL_HINT_RENDER_OPTIMIZE level. */
+static int
+_renderOptimizedScene(const char *level, Uint32 *pixels, SDL_RenderStats *stats)
+{
+   SDL_Window *optWindow;
+   SDL_Renderer *optRenderer;
+   SDL_Texture *textures[2];
+   const Uint32 colors[2] = { 0xFFFF0000, 0xFF0000FF };
+   SDL_Rect rect;
+   int i, ret;
+
+   optWindow = SDL_CreateWindow("render_testOptimizeQueue", 0, 0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 0);
+   SDLTest_AssertCheck(optWindow != NULL, "Verify result from SDL_CreateWindow is not NULL");
+   if (optWindow == NULL) {
+       return -1;
+   }
+
+   SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+   SDL_SetHint(SDL_HINT_RENDER_STATS, "1");
+   SDL_SetHint(SDL_HINT_RENDER_OPTIMIZE, level);
+   optRenderer = SDL_CreateRenderer(optWindow, -1, SDL_RENDERER_SOFTWARE);
+   SDL_SetHint(SDL_HINT_RENDER_BATCHING, NULL);
+   SDL_SetHint(SDL_HINT_RENDER_STATS, NULL);
+   SDL_SetHint(SDL_HINT_RENDER_OPTIMIZE, NULL);
+   SDLTest_AssertCheck(optRenderer != NULL, "Verify result from SDL_CreateRenderer is not NULL");
+   if (optRenderer == NULL) {
+       SDL_DestroyWindow(optWindow);
+       return -1;
+   }
+
+   for (i = 0; i < 2; i++) {
+       textures[i] = SDL_CreateTexture(optRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+       SDLTest_AssertCheck(textures[i] != NULL, "Verify result from SDL_CreateTexture is not NULL");
+       SDL_UpdateTexture(textures[i], NULL, &colors[i], sizeof (Uint32));
+   }
+
+   SDL_SetRenderDrawColor(optRenderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(optRenderer);
+   rect.y = 0;
+   rect.w = rect.h = 4;
+   for (i = 0; i < 8; i++) {
+       rect.x = i * 4;
+       SDL_RenderCopy(optRenderer, textures[i % 2], NULL, &rect);
+   }
+
+   rect.x = rect.y = 0;
+   rect.w = 32;
+   rect.h = 4;
+   ret = SDL_RenderReadPixels(optRenderer, &rect, SDL_PIXELFORMAT_ARGB8888, pixels, rect.w * sizeof (Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   SDL_RenderPresent(optRenderer);
+   SDL_RenderGetStats(optRenderer, stats);
+
+   SDL_DestroyTexture(textures[0]);
+   SDL_DestroyTexture(textures[1]);
+   SDL_DestroyRenderer(optRenderer);
+   SDL_DestroyWindow(optWindow);
+   return 0;
+}
+
+/**
+ * @brief Tests that the render queue optimizer merges copies without changing the output.
+ *
+ * \\sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_HINT_RENDER_OPTIMIZE
+ */
+int
+render_testOptimizeQueue(void *arg)
+{
+   Uint32 reference[32 * 4];
+   Uint32 optimized[32 * 4];
+   SDL_RenderStats stats;
+
+   if (_renderOptimizedScene("0", reference, &stats) < 0) {
+       return TEST_ABORTED;
+   }
+   SDLTest_AssertCheck(stats.copy_commands == 8, "Validate unoptimized copy count, expected: 8, got: %u", (unsigned int) stats.copy_commands);
+
+   if (_renderOptimizedScene("2", optimized, &stats) < 0) {
+       return TEST_ABORTED;
+   }
+   SDLTest_AssertCheck(stats.copy_commands == 2, "Validate reordered copy count, expected: 2, got: %u", (unsigned int) stats.copy_commands);
+   SDLTest_AssertCheck(SDL_memcmp(reference, optimized, sizeof (reference)) == 0, "Validate reordered output matches the unoptimized output");
+
+   return TEST_COMPLETED;
+}
+
+
+/* Draws a mix of commands on a software renderer using the given number of threads. */
+static int
+_renderThreadedScene(const char *threads, Uint32 *pixels)
+{
+   SDL_Window *swWindow;
+   SDL_Renderer *swRenderer;
+   SDL_Texture *texture;
+   Uint32 texels[16 * 16];
+   SDL_Vertex verts[3];
+   SDL_Rect rect;
+   int i, ret;
+
+   swWindow = SDL_CreateWindow("render_testSoftwareThreads", 0, 0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 0);
+   SDLTest_AssertCheck(swWindow != NULL, "Verify result from SDL_CreateWindow is not NULL");
+   if (swWindow == NULL) {
+       return -1;
+   }
+
+   SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+   SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, threads);
+   swRenderer = SDL_CreateRenderer(swWindow, -1, SDL_RENDERER_SOFTWARE);
+   SDL_SetHint(SDL_HINT_RENDER_BATCHING, NULL);
+   SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, NULL);
+   SDLTest_AssertCheck(swRenderer != NULL, "Verify result from SDL_CreateRenderer is not NULL");
+   if (swRenderer == NULL) {
+       SDL_DestroyWindow(swWindow);
+       return -1;
+   }
+
+   for (i = 0; i < SDL_arraysize(texels); i++) {
+       texels[i] = (Uint32) (i * 0x9E3779B1);
+   }
+   texture = SDL_CreateTexture(swRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16);
+   SDLTest_AssertCheck(texture != NULL, "Verify result from SDL_CreateTexture is not NULL");
+   SDL_UpdateTexture(texture, NULL, texels, 16 * sizeof (Uint32));
+   SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+   SDL_SetRenderDrawColor(swRenderer, 10, 20, 30, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(swRenderer);
+   SDL_SetRenderDrawBlendMode(swRenderer, SDL_BLENDMODE_BLEND);
+   for (i = 0; i < 64; i++) {
+       rect.x = (i * 37) % TESTRENDER_SCREEN_W - 8;
+       rect.y = (i * 53) % TESTRENDER_SCREEN_H - 8;
+       rect.w = rect.h = 16 + (i % 5) * 20;
+       SDL_SetRenderDrawColor(swRenderer, i * 4, 255 - i * 4, i * 2, 128);
+       SDL_RenderFillRect(swRenderer, &rect);
+       SDL_RenderDrawLine(swRenderer, rect.x, rect.y, rect.x + rect.w, rect.y + rect.h);
+       rect.w = rect.h = 16;
+       SDL_SetTextureAlphaMod(texture, 255 - i);
+       SDL_RenderCopy(swRenderer, texture, NULL, &rect);
+   }
+   for (i = 0; i < 3; i++) {
+       verts[i].position.x = (float) (20 + i * 150);
+       verts[i].position.y = (float) (i == 1 ? 220 : 10);
+       verts[i].color.r = (Uint8) (i * 120);
+       verts[i].color.g = 200;
+       verts[i].color.b = (Uint8) (255 - i * 120);
+       verts[i].color.a = 200;
+       verts[i].tex_coord.x = verts[i].tex_coord.y = 0.0f;
+   }
+   SDL_RenderGeometry(swRenderer, NULL, verts, 3, NULL, 0);
+
+   ret = SDL_RenderReadPixels(swRenderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, TESTRENDER_SCREEN_W * sizeof (Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(swRenderer);
+   SDL_DestroyWindow(swWindow);
+   return ret;
+}
+
+/**
+ * @brief Tests that the tiled, multithreaded software renderer matches the serial one.
+ *
+ * \\sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_HINT_RENDER_SOFTWARE_THREADS
+ */
+int
+render_testSoftwareThreads(void *arg)
+{
+   const size_t size = TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H * sizeof (Uint32);
+   Uint32 *reference = (Uint32 *) SDL_malloc(size);
+   Uint32 *threaded = (Uint32 *) SDL_malloc(size);
+   int result = TEST_COMPLETED;
+
+   SDLTest_AssertCheck(reference != NULL && threaded != NULL, "Verify result from SDL_malloc is not NULL");
+   if (reference == NULL || threaded == NULL) {
+       result = TEST_ABORTED;
+   } else if (_renderThreadedScene("1", reference) < 0 || _renderThreadedScene("4", threaded) < 0) {
+       result = TEST_ABORTED;
+   } else {
+       SDLTest_AssertCheck(SDL_memcmp(reference, threaded, size) == 0, "Validate threaded output matches the serial output");
+   }
+
+   SDL_free(reference);
+   SDL_free(threaded);
+   return result;
+}
+
+
+/**
+ * @brief Tests batched blits against the blitting reference.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopiesF
+ */
+int
+render_testBlitBatched(void *arg)
+{
+   int ret;
+   SDL_Texture *tface;
+   SDL_Surface *referenceSurface = NULL;
+   SDL_FRect *rects;
+   Uint32 tformat;
+   int taccess, tw, th;
+   int i, j, ni, nj;
+   int count = 0;
+
+   /* Clear surface. */
+   _clearScreen();
+
+   /* Create face surface. */
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL,  "Verify _loadTestFace() result");
+   if (tface == NULL) {
+       return TEST_ABORTED;
+   }
+
+   ret = SDL_QueryTexture(tface, &tformat, &taccess, &tw, &th);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_QueryTexture, expected 0, got %i", ret);
+   ni     = TESTRENDER_SCREEN_W - tw;
+   nj     = TESTRENDER_SCREEN_H - th;
+
+   /* Invalid parameters. */
+   ret = SDL_RenderCopiesF(renderer, tface, NULL, NULL, 1);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderCopiesF with NULL dstrects, expected: -1, got: %i", ret);
+
+   /* Same layout as render_testBlit, in a single call. */
+   rects = (SDL_FRect *)SDL_calloc(((ni / 4) + 1) * ((nj / 4) + 1), sizeof (SDL_FRect));
+   SDLTest_AssertCheck(rects != NULL, "Validate allocated rectangle array");
+   if (rects == NULL) {
+       SDL_DestroyTexture(tface);
+       return TEST_ABORTED;
+   }
+
+   for (j=0; j <= nj; j+=4) {
+      for (i=0; i <= ni; i+=4) {
+         rects[count].x = (float) i;
+         rects[count].y = (float) j;
+         rects[count].w = (float) tw;
+         rects[count].h = (float) th;
+         count++;
+      }
+   }
+
+   ret = SDL_RenderCopiesF(renderer, tface, NULL, rects, count);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopiesF, expected: 0, got: %i", ret);
+
+   /* Make current */
+   SDL_RenderPresent(renderer);
+
+   /* See if it's the same */
+   referenceSurface = SDLTest_ImageBlit();
+   _compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE );
+
+   /* Clean up. */
+   SDL_free(rects);
+   SDL_DestroyTexture( tface );
+   SDL_FreeSurface(referenceSurface);
+   referenceSurface = NULL;
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests batched geometry against the blitting reference.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderGeometry
+ */
+int
+render_testGeometry(void *arg)
+{
+   int ret;
+   SDL_Texture *tface;
+   SDL_Surface *referenceSurface = NULL;
+   SDL_Vertex *vertices;
+   int *indices;
+   Uint32 tformat;
+   int taccess, tw, th;
+   int i, j, ni, nj;
+   int nquads = 0;
+
+   /* Clear surface. */
+   _clearScreen();
+
+   /* Create face surface. */
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL,  "Verify _loadTestFace() result");
+   if (tface == NULL) {
+       return TEST_ABORTED;
+   }
+
+   ret = SDL_QueryTexture(tface, &tformat, &taccess, &tw, &th);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_QueryTexture, expected 0, got %i", ret);
+   ni     = TESTRENDER_SCREEN_W - tw;
+   nj     = TESTRENDER_SCREEN_H - th;
+
+   /* Invalid parameters. */
+   ret = SDL_RenderGeometry(renderer, tface, NULL, 3, NULL, 0);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderGeometry with NULL vertices, expected: -1, got: %i", ret);
+
+   /* Same layout as render_testBlit, but as one indexed list of quads. */
+   vertices = (SDL_Vertex *)SDL_calloc(((ni / 4) + 1) * ((nj / 4) + 1) * 4, sizeof (SDL_Vertex));
+   indices = (int *)SDL_calloc(((ni / 4) + 1) * ((nj / 4) + 1) * 6, sizeof (int));
+   SDLTest_AssertCheck(vertices != NULL && indices != NULL, "Validate allocated vertex and index arrays");
+   if (vertices == NULL || indices == NULL) {
+       SDL_free(vertices);
+       SDL_free(indices);
+       SDL_DestroyTexture(tface);
+       return TEST_ABORTED;
+   }
+
+   for (j=0; j <= nj; j+=4) {
+      for (i=0; i <= ni; i+=4) {
+         SDL_Vertex *v = &vertices[nquads * 4];
+         int *idx = &indices[nquads * 6];
+         int k;
+         for (k = 0; k < 4; k++) {
+            v[k].position.x = (float) (i + ((k == 1 || k == 2) ? tw : 0));
+            v[k].position.y = (float) (j + ((k >= 2) ? th : 0));
+            v[k].tex_coord.x = (k == 1 || k == 2) ? 1.0f : 0.0f;
+            v[k].tex_coord.y = (k >= 2) ? 1.0f : 0.0f;
+            v[k].color.r = v[k].color.g = v[k].color.b = v[k].color.a = 255;
+         }
+         idx[0] = nquads * 4 + 0;
+         idx[1] = nquads * 4 + 1;
+         idx[2] = nquads * 4 + 2;
+         idx[3] = nquads * 4 + 0;
+         idx[4] = nquads * 4 + 2;
+         idx[5] = nquads * 4 + 3;
+         nquads++;
+      }
+   }
+
+   ret = SDL_RenderGeometry(renderer, tface, vertices, nquads * 4, indices, nquads * 6);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGeometry, expected: 0, got: %i", ret);
+
+   /* Make current */
+   SDL_RenderPresent(renderer);
+
+   /* See if it's the same */
+   referenceSurface = SDLTest_ImageBlit();
+   _compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE );
+
+   /* Clean up. */
+   SDL_free(vertices);
+   SDL_free(indices);
+   SDL_DestroyTexture( tface );
+   SDL_FreeSurface(referenceSurface);
+   referenceSurface = NULL;
+
+   return TEST_COMPLETED;
+}
+
+
 /**
  * @brief Blits doing color tests.
  *
@@ -1089,9 +1518,25 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testGeometry, "render_testGeometry", "Tests batched geometry", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testBlitBatched, "render_testBlitBatched", "Tests batched blitting", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        { (SDLTest_TestCaseFp)render_testRenderStats, "render_testRenderStats", "Tests render queue statistics", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest11 =
+        { (SDLTest_TestCaseFp)render_testOptimizeQueue, "render_testOptimizeQueue", "Tests the render queue optimizer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest12 =
+        { (SDLTest_TestCaseFp)render_testSoftwareThreads, "render_testSoftwareThreads", "Tests the multithreaded software renderer", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9,
+    &renderTest10, &renderTest11, &renderTest12, NULL
 };
 
 /* Render test suite (global) */
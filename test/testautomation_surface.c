@@ -595,6 +595,244 @@ surface_testBlitBlendLoop(void *arg) {
 
 }
 
+/* Reference bilinear sample, 16.16 source positions and 7-bit weights */
+static void
+_linearCoord(Sint64 pos, int first, int last, int *i0, int *i1, int *frac)
+{
+    if (pos <= ((Sint64)first << 16)) {
+        *i0 = *i1 = first;
+        *frac = 0;
+    } else if ((int)(pos >> 16) >= last) {
+        *i0 = *i1 = last;
+        *frac = 0;
+    } else {
+        *i0 = (int)(pos >> 16);
+        *i1 = *i0 + 1;
+        *frac = (int)((pos >> 9) & 127);
+    }
+}
+
+static Uint32
+_linearReferencePixel(SDL_Surface *src, const SDL_Rect *srcrect, const SDL_Rect *dstrect, int x, int y)
+{
+    const Sint64 xinc = ((Sint64)srcrect->w << 16) / dstrect->w;
+    const Sint64 yinc = ((Sint64)srcrect->h << 16) / dstrect->h;
+    int x0, x1, y0, y1, fx, fy, shift;
+    Uint32 p[4], pixel = 0;
+
+    _linearCoord(((Sint64)srcrect->x << 16) + xinc / 2 - 0x8000 + x * xinc, srcrect->x, srcrect->x + srcrect->w - 1, &x0, &x1, &fx);
+    _linearCoord(((Sint64)srcrect->y << 16) + yinc / 2 - 0x8000 + y * yinc, srcrect->y, srcrect->y + srcrect->h - 1, &y0, &y1, &fy);
+    p[0] = ((Uint32 *)((Uint8 *)src->pixels + y0 * src->pitch))[x0];
+    p[1] = ((Uint32 *)((Uint8 *)src->pixels + y0 * src->pitch))[x1];
+    p[2] = ((Uint32 *)((Uint8 *)src->pixels + y1 * src->pitch))[x0];
+    p[3] = ((Uint32 *)((Uint8 *)src->pixels + y1 * src->pitch))[x1];
+    for (shift = 0; shift < 32; shift += 8) {
+        const Uint32 c = (((p[0] >> shift) & 0xFF) * (128 - fx) * (128 - fy) +
+                          ((p[1] >> shift) & 0xFF) * fx * (128 - fy) +
+                          ((p[2] >> shift) & 0xFF) * (128 - fx) * fy +
+                          ((p[3] >> shift) & 0xFF) * fx * fy + 8192) >> 14;
+        pixel |= c << shift;
+    }
+    return pixel;
+}
+
+/**
+ * @brief Tests SDL_SoftStretchLinear against a reference implementation.
+ */
+int
+surface_testSoftStretchLinear(void *arg)
+{
+    const Uint32 formats[] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888 };
+    const SDL_Rect srcrects[] = { { 0, 0, 17, 13 }, { 3, 2, 9, 7 }, { 5, 4, 1, 1 } };
+    const SDL_Rect dstrects[] = { { 0, 0, 40, 31 }, { 2, 1, 7, 5 }, { 0, 0, 64, 48 } };
+    SDL_Surface *src, *dst, *other;
+    int f, r, x, y, ret, errors;
+
+    for (f = 0; f < SDL_arraysize(formats); ++f) {
+        src = SDL_CreateRGBSurfaceWithFormat(0, 17, 13, 32, formats[f]);
+        dst = SDL_CreateRGBSurfaceWithFormat(0, 64, 48, 32, formats[f]);
+        SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify surfaces of format %s are not NULL", SDL_GetPixelFormatName(formats[f]));
+        if (src == NULL || dst == NULL) {
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            return TEST_ABORTED;
+        }
+
+        for (y = 0; y < src->h; ++y) {
+            for (x = 0; x < src->w; ++x) {
+                ((Uint32 *)((Uint8 *)src->pixels + y * src->pitch))[x] = SDLTest_RandomUint32();
+            }
+        }
+
+        for (r = 0; r < SDL_arraysize(srcrects); ++r) {
+            ret = SDL_SoftStretchLinear(src, &srcrects[r], dst, &dstrects[r]);
+            SDLTest_AssertPass("Call to SDL_SoftStretchLinear(), %dx%d to %dx%d", srcrects[r].w, srcrects[r].h, dstrects[r].w, dstrects[r].h);
+            SDLTest_AssertCheck(ret == 0, "Verify result value; expected: 0, got: %i", ret);
+
+            errors = 0;
+            for (y = 0; y < dstrects[r].h; ++y) {
+                for (x = 0; x < dstrects[r].w; ++x) {
+                    const Uint32 actual = ((Uint32 *)((Uint8 *)dst->pixels + (dstrects[r].y + y) * dst->pitch))[dstrects[r].x + x];
+                    if (actual != _linearReferencePixel(src, &srcrects[r], &dstrects[r], x, y)) {
+                        ++errors;
+                    }
+                }
+            }
+            SDLTest_AssertCheck(errors == 0, "Verify stretched pixels match the reference; expected: 0 differences, got: %i", errors);
+        }
+
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+    }
+
+    /* Mismatched and unsupported formats are rejected */
+    src = SDL_CreateRGBSurfaceWithFormat(0, 8, 8, 32, SDL_PIXELFORMAT_ARGB8888);
+    dst = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_ABGR8888);
+    other = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 16, SDL_PIXELFORMAT_RGB565);
+    ret = SDL_SoftStretchLinear(src, NULL, dst, NULL);
+    SDLTest_AssertCheck(ret == -1, "Verify mismatched formats fail; expected: -1, got: %i", ret);
+    ret = SDL_SoftStretchLinear(other, NULL, other, NULL);
+    SDLTest_AssertCheck(ret == -1, "Verify 16-bit formats fail; expected: -1, got: %i", ret);
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(dst);
+    SDL_FreeSurface(other);
+
+    return TEST_COMPLETED;
+}
+
+/* The per-pixel alpha blend of BlitRGBtoRGBPixelAlpha */
+static Uint32
+_blendPixelAlphaReference(Uint32 s, Uint32 d)
+{
+    Uint32 alpha = s >> 24;
+    Uint32 dalpha, s1, d1;
+
+    if (alpha == 0) {
+        return d;
+    } else if (alpha == 0xFF) {
+        return s;
+    }
+    dalpha = d >> 24;
+    s1 = s & 0xff00ff;
+    d1 = d & 0xff00ff;
+    d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;
+    s &= 0xff00;
+    d &= 0xff00;
+    d = (d + ((s - d) * alpha >> 8)) & 0xff00;
+    dalpha = alpha + (dalpha * (alpha ^ 0xFF) >> 8);
+    return d1 | d | (dalpha << 24);
+}
+
+/**
+ * @brief Tests conversions and alpha blending between 32-bit formats, which have SIMD versions.
+ */
+int
+surface_testBlit32Formats(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGBX8888, SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_BGRX8888,
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGRA8888
+    };
+    const int w = 37, h = 3;    /* not a multiple of the vector width */
+    SDL_Surface *src, *dst;
+    Uint32 *saved;
+    int i, j, x, errors, ret;
+
+    saved = (Uint32 *)SDL_malloc(w * h * sizeof(Uint32));
+    SDLTest_AssertCheck(saved != NULL, "Verify buffer is not NULL");
+    if (saved == NULL) {
+        return TEST_ABORTED;
+    }
+
+    /* Conversions must keep every channel */
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, formats[i]);
+            dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, formats[j]);
+            if (src == NULL || dst == NULL) {
+                SDLTest_AssertCheck(SDL_FALSE, "Failed to create surfaces: %s", SDL_GetError());
+                SDL_FreeSurface(src);
+                SDL_FreeSurface(dst);
+                SDL_free(saved);
+                return TEST_ABORTED;
+            }
+            for (x = 0; x < w * h; ++x) {
+                ((Uint32 *)src->pixels)[x] = SDLTest_RandomUint32();
+            }
+            SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+
+            ret = SDL_BlitSurface(src, NULL, dst, NULL);
+            SDLTest_AssertCheck(ret == 0, "Verify result from blitting %s to %s; expected: 0, got: %i",
+                                SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(formats[j]), ret);
+
+            errors = 0;
+            for (x = 0; x < w * h; ++x) {
+                Uint8 sr, sg, sb, sa, dr, dg, db, da;
+                SDL_GetRGBA(((Uint32 *)src->pixels)[x], src->format, &sr, &sg, &sb, &sa);
+                SDL_GetRGBA(((Uint32 *)dst->pixels)[x], dst->format, &dr, &dg, &db, &da);
+                if (sr != dr || sg != dg || sb != db || (dst->format->Amask && sa != da)) {
+                    ++errors;
+                }
+            }
+            SDLTest_AssertCheck(errors == 0, "Verify converted pixels; expected: 0 differences, got: %i", errors);
+
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+        }
+    }
+
+    /* Per-pixel alpha blending with 8-bit alpha in the top byte. Only the
+       C and the SSE4.1/AVX2 versions round exactly the same way, the older
+       MMX and ARM versions don't. SDL_BLIT_CPU_FEATURES can turn SSE4.1 off. */
+    if (!SDL_HasSSE41() || SDL_getenv("SDL_BLIT_CPU_FEATURES")) {
+        SDLTest_Log("SSE4.1 not available, skipping the alpha blending check");
+        SDL_free(saved);
+        return TEST_COMPLETED;
+    }
+    for (i = 4; i < SDL_arraysize(formats); i += 2) {
+        src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, formats[i]);
+        dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, formats[i]);
+        if (src == NULL || dst == NULL) {
+            SDLTest_AssertCheck(SDL_FALSE, "Failed to create surfaces: %s", SDL_GetError());
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            SDL_free(saved);
+            return TEST_ABORTED;
+        }
+        for (x = 0; x < w * h; ++x) {
+            Uint32 pixel = SDLTest_RandomUint32();
+            /* Include the transparent and opaque special cases */
+            if (x % 5 == 0) {
+                pixel &= 0x00FFFFFF;
+            } else if (x % 5 == 1) {
+                pixel |= 0xFF000000;
+            }
+            ((Uint32 *)src->pixels)[x] = pixel;
+            ((Uint32 *)dst->pixels)[x] = saved[x] = SDLTest_RandomUint32();
+        }
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+
+        ret = SDL_BlitSurface(src, NULL, dst, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from blending %s; expected: 0, got: %i", SDL_GetPixelFormatName(formats[i]), ret);
+
+        errors = 0;
+        for (x = 0; x < w * h; ++x) {
+            if (((Uint32 *)dst->pixels)[x] != _blendPixelAlphaReference(((Uint32 *)src->pixels)[x], saved[x])) {
+                ++errors;
+            }
+        }
+        SDLTest_AssertCheck(errors == 0, "Verify blended pixels; expected: 0 differences, got: %i", errors);
+
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+    }
+
+    SDL_free(saved);
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -637,11 +875,17 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testSoftStretchLinear, "surface_testSoftStretchLinear", "Tests bilinear stretching against a reference implementation.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testBlit32Formats, "surface_testBlit32Formats", "Tests conversions and alpha blending between 32-bit formats.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14, NULL
 };
 
 /* Surface test suite (global) */
@@ -172,6 +172,130 @@ timer_addRemoveTimer(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Number of timers used by timer_addRemoveManyTimers */
+#define _MANY_TIMERS 500
+
+/* Tick at which each of the many timers fired, or 0 */
+static SDL_atomic_t _manyTimersFired[_MANY_TIMERS];
+
+/* Records when it was called; the low bit is set so tick 0 still counts */
+Uint32 SDLCALL _manyTimersCallback(Uint32 interval, void *param)
+{
+  SDL_AtomicSet(&_manyTimersFired[(int)(intptr_t)param], (int)SDL_GetTicks() | 1);
+  return 0;
+}
+
+/**
+ * @brief Add and remove enough timers to grow the timer ID lookup and the timer queue
+ */
+int
+timer_addRemoveManyTimers(void *arg)
+{
+  SDL_TimerID ids[_MANY_TIMERS];
+  Uint32 added[_MANY_TIMERS];
+  int i, removed = 0, fired = 0, early = 0, wrong = 0;
+
+  /* Long timers that never fire, removed in a different order than added */
+  for (i = 0; i < _MANY_TIMERS; i++) {
+    ids[i] = SDL_AddTimer(100000, _manyTimersCallback, (void *)(intptr_t)i);
+  }
+  SDLTest_AssertPass("Call to SDL_AddTimer(100000,...) %d times", _MANY_TIMERS);
+  for (i = _MANY_TIMERS - 1; i >= 0; i -= 2) {
+    removed += (SDL_RemoveTimer(ids[i]) == SDL_TRUE);
+  }
+  for (i = 0; i < _MANY_TIMERS; i += 2) {
+    removed += (SDL_RemoveTimer(ids[i]) == SDL_TRUE);
+  }
+  SDLTest_AssertCheck(removed == _MANY_TIMERS, "Check removed timers, expected: %d, got: %d", _MANY_TIMERS, removed);
+  removed = 0;
+  for (i = 0; i < _MANY_TIMERS; i++) {
+    removed += (SDL_RemoveTimer(ids[i]) == SDL_TRUE);
+  }
+  SDLTest_AssertCheck(removed == 0, "Check timers can't be removed twice, expected: 0, got: %d", removed);
+
+  /* Short timers with mixed intervals, every third one removed before it fires */
+  for (i = 0; i < _MANY_TIMERS; i++) {
+    SDL_AtomicSet(&_manyTimersFired[i], 0);
+  }
+  for (i = 0; i < _MANY_TIMERS; i++) {
+    added[i] = SDL_GetTicks();
+    ids[i] = SDL_AddTimer((i % 3) ? 10 + (i * 7) % 40 : 5000, _manyTimersCallback, (void *)(intptr_t)i);
+  }
+  for (i = 0; i < _MANY_TIMERS; i += 3) {
+    SDL_RemoveTimer(ids[i]);
+  }
+  SDL_Delay(300);
+  SDLTest_AssertPass("Call to SDL_Delay(300)");
+
+  for (i = 0; i < _MANY_TIMERS; i++) {
+    const Uint32 tick = (Uint32)SDL_AtomicGet(&_manyTimersFired[i]);
+    if (i % 3 == 0) {
+      wrong += (tick != 0);
+    } else if (tick != 0) {
+      fired++;
+      early += ((Sint32)(tick - (added[i] + 10 + (i * 7) % 40)) < -1);
+    }
+  }
+  SDLTest_AssertCheck(wrong == 0, "Check removed timers did not fire, got: %d", wrong);
+  SDLTest_AssertCheck(fired == _MANY_TIMERS - (_MANY_TIMERS + 2) / 3, "Check fired timers, expected: %d, got: %d", _MANY_TIMERS - (_MANY_TIMERS + 2) / 3, fired);
+  SDLTest_AssertCheck(early == 0, "Check no timer fired early, got: %d", early);
+
+  return TEST_COMPLETED;
+}
+
+/* Number of calls made to _nsTimerCallback before it stops */
+#define _NS_TIMER_CALLS 20
+
+static SDL_atomic_t _nsTimerCalls;
+static Uint64 _nsTimerLastCall;
+
+Uint64 SDLCALL _nsTimerCallback(Uint64 interval, void *param)
+{
+  _nsTimerLastCall = SDL_GetTicksNS();
+  if (SDL_AtomicIncRef(&_nsTimerCalls) + 1 >= _NS_TIMER_CALLS) {
+    return 0;
+  }
+  return interval;
+}
+
+/**
+ * @brief Call to SDL_GetTicksNS, SDL_DelayNS and SDL_AddTimerNS
+ */
+int
+timer_addTimerNS(void *arg)
+{
+  const Uint64 interval = 200000;
+  Uint64 start, now;
+  SDL_TimerID id;
+  SDL_bool result;
+
+  /* Delay less than a millisecond */
+  start = SDL_GetTicksNS();
+  SDLTest_AssertPass("Call to SDL_GetTicksNS()");
+  SDL_DelayNS(interval);
+  SDLTest_AssertPass("Call to SDL_DelayNS(%d)", (int)interval);
+  now = SDL_GetTicksNS();
+  SDLTest_AssertCheck(now - start >= interval, "Check elapsed time, expected: >=%d, got: %d", (int)interval, (int)(now - start));
+
+  /* Periodic timer that stops itself */
+  SDL_AtomicSet(&_nsTimerCalls, 0);
+  start = SDL_GetTicksNS();
+  id = SDL_AddTimerNS(interval, _nsTimerCallback, NULL);
+  SDLTest_AssertPass("Call to SDL_AddTimerNS(%d,...)", (int)interval);
+  SDLTest_AssertCheck(id > 0, "Check result value, expected: >0, got: %d", id);
+  SDL_Delay(100);
+  SDLTest_AssertPass("Call to SDL_Delay(100)");
+  SDLTest_AssertCheck(SDL_AtomicGet(&_nsTimerCalls) == _NS_TIMER_CALLS, "Check callback calls, expected: %d, got: %d", _NS_TIMER_CALLS, SDL_AtomicGet(&_nsTimerCalls));
+  SDLTest_AssertCheck(_nsTimerLastCall - start >= _NS_TIMER_CALLS * interval, "Check callbacks weren't early, expected: >=%d, got: %d", (int)(_NS_TIMER_CALLS * interval), (int)(_nsTimerLastCall - start));
+
+  /* The timer stopped itself, so it can't be removed */
+  result = SDL_RemoveTimer(id);
+  SDLTest_AssertPass("Call to SDL_RemoveTimer()");
+  SDLTest_AssertCheck(result == SDL_FALSE, "Check result value, expected: %i, got: %i", SDL_FALSE, result);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Timer test cases */
@@ -187,9 +311,15 @@ static const SDLTest_TestCaseReference timerTest3 =
 static const SDLTest_TestCaseReference timerTest4 =
         { (SDLTest_TestCaseFp)timer_addRemoveTimer, "timer_addRemoveTimer", "Call to SDL_AddTimer and SDL_RemoveTimer", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference timerTest5 =
+        { (SDLTest_TestCaseFp)timer_addRemoveManyTimers, "timer_addRemoveManyTimers", "Call to SDL_AddTimer and SDL_RemoveTimer with many timers", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference timerTest6 =
+        { (SDLTest_TestCaseFp)timer_addTimerNS, "timer_addTimerNS", "Call to SDL_GetTicksNS, SDL_DelayNS and SDL_AddTimerNS", TEST_ENABLED };
+
 /* Sequence of Timer test cases */
 static const SDLTest_TestCaseReference *timerTests[] =  {
-    &timerTest1, &timerTest2, &timerTest3, &timerTest4, NULL
+    &timerTest1, &timerTest2, &timerTest3, &timerTest4, &timerTest5, &timerTest6, NULL
 };
 
 /* Timer test suite (global) */
@@ -12,6 +12,64 @@
 
 #include "SDL.h"
 
+/* Push the whole file through a stream at each resampling quality, in
+   device-sized chunks, and report how long it takes. */
+static int
+benchmark(const SDL_AudioSpec *spec, const Uint8 *data, const Uint32 len, const int cvtfreq, const int cvtchans)
+{
+    static const struct
+    {
+        SDL_AudioResampleQuality quality;
+        const char *name;
+    } tiers[] = {
+        { SDL_AUDIO_RESAMPLE_ZERO_ORDER_HOLD, "zero-order hold" },
+        { SDL_AUDIO_RESAMPLE_LINEAR, "linear" },
+        { SDL_AUDIO_RESAMPLE_SHORT_SINC, "short sinc" },
+        { SDL_AUDIO_RESAMPLE_HIGH_QUALITY, "high quality" }
+    };
+    const int passes = 10;
+    const int framesize = (SDL_AUDIO_BITSIZE(spec->format) / 8) * spec->channels;
+    const int chunk = 1024 * framesize;
+    const double seconds = ((double) (len / framesize)) / spec->freq;
+    Uint8 outbuf[4096];
+    int i;
+
+    for (i = 0; i < (int) SDL_arraysize(tiers); i++) {
+        SDL_AudioStream *stream = SDL_NewAudioStream(spec->format, spec->channels, spec->freq, spec->format, cvtchans, cvtfreq);
+        Uint64 start, elapsed;
+        Uint32 outlen = 0;
+        double ms;
+        int pass;
+
+        if (!stream || (SDL_AudioStreamSetResampleQuality(stream, tiers[i].quality) < 0)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "failed to create stream: %s\n", SDL_GetError());
+            SDL_FreeAudioStream(stream);
+            return 1;
+        }
+
+        start = SDL_GetPerformanceCounter();
+        for (pass = 0; pass < passes; pass++) {
+            Uint32 pos;
+            for (pos = 0; pos < len; pos += chunk) {
+                const int amount = (int) SDL_min((Uint32) chunk, len - pos);
+                int got;
+                SDL_AudioStreamPut(stream, data + pos, amount);
+                while ((got = SDL_AudioStreamGet(stream, outbuf, sizeof (outbuf))) > 0) {
+                    outlen += got;
+                }
+            }
+            SDL_AudioStreamClear(stream);
+        }
+        elapsed = SDL_GetPerformanceCounter() - start;
+        SDL_FreeAudioStream(stream);
+
+        ms = (elapsed * 1000.0) / SDL_GetPerformanceFrequency() / passes;
+        SDL_Log("%-16s %8.3f ms per pass, %8.1fx realtime, %u bytes out\n", tiers[i].name, ms, (seconds * 1000.0) / ms, (unsigned int) (outlen / passes));
+    }
+
+    return 0;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -25,15 +83,21 @@ main(int argc, char **argv)
     int blockalign = 0;
     int avgbytes = 0;
     SDL_RWops *io = NULL;
+    SDL_bool benchmarking;
+    const char *infile;
 
     /* Enable standard application logging */
     SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
 
     if (argc != 5) {
         SDL_Log("USAGE: %s in.wav out.wav newfreq newchans\n", argv[0]);
+        SDL_Log("       %s --benchmark in.wav newfreq newchans\n", argv[0]);
         return 1;
     }
 
+    benchmarking = (SDL_strcmp(argv[1], "--benchmark") == 0) ? SDL_TRUE : SDL_FALSE;
+    infile = benchmarking ? argv[2] : argv[1];
+
     cvtfreq = SDL_atoi(argv[3]);
     cvtchans = SDL_atoi(argv[4]);
 
@@ -42,12 +106,19 @@ main(int argc, char **argv)
         return 2;
     }
 
-    if (SDL_LoadWAV(argv[1], &spec, &data, &len) == NULL) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "failed to load %s: %s\n", argv[1], SDL_GetError());
+    if (SDL_LoadWAV(infile, &spec, &data, &len) == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "failed to load %s: %s\n", infile, SDL_GetError());
         SDL_Quit();
         return 3;
     }
 
+    if (benchmarking) {
+        const int retval = benchmark(&spec, data, len, cvtfreq, cvtchans);
+        SDL_FreeWAV(data);
+        SDL_Quit();
+        return retval ? 9 : 0;
+    }
+
     if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq,
                           spec.format, cvtchans, cvtfreq) == -1) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "failed to build CVT: %s\n", SDL_GetError());
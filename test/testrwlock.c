@@ -0,0 +1,238 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Test the reader-writer lock functions: checks that readers never see a
+   half-finished write, and compares how lookups scale with the number of
+   threads against a mutex
+*/
+
+#include <stdio.h>
+
+#include "SDL.h"
+
+#define MAX_THREADS     16
+#define NUM_LOOKUPS     200000
+#define NUM_WRITES      2000
+#define TABLE_SIZE      64
+
+static SDL_rwlock *rwlock = NULL;
+static SDL_mutex *mutex = NULL;
+static int table[TABLE_SIZE];
+static SDL_atomic_t failures;
+static SDL_atomic_t done_writing;
+
+/* Every write adds one to all the entries */
+static SDL_bool
+TableIsConsistent(void)
+{
+    int i;
+
+    for (i = 1; i < TABLE_SIZE; ++i) {
+        if (table[i] != table[0]) {
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+static int SDLCALL
+Reader(void *data)
+{
+    while (!SDL_AtomicGet(&done_writing)) {
+        SDL_LockRWLockForReading(rwlock);
+        if (!TableIsConsistent()) {
+            SDL_AtomicIncRef(&failures);
+        }
+        SDL_UnlockRWLock(rwlock);
+    }
+    return 0;
+}
+
+static int SDLCALL
+Writer(void *data)
+{
+    int i, j;
+
+    for (i = 0; i < NUM_WRITES; ++i) {
+        SDL_LockRWLockForWriting(rwlock);
+        for (j = 0; j < TABLE_SIZE; ++j) {
+            ++table[j];
+            if ((j % 16) == 0) {
+                SDL_Delay(0);
+            }
+        }
+        SDL_UnlockRWLock(rwlock);
+    }
+    return 0;
+}
+
+static int SDLCALL
+RWLockLookups(void *data)
+{
+    int i, sum = 0;
+
+    for (i = 0; i < NUM_LOOKUPS; ++i) {
+        SDL_LockRWLockForReading(rwlock);
+        sum += table[i % TABLE_SIZE];
+        SDL_UnlockRWLock(rwlock);
+    }
+    return sum;
+}
+
+static int SDLCALL
+MutexLookups(void *data)
+{
+    int i, sum = 0;
+
+    for (i = 0; i < NUM_LOOKUPS; ++i) {
+        SDL_LockMutex(mutex);
+        sum += table[i % TABLE_SIZE];
+        SDL_UnlockMutex(mutex);
+    }
+    return sum;
+}
+
+static double
+TimeLookups(SDL_ThreadFunction func, int numthreads)
+{
+    SDL_Thread *threads[MAX_THREADS];
+    Uint64 start;
+    int i;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < numthreads; ++i) {
+        threads[i] = SDL_CreateThread(func, "Lookups", NULL);
+    }
+    for (i = 0; i < numthreads; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    return (double) (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static void
+CheckResult(const char *what, int result, int expected)
+{
+    if (result != expected) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s returned %d, expected %d\n", what, result, expected);
+        SDL_AtomicIncRef(&failures);
+    }
+}
+
+static int SDLCALL
+TryLockWriting(void *data)
+{
+    return SDL_TryLockRWLockForWriting(rwlock);
+}
+
+static int SDLCALL
+TryLockReading(void *data)
+{
+    int result = SDL_TryLockRWLockForReading(rwlock);
+    if (result == 0) {
+        SDL_UnlockRWLock(rwlock);
+    }
+    return result;
+}
+
+static int
+RunInThread(SDL_ThreadFunction func)
+{
+    SDL_Thread *thread = SDL_CreateThread(func, "TryLock", NULL);
+    int result = -1;
+
+    SDL_WaitThread(thread, &result);
+    return result;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Thread *threads[MAX_THREADS];
+    int maxthreads, numthreads, i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    maxthreads = SDL_GetCPUCount();
+    if (argc > 1) {
+        maxthreads = SDL_atoi(argv[1]);
+    }
+    maxthreads = SDL_max(SDL_min(maxthreads, MAX_THREADS), 1);
+
+    rwlock = SDL_CreateRWLock();
+    mutex = SDL_CreateMutex();
+    if (!rwlock || !mutex) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create locks: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    /* Locking again while holding the lock */
+    CheckResult("SDL_LockRWLockForReading()", SDL_LockRWLockForReading(rwlock), 0);
+    CheckResult("SDL_LockRWLockForReading() again", SDL_LockRWLockForReading(rwlock), 0);
+    CheckResult("SDL_TryLockRWLockForReading() from another thread", RunInThread(TryLockReading), 0);
+    CheckResult("SDL_TryLockRWLockForWriting() from another thread", RunInThread(TryLockWriting), SDL_MUTEX_TIMEDOUT);
+    SDL_UnlockRWLock(rwlock);
+    SDL_UnlockRWLock(rwlock);
+
+    CheckResult("SDL_LockRWLockForWriting()", SDL_LockRWLockForWriting(rwlock), 0);
+    CheckResult("SDL_LockRWLockForWriting() again", SDL_LockRWLockForWriting(rwlock), 0);
+    CheckResult("SDL_LockRWLockForReading() while writing", SDL_LockRWLockForReading(rwlock), 0);
+    CheckResult("SDL_TryLockRWLockForReading() from another thread", RunInThread(TryLockReading), SDL_MUTEX_TIMEDOUT);
+    SDL_UnlockRWLock(rwlock);
+    SDL_UnlockRWLock(rwlock);
+    CheckResult("SDL_TryLockRWLockForReading() from another thread", RunInThread(TryLockReading), SDL_MUTEX_TIMEDOUT);
+    SDL_UnlockRWLock(rwlock);
+    CheckResult("SDL_TryLockRWLockForReading() after unlocking", RunInThread(TryLockReading), 0);
+
+    /* Readers racing a writer */
+    numthreads = SDL_max(maxthreads, 2);
+    threads[0] = SDL_CreateThread(Writer, "Writer", NULL);
+    for (i = 1; i < numthreads; ++i) {
+        threads[i] = SDL_CreateThread(Reader, "Reader", NULL);
+    }
+    SDL_WaitThread(threads[0], NULL);
+    SDL_AtomicSet(&done_writing, 1);
+    for (i = 1; i < numthreads; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    CheckResult("Writes", table[0], NUM_WRITES);
+    if (!TableIsConsistent()) {
+        SDL_AtomicIncRef(&failures);
+    }
+
+    /* Lookups from more and more threads */
+    SDL_Log("%7s %16s %16s\n", "threads", "rwlock", "mutex");
+    for (numthreads = 1; numthreads <= maxthreads; numthreads *= 2) {
+        const double rwlock_time = TimeLookups(RWLockLookups, numthreads);
+        const double mutex_time = TimeLookups(MutexLookups, numthreads);
+        SDL_Log("%7d %13.2f ms %13.2f ms\n", numthreads, rwlock_time, mutex_time);
+    }
+
+    SDL_DestroyRWLock(rwlock);
+    SDL_DestroyMutex(mutex);
+    SDL_Quit();
+
+    if (SDL_AtomicGet(&failures)) {
+        SDL_Log("%d checks failed\n", SDL_AtomicGet(&failures));
+        return 1;
+    }
+    SDL_Log("All checks passed\n");
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
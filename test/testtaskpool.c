@@ -0,0 +1,206 @@
+/*
+  Copyright (C) 1997-2020 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark of the SDL task pool: runs the same work with more and more
+   worker threads, checks the results and reports the speedup over running
+   everything on the calling thread
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "SDL.h"
+
+#define NUM_VALUES      (1 << 21)
+#define NUM_TINY_TASKS  100000
+#define FIB_N           32
+#define FIB_CUTOFF      20
+
+typedef struct
+{
+    int n;
+    int result;
+} FibTask;
+
+static float *values = NULL;
+static float *expected = NULL;
+static SDL_atomic_t tiny_count;
+
+static void SDLCALL
+ComputeValues(void *data, int start, int end)
+{
+    float *out = (float *) data;
+    int i, j;
+
+    for (i = start; i < end; ++i) {
+        float value = 0.0f;
+        for (j = 0; j < 16; ++j) {
+            value = value * 0.5f + SDL_sqrtf((float) (i + j));
+        }
+        out[i] = value;
+    }
+}
+
+static int
+Fib(int n)
+{
+    return (n < 2) ? n : Fib(n - 1) + Fib(n - 2);
+}
+
+/* Splits into nested tasks that wait for each other */
+static void SDLCALL
+FibTaskFunc(void *data)
+{
+    FibTask *task = (FibTask *) data;
+    SDL_TaskGroup *group;
+    FibTask a, b;
+
+    if (task->n < FIB_CUTOFF) {
+        task->result = Fib(task->n);
+        return;
+    }
+
+    a.n = task->n - 1;
+    b.n = task->n - 2;
+    group = SDL_CreateTaskGroup();
+    if (!group || SDL_RunTask(group, FibTaskFunc, &a) < 0) {
+        FibTaskFunc(&a);
+    }
+    FibTaskFunc(&b);
+    SDL_DestroyTaskGroup(group);
+    task->result = a.result + b.result;
+}
+
+static void SDLCALL
+TinyTask(void *data)
+{
+    SDL_AtomicIncRef(&tiny_count);
+}
+
+static double
+Elapsed(Uint64 start)
+{
+    return (double) (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+int
+main(int argc, char *argv[])
+{
+    double base_for = 0.0, base_fib = 0.0, base_tiny = 0.0;
+    double time_for, time_fib, time_tiny;
+    int maxthreads, threads, i, fib_expected;
+    int failed = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    maxthreads = SDL_GetCPUCount() - 1;
+    if (argc > 1) {
+        maxthreads = SDL_atoi(argv[1]);
+    }
+
+    values = (float *) SDL_malloc(NUM_VALUES * sizeof(float));
+    expected = (float *) SDL_malloc(NUM_VALUES * sizeof(float));
+    if (!values || !expected) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        return 1;
+    }
+    ComputeValues(expected, 0, NUM_VALUES);
+    fib_expected = Fib(FIB_N);
+
+    SDL_Log("%d CPUs, testing with 0 to %d worker threads\n", SDL_GetCPUCount(), maxthreads);
+    SDL_Log("%7s %20s %20s %20s\n", "workers", "parallel for", "nested tasks", "tiny tasks");
+
+    for (threads = 0; threads <= maxthreads; ++threads) {
+        char hint[16];
+        FibTask fib;
+        SDL_TaskGroup *group;
+        Uint64 start;
+
+        /* The pool starts again with the new size after SDL_Quit() */
+        SDL_snprintf(hint, sizeof(hint), "%d", threads);
+        SDL_SetHint(SDL_HINT_TASK_POOL_THREADS, hint);
+        if (SDL_Init(0) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+            return 1;
+        }
+        if (SDL_GetTaskPoolThreadCount() != threads) {
+            SDL_Log("Only got %d worker threads\n", SDL_GetTaskPoolThreadCount());
+        }
+
+        /* Parallel for over a big array */
+        SDL_memset(values, 0, NUM_VALUES * sizeof(float));
+        start = SDL_GetPerformanceCounter();
+        if (SDL_ParallelFor(0, NUM_VALUES, 1024, ComputeValues, values) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_ParallelFor() failed: %s\n", SDL_GetError());
+            ++failed;
+        }
+        time_for = Elapsed(start);
+        for (i = 0; i < NUM_VALUES; ++i) {
+            if (values[i] != expected[i]) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_ParallelFor() result %d is wrong\n", i);
+                ++failed;
+                break;
+            }
+        }
+
+        /* Recursive tasks waiting for their children */
+        fib.n = FIB_N;
+        start = SDL_GetPerformanceCounter();
+        FibTaskFunc(&fib);
+        time_fib = Elapsed(start);
+        if (fib.result != fib_expected) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Nested tasks got %d, expected %d\n", fib.result, fib_expected);
+            ++failed;
+        }
+
+        /* Lots of tasks doing next to nothing, measuring the overhead */
+        SDL_AtomicSet(&tiny_count, 0);
+        start = SDL_GetPerformanceCounter();
+        group = SDL_CreateTaskGroup();
+        for (i = 0; i < NUM_TINY_TASKS; ++i) {
+            if (SDL_RunTask(group, TinyTask, NULL) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_RunTask() failed: %s\n", SDL_GetError());
+                ++failed;
+                break;
+            }
+        }
+        SDL_DestroyTaskGroup(group);
+        time_tiny = Elapsed(start);
+        if (SDL_AtomicGet(&tiny_count) != NUM_TINY_TASKS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Ran %d tiny tasks, expected %d\n", SDL_AtomicGet(&tiny_count), NUM_TINY_TASKS);
+            ++failed;
+        }
+
+        if (threads == 0) {
+            base_for = time_for;
+            base_fib = time_fib;
+            base_tiny = time_tiny;
+        }
+        SDL_Log("%7d %9.2f ms (%4.2fx) %9.2f ms (%4.2fx) %9.2f ms (%4.2fx)\n", threads,
+                time_for, base_for / time_for, time_fib, base_fib / time_fib,
+                time_tiny, base_tiny / time_tiny);
+
+        SDL_Quit();
+    }
+
+    SDL_free(values);
+    SDL_free(expected);
+
+    if (failed) {
+        SDL_Log("%d checks failed\n", failed);
+        return 1;
+    }
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
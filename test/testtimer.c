@@ -21,8 +21,14 @@
 
 #define DEFAULT_RESOLUTION  1
 
+/* Jitter is measured over one second of callbacks */
+#define JITTER_SAMPLES      4000
+
 static int ticks = 0;
 
+static Uint64 jitter_times[JITTER_SAMPLES];
+static int jitter_count = 0;
+
 static Uint32 SDLCALL
 ticktock(Uint32 interval, void *param)
 {
@@ -30,6 +36,51 @@ ticktock(Uint32 interval, void *param)
     return (interval);
 }
 
+static Uint32 SDLCALL
+jitter_callback(Uint32 interval, void *param)
+{
+    if (jitter_count < JITTER_SAMPLES) {
+        jitter_times[jitter_count++] = SDL_GetTicksNS();
+    }
+    return interval;
+}
+
+static Uint64 SDLCALL
+jitter_callback_ns(Uint64 interval, void *param)
+{
+    if (jitter_count < JITTER_SAMPLES) {
+        jitter_times[jitter_count++] = SDL_GetTicksNS();
+    }
+    return interval;
+}
+
+/* Reports how much the time between callbacks differed from the interval */
+static void
+report_jitter(const char *name, Uint64 interval_ns)
+{
+    double error, min = 0.0, max = 0.0, sum = 0.0, sum2 = 0.0, avg;
+    int i;
+
+    if (jitter_count < 2) {
+        SDL_Log("%s: only %d callbacks, can't measure jitter\n", name, jitter_count);
+        return;
+    }
+    for (i = 1; i < jitter_count; ++i) {
+        error = (double)(Sint64)(jitter_times[i] - jitter_times[i - 1] - interval_ns) / 1000.0;
+        if (i == 1 || error < min) {
+            min = error;
+        }
+        if (i == 1 || error > max) {
+            max = error;
+        }
+        sum += error;
+        sum2 += error * error;
+    }
+    avg = sum / (jitter_count - 1);
+    SDL_Log("%s: %d callbacks, interval error min = %.1f us, avg = %.1f us, max = %.1f us, stddev = %.1f us\n",
+            name, jitter_count, min, avg, max, SDL_sqrt(SDL_max(sum2 / (jitter_count - 1) - avg * avg, 0.0)));
+}
+
 static Uint32 SDLCALL
 callback(Uint32 interval, void *param)
 {
@@ -76,6 +127,27 @@ main(int argc, char *argv[])
                 desired, (double) (10 * 1000) / ticks);
     }
 
+    /* Measure the jitter of millisecond and nanosecond timers */
+    SDL_Log("Measuring timer jitter for 1 second each...\n");
+    jitter_count = 0;
+    t1 = SDL_AddTimer(1, jitter_callback, NULL);
+    SDL_Delay(1000);
+    SDL_RemoveTimer(t1);
+    SDL_Delay(10);
+    report_jitter("SDL_AddTimer(1 ms)", 1000000);
+
+    jitter_count = 0;
+    t1 = SDL_AddTimerNS(500000, jitter_callback_ns, NULL);
+    SDL_Delay(1000);
+    SDL_RemoveTimer(t1);
+    SDL_Delay(10);
+    report_jitter("SDL_AddTimerNS(500 us)", 500000);
+
+    start = SDL_GetTicksNS();
+    SDL_DelayNS(250000);
+    now = SDL_GetTicksNS();
+    SDL_Log("Delay 250 us = %f us according to SDL_GetTicksNS()\n", (double)(now - start) / 1000.0);
+
     /* Test multiple timers */
     SDL_Log("Testing multiple timers...\n");
     t1 = SDL_AddTimer(100, callback, (void *) 1);